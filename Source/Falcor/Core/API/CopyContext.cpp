@@ -400,6 +400,17 @@ void CopyContext::ReadTextureTask::getData(void* pData, size_t size) const
     mpBuffer->unmap();
 }
 
+const uint8_t* CopyContext::ReadTextureTask::map() const
+{
+    mpFence->wait();
+    return reinterpret_cast<const uint8_t*>(mpBuffer->map());
+}
+
+void CopyContext::ReadTextureTask::unmap() const
+{
+    mpBuffer->unmap();
+}
+
 std::vector<uint8_t> CopyContext::ReadTextureTask::getData() const
 {
     std::vector<uint8_t> result(size_t(mRowCount) * mActualRowSize * mDepth);
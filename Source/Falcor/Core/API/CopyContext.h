@@ -57,6 +57,15 @@ public:
         void getData(void* pData, size_t size) const;
         std::vector<uint8_t> getData() const;
 
+        /**
+         * Wait for the copy to finish and map the staging buffer.
+         * Rows are getRowPitch() bytes apart, slices getRowPitch() * getRowCount() bytes. Call unmap() when done.
+         */
+        const uint8_t* map() const;
+        void unmap() const;
+        uint32_t getRowPitch() const { return mRowSize; }
+        uint32_t getRowCount() const { return mRowCount; }
+
     private:
         ReadTextureTask() = default;
         ref<Fence> mpFence;
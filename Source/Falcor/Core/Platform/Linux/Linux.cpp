@@ -33,11 +33,13 @@
 
 #include <gtk/gtk.h>
 
+#include <fstream>
 #include <iostream>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <pwd.h>
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE // needed for dladdr()
@@ -579,13 +581,19 @@ void OSServices::stop() {}
 
 size_t getCurrentRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    // The second value of statm is the number of resident pages.
+    size_t pages = 0, residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> residentPages))
+        return 0;
+    return residentPages * size_t(sysconf(_SC_PAGESIZE));
 }
 
 size_t getPeakRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return size_t(usage.ru_maxrss) * 1024; // ru_maxrss is in kilobytes.
 }
 } // namespace Falcor
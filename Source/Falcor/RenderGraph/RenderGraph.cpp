@@ -29,6 +29,7 @@
 #include "RenderGraphIR.h"
 #include "RenderGraphImportExport.h"
 #include "RenderGraphCompiler.h"
+#include "RenderPassStandardFlags.h"
 #include "GlobalState.h"
 #include "Core/ObjectPython.h"
 #include "Core/API/Device.h"
@@ -144,7 +145,7 @@ uint32_t RenderGraph::addPass(const ref<RenderPass>& pPass, const std::string& p
 
     if (mpScene)
         pPass->setScene(mpDevice->getRenderContext(), mpScene);
-    mNodeData[passIndex] = {passName, pPass};
+    mNodeData[passIndex] = {passName, pPass, std::nullopt};
     mRecompile = true;
     return passIndex;
 }
@@ -195,6 +196,45 @@ void RenderGraph::updatePass(const std::string& passName, const Properties& prop
     mRecompile = true;
 }
 
+void RenderGraph::setPassSchedule(const std::string& passName, const std::optional<RenderPassSchedule>& schedule)
+{
+    uint32_t index = getPassIndex(passName);
+    FALCOR_CHECK(index != kInvalidIndex, "Can't set schedule of render pass '{}'. Pass doesn't exist.", passName);
+    FALCOR_CHECK(
+        !schedule || schedule->isValid(), "Invalid schedule for render pass '{}': phase must be less than a non-zero interval.", passName
+    );
+
+    mNodeData[index].schedule = schedule;
+    mRecompile = true;
+}
+
+RenderPassSchedule RenderGraph::getPassSchedule(const std::string& passName) const
+{
+    uint32_t index = getPassIndex(passName);
+    FALCOR_CHECK(index != kInvalidIndex, "Can't find render pass '{}'.", passName);
+
+    const auto& data = mNodeData.at(index);
+    return data.schedule ? *data.schedule : data.pPass->getSchedule();
+}
+
+void RenderGraph::setResourceAliasing(bool enabled)
+{
+    if (mCompilerDeps.aliasResources == enabled)
+        return;
+    mCompilerDeps.aliasResources = enabled;
+    mRecompile = true;
+}
+
+std::vector<ResourceCache::Allocation> RenderGraph::getResourceAllocations() const
+{
+    return mpExe ? mpExe->getResourceCache().getAllocations() : std::vector<ResourceCache::Allocation>();
+}
+
+ResourceCache::MemoryStats RenderGraph::getResourceMemoryStats() const
+{
+    return mpExe ? mpExe->getResourceCache().getMemoryStats() : ResourceCache::MemoryStats();
+}
+
 const ref<RenderPass>& RenderGraph::getPass(const std::string& name) const
 {
     uint32_t index = getPassIndex(name);
@@ -447,9 +487,11 @@ void RenderGraph::execute(RenderContext* pRenderContext)
         FALCOR_THROW("Failed to compile render graph:\n{}", log);
 
     FALCOR_ASSERT(mpExe);
+    mPassesDictionary[kRenderPassGraphFrame] = mFrameCount;
     RenderGraphExe::Context c{
-        pRenderContext, mPassesDictionary, mCompilerDeps.defaultResourceProps.dims, mCompilerDeps.defaultResourceProps.format};
+        pRenderContext, mPassesDictionary, mCompilerDeps.defaultResourceProps.dims, mCompilerDeps.defaultResourceProps.format, mFrameCount};
     mpExe->execute(c);
+    mFrameCount++;
 }
 
 void RenderGraph::update(const ref<RenderGraph>& pGraph)
@@ -719,6 +761,27 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     FALCOR_SCRIPT_BINDING_DEPENDENCY(Formats)
     FALCOR_SCRIPT_BINDING_DEPENDENCY(Resource)
 
+    // RenderPassSchedule
+    pybind11::class_<RenderPassSchedule> schedule(m, "RenderPassSchedule");
+    pybind11::falcor_enum<RenderPassSchedule::Trigger>(schedule, "Trigger");
+    schedule.def(
+        pybind11::init(
+            [](RenderPassSchedule::Trigger trigger, uint32_t interval, uint32_t phase) {
+                return RenderPassSchedule{trigger, interval, phase};
+            }
+        ),
+        "trigger"_a = RenderPassSchedule::Trigger::Frame,
+        "interval"_a = 1,
+        "phase"_a = 0
+    );
+    schedule.def_readwrite("trigger", &RenderPassSchedule::trigger);
+    schedule.def_readwrite("interval", &RenderPassSchedule::interval);
+    schedule.def_readwrite("phase", &RenderPassSchedule::phase);
+    schedule.def_static("every", &RenderPassSchedule::every, "interval"_a, "phase"_a = 0);
+    schedule.def_static("on_input_produced", &RenderPassSchedule::onInputProduced);
+    schedule.def_static("on_demand", &RenderPassSchedule::onDemand);
+    schedule.def("__repr__", &RenderPassSchedule::toString);
+
     // RenderPass
     pybind11::class_<RenderPass, ref<RenderPass>> renderPass(m, "RenderPass");
     renderPass.def_property_readonly("name", &RenderPass::getName);
@@ -726,6 +789,7 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     renderPass.def_property_readonly("desc", &RenderPass::getDesc);
     renderPass.def_property_readonly("properties", [](RenderPass& self) { return self.getProperties().toPython(); });
     renderPass.def("set_properties", [](RenderPass& self, pybind11::dict dict) { self.setProperties(Properties(dict)); });
+    renderPass.def_property_readonly("schedule", &RenderPass::getSchedule);
 
     // PYTHONDEPRECATED BEGIN
     renderPass.def("getDictionary", [](RenderPass& pass) { return pass.getProperties().toPython(); });
@@ -757,6 +821,40 @@ FALCOR_SCRIPT_BINDING(RenderGraph)
     renderGraph.def("mark_output", &RenderGraph::markOutput, "name"_a, "mask"_a = TextureChannelFlags::RGB);
     renderGraph.def("unmark_output", &RenderGraph::unmarkOutput, "name"_a);
     renderGraph.def("get_pass", &RenderGraph::getPass, "name"_a);
+    renderGraph.def("set_pass_schedule", &RenderGraph::setPassSchedule, "name"_a, "schedule"_a);
+    renderGraph.def("get_pass_schedule", &RenderGraph::getPassSchedule, "name"_a);
+    renderGraph.def_property("resource_aliasing", &RenderGraph::isResourceAliasingEnabled, &RenderGraph::setResourceAliasing);
+    renderGraph.def(
+        "get_resource_allocations",
+        [](const RenderGraph& self)
+        {
+            pybind11::list allocations;
+            for (const auto& a : self.getResourceAllocations())
+            {
+                pybind11::dict d;
+                d["name"] = a.name;
+                d["lifetime"] = a.lifetime;
+                d["resource"] = a.resourceIndex;
+                d["transient"] = a.transient;
+                d["size"] = a.size;
+                allocations.append(d);
+            }
+            return allocations;
+        }
+    );
+    renderGraph.def(
+        "get_resource_memory_stats",
+        [](const RenderGraph& self)
+        {
+            auto stats = self.getResourceMemoryStats();
+            pybind11::dict d;
+            d["fields"] = stats.fieldCount;
+            d["resources"] = stats.resourceCount;
+            d["required_bytes"] = stats.requiredBytes;
+            d["allocated_bytes"] = stats.allocatedBytes;
+            return d;
+        }
+    );
     renderGraph.def("__getitem__", [](RenderGraph& self, const std::string& name) { return self.getPass(name); });
     renderGraph.def("get_output", pybind11::overload_cast<const std::string&>(&RenderGraph::getOutput), "name"_a);
 
@@ -38,6 +38,7 @@
 #include "Scene/Scene.h"
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -118,6 +119,18 @@ public:
      */
     void updatePass(const std::string& passName, const Properties& props);
 
+    /**
+     * Override the schedule of a render pass, which otherwise is the one returned by RenderPass::getSchedule().
+     * @param[in] passName Render pass name.
+     * @param[in] schedule Schedule, or std::nullopt to use the schedule of the pass.
+     */
+    void setPassSchedule(const std::string& passName, const std::optional<RenderPassSchedule>& schedule);
+
+    /**
+     * Get the schedule a render pass is executed with.
+     */
+    RenderPassSchedule getPassSchedule(const std::string& passName) const;
+
     /**
      * Insert an edge from a render pass' output to a different render pass input.
      * The render passes must be different, the graph must be a DAG.
@@ -150,6 +163,32 @@ public:
      */
     void execute(RenderContext* pRenderContext);
 
+    /**
+     * Get the number of times the graph was executed. This is the frame index the render pass schedules refer to.
+     */
+    uint64_t getFrameCount() const { return mFrameCount; }
+
+    /**
+     * Enable or disable memory aliasing of transient resources. Enabled by default.
+     * Transient resources with the same description whose lifetimes in the execution order don't overlap share memory.
+     */
+    void setResourceAliasing(bool enabled);
+
+    /**
+     * Check if transient resources share memory.
+     */
+    bool isResourceAliasingEnabled() const { return mCompilerDeps.aliasResources; }
+
+    /**
+     * Get the resource allocation decisions of the last compilation. Empty if the graph wasn't compiled.
+     */
+    std::vector<ResourceCache::Allocation> getResourceAllocations() const;
+
+    /**
+     * Get the memory used by the resources of the last compilation.
+     */
+    ResourceCache::MemoryStats getResourceMemoryStats() const;
+
     /**
      * Update graph based on another graph's topology.
      */
@@ -322,6 +361,7 @@ private:
     {
         std::string name;
         ref<RenderPass> pPass;
+        std::optional<RenderPassSchedule> schedule; ///< Overrides the schedule of the pass if set.
     };
 
     struct GraphOut
@@ -378,6 +418,7 @@ private:
     std::unique_ptr<RenderGraphExe> mpExe;           ///< Helper for allocating resources and executing the graph.
     RenderGraphCompiler::Dependencies mCompilerDeps; ///< Data needed by the graph compiler.
     bool mRecompile = false; ///< Set to true to trigger a recompilation after any graph changes (topology/scene/size/passes/etc.)
+    uint64_t mFrameCount = 0; ///< Number of times the graph was executed.
 
     friend class RenderGraphUI;
     friend class RenderGraphExporter;
@@ -30,7 +30,9 @@
 #include "RenderPasses/ResolvePass.h"
 #include "Core/Error.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
+#include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -63,15 +65,18 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     c.compilePasses(pRenderContext);
     if (c.insertAutoPasses())
         c.resolveExecutionOrder();
+    c.pruneDemandPasses();
     c.validateGraph();
     c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
 
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
 
-    for (auto e : c.mExecutionList)
+    auto schedule = c.resolveSchedules();
+    for (size_t i = 0; i < c.mExecutionList.size(); i++)
     {
-        pExe->insertPass(e.name, e.pPass);
+        const auto& e = c.mExecutionList[i];
+        pExe->insertPass(e.name, e.pPass, schedule[i]);
     }
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
@@ -167,11 +172,75 @@ void RenderGraphCompiler::resolveExecutionOrder()
         if (participatingPasses.find(node) != participatingPasses.end())
         {
             const auto pData = mGraph.mNodeData[node];
-            mExecutionList.push_back({node, pData.pPass, pData.name, pData.pPass->reflect(compileData)});
+            RenderPassSchedule schedule = pData.schedule ? *pData.schedule : pData.pPass->getSchedule();
+            FALCOR_CHECK(schedule.isValid(), "Render pass '{}' has an invalid schedule ({}).", pData.name, schedule.toString());
+            mExecutionList.push_back({node, pData.pPass, pData.name, pData.pPass->reflect(compileData), schedule});
         }
     }
 }
 
+void RenderGraphCompiler::pruneDemandPasses()
+{
+    // Passes triggered by demand never run if none of their outputs is consumed. Consumers follow their producers in the
+    // execution list, so a single pass in reverse order also prunes demand passes feeding only pruned ones.
+    std::unordered_set<uint32_t> keptPasses;
+    for (size_t i = mExecutionList.size(); i-- > 0;)
+    {
+        const auto& p = mExecutionList[i];
+        bool keep = p.schedule.trigger != RenderPassSchedule::Trigger::Demand;
+        keep = keep || std::any_of(mGraph.mOutputs.begin(), mGraph.mOutputs.end(), [&](const auto& o) { return o.nodeId == p.index; });
+
+        const DirectedGraph::Node* pNode = mGraph.mpGraph->getNode(p.index);
+        for (uint32_t e = 0; e < pNode->getOutgoingEdgeCount() && !keep; e++)
+        {
+            uint32_t edgeIndex = pNode->getOutgoingEdge(e);
+            if (mGraph.mEdgeData.at(edgeIndex).srcField.empty())
+                keep = true; // Execution edges force the execution.
+            else
+                keep = keptPasses.count(mGraph.mpGraph->getEdge(edgeIndex)->getDestNode()) != 0;
+        }
+
+        if (keep)
+            keptPasses.insert(p.index);
+        else
+            logWarning("Render pass '{}' runs on demand but none of its outputs is consumed. Removing it from the execution.", p.name);
+    }
+
+    mExecutionList.erase(
+        std::remove_if(mExecutionList.begin(), mExecutionList.end(), [&](const PassData& p) { return keptPasses.count(p.index) == 0; }),
+        mExecutionList.end()
+    );
+}
+
+std::vector<ScheduledPass> RenderGraphCompiler::resolveSchedules() const
+{
+    std::unordered_map<uint32_t, uint32_t> nodeToIndex;
+    for (size_t i = 0; i < mExecutionList.size(); i++)
+        nodeToIndex[mExecutionList[i].index] = uint32_t(i);
+
+    std::vector<ScheduledPass> schedule(mExecutionList.size());
+    for (size_t i = 0; i < mExecutionList.size(); i++)
+    {
+        const auto& p = mExecutionList[i];
+        auto& s = schedule[i];
+        s.schedule = p.schedule;
+        s.hasGraphOutput = std::any_of(mGraph.mOutputs.begin(), mGraph.mOutputs.end(), [&](const auto& o) { return o.nodeId == p.index; });
+
+        // Connect the passes over their data and execution edges.
+        const DirectedGraph::Node* pNode = mGraph.mpGraph->getNode(p.index);
+        for (uint32_t e = 0; e < pNode->getOutgoingEdgeCount(); e++)
+        {
+            uint32_t edgeIndex = pNode->getOutgoingEdge(e);
+            auto it = nodeToIndex.find(mGraph.mpGraph->getEdge(edgeIndex)->getDestNode());
+            if (it == nodeToIndex.end())
+                continue;
+            s.consumers.push_back(it->second);
+            schedule[it->second].producers.push_back(uint32_t(i));
+        }
+    }
+    return schedule;
+}
+
 bool RenderGraphCompiler::insertAutoPasses()
 {
     bool addedPasses = false;
@@ -311,6 +380,9 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
                 uint32_t lifetime = graphOutput ? uint32_t(-1) : uint32_t(i);
                 if (graphOutput && field.getBindFlags() != ResourceBindFlags::None)
                     field.bindFlags(field.getBindFlags() | ResourceBindFlags::ShaderResource); // Adding ShaderResource for graph outputs
+                // Outputs of passes that don't run every frame must keep their data for the frames in between
+                if (!mExecutionList[i].schedule.isEveryFrame())
+                    field.flags(field.getFlags() | RenderPassReflection::Field::Flags::Persistent);
                 pResourceCache->registerField(fullFieldName, field, lifetime);
             }
         }
@@ -338,11 +410,11 @@ void RenderGraphCompiler::allocateResources(ref<Device> pDevice, ResourceCache*
 
             const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
             const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-            pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+            pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
         }
     }
 
-    pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps);
+    pResourceCache->allocateResources(pDevice, mDependencies.defaultResourceProps, mDependencies.aliasResources);
 }
 
 void RenderGraphCompiler::restoreCompilationChanges()
@@ -46,6 +46,7 @@ public:
     {
         ResourceCache::DefaultProperties defaultResourceProps;
         ResourceCache::ResourcesMap externalResources;
+        bool aliasResources = true; ///< Share memory between transient resources with disjoint lifetimes.
     };
     static std::unique_ptr<RenderGraphExe> compile(RenderGraph& graph, RenderContext* pRenderContext, const Dependencies& dependencies);
 
@@ -62,6 +63,7 @@ private:
         ref<RenderPass> pPass;
         std::string name;
         RenderPassReflection reflector;
+        RenderPassSchedule schedule;
     };
     std::vector<PassData> mExecutionList;
 
@@ -73,6 +75,8 @@ private:
     } mCompilationChanges;
 
     void resolveExecutionOrder();
+    void pruneDemandPasses();
+    std::vector<ScheduledPass> resolveSchedules() const;
     void compilePasses(RenderContext* pRenderContext);
     bool insertAutoPasses();
     void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
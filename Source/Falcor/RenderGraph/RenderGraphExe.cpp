@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "RenderGraphExe.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Timing/Profiler.h"
 
 namespace Falcor
@@ -34,8 +35,14 @@ void RenderGraphExe::execute(const Context& ctx)
 {
     FALCOR_PROFILE(ctx.pRenderContext, "RenderGraphExe::execute()");
 
-    for (const auto& pass : mExecutionList)
+    resolveActivePasses(mSchedule, ctx.frame, mActive);
+
+    for (size_t i = 0; i < mExecutionList.size(); i++)
     {
+        if (!mActive[i])
+            continue;
+
+        const auto& pass = mExecutionList[i];
         FALCOR_PROFILE(ctx.pRenderContext, pass.name);
 
         RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
@@ -45,8 +52,9 @@ void RenderGraphExe::execute(const Context& ctx)
 
 void RenderGraphExe::renderUI(RenderContext* pRenderContext, Gui::Widgets& widget)
 {
-    for (const auto& p : mExecutionList)
+    for (size_t i = 0; i < mExecutionList.size(); i++)
     {
+        const auto& p = mExecutionList[i];
         const auto& pPass = p.pPass;
 
         if (auto passGroup = widget.group(p.name))
@@ -57,9 +65,31 @@ void RenderGraphExe::renderUI(RenderContext* pRenderContext, Gui::Widgets& widge
             const auto& desc = pPass->getDesc();
             if (desc.size())
                 passGroup.tooltip(desc);
+            if (!mSchedule[i].schedule.isEveryFrame())
+                passGroup.text("Schedule: " + mSchedule[i].schedule.toString());
             pPass->renderUI(pRenderContext, passGroup);
         }
     }
+
+    if (auto resourceGroup = widget.group("Resources"))
+    {
+        const auto stats = mpResourceCache->getMemoryStats();
+        resourceGroup.text(fmt::format(
+            "{} fields in {} resources\nAllocated: {}\nWithout aliasing: {}",
+            stats.fieldCount,
+            stats.resourceCount,
+            formatByteSize(stats.allocatedBytes),
+            formatByteSize(stats.requiredBytes)
+        ));
+        for (const auto& a : mpResourceCache->getAllocations())
+        {
+            std::string lifetime =
+                a.lifetime.second == uint32_t(-1) ? "graph output" : fmt::format("{}-{}", a.lifetime.first, a.lifetime.second);
+            resourceGroup.text(
+                fmt::format("#{} {} [{}] {}{}", a.resourceIndex, a.name, lifetime, formatByteSize(a.size), a.transient ? "" : " (kept)")
+            );
+        }
+    }
 }
 
 void RenderGraphExe::renderOverlayUI(RenderContext* pRenderContext)
@@ -102,9 +132,20 @@ void RenderGraphExe::onHotReload(HotReloadFlags reloaded)
     }
 }
 
-void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass)
+bool RenderGraphExe::isPassActive(const std::string& name) const
+{
+    for (size_t i = 0; i < mExecutionList.size(); i++)
+    {
+        if (mExecutionList[i].name == name)
+            return i < mActive.size() && mActive[i];
+    }
+    return false;
+}
+
+void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass, const ScheduledPass& scheduledPass)
 {
     mExecutionList.push_back(Pass(name, pPass));
+    mSchedule.push_back(scheduledPass);
 }
 
 ref<Resource> RenderGraphExe::getResource(const std::string& name) const
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "RenderPass.h"
+#include "RenderPassSchedule.h"
 #include "ResourceCache.h"
 #include "Core/Macros.h"
 #include "Core/HotReloadFlags.h"
@@ -52,13 +53,19 @@ public:
         Dictionary& passesDictionary;
         uint2 defaultTexDims;
         ResourceFormat defaultTexFormat;
+        uint64_t frame; ///< Frame index used to schedule the passes.
     };
 
     /**
-     * Execute the graph
+     * Execute the passes scheduled for the frame
      */
     void execute(const Context& ctx);
 
+    /**
+     * Check if a pass ran in the last executed frame
+     */
+    bool isPassActive(const std::string& name) const;
+
     /**
      * Render the UI
      */
@@ -99,10 +106,15 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the cache holding the resources of the graph
+     */
+    const ResourceCache& getResourceCache() const { return *mpResourceCache; }
+
 private:
     friend class RenderGraphCompiler;
 
-    void insertPass(const std::string& name, const ref<RenderPass>& pPass);
+    void insertPass(const std::string& name, const ref<RenderPass>& pPass, const ScheduledPass& scheduledPass);
 
     struct Pass
     {
@@ -115,6 +127,8 @@ private:
     };
 
     std::vector<Pass> mExecutionList;
+    std::vector<ScheduledPass> mSchedule; ///< Schedule of the passes in execution order.
+    std::vector<bool> mActive;            ///< Passes running in the current frame.
     std::unique_ptr<ResourceCache> mpResourceCache;
 };
 } // namespace Falcor
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "ResourceCache.h"
+#include "RenderPassSchedule.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
 #include "Core/Plugin.h"
@@ -239,6 +240,12 @@ public:
      */
     virtual void onHotReload(HotReloadFlags reloaded) {}
 
+    /**
+     * Get the frames on which the pass is executed. Can be overridden per graph with RenderGraph::setPassSchedule().
+     * Call requestRecompile() when the schedule changes.
+     */
+    virtual RenderPassSchedule getSchedule() const { return {}; }
+
     /**
      * Get the current pass' name as defined in the graph
      */
@@ -0,0 +1,78 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RenderPassSchedule.h"
+#include "Core/Error.h"
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace Falcor
+{
+std::string RenderPassSchedule::toString() const
+{
+    if (trigger != Trigger::Frame)
+        return enumToString(trigger);
+    if (interval == 1)
+        return "Every frame";
+    return fmt::format("Every {} frames, phase {}", interval, phase);
+}
+
+void resolveActivePasses(const std::vector<ScheduledPass>& passes, uint64_t frame, std::vector<bool>& active)
+{
+    using Trigger = RenderPassSchedule::Trigger;
+
+    active.assign(passes.size(), false);
+    auto anyActive = [&](const std::vector<uint32_t>& indices)
+    { return std::any_of(indices.begin(), indices.end(), [&](uint32_t i) { return bool(active[i]); }); };
+
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        const auto& s = passes[i].schedule;
+        FALCOR_ASSERT(s.isValid());
+        switch (s.trigger)
+        {
+        case Trigger::Frame:
+            active[i] = frame % s.interval == s.phase;
+            break;
+        case Trigger::InputProduced:
+            active[i] = anyActive(passes[i].producers);
+            break;
+        case Trigger::Demand:
+            active[i] = true;
+            break;
+        default:
+            FALCOR_UNREACHABLE();
+        }
+    }
+
+    for (size_t i = passes.size(); i-- > 0;)
+    {
+        if (passes[i].schedule.trigger == Trigger::Demand)
+            active[i] = passes[i].hasGraphOutput || anyActive(passes[i].consumers);
+    }
+}
+} // namespace Falcor
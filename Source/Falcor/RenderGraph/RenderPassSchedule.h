@@ -0,0 +1,106 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Describes on which frames a render pass is executed by the render graph.
+ *
+ * Passes run every frame by default. A pass can run at a lower rate, for example to consume the output of an
+ * accumulation once every N frames, or be triggered by the passes connected to it. Skipped passes keep their outputs
+ * of the last frame they ran.
+ */
+struct FALCOR_API RenderPassSchedule
+{
+    enum class Trigger : uint32_t
+    {
+        Frame,         ///< Run on frames for which (frame % interval) == phase.
+        InputProduced, ///< Run on frames in which a pass it depends on runs, i.e. a pass with an edge to it.
+        Demand,        ///< Run on frames in which a pass depending on it runs, or every frame if the pass has a graph output.
+    };
+
+    FALCOR_ENUM_INFO(
+        Trigger,
+        {
+            {Trigger::Frame, "Frame"},
+            {Trigger::InputProduced, "InputProduced"},
+            {Trigger::Demand, "Demand"},
+        }
+    );
+
+    Trigger trigger = Trigger::Frame;
+    uint32_t interval = 1; ///< Number of frames between two runs, used with Trigger::Frame.
+    uint32_t phase = 0;    ///< Frame within the interval on which the pass runs, used with Trigger::Frame.
+
+    static RenderPassSchedule everyFrame() { return {}; }
+    static RenderPassSchedule every(uint32_t interval, uint32_t phase = 0) { return {Trigger::Frame, interval, phase}; }
+    static RenderPassSchedule onInputProduced() { return {Trigger::InputProduced}; }
+    static RenderPassSchedule onDemand() { return {Trigger::Demand}; }
+
+    bool isEveryFrame() const { return trigger == Trigger::Frame && interval == 1; }
+    bool isValid() const { return interval > 0 && phase < interval; }
+
+    std::string toString() const;
+
+    bool operator==(const RenderPassSchedule& other) const
+    {
+        return trigger == other.trigger && interval == other.interval && phase == other.phase;
+    }
+    bool operator!=(const RenderPassSchedule& other) const { return !(*this == other); }
+};
+
+FALCOR_ENUM_REGISTER(RenderPassSchedule::Trigger);
+
+/**
+ * A pass of a compiled render graph as seen by the scheduler.
+ * Producers and consumers are the execution list indices of the passes with edges to and from the pass.
+ */
+struct ScheduledPass
+{
+    RenderPassSchedule schedule;
+    std::vector<uint32_t> producers;
+    std::vector<uint32_t> consumers;
+    bool hasGraphOutput = false;
+};
+
+/**
+ * Resolve which passes run in a frame.
+ * Frame and input triggers are resolved in execution order, then demand triggers in reverse order. Demand passes are
+ * assumed to run while resolving input triggers, so a demand pass feeding an input-triggered pass runs with it.
+ * @param[in] passes Passes in execution order.
+ * @param[in] frame Frame index of the graph.
+ * @param[out] active Set to true for the passes running in the frame.
+ */
+FALCOR_API void resolveActivePasses(const std::vector<ScheduledPass>& passes, uint64_t frame, std::vector<bool>& active);
+} // namespace Falcor
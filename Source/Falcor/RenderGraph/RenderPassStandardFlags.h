@@ -58,5 +58,34 @@ static const char kRenderPassPRNGDimension[] = "_prngDimension";
  */
 static const char kRenderPassGBufferAdjustShadingNormals[] = "_gbufferAdjustShadingNormals";
 
+/**
+ * Per-pixel sample count texture (R8Uint) published by a pass later in the graph, used by the path tracer
+ * in the next frame when its sample count input is not connected. A null texture disables it.
+ */
+static const char kRenderPassSampleCount[] = "_sampleCount";
+
+/**
+ * Clock time of the current frame in seconds (double), set by the application before the graph is executed.
+ */
+static const char kRenderPassFrameTime[] = "_frameTime";
+
+/**
+ * Activity of the event stage in the current frame (double), reported to the adaptive clock after the graph
+ * is executed. Negative if no pass reported an activity.
+ */
+static const char kRenderPassEventActivity[] = "_eventActivity";
+
+/**
+ * Tile activity map (ref<TileActivity>) published by TileActivityPass, used by event passes to skip static tiles.
+ * A null reference disables it.
+ */
+static const char kRenderPassTileActivity[] = "_tileActivity";
+
+/**
+ * Frame index of the render graph (uint64_t), the one used to schedule the passes (see RenderPassSchedule).
+ * Set by the render graph before the passes are executed.
+ */
+static const char kRenderPassGraphFrame[] = "_graphFrame";
+
 FALCOR_ENUM_CLASS_OPERATORS(RenderPassRefreshFlags);
 } // namespace Falcor
@@ -30,6 +30,12 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <tuple>
 
 namespace Falcor
 {
@@ -37,6 +43,7 @@ void ResourceCache::reset()
 {
     mNameToIndex.clear();
     mResourceData.clear();
+    mAllocations.clear();
 }
 
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
@@ -85,6 +92,16 @@ void mergeTimePoint(std::pair<uint32_t, uint32_t>& range, uint32_t newTime)
     range.second = std::max(range.second, newTime);
 }
 
+bool isTransientField(const RenderPassReflection::Field& field, uint32_t timePoint)
+{
+    // Graph outputs, internal resources (which passes use as history) and persistent resources keep their data between frames
+    if (timePoint == uint32_t(-1))
+        return false;
+    if (is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal))
+        return false;
+    return !is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent);
+}
+
 void ResourceCache::registerField(
     const std::string& name,
     const RenderPassReflection::Field& field,
@@ -106,7 +123,7 @@ void ResourceCache::registerField(
         FALCOR_ASSERT(mNameToIndex.count(name) == 0);
         mNameToIndex[name] = (uint32_t)mResourceData.size();
         bool resolveBindFlags = (field.getBindFlags() == ResourceBindFlags::None);
-        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name});
+        mResourceData.push_back({field, {timePoint, timePoint}, nullptr, resolveBindFlags, name, isTransientField(field, timePoint)});
     }
     else // Add alias
     {
@@ -116,30 +133,50 @@ void ResourceCache::registerField(
         mergeTimePoint(mResourceData[index].lifetime, timePoint);
         mResourceData[index].pResource = nullptr;
         mResourceData[index].resolveBindFlags = mResourceData[index].resolveBindFlags || (field.getBindFlags() == ResourceBindFlags::None);
+        mResourceData[index].transient = mResourceData[index].transient && isTransientField(field, timePoint);
     }
 }
 
-inline ref<Resource> createResourceForPass(
+namespace
+{
+/// Fully resolved resource description. Transient fields with equal descriptions can share a resource.
+struct ResolvedDesc
+{
+    RenderPassReflection::Field::Type type;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t sampleCount;
+    uint32_t arraySize;
+    uint32_t mipLevels;
+    ResourceFormat format;
+    ResourceBindFlags bindFlags;
+
+    auto tie() const { return std::tie(type, width, height, depth, sampleCount, arraySize, mipLevels, format, bindFlags); }
+    bool operator<(const ResolvedDesc& other) const { return tie() < other.tie(); }
+};
+
+ResolvedDesc resolveDesc(
     ref<Device> pDevice,
     const ResourceCache::DefaultProperties& params,
     const RenderPassReflection::Field& field,
-    bool resolveBindFlags,
-    const std::string& resourceName
+    bool resolveBindFlags
 )
 {
-    uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-    uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-    uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-    uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
-    auto bindFlags = field.getBindFlags();
-    auto arraySize = field.getArraySize();
-    auto mipLevels = field.getMipCount();
-
-    ResourceFormat format = ResourceFormat::Unknown;
+    ResolvedDesc desc;
+    desc.type = field.getType();
+    desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+    desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+    desc.depth = field.getDepth() ? field.getDepth() : 1;
+    desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+    desc.bindFlags = field.getBindFlags();
+    desc.arraySize = field.getArraySize();
+    desc.mipLevels = field.getMipCount();
+    desc.format = ResourceFormat::Unknown;
 
     if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
     {
-        format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+        desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
         if (resolveBindFlags)
         {
             ResourceBindFlags mask = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
@@ -147,41 +184,48 @@ inline ref<Resource> createResourceForPass(
             bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
             if (isOutput || isInternal)
                 mask |= ResourceBindFlags::DepthStencil | ResourceBindFlags::RenderTarget;
-            auto supported = pDevice->getFormatBindFlags(format);
+            auto supported = pDevice->getFormatBindFlags(desc.format);
             mask &= supported;
-            bindFlags |= mask;
+            desc.bindFlags |= mask;
         }
     }
     else // RawBuffer
     {
         if (resolveBindFlags)
-            bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
+            desc.bindFlags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
     }
+    return desc;
+}
+
+ref<Resource> createResourceForPass(ref<Device> pDevice, const ResolvedDesc& desc, const std::string& resourceName)
+{
     ref<Resource> pResource;
 
-    switch (field.getType())
+    switch (desc.type)
     {
     case RenderPassReflection::Field::Type::RawBuffer:
-        pResource = pDevice->createBuffer(width, bindFlags, MemoryType::DeviceLocal);
+        pResource = pDevice->createBuffer(desc.width, desc.bindFlags, MemoryType::DeviceLocal);
         break;
     case RenderPassReflection::Field::Type::Texture1D:
-        pResource = pDevice->createTexture1D(width, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture1D(desc.width, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::Texture2D:
-        if (sampleCount > 1)
+        if (desc.sampleCount > 1)
         {
-            pResource = pDevice->createTexture2DMS(width, height, format, sampleCount, arraySize, bindFlags);
+            pResource = pDevice->createTexture2DMS(desc.width, desc.height, desc.format, desc.sampleCount, desc.arraySize, desc.bindFlags);
         }
         else
         {
-            pResource = pDevice->createTexture2D(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+            pResource =
+                pDevice->createTexture2D(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         }
         break;
     case RenderPassReflection::Field::Type::Texture3D:
-        pResource = pDevice->createTexture3D(width, height, depth, format, mipLevels, nullptr, bindFlags);
+        pResource = pDevice->createTexture3D(desc.width, desc.height, desc.depth, desc.format, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     case RenderPassReflection::Field::Type::TextureCube:
-        pResource = pDevice->createTextureCube(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+        pResource =
+            pDevice->createTextureCube(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
         break;
     default:
         FALCOR_UNREACHABLE();
@@ -191,14 +235,129 @@ inline ref<Resource> createResourceForPass(
     return pResource;
 }
 
-void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params)
+uint64_t getResourceSize(const ref<Resource>& pResource)
 {
-    for (auto& data : mResourceData)
+    if (!pResource)
+        return 0;
+    if (auto pTexture = pResource->asTexture())
+        return pTexture->getTextureSizeInBytes();
+    return pResource->getSize();
+}
+} // namespace
+
+void ResourceCache::allocateResources(ref<Device> pDevice, const DefaultProperties& params, bool aliasTransients)
+{
+    // Resources that need to be created, grouped by description. Only transient resources are aliased.
+    std::map<ResolvedDesc, std::vector<uint32_t>> transients;
+    for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
     {
+        auto& data = mResourceData[i];
         if ((data.pResource == nullptr) && (data.field.isValid()))
         {
-            data.pResource = createResourceForPass(pDevice, params, data.field, data.resolveBindFlags, data.name);
+            ResolvedDesc desc = resolveDesc(pDevice, params, data.field, data.resolveBindFlags);
+            if (aliasTransients && data.transient)
+                transients[desc].push_back(i);
+            else
+                data.pResource = createResourceForPass(pDevice, desc, data.name);
+        }
+    }
+
+    // Resources of the same description whose lifetimes don't overlap share memory
+    for (const auto& [desc, indices] : transients)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> lifetimes;
+        for (uint32_t i : indices)
+            lifetimes.push_back(mResourceData[i].lifetime);
+
+        uint32_t slotCount = 0;
+        std::vector<uint32_t> slots = assignIntervalSlots(lifetimes, slotCount);
+        std::vector<ref<Resource>> pSlotResources(slotCount);
+        for (size_t j = 0; j < indices.size(); j++)
+        {
+            auto& data = mResourceData[indices[j]];
+            auto& pResource = pSlotResources[slots[j]];
+            if (!pResource)
+                pResource = createResourceForPass(pDevice, desc, data.name);
+            else
+                pResource->setName(pResource->getName() + ", " + data.name);
+            data.pResource = pResource;
+        }
+    }
+
+    // Record the allocation decisions
+    mAllocations.clear();
+    std::map<const Resource*, uint32_t> resourceIndices;
+    for (const auto& data : mResourceData)
+    {
+        if (!data.pResource)
+            continue;
+        auto it = resourceIndices.emplace(data.pResource.get(), (uint32_t)resourceIndices.size()).first;
+        mAllocations.push_back({data.name, data.lifetime, it->second, data.transient, getResourceSize(data.pResource)});
+    }
+
+    MemoryStats stats = getMemoryStats();
+    if (stats.allocatedBytes < stats.requiredBytes)
+    {
+        logInfo(
+            "ResourceCache: {} fields share {} resources, allocated {} instead of {}.",
+            stats.fieldCount,
+            stats.resourceCount,
+            formatByteSize(stats.allocatedBytes),
+            formatByteSize(stats.requiredBytes)
+        );
+    }
+}
+
+ResourceCache::MemoryStats ResourceCache::getMemoryStats() const
+{
+    MemoryStats stats;
+    std::vector<bool> counted;
+    for (const auto& allocation : mAllocations)
+    {
+        stats.fieldCount++;
+        stats.requiredBytes += allocation.size;
+        if (allocation.resourceIndex >= counted.size())
+            counted.resize(allocation.resourceIndex + 1, false);
+        if (!counted[allocation.resourceIndex])
+        {
+            counted[allocation.resourceIndex] = true;
+            stats.resourceCount++;
+            stats.allocatedBytes += allocation.size;
+        }
+    }
+    return stats;
+}
+
+std::vector<uint32_t> assignIntervalSlots(const std::vector<std::pair<uint32_t, uint32_t>>& intervals, uint32_t& slotCount)
+{
+    // Greedy coloring of the interval graph in order of start time, which uses the fewest slots.
+    std::vector<uint32_t> order(intervals.size());
+    for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return intervals[a].first < intervals[b].first; });
+
+    // Slots ordered by the end of their last interval
+    using SlotEnd = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<SlotEnd, std::vector<SlotEnd>, std::greater<SlotEnd>> slotEnds;
+
+    std::vector<uint32_t> slots(intervals.size());
+    slotCount = 0;
+    for (uint32_t i : order)
+    {
+        FALCOR_ASSERT(intervals[i].first <= intervals[i].second);
+        uint32_t slot;
+        if (!slotEnds.empty() && slotEnds.top().first < intervals[i].first)
+        {
+            slot = slotEnds.top().second;
+            slotEnds.pop();
+        }
+        else
+        {
+            slot = slotCount++;
         }
+        slots[i] = slot;
+        slotEnds.push({intervals[i].second, slot});
     }
+    return slots;
 }
 } // namespace Falcor
@@ -30,6 +30,7 @@
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -51,6 +52,29 @@ public:
         ResourceFormat format = ResourceFormat::Unknown; ///< Format to use for texture creation
     };
 
+    /**
+     * Allocation decision for a registered field, for debugging.
+     */
+    struct Allocation
+    {
+        std::string name;                       ///< Full name of the field, including the pass name.
+        std::pair<uint32_t, uint32_t> lifetime; ///< First and last execution index using the field.
+        uint32_t resourceIndex;                 ///< Index of the allocated resource. Fields with the same index share memory.
+        bool transient;                         ///< Whether the field may share memory with fields of disjoint lifetime.
+        uint64_t size;                          ///< Size of the resource in bytes.
+    };
+
+    /**
+     * Memory used by the resources allocated by the cache.
+     */
+    struct MemoryStats
+    {
+        uint32_t fieldCount = 0;     ///< Number of allocated fields.
+        uint32_t resourceCount = 0;  ///< Number of resources backing them.
+        uint64_t requiredBytes = 0;  ///< Memory needed without aliasing.
+        uint64_t allocatedBytes = 0; ///< Memory actually allocated, which is also the peak since the resources live for the whole graph.
+    };
+
     /**
      * Add/Remove reference to a graph input resource not owned by the cache
      * @param[in] name The resource's name
@@ -86,8 +110,20 @@ public:
     /**
      * Allocate all resources that need to be created/updated.
      * This includes new resources, resources whose properties have been updated since last allocation call.
+     * @param[in] aliasTransients If true, transient fields with the same resolved description and disjoint lifetimes share a resource.
+     * Fields are transient unless they are graph outputs, internal to a pass or marked as persistent.
      */
-    void allocateResources(ref<Device> pDevice, const DefaultProperties& params);
+    void allocateResources(ref<Device> pDevice, const DefaultProperties& params, bool aliasTransients = false);
+
+    /**
+     * Get the allocation decisions of the last allocateResources() call, in registration order.
+     */
+    const std::vector<Allocation>& getAllocations() const { return mAllocations; }
+
+    /**
+     * Get the memory used by the resources of the last allocateResources() call.
+     */
+    MemoryStats getMemoryStats() const;
 
     /**
      * Clears all registered field/resource properties and allocated resources.
@@ -102,6 +138,7 @@ private:
         ref<Resource> pResource;                // The resource
         bool resolveBindFlags;                  // Whether or not we should resolve the field's bind-flags before creating the resource
         std::string name;                       // Full name of the resource, including the pass name
+        bool transient;                         // Whether or not the resource can share memory with other transient resources
     };
 
     // Resources and properties for fields within (and therefore owned by) a render graph
@@ -110,6 +147,17 @@ private:
 
     // References to output resources not to be allocated by the render graph
     ResourcesMap mExternalResources;
+
+    std::vector<Allocation> mAllocations;
 };
 
+/**
+ * Assign the intervals to the fewest slots such that the intervals of a slot don't overlap.
+ * Intervals are inclusive, so two intervals sharing an end point overlap.
+ * @param[in] intervals First and last time point of each interval.
+ * @param[out] slotCount Number of slots used.
+ * @return The slot of each interval.
+ */
+FALCOR_API std::vector<uint32_t> assignIntervalSlots(const std::vector<std::pair<uint32_t, uint32_t>>& intervals, uint32_t& slotCount);
+
 } // namespace Falcor
@@ -0,0 +1,441 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockArchive.h"
+#include "BlockCompression.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFileMagic = 0x4b4c4246;   // 'FBLK'
+const uint32_t kBatchMagic = 0x54424246;  // 'FBBT'
+const uint32_t kFooterMagic = 0x58494246; // 'FBIX'
+const uint32_t kFileVersion = 1;
+const uint64_t kAlignment = 64;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameWidth;
+    uint32_t frameHeight;
+    uint32_t blockSizeX;
+    uint32_t blockSizeY;
+    uint32_t blockSizeZ;
+    uint32_t bytesPerPixel;
+    uint32_t blockCountX;
+    uint32_t blockCountY;
+    uint32_t format;
+    float logThreshold;
+    uint32_t reserved[4];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct BatchHeader
+{
+    uint32_t magic;
+    uint32_t bz;
+    uint32_t blockCount; ///< Number of index entries, equal to blockCountX * blockCountY.
+    uint32_t frameCount; ///< Number of valid frames in the blocks.
+    uint64_t indexOffset; ///< Offset of the index, 0 while the batch is being written.
+    uint64_t reserved1;
+};
+static_assert(sizeof(BatchHeader) == 32);
+
+struct IndexEntry
+{
+    uint32_t bx;
+    uint32_t by;
+    uint32_t bz;
+    uint32_t codec;
+    uint64_t offset; ///< For constant blocks, offset and size hold the pixel value.
+    uint64_t size;
+    float rangeMin;
+    float rangeMax;
+    uint32_t reserved[2];
+};
+static_assert(sizeof(IndexEntry) == 48);
+static_assert(offsetof(IndexEntry, size) == offsetof(IndexEntry, offset) + 8 && kMaxInlinePixelSize == 16);
+
+struct Footer
+{
+    uint64_t batchListOffset;
+    uint32_t batchCount;
+    uint32_t magic;
+};
+static_assert(sizeof(Footer) == 16);
+
+uint64_t alignUp(uint64_t offset)
+{
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+} // namespace
+
+BlockArchiveWriter::BlockArchiveWriter(const std::filesystem::path& path, const BlockArchiveDesc& desc)
+    : mPath(path), mDesc(desc), mBlockCount(desc.getBlockCount())
+{
+    FALCOR_CHECK(all(desc.frameDim > 0u) && all(desc.blockSize > 0u) && desc.bytesPerPixel > 0, "Invalid block archive description.");
+    FALCOR_CHECK(
+        desc.bytesPerPixel == getBlockFormatBytesPerPixel(desc.format),
+        "Block format {} has {} bytes per pixel, got {}.",
+        desc.format,
+        getBlockFormatBytesPerPixel(desc.format),
+        desc.bytesPerPixel
+    );
+
+    mStream.open(path, std::ios::binary | std::ios::trunc);
+    if (!mStream)
+        FALCOR_THROW("Failed to create block archive '{}'.", path);
+
+    FileHeader header = {};
+    header.magic = kFileMagic;
+    header.version = kFileVersion;
+    header.frameWidth = desc.frameDim.x;
+    header.frameHeight = desc.frameDim.y;
+    header.blockSizeX = desc.blockSize.x;
+    header.blockSizeY = desc.blockSize.y;
+    header.blockSizeZ = desc.blockSize.z;
+    header.bytesPerPixel = desc.bytesPerPixel;
+    header.blockCountX = mBlockCount.x;
+    header.blockCountY = mBlockCount.y;
+    header.format = (uint32_t)desc.format;
+    header.logThreshold = desc.logThreshold;
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mOffset = sizeof(header);
+}
+
+BlockArchiveWriter::~BlockArchiveWriter()
+{
+    close();
+}
+
+void BlockArchiveWriter::beginBatch(uint32_t bz, uint32_t frameCount)
+{
+    FALCOR_CHECK(mStream.is_open(), "Block archive '{}' is closed.", mPath);
+    FALCOR_CHECK(!mInBatch, "Block archive batch {} was not ended.", mBatchZ);
+
+    writePadding();
+    mInBatch = true;
+    mBatchZ = bz;
+    mBatchOffset = mOffset;
+    mBatchBlocks.assign(size_t(mBlockCount.x) * mBlockCount.y, BlockInfo{});
+    mBatchValues.assign(mBatchBlocks.size(), {});
+    for (uint32_t by = 0; by < mBlockCount.y; ++by)
+        for (uint32_t bx = 0; bx < mBlockCount.x; ++bx)
+            mBatchBlocks[size_t(by) * mBlockCount.x + bx] = {bx, by, bz, BlockCodec::Raw, 0, 0};
+
+    BatchHeader header = {};
+    header.magic = kBatchMagic;
+    header.bz = bz;
+    header.blockCount = (uint32_t)mBatchBlocks.size();
+    header.frameCount = frameCount > 0 ? std::min(frameCount, mDesc.blockSize.z) : mDesc.blockSize.z;
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mOffset += sizeof(header);
+}
+
+void BlockArchiveWriter::writeBlock(uint32_t bx, uint32_t by, BlockCodec codec, const void* pData, size_t size, float2 range)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    FALCOR_CHECK(mInBatch, "Block archive '{}' has no active batch.", mPath);
+    FALCOR_CHECK(bx < mBlockCount.x && by < mBlockCount.y, "Block ({}, {}) is out of range.", bx, by);
+
+    const size_t index = size_t(by) * mBlockCount.x + bx;
+    BlockInfo& info = mBatchBlocks[index];
+    if (info.offset != 0 || info.codec != BlockCodec::Raw)
+        logWarning("Block ({}, {}, {}) was written twice to block archive '{}'.", bx, by, mBatchZ, mPath);
+
+    // Elided blocks have no payload.
+    if (codec == BlockCodec::Zero || codec == BlockCodec::Constant)
+    {
+        FALCOR_CHECK(codec == BlockCodec::Zero || size <= kMaxInlinePixelSize, "Constant pixel of {} bytes is too large.", size);
+        info.codec = codec;
+        info.offset = 0;
+        info.size = codec == BlockCodec::Constant ? size : 0;
+        info.range = range;
+        mBatchValues[index] = {};
+        if (codec == BlockCodec::Constant)
+            std::memcpy(mBatchValues[index].data(), pData, size);
+        return;
+    }
+
+    writePadding();
+    if (size > 0)
+        mStream.write(reinterpret_cast<const char*>(pData), size);
+    if (!mStream)
+        FALCOR_THROW("Failed to write to block archive '{}'.", mPath);
+
+    info.codec = codec;
+    info.offset = mOffset;
+    info.size = size;
+    info.range = range;
+    mOffset += size;
+}
+
+void BlockArchiveWriter::endBatch()
+{
+    FALCOR_CHECK(mInBatch, "Block archive '{}' has no active batch.", mPath);
+
+    writePadding();
+    const uint64_t indexOffset = mOffset;
+    for (size_t i = 0; i < mBatchBlocks.size(); ++i)
+    {
+        const BlockInfo& info = mBatchBlocks[i];
+        IndexEntry entry = {info.bx, info.by, info.bz, (uint32_t)info.codec, info.offset, info.size, info.range.x, info.range.y, {}};
+        if (info.codec == BlockCodec::Constant)
+            std::memcpy(&entry.offset, mBatchValues[i].data(), kMaxInlinePixelSize);
+        mStream.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    mOffset += mBatchBlocks.size() * sizeof(IndexEntry);
+
+    // Publish the batch by patching the index offset into its header.
+    mStream.seekp(mBatchOffset + offsetof(BatchHeader, indexOffset));
+    mStream.write(reinterpret_cast<const char*>(&indexOffset), sizeof(indexOffset));
+    mStream.seekp(mOffset);
+    mStream.flush();
+    if (!mStream)
+        FALCOR_THROW("Failed to write index of block archive '{}'.", mPath);
+
+    mBatchOffsets.push_back(mBatchOffset);
+    mInBatch = false;
+}
+
+void BlockArchiveWriter::close()
+{
+    if (!mStream.is_open())
+        return;
+    if (mInBatch)
+        endBatch();
+
+    const uint64_t listOffset = mOffset;
+    mStream.write(reinterpret_cast<const char*>(mBatchOffsets.data()), mBatchOffsets.size() * sizeof(uint64_t));
+    Footer footer = {listOffset, (uint32_t)mBatchOffsets.size(), kFooterMagic};
+    mStream.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    mOffset += mBatchOffsets.size() * sizeof(uint64_t) + sizeof(footer);
+    mStream.close();
+    if (!mStream)
+        logError("Failed to write footer of block archive '{}'.", mPath);
+}
+
+void BlockArchiveWriter::writePadding()
+{
+    static const char kZeros[kAlignment] = {};
+    const uint64_t padding = alignUp(mOffset) - mOffset;
+    mStream.write(kZeros, padding);
+    mOffset += padding;
+}
+
+bool BlockArchiveReader::open(const std::filesystem::path& path)
+{
+    close();
+
+    if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+        return false;
+
+    FileHeader header;
+    if (mFile.getSize() < sizeof(header))
+    {
+        logWarning("Block archive '{}' is too small.", path);
+        close();
+        return false;
+    }
+    std::memcpy(&header, mFile.getData(), sizeof(header));
+    if (header.magic != kFileMagic || header.version != kFileVersion)
+    {
+        logWarning("'{}' is not a block archive (version {}).", path, kFileVersion);
+        close();
+        return false;
+    }
+
+    mDesc.frameDim = {header.frameWidth, header.frameHeight};
+    mDesc.blockSize = {header.blockSizeX, header.blockSizeY, header.blockSizeZ};
+    mDesc.format = (BlockFormat)header.format;
+    mDesc.bytesPerPixel = header.bytesPerPixel;
+    mDesc.logThreshold = header.logThreshold;
+    mBlockCount = {header.blockCountX, header.blockCountY};
+    if (any(mDesc.blockSize == 0u) || any(mBlockCount != mDesc.getBlockCount()) ||
+        mDesc.bytesPerPixel != getBlockFormatBytesPerPixel(mDesc.format))
+    {
+        logWarning("Block archive '{}' has an invalid header.", path);
+        close();
+        return false;
+    }
+
+    std::vector<uint64_t> batchOffsets;
+    if (!readFooter(batchOffsets))
+    {
+        logWarning("Block archive '{}' has no valid footer, recovering batches from the batch headers.", path);
+        scanBatches(batchOffsets);
+        mRecovered = true;
+    }
+
+    for (uint64_t offset : batchOffsets)
+    {
+        if (!readBatch(offset))
+        {
+            logWarning("Block archive '{}' has a corrupt batch at offset {}.", path, offset);
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlockArchiveReader::close()
+{
+    mFile.close();
+    mDesc = {};
+    mBlockCount = {0, 0};
+    mBlocks.clear();
+    mBatches.clear();
+    mBatchFrameCounts.clear();
+    mRecovered = false;
+}
+
+const BlockInfo* BlockArchiveReader::findBlock(uint32_t bx, uint32_t by, uint32_t bz) const
+{
+    if (bx >= mBlockCount.x || by >= mBlockCount.y || bz >= mBatches.size() || mBatches[bz] < 0)
+        return nullptr;
+    const BlockInfo& info = mBlocks[mBatches[bz] + size_t(by) * mBlockCount.x + bx];
+    return info.offset != 0 || info.codec == BlockCodec::Zero ? &info : nullptr;
+}
+
+const void* BlockArchiveReader::getBlockData(const BlockInfo& info) const
+{
+    FALCOR_CHECK(info.offset + info.size <= mFile.getSize(), "Block ({}, {}, {}) is out of range.", info.bx, info.by, info.bz);
+    return reinterpret_cast<const uint8_t*>(mFile.getData()) + info.offset;
+}
+
+uint64_t BlockArchiveReader::getFrameCount() const
+{
+    if (mBatches.empty())
+        return 0;
+    return uint64_t(mBatches.size() - 1) * mDesc.blockSize.z + mBatchFrameCounts.back();
+}
+
+void BlockArchiveReader::readBlock(const BlockInfo& info, void* pDst) const
+{
+    decodeBlock(info.codec, getBlockData(info), info.size, pDst, mDesc.getBlockByteSize(), mDesc.bytesPerPixel);
+}
+
+bool BlockArchiveReader::readFooter(std::vector<uint64_t>& batchOffsets) const
+{
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(mFile.getData());
+    const uint64_t fileSize = mFile.getSize();
+    if (fileSize < sizeof(FileHeader) + sizeof(Footer))
+        return false;
+
+    Footer footer;
+    std::memcpy(&footer, pData + fileSize - sizeof(footer), sizeof(footer));
+    if (footer.magic != kFooterMagic || footer.batchListOffset < sizeof(FileHeader) ||
+        footer.batchListOffset + uint64_t(footer.batchCount) * sizeof(uint64_t) + sizeof(Footer) != fileSize)
+        return false;
+
+    batchOffsets.resize(footer.batchCount);
+    std::memcpy(batchOffsets.data(), pData + footer.batchListOffset, batchOffsets.size() * sizeof(uint64_t));
+    return true;
+}
+
+void BlockArchiveReader::scanBatches(std::vector<uint64_t>& batchOffsets) const
+{
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(mFile.getData());
+    const uint64_t fileSize = mFile.getSize();
+    const uint64_t indexSize = uint64_t(mBlockCount.x) * mBlockCount.y * sizeof(IndexEntry);
+
+    batchOffsets.clear();
+    uint64_t offset = alignUp(sizeof(FileHeader));
+    while (offset + sizeof(BatchHeader) <= fileSize)
+    {
+        BatchHeader header;
+        std::memcpy(&header, pData + offset, sizeof(header));
+        // Stop at the first unfinished batch, it was being written when the run was interrupted.
+        if (header.magic != kBatchMagic || header.indexOffset <= offset || header.indexOffset + indexSize > fileSize)
+            break;
+        batchOffsets.push_back(offset);
+        offset = alignUp(header.indexOffset + indexSize);
+    }
+}
+
+bool BlockArchiveReader::readBatch(uint64_t offset)
+{
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(mFile.getData());
+    const uint64_t fileSize = mFile.getSize();
+    const size_t blockCount = size_t(mBlockCount.x) * mBlockCount.y;
+
+    BatchHeader header;
+    if (offset + sizeof(header) > fileSize)
+        return false;
+    std::memcpy(&header, pData + offset, sizeof(header));
+    if (header.magic != kBatchMagic || header.blockCount != blockCount || header.indexOffset <= offset ||
+        header.indexOffset + blockCount * sizeof(IndexEntry) > fileSize)
+        return false;
+
+    const size_t first = mBlocks.size();
+    mBlocks.resize(first + blockCount);
+    for (size_t i = 0; i < blockCount; ++i)
+    {
+        IndexEntry entry;
+        const uint64_t entryOffset = header.indexOffset + i * sizeof(IndexEntry);
+        std::memcpy(&entry, pData + entryOffset, sizeof(entry));
+        const BlockCodec codec = (BlockCodec)entry.codec;
+        if (codec == BlockCodec::Zero)
+        {
+            entry.offset = entry.size = 0;
+        }
+        else if (codec == BlockCodec::Constant)
+        {
+            // Point into the mapped index entry holding the pixel value.
+            if (mDesc.bytesPerPixel > kMaxInlinePixelSize)
+                return false;
+            entry.offset = entryOffset + offsetof(IndexEntry, offset);
+            entry.size = mDesc.bytesPerPixel;
+        }
+        else if (entry.codec > (uint32_t)BlockCodec::Constant ||
+                 (entry.offset != 0 && (entry.offset < offset || entry.offset + entry.size > header.indexOffset)))
+        {
+            return false;
+        }
+        mBlocks[first + i] = {entry.bx, entry.by, entry.bz, codec, entry.offset, entry.size, float2(entry.rangeMin, entry.rangeMax)};
+    }
+
+    if (header.bz >= mBatches.size())
+    {
+        mBatches.resize(header.bz + 1, -1);
+        mBatchFrameCounts.resize(header.bz + 1, 0);
+    }
+    if (mBatches[header.bz] >= 0)
+        logWarning("Block archive contains batch {} twice, using the last one.", header.bz);
+    mBatches[header.bz] = (int64_t)first;
+    mBatchFrameCounts[header.bz] = header.frameCount;
+    return true;
+}
+} // namespace Falcor
@@ -0,0 +1,296 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Encoding of a block payload.
+ */
+enum class BlockCodec : uint32_t
+{
+    Raw = 0,      ///< Uncompressed pixels, ordered by frame, row and column.
+    LZ4 = 1,      ///< Raw pixels compressed with the LZ4 block format.
+    Deflate = 2,  ///< Raw pixels compressed with zlib.
+    Zero = 3,     ///< All bytes are zero, no payload is stored.
+    Constant = 4, ///< All pixels are identical. The pixel is stored inline in the index entry, no payload is stored.
+};
+FALCOR_ENUM_INFO(
+    BlockCodec,
+    {
+        {BlockCodec::Raw, "Raw"},
+        {BlockCodec::LZ4, "LZ4"},
+        {BlockCodec::Deflate, "Deflate"},
+        {BlockCodec::Zero, "Zero"},
+        {BlockCodec::Constant, "Constant"},
+    }
+);
+FALCOR_ENUM_REGISTER(BlockCodec);
+
+/**
+ * Pixel format of the blocks in an archive.
+ * Quantized formats store codes q in [0, 2^n - 1] per block, which map to range.x + q / (2^n - 1) * (range.y - range.x)
+ * using the value range of the block (see BlockInfo::range).
+ */
+enum class BlockFormat : uint32_t
+{
+    RGBA32Float = 0, ///< Linear RGBA, 16 bytes per pixel.
+    RGBA16Float = 1, ///< Linear RGB as half floats with alpha, 8 bytes per pixel.
+    Luma32Float = 2, ///< Linear luma, 4 bytes per pixel.
+    Luma16Float = 3, ///< Linear luma as half float, 2 bytes per pixel.
+    LogLuma16 = 4,   ///< Lin-log luma quantized to 16 bits with a per-block range, 2 bytes per pixel.
+    LogLuma8 = 5,    ///< Lin-log luma quantized to 8 bits with a per-block range, 1 byte per pixel.
+};
+FALCOR_ENUM_INFO(
+    BlockFormat,
+    {
+        {BlockFormat::RGBA32Float, "RGBA32Float"},
+        {BlockFormat::RGBA16Float, "RGBA16Float"},
+        {BlockFormat::Luma32Float, "Luma32Float"},
+        {BlockFormat::Luma16Float, "Luma16Float"},
+        {BlockFormat::LogLuma16, "LogLuma16"},
+        {BlockFormat::LogLuma8, "LogLuma8"},
+    }
+);
+FALCOR_ENUM_REGISTER(BlockFormat);
+
+/// Get the size of a pixel in bytes.
+inline uint32_t getBlockFormatBytesPerPixel(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::RGBA32Float:
+        return 16;
+    case BlockFormat::RGBA16Float:
+        return 8;
+    case BlockFormat::Luma32Float:
+        return 4;
+    case BlockFormat::Luma16Float:
+    case BlockFormat::LogLuma16:
+        return 2;
+    case BlockFormat::LogLuma8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/// True if the format stores quantized values with a per-block range.
+inline bool isQuantizedBlockFormat(BlockFormat format)
+{
+    return format == BlockFormat::LogLuma16 || format == BlockFormat::LogLuma8;
+}
+
+/**
+ * Description stored in the header of a block archive.
+ */
+struct BlockArchiveDesc
+{
+    uint2 frameDim = {0, 0};                    ///< Frame dimension in pixels.
+    uint3 blockSize = {64, 64, 64};             ///< Block dimension in pixels (x, y) and frames (z).
+    BlockFormat format = BlockFormat::RGBA32Float;
+    uint32_t bytesPerPixel = 16;                ///< Size of an uncompressed pixel in bytes.
+    float logThreshold = 20.f;                  ///< Threshold of the lin-log mapping of the LogLuma formats.
+
+    /// Number of blocks in x and y covering a frame.
+    uint2 getBlockCount() const { return (frameDim + blockSize.xy() - 1u) / blockSize.xy(); }
+    /// Size of an uncompressed block in bytes.
+    size_t getBlockByteSize() const { return size_t(blockSize.x) * blockSize.y * blockSize.z * bytesPerPixel; }
+};
+
+/**
+ * Location of a block in an archive.
+ */
+struct BlockInfo
+{
+    uint32_t bx = 0;
+    uint32_t by = 0;
+    uint32_t bz = 0;
+    BlockCodec codec = BlockCodec::Raw;
+    uint64_t offset = 0; ///< Byte offset of the payload from the start of the file, 0 if the block is missing or Zero.
+    uint64_t size = 0;   ///< Payload size in bytes.
+    float2 range = {0.f, 0.f}; ///< Value range of quantized formats.
+};
+
+/// Maximum pixel size in bytes that can be stored inline with BlockCodec::Constant.
+static constexpr uint32_t kMaxInlinePixelSize = 16;
+
+/**
+ * Writer for block archives, which pack all blocks of a channel into a single append-only file.
+ *
+ * File layout (all values little-endian, records aligned to 64 bytes):
+ *  - 64 byte file header with the BlockArchiveDesc.
+ *  - One record per batch of frames (block z coordinate): a 32 byte batch header, the block payloads and
+ *    a fixed-size index with one 48 byte entry (bx, by, bz, codec, offset, size, range) per block, ordered by (by, bx).
+ *    The block (bx, by) of a batch is found at entry by * blockCount.x + bx. Zero blocks have no payload, constant
+ *    blocks store their pixel in place of the offset and size fields of the entry.
+ *  - A footer listing the offsets of all batch headers, written by close().
+ *
+ * If a run is interrupted before close(), readers recover all completed batches by scanning the batch headers.
+ * writeBlock() is thread-safe, the other functions must be called from a single thread.
+ */
+class FALCOR_API BlockArchiveWriter
+{
+public:
+    /**
+     * Create a new archive. Throws if the file cannot be created.
+     * @param[in] path File path. An existing file is overwritten.
+     * @param[in] desc Archive description stored in the header.
+     */
+    BlockArchiveWriter(const std::filesystem::path& path, const BlockArchiveDesc& desc);
+
+    /// Destructor. Closes the file.
+    ~BlockArchiveWriter();
+
+    /**
+     * Start a batch of blocks.
+     * @param[in] bz Block z coordinate.
+     * @param[in] frameCount Number of valid frames in the blocks, 0 for blockSize.z. The last batch of a run may be partial.
+     */
+    void beginBatch(uint32_t bz, uint32_t frameCount = 0);
+
+    /**
+     * Append a block to the current batch. Thread-safe.
+     * @param[in] bx Block x coordinate.
+     * @param[in] by Block y coordinate.
+     * @param[in] codec Encoding of the payload.
+     * @param[in] pData Payload. For BlockCodec::Constant this is the pixel value, for BlockCodec::Zero it is ignored.
+     * @param[in] size Payload size in bytes. At most kMaxInlinePixelSize for BlockCodec::Constant.
+     * @param[in] range Value range of quantized formats.
+     */
+    void writeBlock(uint32_t bx, uint32_t by, BlockCodec codec, const void* pData, size_t size, float2 range = float2(0.f));
+
+    /// Write the index of the current batch.
+    void endBatch();
+
+    /// Write the footer and close the file. Ends the current batch if needed. Does nothing if already closed.
+    void close();
+
+    const std::filesystem::path& getPath() const { return mPath; }
+    const BlockArchiveDesc& getDesc() const { return mDesc; }
+    uint64_t getBytesWritten() const { return mOffset; }
+
+private:
+    BlockArchiveWriter(const BlockArchiveWriter&) = delete;
+    BlockArchiveWriter& operator=(const BlockArchiveWriter&) = delete;
+
+    void writePadding();
+
+    std::filesystem::path mPath;
+    BlockArchiveDesc mDesc;
+    uint2 mBlockCount;
+    std::ofstream mStream;
+    std::mutex mMutex;
+    uint64_t mOffset = 0;
+
+    bool mInBatch = false;
+    uint32_t mBatchZ = 0;
+    uint64_t mBatchOffset = 0;
+    std::vector<BlockInfo> mBatchBlocks;
+    std::vector<std::array<uint8_t, kMaxInlinePixelSize>> mBatchValues; ///< Pixel values of constant blocks.
+    std::vector<uint64_t> mBatchOffsets;
+};
+
+/**
+ * Reader for block archives written by BlockArchiveWriter.
+ * The file is memory mapped, block payloads are accessed without copies.
+ */
+class FALCOR_API BlockArchiveReader
+{
+public:
+    BlockArchiveReader() = default;
+
+    /**
+     * Constructor opening a file. Use isOpen() to check if successful.
+     */
+    BlockArchiveReader(const std::filesystem::path& path) { open(path); }
+
+    /**
+     * Open a block archive.
+     * @return True if the file was successfully opened.
+     */
+    bool open(const std::filesystem::path& path);
+
+    void close();
+
+    bool isOpen() const { return mFile.isOpen(); }
+
+    /// True if the batches were recovered by scanning because the file was not closed properly.
+    bool wasRecovered() const { return mRecovered; }
+
+    const BlockArchiveDesc& getDesc() const { return mDesc; }
+
+    /// Number of batches, i.e. one more than the largest block z coordinate.
+    uint32_t getBatchCount() const { return uint32_t(mBatches.size()); }
+
+    /// Number of valid frames in a batch, 0 if the batch is missing.
+    uint32_t getBatchFrameCount(uint32_t bz) const { return bz < mBatchFrameCounts.size() ? mBatchFrameCounts[bz] : 0; }
+
+    /// Total number of frames, counting missing batches as full.
+    uint64_t getFrameCount() const;
+
+    /// Find a block. Returns nullptr if the block is not in the archive.
+    const BlockInfo* findBlock(uint32_t bx, uint32_t by, uint32_t bz) const;
+
+    /// Get the mapped payload of a block. For constant blocks this is the pixel value.
+    const void* getBlockData(const BlockInfo& info) const;
+
+    /**
+     * Decode a block into uncompressed pixels.
+     * @param[in] info Block to decode.
+     * @param[out] pDst Destination of getDesc().getBlockByteSize() bytes.
+     */
+    void readBlock(const BlockInfo& info, void* pDst) const;
+
+private:
+    BlockArchiveReader(const BlockArchiveReader&) = delete;
+    BlockArchiveReader& operator=(const BlockArchiveReader&) = delete;
+
+    bool readFooter(std::vector<uint64_t>& batchOffsets) const;
+    void scanBatches(std::vector<uint64_t>& batchOffsets) const;
+    bool readBatch(uint64_t offset);
+
+    MemoryMappedFile mFile;
+    BlockArchiveDesc mDesc;
+    uint2 mBlockCount = {0, 0};
+    std::vector<BlockInfo> mBlocks;
+    std::vector<int64_t> mBatches; ///< First entry in mBlocks per block z coordinate, -1 if the batch is missing.
+    std::vector<uint32_t> mBatchFrameCounts;
+    bool mRecovered = false;
+};
+} // namespace Falcor
@@ -0,0 +1,159 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockCompression.h"
+#include "Core/Error.h"
+#include <lz4.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+/// A block is constant if it equals itself shifted by one pixel.
+bool isConstant(const uint8_t* pData, size_t size, uint32_t bytesPerPixel)
+{
+    return size <= bytesPerPixel || std::memcmp(pData, pData + bytesPerPixel, size - bytesPerPixel) == 0;
+}
+
+bool isZero(const uint8_t* pData, uint32_t bytesPerPixel)
+{
+    return std::all_of(pData, pData + bytesPerPixel, [](uint8_t b) { return b == 0; });
+}
+
+size_t compressLZ4(const uint8_t* pData, size_t size, std::vector<uint8_t>& buffer)
+{
+    FALCOR_CHECK(size <= size_t(LZ4_MAX_INPUT_SIZE), "Block of {} bytes is too large for LZ4.", size);
+    buffer.resize(LZ4_compressBound(int(size)));
+    int compressedSize =
+        LZ4_compress_default(reinterpret_cast<const char*>(pData), reinterpret_cast<char*>(buffer.data()), int(size), int(buffer.size()));
+    return size_t(std::max(compressedSize, 0));
+}
+
+size_t compressDeflate(const uint8_t* pData, size_t size, std::vector<uint8_t>& buffer)
+{
+    uLongf compressedSize = compressBound(uLong(size));
+    buffer.resize(compressedSize);
+    // Level 1 is several times faster than the default with a similar ratio on image data.
+    if (compress2(buffer.data(), &compressedSize, pData, uLong(size), 1) != Z_OK)
+        return 0;
+    return compressedSize;
+}
+} // namespace
+
+EncodedBlock encodeBlock(
+    const void* pData,
+    size_t size,
+    uint32_t bytesPerPixel,
+    BlockCompression compression,
+    bool elideConstant,
+    std::vector<uint8_t>& buffer
+)
+{
+    FALCOR_CHECK(bytesPerPixel > 0 && size % bytesPerPixel == 0, "Block size {} is not a multiple of the pixel size {}.", size, bytesPerPixel);
+    const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+
+    if (elideConstant && size > 0 && bytesPerPixel <= kMaxInlinePixelSize && isConstant(pBytes, size, bytesPerPixel))
+    {
+        if (isZero(pBytes, bytesPerPixel))
+            return {BlockCodec::Zero, nullptr, 0};
+        return {BlockCodec::Constant, pData, bytesPerPixel};
+    }
+
+    size_t compressedSize = 0;
+    BlockCodec codec = BlockCodec::Raw;
+    switch (compression)
+    {
+    case BlockCompression::None:
+        break;
+    case BlockCompression::LZ4:
+        compressedSize = compressLZ4(pBytes, size, buffer);
+        codec = BlockCodec::LZ4;
+        break;
+    case BlockCompression::Deflate:
+        compressedSize = compressDeflate(pBytes, size, buffer);
+        codec = BlockCodec::Deflate;
+        break;
+    default:
+        FALCOR_UNREACHABLE();
+    }
+
+    // Store incompressible blocks as is.
+    if (compressedSize == 0 || compressedSize >= size)
+        return {BlockCodec::Raw, pData, size};
+    return {codec, buffer.data(), compressedSize};
+}
+
+void decodeBlock(BlockCodec codec, const void* pData, size_t size, void* pDst, size_t blockSize, uint32_t bytesPerPixel)
+{
+    uint8_t* pBytes = reinterpret_cast<uint8_t*>(pDst);
+    switch (codec)
+    {
+    case BlockCodec::Raw:
+        FALCOR_CHECK(size == blockSize, "Raw block has {} bytes, expected {}.", size, blockSize);
+        std::memcpy(pDst, pData, size);
+        break;
+    case BlockCodec::LZ4:
+    {
+        FALCOR_CHECK(
+            size <= size_t(std::numeric_limits<int>::max()) && blockSize <= size_t(std::numeric_limits<int>::max()), "LZ4 block is too large."
+        );
+        int decompressedSize =
+            LZ4_decompress_safe(reinterpret_cast<const char*>(pData), reinterpret_cast<char*>(pDst), int(size), int(blockSize));
+        FALCOR_CHECK(decompressedSize == int(blockSize), "Corrupt LZ4 block.");
+        break;
+    }
+    case BlockCodec::Deflate:
+    {
+        uLongf decompressedSize = uLongf(blockSize);
+        int result = uncompress(pBytes, &decompressedSize, reinterpret_cast<const Bytef*>(pData), uLong(size));
+        FALCOR_CHECK(result == Z_OK && decompressedSize == blockSize, "Corrupt deflate block (error: {}).", result);
+        break;
+    }
+    case BlockCodec::Zero:
+        std::memset(pDst, 0, blockSize);
+        break;
+    case BlockCodec::Constant:
+        FALCOR_CHECK(size == bytesPerPixel && blockSize % bytesPerPixel == 0, "Invalid constant block.");
+        // Fill by doubling the initialized prefix.
+        if (blockSize > 0)
+            std::memcpy(pBytes, pData, size);
+        for (size_t filled = size; filled < blockSize && filled > 0;)
+        {
+            size_t count = std::min(filled, blockSize - filled);
+            std::memcpy(pBytes + filled, pBytes, count);
+            filled += count;
+        }
+        break;
+    default:
+        FALCOR_THROW("Unknown block codec {}.", uint32_t(codec));
+    }
+}
+} // namespace Falcor
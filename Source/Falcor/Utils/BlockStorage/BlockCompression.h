@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "BlockArchive.h"
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Compression applied to blocks that are not elided.
+ */
+enum class BlockCompression : uint32_t
+{
+    None,
+    LZ4,     ///< Fast, moderate ratio.
+    Deflate, ///< Slower, higher ratio.
+};
+FALCOR_ENUM_INFO(
+    BlockCompression,
+    {
+        {BlockCompression::None, "None"},
+        {BlockCompression::LZ4, "LZ4"},
+        {BlockCompression::Deflate, "Deflate"},
+    }
+);
+FALCOR_ENUM_REGISTER(BlockCompression);
+
+/**
+ * Result of encoding a block.
+ */
+struct EncodedBlock
+{
+    BlockCodec codec = BlockCodec::Raw;
+    const void* pData = nullptr; ///< Payload, points either to the input block or to the scratch buffer.
+    size_t size = 0;             ///< Payload size in bytes.
+};
+
+/**
+ * Encode a block for storage in a block archive.
+ * Blocks whose pixels are all identical are elided to BlockCodec::Zero or BlockCodec::Constant if requested.
+ * Other blocks are compressed, falling back to BlockCodec::Raw if compression does not reduce the size.
+ * @param[in] pData Uncompressed block.
+ * @param[in] size Size of the block in bytes, a multiple of bytesPerPixel.
+ * @param[in] bytesPerPixel Pixel size in bytes.
+ * @param[in] compression Compression to apply.
+ * @param[in] elideConstant Elide blocks with identical pixels.
+ * @param[in,out] buffer Scratch buffer holding the compressed payload. Reused across calls to avoid allocations.
+ * @return The encoded block.
+ */
+FALCOR_API EncodedBlock encodeBlock(
+    const void* pData,
+    size_t size,
+    uint32_t bytesPerPixel,
+    BlockCompression compression,
+    bool elideConstant,
+    std::vector<uint8_t>& buffer
+);
+
+/**
+ * Decode a block. Throws if the payload is corrupt.
+ * @param[in] codec Encoding of the payload.
+ * @param[in] pData Payload.
+ * @param[in] size Payload size in bytes.
+ * @param[out] pDst Destination of the uncompressed block.
+ * @param[in] blockSize Size of the uncompressed block in bytes.
+ * @param[in] bytesPerPixel Pixel size in bytes.
+ */
+FALCOR_API void decodeBlock(BlockCodec codec, const void* pData, size_t size, void* pDst, size_t blockSize, uint32_t bytesPerPixel);
+} // namespace Falcor
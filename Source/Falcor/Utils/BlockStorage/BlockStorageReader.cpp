@@ -0,0 +1,600 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockStorageReader.h"
+#include "Core/Error.h"
+#include "Core/ObjectPython.h"
+#include "Core/API/PythonHelpers.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <algorithm>
+#include <cstring>
+#include <regex>
+
+namespace Falcor
+{
+namespace
+{
+uint32_t getBlockFormatChannelCount(BlockFormat format)
+{
+    return format == BlockFormat::RGBA32Float || format == BlockFormat::RGBA16Float ? 4 : 1;
+}
+
+bool isFloatBlockFormat(BlockFormat format)
+{
+    return format == BlockFormat::RGBA32Float || format == BlockFormat::Luma32Float;
+}
+
+std::filesystem::path getBlockFilePath(const std::filesystem::path& directory, uint32_t bx, uint32_t by, uint32_t bz)
+{
+    return directory / fmt::format("block_{}_{}_{}.bin", bx, by, bz);
+}
+} // namespace
+
+BlockStorageReader::BlockStorageReader(const std::filesystem::path& path, const BlockArchiveDesc& desc, size_t cacheBudget, uint32_t threadCount)
+    : mPath(path)
+    , mCacheBudget(cacheBudget)
+    , mpThreadPool(threadCount > 0 ? std::make_shared<BS::thread_pool>(threadCount) : Threading::getSharedPool())
+{
+    std::filesystem::path archivePath = path;
+    if (std::filesystem::is_directory(path))
+        archivePath = path / "blocks.fba";
+
+    if (std::filesystem::is_regular_file(archivePath))
+    {
+        mpArchive = std::make_unique<BlockArchiveReader>(archivePath);
+        FALCOR_CHECK(mpArchive->isOpen(), "Failed to open block archive '{}'.", archivePath);
+        if (mpArchive->wasRecovered())
+            logWarning("Block archive '{}' was not closed properly, recovered {} batches.", archivePath, mpArchive->getBatchCount());
+        mDesc = mpArchive->getDesc();
+        const uint2 blockCount = mDesc.getBlockCount();
+        mBlockCount = uint3(blockCount, mpArchive->getBatchCount());
+        mDim = uint3(mDesc.frameDim, uint32_t(mpArchive->getFrameCount()));
+    }
+    else
+    {
+        FALCOR_CHECK(std::filesystem::is_directory(path), "Block storage '{}' does not exist.", path);
+        FALCOR_CHECK(
+            all(desc.frameDim > 0u) && all(desc.blockSize > 0u), "Block files in '{}' require a frame dimension and block size.", path
+        );
+        mDesc = desc;
+        mDesc.bytesPerPixel = getBlockFormatBytesPerPixel(desc.format);
+        if (isQuantizedBlockFormat(mDesc.format))
+            logWarning("Block files do not store the value ranges of format '{}', values are read as normalized codes.", mDesc.format);
+
+        // Find the block files to determine the number of batches.
+        const uint2 blockCount = mDesc.getBlockCount();
+        const std::regex pattern("block_(\\d+)_(\\d+)_(\\d+)\\.bin");
+        std::vector<uint3> blocks;
+        for (const auto& entry : std::filesystem::directory_iterator(path))
+        {
+            std::smatch match;
+            const std::string filename = entry.path().filename().string();
+            if (!std::regex_match(filename, match, pattern))
+                continue;
+            const uint3 block(std::stoul(match[1]), std::stoul(match[2]), std::stoul(match[3]));
+            if (block.x < blockCount.x && block.y < blockCount.y)
+                blocks.push_back(block);
+        }
+
+        mBlockCount = uint3(blockCount, 0);
+        for (const uint3& block : blocks)
+            mBlockCount.z = std::max(mBlockCount.z, block.z + 1);
+        mBlockFiles.resize(size_t(mBlockCount.x) * mBlockCount.y * mBlockCount.z);
+        for (const uint3& block : blocks)
+            mBlockFiles[getBlockKey(block.x, block.y, block.z)] = true;
+        mDim = uint3(mDesc.frameDim, mBlockCount.z * mDesc.blockSize.z);
+    }
+
+    mChannelCount = getBlockFormatChannelCount(mDesc.format);
+}
+
+std::shared_ptr<const BlockStorageReader::Block> BlockStorageReader::getBlock(uint32_t bx, uint32_t by, uint32_t bz) const
+{
+    if (bx >= mBlockCount.x || by >= mBlockCount.y || bz >= mBlockCount.z)
+        return nullptr;
+
+    const uint64_t key = getBlockKey(bx, by, bz);
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        auto it = mCache.find(key);
+        if (it != mCache.end())
+        {
+            mLru.splice(mLru.begin(), mLru, it->second.lruIt);
+            mStats.hits++;
+            return it->second.pBlock;
+        }
+        mStats.misses++;
+    }
+
+    // Load outside of the lock, concurrent loads of the same block keep the first block inserted.
+    BlockPtr pBlock = loadBlock(bx, by, bz);
+    if (!pBlock)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    auto [it, inserted] = mCache.try_emplace(key);
+    if (!inserted)
+        return it->second.pBlock;
+    mLru.push_front(key);
+    it->second = {pBlock, mLru.begin()};
+    mStats.cachedBytes += pBlock->byteSize;
+    evict(mCacheBudget);
+    return pBlock;
+}
+
+void BlockStorageReader::readBox(uint3 origin, uint3 size, float* pDst) const
+{
+    FALCOR_CHECK(
+        all(origin + size <= mDim) && all(origin + size >= origin),
+        "Box at ({}, {}, {}) of size ({}, {}, {}) is out of bounds of ({}, {}, {}).",
+        origin.x,
+        origin.y,
+        origin.z,
+        size.x,
+        size.y,
+        size.z,
+        mDim.x,
+        mDim.y,
+        mDim.z
+    );
+    if (any(size == 0u))
+        return;
+
+    const uint3 blockSize = mDesc.blockSize;
+    const uint3 firstBlock = origin / blockSize;
+    const uint3 blockCount = (origin + size - 1u) / blockSize - firstBlock + 1u;
+    const uint32_t C = mChannelCount;
+
+    auto gatherBlock = [&](uint32_t index)
+    {
+        const uint3 block = firstBlock + uint3(index % blockCount.x, index / blockCount.x % blockCount.y, index / blockCount.x / blockCount.y);
+        const uint3 start = max(origin, block * blockSize);
+        const uint3 end = min(origin + size, (block + 1u) * blockSize);
+        const size_t rowSize = size_t(end.x - start.x) * C;
+
+        BlockPtr pBlock = getBlock(block.x, block.y, block.z);
+        for (uint32_t z = start.z; z < end.z; ++z)
+        {
+            for (uint32_t y = start.y; y < end.y; ++y)
+            {
+                float* pRow = pDst + ((size_t(z - origin.z) * size.y + (y - origin.y)) * size.x + (start.x - origin.x)) * C;
+                if (!pBlock)
+                {
+                    std::fill_n(pRow, rowSize, 0.f);
+                    continue;
+                }
+                const uint3 local = uint3(start.x, y, z) - block * blockSize;
+                const float* pSrc = pBlock->pData + ((size_t(local.z) * blockSize.y + local.y) * blockSize.x + local.x) * C;
+                std::memcpy(pRow, pSrc, rowSize * sizeof(float));
+            }
+        }
+    };
+
+    const uint32_t totalBlocks = blockCount.x * blockCount.y * blockCount.z;
+    if (totalBlocks == 1)
+    {
+        gatherBlock(0);
+        return;
+    }
+    mpThreadPool
+        ->parallelize_loop(
+            totalBlocks,
+            [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                    gatherBlock(i);
+            }
+        )
+        .get();
+}
+
+void BlockStorageReader::readColumns(const uint2* pPixels, size_t pixelCount, uint32_t z, uint32_t frameCount, float* pDst) const
+{
+    FALCOR_CHECK(
+        z + frameCount <= mDim.z && z + frameCount >= z, "Frames {} to {} are out of bounds of {} frames.", z, z + frameCount, mDim.z
+    );
+    for (size_t i = 0; i < pixelCount; ++i)
+        FALCOR_CHECK(all(pPixels[i] < mDim.xy()), "Pixel ({}, {}) is out of bounds.", pPixels[i].x, pPixels[i].y);
+    if (pixelCount == 0 || frameCount == 0)
+        return;
+
+    // Sort the pixels by block and split them into groups sharing a block column.
+    const uint3 blockSize = mDesc.blockSize;
+    auto getColumnKey = [&](size_t i)
+    {
+        const uint2 block = pPixels[i] / blockSize.xy();
+        return block.y * mBlockCount.x + block.x;
+    };
+    std::vector<uint32_t> order(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i)
+        order[i] = uint32_t(i);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return getColumnKey(a) < getColumnKey(b); });
+    std::vector<size_t> groups;
+    for (size_t i = 0; i < pixelCount; ++i)
+        if (i == 0 || getColumnKey(order[i]) != getColumnKey(order[i - 1]))
+            groups.push_back(i);
+    groups.push_back(pixelCount);
+
+    const uint32_t firstBlockZ = z / blockSize.z;
+    const uint32_t blockCountZ = (z + frameCount - 1) / blockSize.z - firstBlockZ + 1;
+    const uint32_t C = mChannelCount;
+
+    auto gatherGroup = [&](size_t index)
+    {
+        const size_t group = index / blockCountZ;
+        const uint32_t bz = firstBlockZ + uint32_t(index % blockCountZ);
+        const uint2 block = pPixels[order[groups[group]]] / blockSize.xy();
+        const uint32_t startZ = std::max(z, bz * blockSize.z);
+        const uint32_t endZ = std::min(z + frameCount, (bz + 1) * blockSize.z);
+
+        BlockPtr pBlock = getBlock(block.x, block.y, bz);
+        for (size_t i = groups[group]; i < groups[group + 1]; ++i)
+        {
+            const uint32_t pixel = order[i];
+            const uint2 local = pPixels[pixel] - block * blockSize.xy();
+            float* pColumn = pDst + (size_t(pixel) * frameCount + (startZ - z)) * C;
+            for (uint32_t frame = startZ; frame < endZ; ++frame, pColumn += C)
+            {
+                if (!pBlock)
+                {
+                    std::fill_n(pColumn, C, 0.f);
+                    continue;
+                }
+                const size_t offset = ((size_t(frame - bz * blockSize.z) * blockSize.y + local.y) * blockSize.x + local.x) * C;
+                std::copy_n(pBlock->pData + offset, C, pColumn);
+            }
+        }
+    };
+
+    const size_t taskCount = (groups.size() - 1) * blockCountZ;
+    mpThreadPool
+        ->parallelize_loop(
+            taskCount,
+            [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    gatherGroup(i);
+            }
+        )
+        .get();
+}
+
+size_t BlockStorageReader::getCacheBudget() const
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    return mCacheBudget;
+}
+
+void BlockStorageReader::setCacheBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    mCacheBudget = bytes;
+    evict(mCacheBudget);
+}
+
+void BlockStorageReader::clearCache()
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    evict(0);
+}
+
+BlockStorageReader::Stats BlockStorageReader::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    Stats stats = mStats;
+    stats.cachedBlocks = mCache.size();
+    return stats;
+}
+
+BlockStorageReader::BlockPtr BlockStorageReader::loadBlock(uint32_t bx, uint32_t by, uint32_t bz) const
+{
+    const size_t blockByteSize = mDesc.getBlockByteSize();
+    const size_t valueCount = size_t(mDesc.blockSize.x) * mDesc.blockSize.y * mDesc.blockSize.z * mChannelCount;
+    auto pBlock = std::make_shared<Block>();
+
+    if (mpArchive)
+    {
+        const BlockInfo* pInfo = mpArchive->findBlock(bx, by, bz);
+        if (!pInfo)
+            return nullptr;
+
+        // Uncompressed float blocks are served from the mapping of the archive, which lives as long as the reader.
+        if (pInfo->codec == BlockCodec::Raw && isFloatBlockFormat(mDesc.format))
+        {
+            FALCOR_CHECK(pInfo->size == blockByteSize, "Block ({}, {}, {}) has an invalid size.", bx, by, bz);
+            pBlock->pData = reinterpret_cast<const float*>(mpArchive->getBlockData(*pInfo));
+            return pBlock;
+        }
+
+        pBlock->storage.resize(valueCount);
+        if (isFloatBlockFormat(mDesc.format))
+        {
+            mpArchive->readBlock(*pInfo, pBlock->storage.data());
+        }
+        else
+        {
+            thread_local std::vector<uint8_t> buffer;
+            buffer.resize(blockByteSize);
+            mpArchive->readBlock(*pInfo, buffer.data());
+            convertBlock(buffer.data(), pInfo->range, pBlock->storage.data());
+        }
+    }
+    else
+    {
+        const uint64_t key = getBlockKey(bx, by, bz);
+        if (!mBlockFiles[key])
+            return nullptr;
+
+        const std::filesystem::path path = getBlockFilePath(mPath, bx, by, bz);
+        FALCOR_CHECK(pBlock->file.open(path), "Failed to open block file '{}'.", path);
+        FALCOR_CHECK(pBlock->file.getSize() == blockByteSize, "Block file '{}' has an invalid size.", path);
+
+        // Float blocks are served from the mapping of the block file, which is owned by the block.
+        if (isFloatBlockFormat(mDesc.format))
+        {
+            pBlock->pData = reinterpret_cast<const float*>(pBlock->file.getData());
+            pBlock->byteSize = pBlock->file.getMappedSize();
+            return pBlock;
+        }
+
+        pBlock->storage.resize(valueCount);
+        convertBlock(pBlock->file.getData(), float2(0.f, 1.f), pBlock->storage.data());
+        pBlock->file.close();
+    }
+
+    pBlock->pData = pBlock->storage.data();
+    pBlock->byteSize = pBlock->storage.size() * sizeof(float);
+    return pBlock;
+}
+
+void BlockStorageReader::convertBlock(const void* pSrc, float2 range, float* pDst) const
+{
+    const size_t valueCount = size_t(mDesc.blockSize.x) * mDesc.blockSize.y * mDesc.blockSize.z * mChannelCount;
+    switch (mDesc.format)
+    {
+    case BlockFormat::RGBA16Float:
+    case BlockFormat::Luma16Float:
+    {
+        const uint16_t* pValues = reinterpret_cast<const uint16_t*>(pSrc);
+        for (size_t i = 0; i < valueCount; ++i)
+            pDst[i] = math::float16ToFloat32(pValues[i]);
+        break;
+    }
+    case BlockFormat::LogLuma16:
+    {
+        const uint16_t* pCodes = reinterpret_cast<const uint16_t*>(pSrc);
+        const float scale = (range.y - range.x) / 65535.f;
+        for (size_t i = 0; i < valueCount; ++i)
+            pDst[i] = range.x + pCodes[i] * scale;
+        break;
+    }
+    case BlockFormat::LogLuma8:
+    {
+        const uint8_t* pCodes = reinterpret_cast<const uint8_t*>(pSrc);
+        const float scale = (range.y - range.x) / 255.f;
+        for (size_t i = 0; i < valueCount; ++i)
+            pDst[i] = range.x + pCodes[i] * scale;
+        break;
+    }
+    default:
+        std::memcpy(pDst, pSrc, valueCount * sizeof(float));
+        break;
+    }
+}
+
+void BlockStorageReader::evict(size_t budget) const
+{
+    while (mStats.cachedBytes > budget || (budget == 0 && !mLru.empty()))
+    {
+        auto it = mCache.find(mLru.back());
+        mStats.cachedBytes -= it->second.pBlock->byteSize;
+        mCache.erase(it);
+        mLru.pop_back();
+        mStats.evictions++;
+    }
+}
+
+namespace
+{
+/// Create a numpy array owning a buffer of values.
+pybind11::ndarray<pybind11::numpy> valuesToNumpy(float* pValues, std::vector<pybind11::size_t> shape)
+{
+    pybind11::capsule owner(pValues, [](void* p) noexcept { delete[] reinterpret_cast<float*>(p); });
+    return pybind11::ndarray<pybind11::numpy>(
+        pValues, shape.size(), shape.data(), owner, nullptr, pybind11::dtype<float>(), pybind11::device::cpu::value
+    );
+}
+
+/// Read a box into a new numpy array of shape (size.z, size.y, size.x, channels), dropping axes with dropAxes set.
+pybind11::ndarray<pybind11::numpy> readBoxToNumpy(const BlockStorageReader& self, uint3 origin, uint3 size, bool3 dropAxes)
+{
+    const uint32_t channelCount = self.getChannelCount();
+    float* pValues = new float[size_t(size.x) * size.y * size.z * channelCount];
+    try
+    {
+        self.readBox(origin, size, pValues);
+    }
+    catch (...)
+    {
+        delete[] pValues;
+        throw;
+    }
+
+    std::vector<pybind11::size_t> shape;
+    for (int axis = 2; axis >= 0; --axis)
+        if (!dropAxes[axis])
+            shape.push_back(size[axis]);
+    shape.push_back(channelCount);
+    return valuesToNumpy(pValues, shape);
+}
+} // namespace
+
+FALCOR_SCRIPT_BINDING(BlockStorageReader)
+{
+    using namespace pybind11::literals;
+
+    pybind11::falcor_enum<BlockFormat>(m, "BlockFormat");
+
+    pybind11::class_<BlockStorageReader, ref<BlockStorageReader>> reader(m, "BlockStorageReader");
+    reader.def(
+        pybind11::init(
+            [](const std::filesystem::path& path,
+               uint3 frame_dim,
+               uint3 block_size,
+               BlockFormat format,
+               size_t cache_budget,
+               uint32_t thread_count)
+            {
+                BlockArchiveDesc desc;
+                desc.frameDim = frame_dim.xy();
+                desc.blockSize = block_size;
+                desc.format = format;
+                return BlockStorageReader::create(path, desc, cache_budget, thread_count);
+            }
+        ),
+        "path"_a,
+        "frame_dim"_a = uint3(0),
+        "block_size"_a = uint3(BlockArchiveDesc().blockSize),
+        "format"_a = BlockFormat::RGBA32Float,
+        "cache_budget"_a = BlockStorageReader::kDefaultCacheBudget,
+        "thread_count"_a = 0
+    );
+    reader.def_property_readonly("is_archive", &BlockStorageReader::isArchive);
+    reader.def_property_readonly("dim", &BlockStorageReader::getDim);
+    reader.def_property_readonly("block_count", &BlockStorageReader::getBlockCount);
+    reader.def_property_readonly("block_size", [](const BlockStorageReader& self) { return self.getDesc().blockSize; });
+    reader.def_property_readonly("format", [](const BlockStorageReader& self) { return self.getDesc().format; });
+    reader.def_property_readonly("channel_count", &BlockStorageReader::getChannelCount);
+    reader.def_property("cache_budget", &BlockStorageReader::getCacheBudget, &BlockStorageReader::setCacheBudget);
+    reader.def("clear_cache", &BlockStorageReader::clearCache);
+    reader.def(
+        "get_stats",
+        [](const BlockStorageReader& self)
+        {
+            const BlockStorageReader::Stats stats = self.getStats();
+            pybind11::dict d;
+            d["hits"] = stats.hits;
+            d["misses"] = stats.misses;
+            d["evictions"] = stats.evictions;
+            d["cached_blocks"] = stats.cachedBlocks;
+            d["cached_bytes"] = stats.cachedBytes;
+            return d;
+        }
+    );
+
+    // Blocks are returned as read-only views of the cached block, which keep the block and the reader alive.
+    // The block may be shared with other callers or mapped read-only, so the views are not writeable.
+    reader.def(
+        "block",
+        [](const ref<BlockStorageReader>& self, uint32_t bx, uint32_t by, uint32_t bz) -> pybind11::object
+        {
+            auto pBlock = self->getBlock(bx, by, bz);
+            if (!pBlock)
+                return pybind11::none();
+
+            struct View
+            {
+                ref<BlockStorageReader> pReader;
+                std::shared_ptr<const BlockStorageReader::Block> pBlock;
+            };
+            View* pView = new View{self, pBlock};
+            pybind11::capsule owner(pView, [](void* p) noexcept { delete reinterpret_cast<View*>(p); });
+            const uint3 blockSize = self->getDesc().blockSize;
+            pybind11::size_t shape[4] = {blockSize.z, blockSize.y, blockSize.x, self->getChannelCount()};
+            return pybind11::cast(pybind11::ndarray<pybind11::numpy, pybind11::ro>(
+                const_cast<float*>(pBlock->pData), 4, shape, owner, nullptr, pybind11::dtype<float>(), pybind11::device::cpu::value
+            ));
+        },
+        "bx"_a,
+        "by"_a,
+        "bz"_a
+    );
+
+    reader.def(
+        "voxel",
+        [](const BlockStorageReader& self, uint32_t x, uint32_t y, uint32_t z)
+        { return readBoxToNumpy(self, {x, y, z}, {1, 1, 1}, bool3(true)); },
+        "x"_a,
+        "y"_a,
+        "z"_a
+    );
+    reader.def(
+        "column",
+        [](const BlockStorageReader& self, uint32_t x, uint32_t y, uint32_t z, std::optional<uint32_t> frame_count)
+        {
+            const uint32_t frameCount = frame_count ? *frame_count : self.getDim().z - std::min(z, self.getDim().z);
+            return readBoxToNumpy(self, {x, y, z}, {1, 1, frameCount}, {true, true, false});
+        },
+        "x"_a,
+        "y"_a,
+        "z"_a = 0,
+        "frame_count"_a = pybind11::none()
+    );
+    reader.def(
+        "slice",
+        [](const BlockStorageReader& self, uint32_t z)
+        { return readBoxToNumpy(self, {0, 0, z}, uint3(self.getDim().xy(), 1), {false, false, true}); },
+        "z"_a
+    );
+    reader.def(
+        "box",
+        [](const BlockStorageReader& self, uint3 origin, uint3 size) { return readBoxToNumpy(self, origin, size, bool3(false)); },
+        "origin"_a,
+        "size"_a
+    );
+    reader.def(
+        "columns",
+        [](const BlockStorageReader& self, pybind11::ndarray<pybind11::numpy> pixels, uint32_t z, std::optional<uint32_t> frame_count)
+        {
+            FALCOR_CHECK(isNdarrayContiguous(pixels), "pixels array is not contiguous");
+            FALCOR_CHECK(pixels.dtype() == pybind11::dtype<uint32_t>(), "pixels array must be of type uint32");
+            FALCOR_CHECK(pixels.ndim() == 2 && pixels.shape(1) == 2, "pixels array must have shape (N, 2)");
+            const size_t pixelCount = pixels.shape(0);
+            const uint32_t frameCount = frame_count ? *frame_count : self.getDim().z - std::min(z, self.getDim().z);
+
+            float* pValues = new float[pixelCount * frameCount * self.getChannelCount()];
+            try
+            {
+                self.readColumns(reinterpret_cast<const uint2*>(pixels.data()), pixelCount, z, frameCount, pValues);
+            }
+            catch (...)
+            {
+                delete[] pValues;
+                throw;
+            }
+            return valuesToNumpy(pValues, {pixelCount, frameCount, self.getChannelCount()});
+        },
+        "pixels"_a,
+        "z"_a = 0,
+        "frame_count"_a = pybind11::none()
+    );
+}
+} // namespace Falcor
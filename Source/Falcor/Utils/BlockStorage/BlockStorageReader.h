@@ -0,0 +1,198 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "BlockArchive.h"
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Threading.h"
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Random access reader for frames stored as blocks by the BlockStoragePass.
+ *
+ * Reads either a block archive (see BlockArchive.h) or a directory of per-block files named block_{bx}_{by}_{bz}.bin.
+ * Blocks are memory mapped and converted to float values with getChannelCount() channels. Blocks that are stored
+ * uncompressed as 32-bit floats are served directly from the mapping, all other blocks are decoded into memory.
+ * Decoded blocks are kept in an LRU cache bounded by a byte budget.
+ *
+ * Queries address pixels by (x, y, z), where z is the frame index, and write float values ordered by frame, row,
+ * column and channel. Queries spanning several blocks gather the blocks on a thread pool, by default the shared pool
+ * of Threading, so queries must not be issued from tasks of that pool. Missing blocks read as zero.
+ * All functions are thread-safe.
+ */
+class FALCOR_API BlockStorageReader : public Object
+{
+    FALCOR_OBJECT(BlockStorageReader)
+public:
+    static constexpr size_t kDefaultCacheBudget = size_t(1) << 30;
+
+    /**
+     * Block converted to float values, ordered by frame, row, column and channel.
+     */
+    struct Block
+    {
+        const float* pData = nullptr; ///< Values, pointing either into a memory mapped file or to storage.
+        size_t byteSize = 0;          ///< Memory held by the block, counted against the cache budget.
+        std::vector<float> storage;
+        MemoryMappedFile file;
+    };
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t cachedBlocks = 0;
+        size_t cachedBytes = 0;
+    };
+
+    /**
+     * Create a reader. Throws if the storage cannot be opened.
+     * @param[in] path Block archive, or directory containing either a block archive named blocks.fba or block files.
+     * @param[in] desc Frame dimension, block size and format of block files. Ignored for archives, which store their description.
+     * @param[in] cacheBudget Maximum memory in bytes held by cached blocks.
+     * @param[in] threadCount Threads of a pool owned by the reader, 0 to use the shared pool of Threading.
+     */
+    static ref<BlockStorageReader> create(
+        const std::filesystem::path& path,
+        const BlockArchiveDesc& desc = {},
+        size_t cacheBudget = kDefaultCacheBudget,
+        uint32_t threadCount = 0
+    )
+    {
+        return make_ref<BlockStorageReader>(path, desc, cacheBudget, threadCount);
+    }
+
+    BlockStorageReader(
+        const std::filesystem::path& path,
+        const BlockArchiveDesc& desc = {},
+        size_t cacheBudget = kDefaultCacheBudget,
+        uint32_t threadCount = 0
+    );
+
+    /// True if the blocks are read from an archive.
+    bool isArchive() const { return mpArchive != nullptr; }
+
+    const BlockArchiveDesc& getDesc() const { return mDesc; }
+
+    /// Number of channels of the values, 4 for RGBA formats and 1 for luma formats.
+    uint32_t getChannelCount() const { return mChannelCount; }
+
+    /// Dimension of the stored volume in pixels (x, y) and frames (z).
+    uint3 getDim() const { return mDim; }
+
+    /// Number of blocks covering the volume.
+    uint3 getBlockCount() const { return mBlockCount; }
+
+    /**
+     * Get a block, loading it if it is not cached. The block stays valid as long as the reader exists.
+     * @return The block or nullptr if the block is missing.
+     */
+    std::shared_ptr<const Block> getBlock(uint32_t bx, uint32_t by, uint32_t bz) const;
+
+    /**
+     * Read a box of pixels. Throws if the box is out of bounds.
+     * @param[in] origin First pixel (x, y, z).
+     * @param[in] size Size of the box in pixels and frames.
+     * @param[out] pDst Destination of size.x * size.y * size.z * getChannelCount() values.
+     */
+    void readBox(uint3 origin, uint3 size, float* pDst) const;
+
+    /// Read a single pixel of a frame into getChannelCount() values.
+    void readVoxel(uint32_t x, uint32_t y, uint32_t z, float* pDst) const { readBox({x, y, z}, {1, 1, 1}, pDst); }
+
+    /// Read the values of a pixel over frameCount frames starting at frame z.
+    void readColumn(uint32_t x, uint32_t y, uint32_t z, uint32_t frameCount, float* pDst) const
+    {
+        readBox({x, y, z}, {1, 1, frameCount}, pDst);
+    }
+
+    /// Read a whole frame.
+    void readSlice(uint32_t z, float* pDst) const { readBox({0, 0, z}, {mDim.x, mDim.y, 1}, pDst); }
+
+    /**
+     * Read the values of many pixels over a range of frames.
+     * Pixels are grouped by block so that every block is loaded once.
+     * @param[in] pPixels Pixel coordinates.
+     * @param[in] pixelCount Number of pixels.
+     * @param[in] z First frame.
+     * @param[in] frameCount Number of frames.
+     * @param[out] pDst Destination of pixelCount * frameCount * getChannelCount() values, ordered by pixel, frame and channel.
+     */
+    void readColumns(const uint2* pPixels, size_t pixelCount, uint32_t z, uint32_t frameCount, float* pDst) const;
+
+    size_t getCacheBudget() const;
+
+    /// Set the cache budget in bytes, evicting blocks if needed.
+    void setCacheBudget(size_t bytes);
+
+    void clearCache();
+
+    Stats getStats() const;
+
+private:
+    using BlockPtr = std::shared_ptr<const Block>;
+
+    struct CacheEntry
+    {
+        BlockPtr pBlock;
+        std::list<uint64_t>::iterator lruIt;
+    };
+
+    uint64_t getBlockKey(uint32_t bx, uint32_t by, uint32_t bz) const { return (uint64_t(bz) * mBlockCount.y + by) * mBlockCount.x + bx; }
+    BlockPtr loadBlock(uint32_t bx, uint32_t by, uint32_t bz) const;
+    void convertBlock(const void* pSrc, float2 range, float* pDst) const;
+    void evict(size_t budget) const;
+
+    std::filesystem::path mPath;
+    std::unique_ptr<BlockArchiveReader> mpArchive; ///< Archive the blocks are read from, nullptr for block files.
+    BlockArchiveDesc mDesc;
+    uint32_t mChannelCount = 0;
+    uint3 mDim = {0, 0, 0};
+    uint3 mBlockCount = {0, 0, 0};
+    std::vector<bool> mBlockFiles; ///< Block files present in the directory, indexed by block key.
+
+    mutable std::mutex mCacheMutex;
+    mutable std::unordered_map<uint64_t, CacheEntry> mCache;
+    mutable std::list<uint64_t> mLru; ///< Keys of the cached blocks, most recently used first.
+    mutable Stats mStats;
+    size_t mCacheBudget;
+
+    std::shared_ptr<BS::thread_pool> mpThreadPool;
+};
+} // namespace Falcor
@@ -0,0 +1,215 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PixelSeries.h"
+#include "Core/Error.h"
+#include "Core/ObjectPython.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFileMagic = 0x53585046; // 'FPXS'
+const uint32_t kFileVersion = 1;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frameWidth;
+    uint32_t frameHeight;
+    uint32_t chunkWidth;
+    uint32_t chunkHeight;
+    uint32_t frameCount;
+    uint32_t channelCount;
+    uint32_t reserved[8];
+};
+static_assert(sizeof(FileHeader) == 64);
+} // namespace
+
+uint64_t PixelSeriesDesc::getSeriesOffset(uint32_t x, uint32_t y) const
+{
+    // Chunks are clipped to the frame, so the chunks of a chunk row all have the height of the row.
+    const uint2 origin = uint2(x, y) / chunkSize * chunkSize;
+    const uint2 size = min(chunkSize, frameDim - origin);
+    const uint64_t pixel =
+        uint64_t(origin.y) * frameDim.x + uint64_t(origin.x) * size.y + uint64_t(y - origin.y) * size.x + (x - origin.x);
+    return sizeof(FileHeader) + pixel * getSeriesByteSize();
+}
+
+void writePixelSeries(const BlockStorageReader& reader, const std::filesystem::path& path, uint2 chunkSize, size_t workingSetSize)
+{
+    const uint3 dim = reader.getDim();
+    const uint32_t frameBatch = reader.getDesc().blockSize.z;
+
+    PixelSeriesDesc desc;
+    desc.frameDim = dim.xy();
+    desc.chunkSize = any(chunkSize == 0u) ? reader.getDesc().blockSize.xy() : chunkSize;
+    desc.frameCount = dim.z;
+    desc.channelCount = reader.getChannelCount();
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    FALCOR_CHECK(stream.good(), "Failed to create pixel series file '{}'.", path);
+
+    FileHeader header = {};
+    header.magic = kFileMagic;
+    header.version = kFileVersion;
+    header.frameWidth = desc.frameDim.x;
+    header.frameHeight = desc.frameDim.y;
+    header.chunkWidth = desc.chunkSize.x;
+    header.chunkHeight = desc.chunkSize.y;
+    header.frameCount = desc.frameCount;
+    header.channelCount = desc.channelCount;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Gather one chunk at a time, reading one batch of frames at a time so every block is read once. The series of a
+    // chunk are gathered in passes of whole batches, which are written to their offsets in the series of the pixels.
+    const uint32_t C = desc.channelCount;
+    const uint2 chunkCount = desc.getChunkCount();
+    const size_t seriesSize = desc.getSeriesByteSize();
+    std::vector<float> frames;
+    std::vector<float> series;
+    for (uint32_t cy = 0; cy < chunkCount.y && desc.frameCount > 0; ++cy)
+    {
+        for (uint32_t cx = 0; cx < chunkCount.x; ++cx)
+        {
+            const uint2 origin = uint2(cx, cy) * desc.chunkSize;
+            const uint2 size = min(desc.chunkSize, desc.frameDim - origin);
+            const size_t pixelCount = size_t(size.x) * size.y;
+            const uint64_t chunkOffset = desc.getSeriesOffset(origin.x, origin.y);
+            const size_t batchSize = pixelCount * frameBatch * C * sizeof(float);
+            const uint32_t passFrames = uint32_t(std::min<size_t>(std::max<size_t>(1, workingSetSize / batchSize) * frameBatch, desc.frameCount));
+
+            for (uint32_t passBegin = 0; passBegin < desc.frameCount; passBegin += passFrames)
+            {
+                const uint32_t passCount = std::min(passFrames, desc.frameCount - passBegin);
+                series.resize(pixelCount * passCount * C);
+                for (uint32_t z = passBegin; z < passBegin + passCount; z += frameBatch)
+                {
+                    const uint32_t frameCount = std::min(frameBatch, passBegin + passCount - z);
+                    frames.resize(pixelCount * frameCount * C);
+                    reader.readBox(uint3(origin, z), uint3(size, frameCount), frames.data());
+                    for (uint32_t frame = 0; frame < frameCount; ++frame)
+                        for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+                            std::copy_n(
+                                &frames[(frame * pixelCount + pixel) * C], C, &series[(pixel * passCount + z - passBegin + frame) * C]
+                            );
+                }
+
+                // A pass over all frames holds the contiguous series of the chunk.
+                const size_t passSize = size_t(passCount) * C * sizeof(float);
+                if (passCount == desc.frameCount)
+                {
+                    stream.seekp(chunkOffset);
+                    stream.write(reinterpret_cast<const char*>(series.data()), series.size() * sizeof(float));
+                    continue;
+                }
+                for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+                {
+                    stream.seekp(chunkOffset + pixel * seriesSize + size_t(passBegin) * C * sizeof(float));
+                    stream.write(reinterpret_cast<const char*>(&series[pixel * passCount * C]), passSize);
+                }
+            }
+        }
+    }
+
+    stream.flush();
+    FALCOR_CHECK(stream.good(), "Failed to write pixel series file '{}'.", path);
+}
+
+PixelSeriesReader::PixelSeriesReader(const std::filesystem::path& path)
+{
+    FALCOR_CHECK(mFile.open(path), "Failed to open pixel series file '{}'.", path);
+    FALCOR_CHECK(mFile.getSize() >= sizeof(FileHeader), "Pixel series file '{}' is too small.", path);
+
+    const FileHeader& header = *reinterpret_cast<const FileHeader*>(mFile.getData());
+    FALCOR_CHECK(
+        header.magic == kFileMagic && header.version == kFileVersion, "File '{}' is not a pixel series file or has an unsupported version.", path
+    );
+    mDesc.frameDim = {header.frameWidth, header.frameHeight};
+    mDesc.chunkSize = {header.chunkWidth, header.chunkHeight};
+    mDesc.frameCount = header.frameCount;
+    mDesc.channelCount = header.channelCount;
+    FALCOR_CHECK(all(mDesc.chunkSize > 0u), "Pixel series file '{}' has an invalid chunk size.", path);
+
+    const uint64_t expectedSize = sizeof(FileHeader) + uint64_t(mDesc.frameDim.x) * mDesc.frameDim.y * mDesc.getSeriesByteSize();
+    FALCOR_CHECK(mFile.getSize() == expectedSize, "Pixel series file '{}' is incomplete ({} of {} bytes).", path, mFile.getSize(), expectedSize);
+}
+
+const float* PixelSeriesReader::getSeries(uint32_t x, uint32_t y) const
+{
+    FALCOR_CHECK(x < mDesc.frameDim.x && y < mDesc.frameDim.y, "Pixel ({}, {}) is out of bounds.", x, y);
+    return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(mFile.getData()) + mDesc.getSeriesOffset(x, y));
+}
+
+FALCOR_SCRIPT_BINDING(PixelSeries)
+{
+    using namespace pybind11::literals;
+
+    FALCOR_SCRIPT_BINDING_DEPENDENCY(BlockStorageReader)
+
+    m.def(
+        "write_pixel_series",
+        [](const BlockStorageReader& reader, const std::filesystem::path& path, uint2 chunk_size, size_t working_set_size)
+        { writePixelSeries(reader, path, chunk_size, working_set_size); },
+        "reader"_a,
+        "path"_a,
+        "chunk_size"_a = uint2(0),
+        "working_set_size"_a = kPixelSeriesWorkingSetSize
+    );
+
+    pybind11::class_<PixelSeriesReader, ref<PixelSeriesReader>> reader(m, "PixelSeriesReader");
+    reader.def(pybind11::init(&PixelSeriesReader::create), "path"_a);
+    reader.def_property_readonly("frame_dim", [](const PixelSeriesReader& self) { return self.getDesc().frameDim; });
+    reader.def_property_readonly("chunk_size", [](const PixelSeriesReader& self) { return self.getDesc().chunkSize; });
+    reader.def_property_readonly("frame_count", [](const PixelSeriesReader& self) { return self.getDesc().frameCount; });
+    reader.def_property_readonly("channel_count", [](const PixelSeriesReader& self) { return self.getDesc().channelCount; });
+
+    // Series are returned as read-only views of the mapped file, which keep the reader alive. The file is mapped
+    // read-only, so the views are not writeable.
+    reader.def(
+        "series",
+        [](const ref<PixelSeriesReader>& self, uint32_t x, uint32_t y)
+        {
+            const float* pSeries = self->getSeries(x, y);
+            auto pOwner = new ref<PixelSeriesReader>(self);
+            pybind11::capsule owner(pOwner, [](void* p) noexcept { delete reinterpret_cast<ref<PixelSeriesReader>*>(p); });
+            pybind11::size_t shape[2] = {self->getDesc().frameCount, self->getDesc().channelCount};
+            return pybind11::ndarray<pybind11::numpy, pybind11::ro>(
+                const_cast<float*>(pSeries), 2, shape, owner, nullptr, pybind11::dtype<float>(), pybind11::device::cpu::value
+            );
+        },
+        "x"_a,
+        "y"_a
+    );
+}
+} // namespace Falcor
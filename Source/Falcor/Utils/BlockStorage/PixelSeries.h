@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "BlockStorageReader.h"
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Description stored in the header of a pixel series file.
+ */
+struct FALCOR_API PixelSeriesDesc
+{
+    uint2 frameDim = {0, 0};     ///< Frame dimension in pixels.
+    uint2 chunkSize = {64, 64};  ///< Chunk dimension in pixels.
+    uint32_t frameCount = 0;     ///< Number of frames per pixel.
+    uint32_t channelCount = 0;   ///< Number of float values per frame.
+
+    /// Number of chunks in x and y covering a frame.
+    uint2 getChunkCount() const { return (frameDim + chunkSize - 1u) / chunkSize; }
+    /// Size of the time series of a pixel in bytes.
+    size_t getSeriesByteSize() const { return size_t(frameCount) * channelCount * sizeof(float); }
+    /// Byte offset of the time series of a pixel from the start of the file.
+    uint64_t getSeriesOffset(uint32_t x, uint32_t y) const;
+};
+
+/// Default maximum size of the series writePixelSeries() gathers in memory in bytes.
+constexpr size_t kPixelSeriesWorkingSetSize = size_t(64) << 20;
+
+/**
+ * Write the frames of a block storage to a pixel series file, the pixel-major counterpart of the block layout.
+ *
+ * The file holds the time series of every pixel contiguously, frameCount * channelCount float values ordered by frame
+ * and channel. Pixels are grouped into chunks of chunkSize pixels, which are stored in row-major order and clipped to
+ * the frame. Within a chunk, pixels are in row-major order. All values are written after a 64 byte header.
+ *
+ * The transposition streams over the chunks. The series of a chunk are gathered in passes of whole frame batches that
+ * fit into workingSetSize bytes, each pass is written to its offset in the series of the pixels. At least one frame
+ * batch of a chunk is held in memory. With the default chunk size, which is the block size of the storage, every
+ * block is read once.
+ * @param[in] reader Block storage to transpose.
+ * @param[in] path File path. An existing file is overwritten.
+ * @param[in] chunkSize Chunk dimension in pixels, 0 to use the block size.
+ * @param[in] workingSetSize Maximum size of the series gathered in memory in bytes.
+ */
+FALCOR_API void writePixelSeries(
+    const BlockStorageReader& reader,
+    const std::filesystem::path& path,
+    uint2 chunkSize = uint2(0),
+    size_t workingSetSize = kPixelSeriesWorkingSetSize
+);
+
+/**
+ * Reader for pixel series files written by writePixelSeries().
+ * The file is memory mapped, the series of a pixel is accessed without copies.
+ */
+class FALCOR_API PixelSeriesReader : public Object
+{
+    FALCOR_OBJECT(PixelSeriesReader)
+public:
+    /// Create a reader. Throws if the file cannot be opened or is invalid.
+    static ref<PixelSeriesReader> create(const std::filesystem::path& path) { return make_ref<PixelSeriesReader>(path); }
+
+    PixelSeriesReader(const std::filesystem::path& path);
+
+    const PixelSeriesDesc& getDesc() const { return mDesc; }
+
+    /// Get the time series of a pixel, frameCount * channelCount values. Throws if the pixel is out of bounds.
+    const float* getSeries(uint32_t x, uint32_t y) const;
+
+private:
+    MemoryMappedFile mFile;
+    PixelSeriesDesc mDesc;
+};
+} // namespace Falcor
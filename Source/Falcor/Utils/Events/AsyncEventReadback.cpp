@@ -0,0 +1,292 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AsyncEventReadback.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Logger.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include <algorithm>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kInvalidSlot = uint32_t(-1);
+}
+
+AsyncEventReadback::AsyncEventReadback(
+    ref<Device> pDevice,
+    uint32_t elementSize,
+    uint32_t elementCount,
+    WriteCallback writeCallback,
+    uint32_t slotCount
+)
+    : mpDevice(pDevice), mElementSize(elementSize), mElementCount(elementCount), mWriteCallback(std::move(writeCallback))
+{
+    FALCOR_CHECK(mElementSize > 0 && mElementCount > 0, "AsyncEventReadback: element size and count must be non-zero.");
+    FALCOR_CHECK(slotCount >= 2, "AsyncEventReadback: at least two slots are required.");
+    FALCOR_CHECK(mWriteCallback, "AsyncEventReadback: write callback must be set.");
+
+    mpFence = mpDevice->createFence();
+
+    mSlots.resize(slotCount);
+    for (auto& slot : mSlots)
+    {
+        slot.pEventBuffer = mpDevice->createStructuredBuffer(
+            mElementSize,
+            mElementCount,
+            ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+            MemoryType::DeviceLocal,
+            nullptr,
+            true
+        );
+        slot.pCounterStaging = mpDevice->createBuffer(sizeof(uint32_t), ResourceBindFlags::None, MemoryType::ReadBack);
+        slot.pPayloadStaging = mpDevice->createBuffer(size_t(mElementSize) * mElementCount, ResourceBindFlags::None, MemoryType::ReadBack);
+    }
+
+    mWriterThread = std::thread(&AsyncEventReadback::runWriter, this);
+}
+
+AsyncEventReadback::~AsyncEventReadback()
+{
+    flush(mpDevice->getRenderContext());
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+    }
+    mCondition.notify_all();
+    mWriterThread.join();
+}
+
+const ref<Buffer>& AsyncEventReadback::beginFrame(RenderContext* pRenderContext)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    FALCOR_CHECK(mRecordingSlot == kInvalidSlot, "AsyncEventReadback: beginFrame() called twice without endFrame().");
+
+    poll(pRenderContext, lock);
+
+    auto findFreeSlot = [this]()
+    {
+        for (uint32_t i = 0; i < (uint32_t)mSlots.size(); ++i)
+            if (mSlots[i].state == SlotState::Free)
+                return i;
+        return kInvalidSlot;
+    };
+
+    uint32_t index = findFreeSlot();
+    if (index == kInvalidSlot)
+    {
+        // All slots are in flight, wait for the oldest one to retire.
+        mStalls++;
+        while ((index = findFreeSlot()) == kInvalidSlot)
+        {
+            waitOldest(lock);
+            poll(pRenderContext, lock);
+        }
+    }
+
+    Slot& slot = mSlots[index];
+    slot.state = SlotState::Recording;
+    mRecordingSlot = index;
+
+    pRenderContext->clearUAVCounter(slot.pEventBuffer, 0);
+    return slot.pEventBuffer;
+}
+
+void AsyncEventReadback::endFrame(RenderContext* pRenderContext, uint32_t frame)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    FALCOR_CHECK(mRecordingSlot != kInvalidSlot, "AsyncEventReadback: endFrame() called without beginFrame().");
+
+    Slot& slot = mSlots[mRecordingSlot];
+    const ref<Buffer>& pCounterBuffer = slot.pEventBuffer->getUAVCounter();
+    pRenderContext->copyBufferRegion(slot.pCounterStaging.get(), 0, pCounterBuffer.get(), 0, sizeof(uint32_t));
+    pRenderContext->submit(false);
+    slot.fenceValue = pRenderContext->signal(mpFence.get());
+    slot.frame = frame;
+    slot.eventCount = 0;
+    slot.state = SlotState::CounterPending;
+
+    mInFlight.push_back(mRecordingSlot);
+    mRecordingSlot = kInvalidSlot;
+
+    poll(pRenderContext, lock);
+}
+
+void AsyncEventReadback::cancelFrame()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mRecordingSlot == kInvalidSlot)
+        return;
+    mSlots[mRecordingSlot].state = SlotState::Free;
+    mRecordingSlot = kInvalidSlot;
+}
+
+void AsyncEventReadback::flush(RenderContext* pRenderContext)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    poll(pRenderContext, lock);
+    while (!mInFlight.empty())
+    {
+        waitOldest(lock);
+        poll(pRenderContext, lock);
+    }
+}
+
+AsyncEventReadback::Stats AsyncEventReadback::getStats() const
+{
+    Stats stats;
+    stats.framesWritten = mFramesWritten;
+    stats.bytesWritten = mBytesWritten;
+    stats.eventsWritten = stats.bytesWritten / mElementSize;
+    stats.stalls = mStalls;
+    return stats;
+}
+
+void AsyncEventReadback::poll(RenderContext* pRenderContext, std::unique_lock<std::mutex>& lock)
+{
+    const uint64_t completedValue = mpFence->getCurrentValue();
+
+    // Slots are handed to the writer in submission order. Once a slot cannot be handed over,
+    // all younger slots have to wait even if their data is already available.
+    bool inOrder = true;
+    for (uint32_t index : mInFlight)
+    {
+        Slot& slot = mSlots[index];
+
+        if (slot.state == SlotState::CounterPending && completedValue >= slot.fenceValue)
+        {
+            const uint32_t counter = *static_cast<const uint32_t*>(slot.pCounterStaging->map());
+            slot.pCounterStaging->unmap();
+            slot.eventCount = std::min(counter, mElementCount);
+            if (counter > mElementCount)
+                logWarning("AsyncEventReadback: frame {} produced {} events, clamping to {}.", slot.frame, counter, mElementCount);
+
+            if (slot.eventCount > 0)
+            {
+                const uint64_t size = uint64_t(slot.eventCount) * mElementSize;
+                pRenderContext->copyBufferRegion(slot.pPayloadStaging.get(), 0, slot.pEventBuffer.get(), 0, size);
+                pRenderContext->submit(false);
+                slot.fenceValue = pRenderContext->signal(mpFence.get());
+            }
+            else
+            {
+                slot.fenceValue = 0;
+            }
+            slot.state = SlotState::PayloadPending;
+        }
+
+        if (slot.state == SlotState::PayloadPending && inOrder && completedValue >= slot.fenceValue)
+        {
+            const size_t size = size_t(slot.eventCount) * mElementSize;
+            const void* pData = size > 0 ? slot.pPayloadStaging->map() : nullptr;
+            mWriteQueue.push_back({index, slot.frame, pData, size});
+            slot.state = SlotState::Writing;
+            mCondition.notify_all();
+        }
+
+        if (slot.state != SlotState::Writing && slot.state != SlotState::Written)
+            inOrder = false;
+    }
+
+    // Retire slots the writer is done with.
+    while (!mInFlight.empty() && mSlots[mInFlight.front()].state == SlotState::Written)
+    {
+        Slot& slot = mSlots[mInFlight.front()];
+        slot.pPayloadStaging->unmap();
+        slot.state = SlotState::Free;
+        mInFlight.pop_front();
+    }
+}
+
+void AsyncEventReadback::waitOldest(std::unique_lock<std::mutex>& lock)
+{
+    FALCOR_ASSERT(!mInFlight.empty());
+    Slot& slot = mSlots[mInFlight.front()];
+    switch (slot.state)
+    {
+    case SlotState::CounterPending:
+    case SlotState::PayloadPending:
+    {
+        const uint64_t fenceValue = slot.fenceValue;
+        lock.unlock();
+        mpFence->wait(fenceValue);
+        lock.lock();
+        break;
+    }
+    case SlotState::Writing:
+        mCondition.wait(lock, [&slot]() { return slot.state == SlotState::Written; });
+        break;
+    default:
+        break;
+    }
+}
+
+void AsyncEventReadback::runWriter()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mCondition.wait(lock, [this]() { return mTerminate || !mWriteQueue.empty(); });
+        if (mWriteQueue.empty())
+            break;
+
+        WriteRequest request = mWriteQueue.front();
+        mWriteQueue.pop_front();
+        lock.unlock();
+
+        try
+        {
+            mWriteCallback(request.frame, request.pData, request.size);
+        }
+        catch (const std::exception& e)
+        {
+            logError("AsyncEventReadback: failed to write frame {}: {}", request.frame, e.what());
+        }
+        mFramesWritten++;
+        mBytesWritten += request.size;
+
+        lock.lock();
+        mSlots[request.slot].state = SlotState::Written;
+        mCondition.notify_all();
+    }
+}
+
+pybind11::dict toPython(const AsyncEventReadback::Stats& stats, uint64_t storedBytes)
+{
+    pybind11::dict d;
+    d["frames"] = stats.framesWritten;
+    d["events"] = stats.eventsWritten;
+    d["bytes_read_back"] = stats.bytesWritten;
+    d["bytes_stored"] = storedBytes;
+    d["stalls"] = stats.stalls;
+    return d;
+}
+} // namespace Falcor
@@ -0,0 +1,199 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/fwd.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Fence.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+namespace pybind11
+{
+class dict;
+} // namespace pybind11
+
+namespace Falcor
+{
+class RenderContext;
+
+/**
+ * Pipelined GPU->CPU readback of append-style event buffers.
+ *
+ * The class owns a ring of slots. Each slot holds a device-local structured buffer with a UAV counter
+ * that a compute pass appends events to (or EventCompaction writes compacted events and their count to),
+ * plus staging buffers for the counter and the payload.
+ * The readback of a slot happens in two fenced stages that are polled on later frames:
+ *  1. The UAV counter is copied to a staging buffer at the end of the frame.
+ *  2. Once the counter is available, exactly counter * elementSize bytes are copied to the payload staging buffer.
+ * The mapped payload is then handed to a background writer thread that invokes the write callback.
+ * The render thread only blocks when all slots are in flight (this is reported as a stall).
+ *
+ * Typical usage per frame:
+ *
+ *   ref<Buffer> pEvents = readback.beginFrame(pRenderContext);
+ *   <bind pEvents as RWStructuredBuffer and dispatch>
+ *   readback.endFrame(pRenderContext, frame);
+ */
+class FALCOR_API AsyncEventReadback
+{
+public:
+    /// Callback invoked on the writer thread. The data pointer is only valid during the call.
+    using WriteCallback = std::function<void(uint32_t frame, const void* pData, size_t size)>;
+
+    static constexpr uint32_t kDefaultSlotCount = 4;
+
+    struct Stats
+    {
+        uint64_t framesWritten = 0; ///< Number of frames handed to the write callback.
+        uint64_t bytesWritten = 0;  ///< Number of payload bytes handed to the write callback.
+        uint64_t eventsWritten = 0; ///< Number of events handed to the write callback.
+        uint64_t stalls = 0;        ///< Number of times the render thread had to wait for a free slot.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] elementSize Size of one event element in bytes.
+     * @param[in] elementCount Maximum number of events per frame.
+     * @param[in] writeCallback Function called on the writer thread for every frame read back.
+     * @param[in] slotCount Number of frames that can be in flight (at least 2).
+     */
+    AsyncEventReadback(
+        ref<Device> pDevice,
+        uint32_t elementSize,
+        uint32_t elementCount,
+        WriteCallback writeCallback,
+        uint32_t slotCount = kDefaultSlotCount
+    );
+
+    /**
+     * Destructor.
+     * Flushes all frames in flight and blocks until the writer thread has terminated.
+     */
+    ~AsyncEventReadback();
+
+    /**
+     * Acquire the event buffer for the current frame. The UAV counter is reset to zero.
+     * Blocks if all slots are in flight.
+     * @return Structured buffer (with UAV counter) to append events to.
+     */
+    const ref<Buffer>& beginFrame(RenderContext* pRenderContext);
+
+    /**
+     * Schedule the readback of the buffer acquired by beginFrame().
+     * @param[in] frame Frame index passed on to the write callback.
+     */
+    void endFrame(RenderContext* pRenderContext, uint32_t frame);
+
+    /**
+     * Release the buffer acquired by beginFrame() without reading it back.
+     */
+    void cancelFrame();
+
+    /**
+     * Block until all scheduled frames have been handed to the write callback.
+     */
+    void flush(RenderContext* pRenderContext);
+
+    uint32_t getElementSize() const { return mElementSize; }
+    uint32_t getElementCount() const { return mElementCount; }
+
+    Stats getStats() const;
+
+private:
+    enum class SlotState
+    {
+        Free,           ///< Available for beginFrame().
+        Recording,      ///< Acquired by beginFrame(), waiting for endFrame().
+        CounterPending, ///< Counter copy submitted, waiting for the fence.
+        PayloadPending, ///< Payload copy submitted, waiting for the fence.
+        Writing,        ///< Payload handed to the writer thread.
+        Written,        ///< Writer thread is done, staging buffer can be unmapped.
+    };
+
+    struct Slot
+    {
+        ref<Buffer> pEventBuffer;
+        ref<Buffer> pCounterStaging;
+        ref<Buffer> pPayloadStaging;
+        SlotState state = SlotState::Free;
+        uint64_t fenceValue = 0;
+        uint32_t frame = 0;
+        uint32_t eventCount = 0;
+    };
+
+    struct WriteRequest
+    {
+        uint32_t slot;
+        uint32_t frame;
+        const void* pData;
+        size_t size;
+    };
+
+    /// Advance all in-flight slots as far as possible without blocking. Must be called with mMutex held.
+    void poll(RenderContext* pRenderContext, std::unique_lock<std::mutex>& lock);
+    /// Block until the oldest in-flight slot makes progress. Must be called with mMutex held.
+    void waitOldest(std::unique_lock<std::mutex>& lock);
+    void runWriter();
+
+    ref<Device> mpDevice;
+    ref<Fence> mpFence;
+    uint32_t mElementSize;
+    uint32_t mElementCount;
+    WriteCallback mWriteCallback;
+
+    std::vector<Slot> mSlots;
+    std::deque<uint32_t> mInFlight;      ///< Slot indices in submission order.
+    uint32_t mRecordingSlot = uint32_t(-1);
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<WriteRequest> mWriteQueue;
+    std::thread mWriterThread;
+    bool mTerminate = false;
+
+    uint64_t mStalls = 0;
+    std::atomic<uint64_t> mFramesWritten{0};
+    std::atomic<uint64_t> mBytesWritten{0};
+};
+
+/**
+ * Convert the statistics of an event pass to the dict returned by the `stats` property of its Python binding.
+ * @param[in] stats Statistics of the event readback.
+ * @param[in] storedBytes Bytes stored on disk, after encoding.
+ */
+FALCOR_API pybind11::dict toPython(const AsyncEventReadback::Stats& stats, uint64_t storedBytes);
+} // namespace Falcor
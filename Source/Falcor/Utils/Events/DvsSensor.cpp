@@ -0,0 +1,86 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DvsSensor.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+const double kPi = 3.14159265358979323846;
+
+/// Frames of the random streams of the per-pixel parameters, chosen to not collide with the noise of early frames.
+const uint32_t kThresholdOnStream = 0xfffffff0;
+const uint32_t kThresholdOffStream = 0xfffffff2;
+const uint32_t kLeakStream = 0xfffffff4;
+
+/// Standard normal random number of a pixel using the Box-Muller transform on two consecutive streams.
+double normal(uint32_t seed, uint32_t pixel, uint32_t stream)
+{
+    const double u1 = 1.0 - dvsUniform(seed, pixel, stream);
+    const double u2 = dvsUniform(seed, pixel, stream + 1);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * kPi * u2);
+}
+} // namespace
+
+DvsFrameConstants getDvsFrameConstants(const DvsSensorDesc& desc, uint32_t duration, double ticksPerSecond)
+{
+    DvsFrameConstants constants;
+    constants.dt = float(duration / ticksPerSecond);
+    constants.lowpassGain = float(2.0 * kPi * desc.cutoffHz * constants.dt);
+    // Each polarity has half the rate, capped so the ON and OFF ranges of the uniform number do not overlap.
+    constants.shotProbability = float(std::min(0.5, 0.5 * desc.shotNoiseRateHz * constants.dt));
+    constants.refractoryTicks = uint32_t(std::llround(desc.refractoryPeriod * ticksPerSecond));
+    return constants;
+}
+
+std::vector<float4> createDvsPixelParams(const DvsSensorDesc& desc, float contrastThreshold, uint32_t pixelCount)
+{
+    // Thresholds are clipped like in v2e to avoid floods of events from pixels with tiny thresholds.
+    const float kMinThreshold = 0.01f;
+
+    std::vector<float4> params(pixelCount);
+    for (uint32_t pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        float4& p = params[pixel];
+        p.x = contrastThreshold;
+        p.y = contrastThreshold;
+        p.z = desc.leakRateHz;
+        p.w = 0.f;
+        if (desc.thresholdSigma > 0.f)
+        {
+            p.x = std::max(kMinThreshold, float(contrastThreshold + desc.thresholdSigma * normal(desc.seed, pixel, kThresholdOnStream)));
+            p.y = std::max(kMinThreshold, float(contrastThreshold + desc.thresholdSigma * normal(desc.seed, pixel, kThresholdOffStream)));
+        }
+        if (desc.leakJitter > 0.f)
+            p.z = std::max(0.f, float(desc.leakRateHz * (1.0 + desc.leakJitter * normal(desc.seed, pixel, kLeakStream))));
+    }
+    return params;
+}
+} // namespace Falcor
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Non-idealities of a DVS sensor applied on top of the log-threshold event model, following v2e
+ * (Hu et al., "v2e: From Video Frames to Realistic DVS Events", 2021).
+ *
+ * All random numbers are derived from hashes of the seed, the pixel and the frame, so the CPU and GPU
+ * implementations produce the same events for the same seed.
+ */
+struct DvsSensorDesc
+{
+    bool enabled = false;
+    float thresholdSigma = 0.f;   ///< Standard deviation of the per-pixel ON and OFF thresholds around the contrast threshold.
+    float cutoffHz = 0.f;         ///< Photoreceptor low-pass cutoff frequency at full intensity, 0 disables the filter.
+    float leakRateHz = 0.f;       ///< Rate of leak (ON) events per pixel.
+    float leakJitter = 0.f;       ///< Relative standard deviation of the per-pixel leak rate.
+    float shotNoiseRateHz = 0.f;  ///< Rate of shot noise events per pixel, ON and OFF combined.
+    float refractoryPeriod = 0.f; ///< Minimum time between two events of a pixel in seconds.
+    uint32_t seed = 0;            ///< Seed of the per-pixel parameters and the noise.
+};
+
+/**
+ * Per-frame constants of the sensor model. Computed on the host for both implementations to keep them identical.
+ */
+struct DvsFrameConstants
+{
+    float dt = 0.f;                ///< Frame duration in seconds.
+    float lowpassGain = 0.f;       ///< 2 pi cutoff dt, the low-pass filter gain at full intensity.
+    float shotProbability = 0.f;   ///< Probability of a shot noise event of each polarity.
+    uint32_t refractoryTicks = 0;  ///< Refractory period in timestamp ticks.
+};
+
+/// Value of the last event time of pixels that did not emit an event yet.
+static constexpr uint32_t kDvsNoEvent = 0xffffffff;
+
+/**
+ * Compute the per-frame constants.
+ * @param[in] desc Sensor description.
+ * @param[in] duration Frame duration in timestamp ticks.
+ * @param[in] ticksPerSecond Timestamp ticks per second.
+ */
+FALCOR_API DvsFrameConstants getDvsFrameConstants(const DvsSensorDesc& desc, uint32_t duration, double ticksPerSecond);
+
+/**
+ * Create the per-pixel parameters (ON threshold, OFF threshold, leak rate in Hz, 0).
+ * @param[in] desc Sensor description.
+ * @param[in] contrastThreshold Mean of the thresholds.
+ * @param[in] pixelCount Number of pixels.
+ */
+FALCOR_API std::vector<float4> createDvsPixelParams(const DvsSensorDesc& desc, float contrastThreshold, uint32_t pixelCount);
+
+/// 32-bit hash by Robert Jenkins, same as jenkinsHash() in Utils/Math/HashUtils.slang.
+inline uint32_t dvsHash(uint32_t a)
+{
+    a = (a + 0x7ed55d16) + (a << 12);
+    a = (a ^ 0xc761c23c) ^ (a >> 19);
+    a = (a + 0x165667b1) + (a << 5);
+    a = (a + 0xd3a2646c) ^ (a << 9);
+    a = (a + 0xfd7046c5) + (a << 3);
+    a = (a ^ 0xb55a4f09) ^ (a >> 16);
+    return a;
+}
+
+/// Uniform random number in [0, 1) of a pixel and frame, same as dvsUniform() in DvsSensor.slangh.
+inline float dvsUniform(uint32_t seed, uint32_t pixel, uint32_t frame)
+{
+    const uint32_t h = dvsHash(dvsHash(dvsHash(seed) ^ pixel) ^ frame);
+    return float(h >> 8) * (1.f / 16777216.f);
+}
+} // namespace Falcor
@@ -0,0 +1,236 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventCheckpoint.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/RenderContext.h"
+#include "Core/API/Texture.h"
+#include "Utils/StringFormatters.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFileMagic = 0x50434546; // 'FECP'
+const uint32_t kFileVersion = 1;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frame;
+    uint32_t sectionCount;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+/// Layout of a texture section, followed by the size (uint64_t) and data of every subresource.
+struct TextureHeader
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t arraySize;
+    uint32_t mipCount;
+    uint32_t format;
+};
+
+void writeString(std::ofstream& stream, const std::string& str)
+{
+    const uint32_t length = (uint32_t)str.size();
+    stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    stream.write(str.data(), length);
+}
+
+bool readString(std::ifstream& stream, std::string& str)
+{
+    uint32_t length = 0;
+    if (!stream.read(reinterpret_cast<char*>(&length), sizeof(length)))
+        return false;
+    str.resize(length);
+    return bool(stream.read(str.data(), length));
+}
+
+TextureHeader getTextureHeader(const Texture* pTexture)
+{
+    return {
+        pTexture->getWidth(),
+        pTexture->getHeight(),
+        pTexture->getDepth(),
+        pTexture->getArraySize(),
+        pTexture->getMipCount(),
+        (uint32_t)pTexture->getFormat(),
+    };
+}
+} // namespace
+
+EventCheckpoint EventCheckpoint::load(const std::filesystem::path& path, const std::string& passType)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        FALCOR_THROW("Failed to open checkpoint file '{}'.", path);
+
+    FileHeader header = {};
+    std::string fileType;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kFileMagic)
+        FALCOR_THROW("'{}' is not a checkpoint file.", path);
+    if (header.version != kFileVersion)
+        FALCOR_THROW("Checkpoint file '{}' has version {}, expected {}.", path, header.version, kFileVersion);
+    if (!readString(stream, fileType))
+        FALCOR_THROW("Checkpoint file '{}' is truncated.", path);
+    if (fileType != passType)
+        FALCOR_THROW("Checkpoint file '{}' was saved by a {}, not a {}.", path, fileType, passType);
+
+    EventCheckpoint checkpoint(fileType, header.frame);
+    for (uint32_t i = 0; i < header.sectionCount; ++i)
+    {
+        std::string name;
+        uint64_t size = 0;
+        if (!readString(stream, name) || !stream.read(reinterpret_cast<char*>(&size), sizeof(size)))
+            FALCOR_THROW("Checkpoint file '{}' is truncated.", path);
+        std::vector<uint8_t>& data = checkpoint.mSections[name];
+        data.resize(size);
+        if (!stream.read(reinterpret_cast<char*>(data.data()), size))
+            FALCOR_THROW("Checkpoint file '{}' is truncated.", path);
+    }
+    return checkpoint;
+}
+
+void EventCheckpoint::save(const std::filesystem::path& path) const
+{
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            FALCOR_THROW("Failed to create checkpoint file '{}'.", tempPath);
+
+        const FileHeader header = {kFileMagic, kFileVersion, mFrame, (uint32_t)mSections.size()};
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeString(stream, mPassType);
+        for (const auto& [name, data] : mSections)
+        {
+            const uint64_t size = data.size();
+            writeString(stream, name);
+            stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            stream.write(reinterpret_cast<const char*>(data.data()), size);
+        }
+        if (!stream)
+            FALCOR_THROW("Failed to write checkpoint file '{}'.", tempPath);
+    }
+    std::filesystem::rename(tempPath, path);
+}
+
+void EventCheckpoint::setData(const std::string& name, const void* pData, size_t size)
+{
+    const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+    mSections[name].assign(pBytes, pBytes + size);
+}
+
+const std::vector<uint8_t>& EventCheckpoint::getData(const std::string& name) const
+{
+    auto it = mSections.find(name);
+    if (it == mSections.end())
+        FALCOR_THROW("Checkpoint of {} at frame {} has no section '{}'.", mPassType, mFrame, name);
+    return it->second;
+}
+
+void EventCheckpoint::storeTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture)
+{
+    FALCOR_CHECK(pTexture, "Checkpoint texture '{}' is missing.", name);
+    const TextureHeader header = getTextureHeader(pTexture);
+    std::vector<uint8_t>& data = mSections[name];
+    data.resize(sizeof(header));
+    std::memcpy(data.data(), &header, sizeof(header));
+    for (uint32_t i = 0; i < header.arraySize * header.mipCount; ++i)
+    {
+        const std::vector<uint8_t> subresource = pRenderContext->readTextureSubresource(pTexture, i);
+        const uint64_t size = subresource.size();
+        const size_t offset = data.size();
+        data.resize(offset + sizeof(size) + size);
+        std::memcpy(data.data() + offset, &size, sizeof(size));
+        std::memcpy(data.data() + offset + sizeof(size), subresource.data(), size);
+    }
+}
+
+void EventCheckpoint::restoreTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture) const
+{
+    FALCOR_CHECK(pTexture, "Checkpoint texture '{}' is missing.", name);
+    const std::vector<uint8_t>& data = getData(name);
+    const TextureHeader expected = getTextureHeader(pTexture);
+    TextureHeader header = {};
+    FALCOR_CHECK(data.size() >= sizeof(header), "Checkpoint section '{}' is not a texture.", name);
+    std::memcpy(&header, data.data(), sizeof(header));
+    FALCOR_CHECK(
+        std::memcmp(&header, &expected, sizeof(header)) == 0,
+        "Checkpoint texture '{}' is {}x{}x{} ({} slices, {} mips, {}), the pass uses {}x{}x{} ({} slices, {} mips, {}).",
+        name,
+        header.width,
+        header.height,
+        header.depth,
+        header.arraySize,
+        header.mipCount,
+        to_string(ResourceFormat(header.format)),
+        expected.width,
+        expected.height,
+        expected.depth,
+        expected.arraySize,
+        expected.mipCount,
+        to_string(ResourceFormat(expected.format))
+    );
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.arraySize * header.mipCount; ++i)
+    {
+        uint64_t size = 0;
+        FALCOR_CHECK(offset + sizeof(size) <= data.size(), "Checkpoint texture '{}' is truncated.", name);
+        std::memcpy(&size, data.data() + offset, sizeof(size));
+        offset += sizeof(size);
+        FALCOR_CHECK(offset + size <= data.size(), "Checkpoint texture '{}' is truncated.", name);
+        pRenderContext->updateSubresourceData(pTexture, i, data.data() + offset);
+        offset += size;
+    }
+}
+
+void EventCheckpoint::storeBuffer(RenderContext* pRenderContext, const std::string& name, const Buffer* pBuffer)
+{
+    FALCOR_CHECK(pBuffer, "Checkpoint buffer '{}' is missing.", name);
+    std::vector<uint8_t>& data = mSections[name];
+    data.resize(pBuffer->getSize());
+    pRenderContext->readBuffer(pBuffer, data.data(), 0, data.size());
+}
+
+void EventCheckpoint::restoreBuffer(RenderContext* pRenderContext, const std::string& name, const Buffer* pBuffer) const
+{
+    FALCOR_CHECK(pBuffer, "Checkpoint buffer '{}' is missing.", name);
+    const std::vector<uint8_t>& data = getData(name);
+    FALCOR_CHECK(
+        data.size() == pBuffer->getSize(), "Checkpoint buffer '{}' has {} bytes, the pass uses {}.", name, data.size(), pBuffer->getSize()
+    );
+    pRenderContext->updateBuffer(pBuffer, data.data(), 0, data.size());
+}
+} // namespace Falcor
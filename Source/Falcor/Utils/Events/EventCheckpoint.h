@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Error.h"
+#include <filesystem>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+namespace Falcor
+{
+class RenderContext;
+class Texture;
+class Buffer;
+
+/**
+ * Part of a sequence rendered by one process when a long sequence is split into shards.
+ *
+ * Frames are counted in the output frames of a pass (after its accumulation), the first frame of a sequence is 1.
+ * A shard renders the frames [beginFrame, endFrame), preceded either by a number of warm-up frames that rebuild the
+ * pass state, or by restoring a checkpoint saved at frame beginFrame - 1 by the previous shard. Events of warm-up
+ * frames are discarded, so the event streams of the shards can be concatenated (see pythons/EventStream.py).
+ */
+struct EventShardDesc
+{
+    uint32_t frameOffset = 0;              ///< Number of frames before the first frame rendered by the process.
+    uint32_t beginFrame = 0;               ///< First frame whose output is written.
+    uint32_t endFrame = 0;                 ///< End of the frames whose output is written, 0 for no limit.
+    std::filesystem::path loadCheckpoint;  ///< Checkpoint restored before the first frame, empty for none.
+    std::filesystem::path saveCheckpoint;  ///< Checkpoint written after checkpointFrame, empty for none.
+    uint32_t checkpointFrame = 0;          ///< Frame after which the checkpoint is saved, 0 for the last frame before endFrame.
+
+    /// True if the output of the frame is written.
+    bool isWritten(uint32_t frame) const { return frame >= beginFrame && (endFrame == 0 || frame < endFrame); }
+
+    /// True if the checkpoint is saved after the frame.
+    bool isCheckpointFrame(uint32_t frame) const
+    {
+        if (saveCheckpoint.empty())
+            return false;
+        return frame == (checkpointFrame != 0 ? checkpointFrame : endFrame - 1);
+    }
+};
+
+/**
+ * Snapshot of the state of an event pass after a frame, used to continue a sequence in another process.
+ *
+ * A checkpoint holds named sections of binary data: the contents of state textures and buffers and the values of
+ * counters. Textures store their size and format, restoring a checkpoint into a texture of a different size throws.
+ *
+ * File layout (all values little-endian): a 16 byte header with magic, version, frame and section count, the pass
+ * type as length and characters, then per section the name as length and characters, the data size and the data.
+ */
+class FALCOR_API EventCheckpoint
+{
+public:
+    /**
+     * Create an empty checkpoint.
+     * @param[in] passType Type of the pass that owns the state, checked when restoring.
+     * @param[in] frame Frame after which the state was taken.
+     */
+    EventCheckpoint(std::string passType, uint32_t frame) : mPassType(std::move(passType)), mFrame(frame) {}
+
+    /**
+     * Load a checkpoint file. Throws if the file cannot be read or belongs to a different pass type.
+     */
+    static EventCheckpoint load(const std::filesystem::path& path, const std::string& passType);
+
+    /**
+     * Save the checkpoint. The file is written under a temporary name and renamed, so an interrupted run does not
+     * leave a truncated checkpoint behind. Throws if the file cannot be written.
+     */
+    void save(const std::filesystem::path& path) const;
+
+    const std::string& getPassType() const { return mPassType; }
+    uint32_t getFrame() const { return mFrame; }
+    bool hasSection(const std::string& name) const { return mSections.count(name) != 0; }
+
+    void setData(const std::string& name, const void* pData, size_t size);
+    /// Get the data of a section. Throws if the section does not exist.
+    const std::vector<uint8_t>& getData(const std::string& name) const;
+
+    template<typename T>
+    void setValue(const std::string& name, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        setData(name, &value, sizeof(T));
+    }
+
+    /// Get a value stored with setValue(). Throws if the section does not exist or has a different size.
+    template<typename T>
+    T getValue(const std::string& name) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const std::vector<uint8_t>& data = getData(name);
+        FALCOR_CHECK(data.size() == sizeof(T), "Checkpoint section '{}' has {} bytes, expected {}.", name, data.size(), sizeof(T));
+        T value;
+        std::memcpy(&value, data.data(), sizeof(T));
+        return value;
+    }
+
+    /// Store all subresources of a texture. Waits for the GPU.
+    void storeTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture);
+    /// Restore a texture stored with storeTexture(). Throws if the size or format differ.
+    void restoreTexture(RenderContext* pRenderContext, const std::string& name, const Texture* pTexture) const;
+
+    /// Store the contents of a buffer. Waits for the GPU.
+    void storeBuffer(RenderContext* pRenderContext, const std::string& name, const Buffer* pBuffer);
+    /// Restore a buffer stored with storeBuffer(). Throws if the size differs.
+    void restoreBuffer(RenderContext* pRenderContext, const std::string& name, const Buffer* pBuffer) const;
+
+private:
+    std::string mPassType;
+    uint32_t mFrame = 0;
+    std::map<std::string, std::vector<uint8_t>> mSections;
+};
+} // namespace Falcor
@@ -0,0 +1,322 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventCodec.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define EVENT_CODEC_SSE2 1
+#include <emmintrin.h>
+#else
+#define EVENT_CODEC_SSE2 0
+#endif
+
+namespace Falcor
+{
+namespace
+{
+const uint64_t kKindEvent = 0;
+const uint64_t kKindRun = 1;
+const uint64_t kKindTime = 2;
+
+// Maximum size of a varint token in bytes (tokens hold at most 64 bits).
+const size_t kMaxTokenSize = 10;
+// Inputs smaller than this are sorted with std::sort instead of a radix sort.
+const size_t kRadixSortThreshold = 256;
+
+inline uint8_t* writeVarint(uint8_t* pDst, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        *pDst++ = uint8_t(v) | 0x80;
+        v >>= 7;
+    }
+    *pDst++ = uint8_t(v);
+    return pDst;
+}
+
+inline bool readVarint(const uint8_t*& pSrc, const uint8_t* pEnd, uint64_t& v)
+{
+    v = 0;
+    for (uint32_t shift = 0; shift < 64 && pSrc < pEnd; shift += 7)
+    {
+        uint8_t byte = *pSrc++;
+        v |= uint64_t(byte & 0x7f) << shift;
+        if (byte < 0x80)
+            return true;
+    }
+    return false;
+}
+
+bool isSorted(const uint32_t* pData, size_t count)
+{
+    size_t i = 1;
+#if EVENT_CODEC_SSE2
+    // SSE2 only has signed compares, flip the sign bits to compare unsigned values.
+    const __m128i bias = _mm_set1_epi32(int(0x80000000));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i prev = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i - 1)), bias);
+        __m128i cur = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + i)), bias);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi32(prev, cur)) != 0)
+            return false;
+    }
+#endif
+    for (; i < count; ++i)
+        if (pData[i - 1] > pData[i])
+            return false;
+    return true;
+}
+
+/// Number of elements starting at index i that continue a run, i.e. pData[j] == pData[j - 1] + 2, up to maxLength.
+size_t getRunLength(const uint32_t* pData, size_t i, size_t count, size_t maxLength)
+{
+    size_t end = std::min(count, i + maxLength);
+    size_t j = i + 1;
+#if EVENT_CODEC_SSE2
+    const __m128i two = _mm_set1_epi32(2);
+    for (; j + 4 <= end; j += 4)
+    {
+        __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + j - 1));
+        __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pData + j));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_sub_epi32(cur, prev), two)));
+        if (mask != 0xf)
+        {
+            // Advance to the first lane that breaks the run.
+            while (mask & 1)
+            {
+                ++j;
+                mask >>= 1;
+            }
+            return j - i;
+        }
+    }
+#endif
+    while (j < end && pData[j] == pData[j - 1] + 2)
+        ++j;
+    return j - i;
+}
+
+inline void emitRun(std::vector<uint2>& events, uint32_t time, uint32_t address, uint32_t count)
+{
+    for (uint32_t k = 0; k < count; ++k)
+        events.push_back({time, address + 2 * k});
+}
+} // namespace
+
+void EventCodec::encodeAddress32(const uint32_t* pAddresses, size_t count, uint32_t time, std::vector<uint8_t>& output)
+{
+    mAddresses.assign(pAddresses, pAddresses + count);
+    sortAddresses(mAddresses);
+    encodeSorted(mAddresses.data(), mAddresses.size(), time, output);
+}
+
+void EventCodec::encodeFrameAddress64(const uint2* pEvents, size_t count, std::vector<uint8_t>& output)
+{
+    if (count == 0)
+        return;
+
+    // Fast path for the common case of a chunk holding a single frame.
+    const uint32_t firstTime = pEvents[0].x;
+    bool singleTime = std::all_of(pEvents, pEvents + count, [firstTime](const uint2& e) { return e.x == firstTime; });
+    if (singleTime)
+    {
+        mAddresses.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            mAddresses[i] = pEvents[i].y;
+        sortAddresses(mAddresses);
+        encodeSorted(mAddresses.data(), count, firstTime, output);
+        return;
+    }
+
+    mKeys.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        mKeys[i] = (uint64_t(pEvents[i].x) << 32) | pEvents[i].y;
+    std::sort(mKeys.begin(), mKeys.end());
+
+    mAddresses.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        mAddresses[i] = uint32_t(mKeys[i]);
+
+    uint32_t time = 0;
+    for (size_t begin = 0; begin < count;)
+    {
+        const uint32_t segmentTime = uint32_t(mKeys[begin] >> 32);
+        size_t end = begin + 1;
+        while (end < count && uint32_t(mKeys[end] >> 32) == segmentTime)
+            ++end;
+        encodeSorted(mAddresses.data() + begin, end - begin, segmentTime - time, output);
+        time = segmentTime;
+        begin = end;
+    }
+}
+
+bool EventCodec::decode(const uint8_t* pData, size_t size, std::vector<uint2>& events)
+{
+    const uint8_t* pSrc = pData;
+    const uint8_t* pEnd = pData + size;
+    uint64_t time = 0;
+    uint64_t pixel = 0;
+
+    while (pSrc < pEnd)
+    {
+#if EVENT_CODEC_SSE2
+        // Fast path for 16 single byte tokens, which are common for dense events.
+        if (pEnd - pSrc >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc))) == 0)
+        {
+            for (const uint8_t* pBlockEnd = pSrc + 16; pSrc < pBlockEnd; ++pSrc)
+            {
+                const uint32_t v = *pSrc;
+                switch (v & 3)
+                {
+                case kKindEvent:
+                    pixel += v >> 3;
+                    events.push_back({uint32_t(time), uint32_t(pixel << 1) | ((v >> 2) & 1)});
+                    break;
+                case kKindRun:
+                {
+                    // The delta of a single byte run token is always zero.
+                    const uint32_t n = ((v >> 3) & 31) + 2;
+                    emitRun(events, uint32_t(time), uint32_t(pixel << 1) | ((v >> 2) & 1), n);
+                    pixel += n - 1;
+                    break;
+                }
+                case kKindTime:
+                    time += v >> 2;
+                    pixel = 0;
+                    break;
+                default:
+                    return false;
+                }
+            }
+            if (pixel > 0x7fffffff || time > 0xffffffff)
+                return false;
+            continue;
+        }
+#endif
+        uint64_t v;
+        if (!readVarint(pSrc, pEnd, v))
+            return false;
+
+        switch (v & 3)
+        {
+        case kKindEvent:
+            pixel += v >> 3;
+            if (pixel > 0x7fffffff)
+                return false;
+            events.push_back({uint32_t(time), uint32_t(pixel << 1) | uint32_t((v >> 2) & 1)});
+            break;
+        case kKindRun:
+        {
+            const uint32_t n = uint32_t((v >> 3) & 31) + 2;
+            pixel += v >> 8;
+            if (pixel + n - 1 > 0x7fffffff)
+                return false;
+            emitRun(events, uint32_t(time), uint32_t(pixel << 1) | uint32_t((v >> 2) & 1), n);
+            pixel += n - 1;
+            break;
+        }
+        case kKindTime:
+            time += v >> 2;
+            pixel = 0;
+            if (time > 0xffffffff)
+                return false;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+void EventCodec::sortAddresses(std::vector<uint32_t>& addresses)
+{
+    const size_t count = addresses.size();
+    // Addresses are appended by the GPU in nearly sorted order, skip the sort when possible.
+    if (isSorted(addresses.data(), count))
+        return;
+    if (count < kRadixSortThreshold)
+    {
+        std::sort(addresses.begin(), addresses.end());
+        return;
+    }
+
+    // LSD radix sort with 11 bit digits.
+    mScratch.resize(count);
+    uint32_t* pSrc = addresses.data();
+    uint32_t* pDst = mScratch.data();
+    for (uint32_t shift = 0; shift < 32; shift += 11)
+    {
+        uint32_t histogram[2048] = {};
+        for (size_t i = 0; i < count; ++i)
+            ++histogram[(pSrc[i] >> shift) & 2047];
+        // Skip passes where all elements share the same digit.
+        if (histogram[(pSrc[0] >> shift) & 2047] == count)
+            continue;
+        uint32_t sum = 0;
+        for (uint32_t& h : histogram)
+        {
+            uint32_t c = h;
+            h = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < count; ++i)
+            pDst[histogram[(pSrc[i] >> shift) & 2047]++] = pSrc[i];
+        std::swap(pSrc, pDst);
+    }
+    if (pSrc != addresses.data())
+        std::memcpy(addresses.data(), pSrc, count * sizeof(uint32_t));
+}
+
+void EventCodec::encodeSorted(const uint32_t* pAddresses, size_t count, uint32_t dt, std::vector<uint8_t>& output)
+{
+    // Reserve the worst case and trim afterwards to avoid per token bounds checks.
+    const size_t offset = output.size();
+    output.resize(offset + (count + 1) * kMaxTokenSize);
+    uint8_t* pDst = output.data() + offset;
+
+    pDst = writeVarint(pDst, (uint64_t(dt) << 2) | kKindTime);
+
+    uint64_t pixel = 0;
+    for (size_t i = 0; i < count;)
+    {
+        const uint32_t address = pAddresses[i];
+        const uint64_t delta = (address >> 1) - pixel;
+        const uint64_t p = address & 1;
+        const size_t n = getRunLength(pAddresses, i, count, kMaxRunLength);
+        if (n >= 2)
+            pDst = writeVarint(pDst, (delta << 8) | (uint64_t(n - 2) << 3) | (p << 2) | kKindRun);
+        else
+            pDst = writeVarint(pDst, (delta << 3) | (p << 2) | kKindEvent);
+        pixel = (address >> 1) + n - 1;
+        i += n;
+    }
+
+    output.resize(pDst - output.data());
+}
+} // namespace Falcor
@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Codec for the compact event encoding (EventEncoding::Compact).
+ *
+ * Events are sorted by (time, address) and stored as a sequence of LEB128 varint tokens.
+ * The two lowest bits of a token select its kind:
+ *  - Time (2):  v = dt << 2. Advances the current time by dt and resets the current pixel to 0.
+ *  - Event (0): v = delta << 3 | p << 2. One event with polarity bit p at pixel current + delta.
+ *  - Run (1):   v = delta << 8 | (n - 2) << 3 | p << 2. n (2 to 33) events with polarity bit p at consecutive
+ *               pixels starting at current + delta.
+ * After an event or run, the current pixel is the pixel of its last event. Addresses are (pixel << 1) | p
+ * as in the raw encodings. Every token is self-contained, so decoders can locate all tokens up front.
+ *
+ * The encoder keeps scratch buffers between calls, use one instance per thread.
+ */
+class FALCOR_API EventCodec
+{
+public:
+    /// Maximum number of events in a run token.
+    static constexpr uint32_t kMaxRunLength = 33;
+
+    /**
+     * Encode events sharing the same time (EventEncoding::Address32 payload).
+     * @param[in] pAddresses Event addresses.
+     * @param[in] count Number of events.
+     * @param[in] time Time of the events.
+     * @param[in,out] output Encoded data is appended to this buffer.
+     */
+    void encodeAddress32(const uint32_t* pAddresses, size_t count, uint32_t time, std::vector<uint8_t>& output);
+
+    /**
+     * Encode (time, address) events (EventEncoding::FrameAddress64 payload).
+     * @param[in] pEvents Events.
+     * @param[in] count Number of events.
+     * @param[in,out] output Encoded data is appended to this buffer.
+     */
+    void encodeFrameAddress64(const uint2* pEvents, size_t count, std::vector<uint8_t>& output);
+
+    /**
+     * Decode events.
+     * @param[in] pData Encoded data.
+     * @param[in] size Size of the encoded data in bytes.
+     * @param[in,out] events Decoded (time, address) events are appended to this buffer, sorted by time and address.
+     * @return True if successful, false if the data is malformed.
+     */
+    static bool decode(const uint8_t* pData, size_t size, std::vector<uint2>& events);
+
+private:
+    void sortAddresses(std::vector<uint32_t>& addresses);
+    void encodeSorted(const uint32_t* pAddresses, size_t count, uint32_t dt, std::vector<uint8_t>& output);
+
+    std::vector<uint32_t> mAddresses;
+    std::vector<uint32_t> mScratch;
+    std::vector<uint64_t> mKeys;
+};
+} // namespace Falcor
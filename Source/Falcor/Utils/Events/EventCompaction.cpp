@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventCompaction.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Utils/Events/EventCompaction.cs.slang";
+} // namespace
+
+EventCompaction::EventCompaction(ref<Device> pDevice, uint32_t elementSize)
+    : mpDevice(pDevice), mElementSize(elementSize), mPrefixSum(pDevice)
+{
+    FALCOR_CHECK(elementSize == 4 || elementSize == 8, "EventCompaction: element size must be 4 or 8 bytes, got {}.", elementSize);
+
+    DefineList defines;
+    defines.add("TILE_SIZE", std::to_string(kTileSize));
+    defines.add("EVENT_TYPE", elementSize == 4 ? "uint" : "uint2");
+    mpTileCountPass = ComputePass::create(mpDevice, kShaderFile, "tileCounts", defines);
+    mpScatterPass = ComputePass::create(mpDevice, kShaderFile, "scatter", defines);
+}
+
+void EventCompaction::resize(uint32_t pixelCount, uint32_t maxEventsPerPixel)
+{
+    FALCOR_CHECK(pixelCount > 0 && maxEventsPerPixel > 0, "EventCompaction: pixel count and events per pixel must be non-zero.");
+    if (pixelCount == mPixelCount && maxEventsPerPixel == mMaxEventsPerPixel)
+        return;
+
+    mPixelCount = pixelCount;
+    mMaxEventsPerPixel = maxEventsPerPixel;
+    mpSlots = mpDevice->createStructuredBuffer(
+        mElementSize,
+        pixelCount * maxEventsPerPixel,
+        ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+        MemoryType::DeviceLocal,
+        nullptr,
+        false
+    );
+    mpCounts = mpDevice->createStructuredBuffer(
+        sizeof(uint32_t),
+        pixelCount,
+        ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+        MemoryType::DeviceLocal,
+        nullptr,
+        false
+    );
+    mpTileOffsets = mpDevice->createBuffer(
+        div_round_up(pixelCount, kTileSize) * sizeof(uint32_t),
+        ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+        MemoryType::DeviceLocal,
+        nullptr
+    );
+}
+
+void EventCompaction::bindShaderData(const ShaderVar& var) const
+{
+    FALCOR_CHECK(mpSlots, "EventCompaction: resize() must be called before binding the event slots.");
+    var["slots"] = mpSlots;
+    var["counts"] = mpCounts;
+    var["maxEventsPerPixel"] = mMaxEventsPerPixel;
+}
+
+void EventCompaction::execute(RenderContext* pRenderContext, const ref<Buffer>& pEvents)
+{
+    FALCOR_PROFILE(pRenderContext, "EventCompaction::execute");
+
+    FALCOR_CHECK(mpSlots, "EventCompaction: resize() must be called before execute().");
+    FALCOR_CHECK(pEvents && pEvents->getStructSize() == mElementSize, "EventCompaction: event buffer must have {} byte elements.", mElementSize);
+    FALCOR_CHECK(pEvents->getUAVCounter(), "EventCompaction: event buffer must have a UAV counter.");
+
+    const uint32_t tileCount = div_round_up(mPixelCount, kTileSize);
+
+    // Pass 1: event count per tile.
+    {
+        auto var = mpTileCountPass->getRootVar();
+        var["CB"]["gPixelCount"] = mPixelCount;
+        var["gCounts"] = mpCounts;
+        var["gTileOffsets"] = mpTileOffsets;
+        mpTileCountPass->execute(pRenderContext, uint3(tileCount * kTileSize, 1, 1));
+    }
+
+    // Pass 2: tile offsets, the total count is copied to the UAV counter of the event buffer.
+    pRenderContext->uavBarrier(mpTileOffsets.get());
+    mPrefixSum.execute(pRenderContext, mpTileOffsets, tileCount, nullptr, pEvents->getUAVCounter(), 0);
+
+    // Pass 3: scatter the events of each tile.
+    {
+        auto var = mpScatterPass->getRootVar();
+        var["CB"]["gPixelCount"] = mPixelCount;
+        var["CB"]["gMaxEventsPerPixel"] = mMaxEventsPerPixel;
+        var["CB"]["gCapacity"] = pEvents->getElementCount();
+        var["gSlots"] = mpSlots;
+        var["gCounts"] = mpCounts;
+        var["gTileOffsets"] = mpTileOffsets;
+        var["gEvents"] = pEvents;
+        mpScatterPass->execute(pRenderContext, uint3(tileCount * kTileSize, 1, 1));
+    }
+}
+} // namespace Falcor
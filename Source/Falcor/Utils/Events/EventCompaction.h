@@ -0,0 +1,148 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/Pass/ComputePass.h"
+#include "Core/Program/ShaderVar.h"
+#include "Utils/Algorithm/PrefixSum.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+class RenderContext;
+
+/**
+ * Deterministic compaction of per-pixel event slots into an address-sorted event buffer.
+ *
+ * Instead of appending to a buffer with an atomic counter, event shaders write the events of each pixel to
+ * fixed slots and store the number of events of every pixel (see EventSlots.slangh). The compaction then
+ *  1. sums the event counts of each tile of kTileSize consecutive pixels,
+ *  2. computes the exclusive prefix sum over the tile counts (see PrefixSum),
+ *  3. scatters the events of each tile to its offset, scanning the pixel counts within the tile.
+ * The events end up ordered by pixel and slot independent of the GPU scheduling, and the total event count is
+ * written to the UAV counter of the event buffer, so it is read back exactly like an appended buffer.
+ *
+ * compact() is the CPU implementation of the same stages, producing identical output.
+ */
+class FALCOR_API EventCompaction
+{
+public:
+    /// Number of consecutive pixels per tile (one thread group per tile).
+    static constexpr uint32_t kTileSize = 1024;
+
+    /**
+     * Constructor. Throws an exception if creation failed.
+     * @param[in] pDevice GPU device.
+     * @param[in] elementSize Size of one event in bytes, 4 for uint and 8 for uint2 events.
+     */
+    EventCompaction(ref<Device> pDevice, uint32_t elementSize);
+
+    /**
+     * Allocate the event slots.
+     * @param[in] pixelCount Number of pixels.
+     * @param[in] maxEventsPerPixel Number of event slots per pixel.
+     */
+    void resize(uint32_t pixelCount, uint32_t maxEventsPerPixel);
+
+    /// Bind the event slots to a shader variable of type EventSlots.
+    void bindShaderData(const ShaderVar& var) const;
+
+    /**
+     * Compact the events written to the slots.
+     * @param[in] pRenderContext The render context.
+     * @param[in] pEvents Structured buffer with UAV counter the events are written to. The counter is set to the
+     *                    number of events, events beyond the buffer size are dropped.
+     */
+    void execute(RenderContext* pRenderContext, const ref<Buffer>& pEvents);
+
+    uint32_t getElementSize() const { return mElementSize; }
+    uint32_t getPixelCount() const { return mPixelCount; }
+    uint32_t getMaxEventsPerPixel() const { return mMaxEventsPerPixel; }
+    const ref<Buffer>& getSlotBuffer() const { return mpSlots; }
+    const ref<Buffer>& getCountBuffer() const { return mpCounts; }
+
+    /**
+     * Compact event slots on the CPU.
+     * @param[in] pSlots Event slots, maxEventsPerPixel per pixel.
+     * @param[in] pCounts Number of events per pixel, clamped to maxEventsPerPixel.
+     * @param[in] pixelCount Number of pixels.
+     * @param[in] maxEventsPerPixel Number of event slots per pixel.
+     * @param[in,out] events Events are appended to this buffer.
+     * @return Number of events.
+     */
+    template<typename T>
+    static size_t compact(const T* pSlots, const uint32_t* pCounts, uint32_t pixelCount, uint32_t maxEventsPerPixel, std::vector<T>& events)
+    {
+        // Tile counts and their exclusive prefix sum.
+        const uint32_t tileCount = (pixelCount + kTileSize - 1) / kTileSize;
+        std::vector<size_t> tileOffsets(tileCount);
+        size_t total = 0;
+        for (uint32_t tile = 0; tile < tileCount; ++tile)
+        {
+            tileOffsets[tile] = total;
+            const uint32_t end = std::min(pixelCount, (tile + 1) * kTileSize);
+            for (uint32_t pixel = tile * kTileSize; pixel < end; ++pixel)
+                total += std::min(pCounts[pixel], maxEventsPerPixel);
+        }
+
+        // Scatter.
+        const size_t firstEvent = events.size();
+        events.resize(firstEvent + total);
+        for (uint32_t tile = 0; tile < tileCount; ++tile)
+        {
+            size_t offset = firstEvent + tileOffsets[tile];
+            const uint32_t end = std::min(pixelCount, (tile + 1) * kTileSize);
+            for (uint32_t pixel = tile * kTileSize; pixel < end; ++pixel)
+            {
+                const uint32_t count = std::min(pCounts[pixel], maxEventsPerPixel);
+                const T* pPixelSlots = pSlots + size_t(pixel) * maxEventsPerPixel;
+                std::copy(pPixelSlots, pPixelSlots + count, events.begin() + offset);
+                offset += count;
+            }
+        }
+        return total;
+    }
+
+private:
+    ref<Device> mpDevice;
+    uint32_t mElementSize;
+    uint32_t mPixelCount = 0;
+    uint32_t mMaxEventsPerPixel = 0;
+
+    ref<ComputePass> mpTileCountPass;
+    ref<ComputePass> mpScatterPass;
+    PrefixSum mPrefixSum;
+
+    ref<Buffer> mpSlots;       ///< Event slots, mMaxEventsPerPixel per pixel.
+    ref<Buffer> mpCounts;      ///< Number of events per pixel.
+    ref<Buffer> mpTileOffsets; ///< Event count per tile, turned into offsets by the prefix sum.
+};
+} // namespace Falcor
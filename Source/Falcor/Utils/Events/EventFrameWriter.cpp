@@ -0,0 +1,84 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventFrameWriter.h"
+#include "Core/Error.h"
+#include <fmt/format.h>
+#include <fstream>
+
+namespace Falcor
+{
+void EventFrameWriter::open(const Desc& desc, uint2 frameDim, uint32_t frame)
+{
+    FALCOR_CHECK(
+        desc.encoding == EventEncoding::Address32 || desc.encoding == EventEncoding::FrameAddress64,
+        "EventFrameWriter: events must be written as Address32 or FrameAddress64."
+    );
+    mDesc = desc;
+    if (mDesc.outputFormat != EventOutputFormat::Stream)
+        return;
+
+    // A resolution change closes the current stream and continues in a new file.
+    std::string filename = mpStream ? fmt::format("events-{}.evs", frame) : "events.evs";
+    EventStreamDesc streamDesc;
+    streamDesc.width = frameDim.x;
+    streamDesc.height = frameDim.y;
+    streamDesc.timeScale = mDesc.timeScale;
+    streamDesc.encoding = mDesc.compact ? EventEncoding::Compact : mDesc.encoding;
+    streamDesc.polarity = mDesc.polarity;
+    mpStream = std::make_unique<EventStreamWriter>(mDesc.directory / filename, streamDesc);
+}
+
+void EventFrameWriter::write(uint32_t frame, uint64_t timestamp, const void* pData, size_t size)
+{
+    if (mDesc.outputFormat == EventOutputFormat::Files)
+    {
+        std::filesystem::path filename = mDesc.directory / fmt::format("data-{}.bin", frame);
+        std::ofstream file(filename, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pData), size);
+        file.close();
+        mStoredBytes += size;
+        return;
+    }
+
+    FALCOR_CHECK(mpStream, "EventFrameWriter: no stream is open.");
+    const bool address32 = mDesc.encoding == EventEncoding::Address32;
+    const uint32_t eventCount = uint32_t(size / (address32 ? sizeof(uint32_t) : sizeof(uint2)));
+    if (mDesc.compact)
+    {
+        mEncodedEvents.clear();
+        if (address32)
+            mCodec.encodeAddress32(reinterpret_cast<const uint32_t*>(pData), eventCount, frame, mEncodedEvents);
+        else
+            mCodec.encodeFrameAddress64(reinterpret_cast<const uint2*>(pData), eventCount, mEncodedEvents);
+        pData = mEncodedEvents.data();
+        size = mEncodedEvents.size();
+    }
+    mpStream->appendChunk(frame, timestamp, eventCount, pData, size);
+    mStoredBytes += size;
+}
+} // namespace Falcor
@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "EventCodec.h"
+#include "EventStreamFile.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Writes the event frames read back by AsyncEventReadback to disk.
+ *
+ * With EventOutputFormat::Stream the frames are appended as chunks to an event stream file, encoded with EventCodec
+ * if compact events are enabled. With EventOutputFormat::Files every frame is written raw to data-<frame>.bin.
+ * open() is called on the render thread while no frame is in flight, write() on the readback writer thread.
+ */
+class FALCOR_API EventFrameWriter
+{
+public:
+    struct Desc
+    {
+        std::filesystem::path directory;
+        EventOutputFormat outputFormat = EventOutputFormat::Stream;
+        /// Layout of the events passed to write(), either Address32 or FrameAddress64.
+        EventEncoding encoding = EventEncoding::FrameAddress64;
+        /// Store the events with EventEncoding::Compact instead of the layout above.
+        bool compact = true;
+        EventPolarity polarity = EventPolarity::OddIsOn;
+        double timeScale = 1.0; ///< Number of timestamp ticks per second.
+    };
+
+    /**
+     * Open the output for a frame size. The first stream is written to events.evs. A later call, after a resolution
+     * change, closes it and continues in events-<frame>.evs.
+     * @param[in] desc Output description.
+     * @param[in] frameDim Frame size in pixels.
+     * @param[in] frame Current frame, used to name the continued stream.
+     */
+    void open(const Desc& desc, uint2 frameDim, uint32_t frame);
+
+    /**
+     * Write the events of a frame.
+     * @param[in] frame Render frame that produced the events.
+     * @param[in] timestamp Timestamp of the chunk in ticks (only used with EventOutputFormat::Stream).
+     * @param[in] pData Events in the layout given by Desc::encoding.
+     * @param[in] size Size of the events in bytes.
+     */
+    void write(uint32_t frame, uint64_t timestamp, const void* pData, size_t size);
+
+    /// Close the stream. Does nothing if no stream is open.
+    void close() { mpStream.reset(); }
+
+    /// Get the number of bytes stored on disk so far, after encoding.
+    uint64_t getStoredBytes() const { return mStoredBytes; }
+
+private:
+    Desc mDesc;
+    std::unique_ptr<EventStreamWriter> mpStream;
+    /// Encoder and scratch buffer for compact event streams (only used on the readback writer thread)
+    EventCodec mCodec;
+    std::vector<uint8_t> mEncodedEvents;
+    /// Bytes stored on disk (updated on the readback writer thread)
+    std::atomic<uint64_t> mStoredBytes{0};
+};
+} // namespace Falcor
@@ -0,0 +1,629 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventSimulator.h"
+#include "Core/Error.h"
+#include "Core/API/PythonHelpers.h"
+#include "Utils/BlockStorage/BlockStorageReader.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kRecentCount = 5;
+
+/// Number of row ranges per worker thread, more ranges balance frames with uneven event density.
+const uint32_t kRangesPerThread = 4;
+} // namespace
+
+EventSimulator::EventSimulator(const EventSimulatorDesc& desc, uint32_t threadCount) : mDesc(desc), mThreadPool(threadCount)
+{
+    FALCOR_CHECK(all(desc.frameDim > 0u), "Invalid frame dimension {}.", desc.frameDim);
+    FALCOR_CHECK(desc.channelCount == 1 || desc.channelCount == 4, "Invalid channel count {}, must be 1 or 4.", desc.channelCount);
+    FALCOR_CHECK(desc.toleranceEvents < kRecentCount, "Invalid tolerance {}, must be less than {}.", desc.toleranceEvents, kRecentCount);
+    FALCOR_CHECK(desc.window > 0, "Invalid window size {}.", desc.window);
+    FALCOR_CHECK(!desc.interpolate || desc.model == EventModel::LogThreshold, "Event interpolation requires the LogThreshold model.");
+    FALCOR_CHECK(!desc.interpolate || desc.maxEventsPerFrame > 0, "Invalid maximum number of events per frame {}.", desc.maxEventsPerFrame);
+    FALCOR_CHECK(!desc.sensor.enabled || desc.interpolate, "The sensor model requires event interpolation.");
+    FALCOR_CHECK(
+        desc.sensor.thresholdSigma >= 0.f && desc.sensor.cutoffHz >= 0.f && desc.sensor.leakRateHz >= 0.f && desc.sensor.leakJitter >= 0.f &&
+            desc.sensor.shotNoiseRateHz >= 0.f && desc.sensor.refractoryPeriod >= 0.f,
+        "Invalid sensor parameters, all rates and periods must be non-negative."
+    );
+    FALCOR_CHECK(desc.ticksPerSecond > 0.0, "Invalid ticks per second {}.", desc.ticksPerSecond);
+    FALCOR_CHECK(desc.tau > 0.f, "Invalid time constant {}.", desc.tau);
+
+    mPixelCount = size_t(desc.frameDim.x) * desc.frameDim.y;
+    mPolarity.resize(mPixelCount);
+    if (desc.sensor.enabled)
+        mPixelParams = createDvsPixelParams(desc.sensor, desc.contrastThreshold, uint32_t(mPixelCount));
+    reset();
+}
+
+void EventSimulator::reset()
+{
+    // The passes start from zero-initialized textures and buffers.
+    mFrameIndex = 0;
+    mPrevFrame = 0;
+    mLastEvent.clear();
+    for (uint32_t i = 0; i < kRecentCount; ++i)
+    {
+        mRecentSum[i].clear();
+        mRecentCount[i].clear();
+    }
+    mHistory.clear();
+    mInternalState.clear();
+    mLastLog.clear();
+    mLastEventTime.clear();
+    mPotential.clear();
+
+    switch (mDesc.model)
+    {
+    case EventModel::RatioThreshold:
+        mLastEvent.resize(mPixelCount, 0.f);
+        for (uint32_t i = 0; i < kRecentCount; ++i)
+        {
+            mRecentSum[i].resize(mPixelCount, 0.f);
+            mRecentCount[i].resize(mPixelCount, 0);
+        }
+        break;
+    case EventModel::LogThreshold:
+        mHistory.resize(mDesc.window * (mDesc.channelCount == 4 ? 3 : 1), std::vector<float>(mPixelCount, 0.f));
+        mInternalState.resize(mPixelCount, 0.f);
+        if (mDesc.interpolate)
+            mLastLog.resize(mPixelCount, 0.f);
+        if (mDesc.sensor.enabled)
+            mLastEventTime.resize(mPixelCount, kDvsNoEvent);
+        break;
+    case EventModel::LeakyIntegrateFire:
+        mPotential.resize(mPixelCount, 0.f);
+        break;
+    default:
+        FALCOR_THROW("Unknown event model {}.", uint32_t(mDesc.model));
+    }
+}
+
+size_t EventSimulator::simulate(const float* pFrame, uint32_t frame, std::vector<uint2>& events)
+{
+    const auto start = CpuTimer::getCurrentTimePoint();
+
+    const uint32_t height = mDesc.frameDim.y;
+    const uint32_t rangeCount = std::min(height, std::max(1u, mThreadPool.get_thread_count() * kRangesPerThread));
+    const uint32_t rowsPerRange = (height + rangeCount - 1) / rangeCount;
+    mRangeEvents.resize(rangeCount);
+    mThreadPool
+        .parallelize_loop(
+            rangeCount,
+            [&](uint32_t begin, uint32_t end)
+            {
+                for (uint32_t range = begin; range < end; ++range)
+                {
+                    const uint32_t rowBegin = std::min(height, range * rowsPerRange);
+                    const uint32_t rowEnd = std::min(height, rowBegin + rowsPerRange);
+                    simulateRows(pFrame, frame, rowBegin, rowEnd, mRangeEvents[range]);
+                }
+            }
+        )
+        .get();
+    mFrameIndex++;
+    mPrevFrame = frame;
+
+    // Ranges are concatenated in order, so events are sorted by address.
+    const size_t firstEvent = events.size();
+    for (const auto& rangeEvents : mRangeEvents)
+        events.insert(events.end(), rangeEvents.begin(), rangeEvents.end());
+    const size_t eventCount = events.size() - firstEvent;
+    if (mDesc.interpolate)
+    {
+        std::sort(
+            events.begin() + firstEvent,
+            events.end(),
+            [](uint2 a, uint2 b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+        );
+    }
+
+    mStats.frames++;
+    mStats.pixelFrames += mPixelCount;
+    mStats.events += eventCount;
+    mStats.seconds += CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) * 1e-3;
+    return eventCount;
+}
+
+size_t EventSimulator::simulate(const BlockStorageReader& reader, uint32_t firstFrame, uint32_t frameCount, std::vector<uint2>& events)
+{
+    FALCOR_CHECK(mDesc.model != EventModel::LeakyIntegrateFire, "The LeakyIntegrateFire model can't simulate block storage frames.");
+    const BlockFormat format = reader.getDesc().format;
+    FALCOR_CHECK(
+        format != BlockFormat::LogLuma16 && format != BlockFormat::LogLuma8,
+        "Block storage format '{}' does not hold linear values.",
+        format
+    );
+    FALCOR_CHECK(
+        all(reader.getDim().xy() == mDesc.frameDim),
+        "Block storage frame dimension {} does not match the simulation frame dimension {}.",
+        reader.getDim().xy(),
+        mDesc.frameDim
+    );
+    FALCOR_CHECK(
+        reader.getChannelCount() == mDesc.channelCount,
+        "Block storage channel count {} does not match the simulation channel count {}.",
+        reader.getChannelCount(),
+        mDesc.channelCount
+    );
+    FALCOR_CHECK(
+        firstFrame <= reader.getDim().z && frameCount <= reader.getDim().z - firstFrame,
+        "Frames {} to {} are out of range, the storage holds {} frames.",
+        firstFrame,
+        uint64_t(firstFrame) + frameCount,
+        reader.getDim().z
+    );
+
+    std::vector<float> frame(mPixelCount * mDesc.channelCount);
+    size_t eventCount = 0;
+    for (uint32_t z = firstFrame; z < firstFrame + frameCount; ++z)
+    {
+        reader.readSlice(z, frame.data());
+        eventCount += simulate(frame.data(), z, events);
+    }
+    return eventCount;
+}
+
+void EventSimulator::simulateRows(const float* pFrame, uint32_t frame, uint32_t rowBegin, uint32_t rowEnd, std::vector<uint2>& events)
+{
+    const size_t begin = size_t(rowBegin) * mDesc.frameDim.x;
+    const size_t end = size_t(rowEnd) * mDesc.frameDim.x;
+    events.clear();
+    switch (mDesc.model)
+    {
+    case EventModel::RatioThreshold:
+        simulateRatioThreshold(pFrame, begin, end);
+        break;
+    case EventModel::LogThreshold:
+        simulateLogThreshold(pFrame, frame, begin, end, events);
+        break;
+    case EventModel::LeakyIntegrateFire:
+        simulateLeakyIntegrateFire(pFrame, begin, end);
+        break;
+    }
+
+    // Interpolated events are emitted by the model.
+    if (mDesc.interpolate)
+        return;
+    for (size_t i = begin; i < end; ++i)
+        if (mPolarity[i] != 0)
+            events.push_back({frame, uint32_t(i) * 2 + (mPolarity[i] > 0 ? 1 : 0)});
+}
+
+void EventSimulator::simulateRatioThreshold(const float* pFrame, size_t begin, size_t end)
+{
+    const uint32_t C = mDesc.channelCount;
+    const float threshold = mDesc.ratioThreshold;
+    const uint32_t tolerance = mDesc.toleranceEvents;
+    const uint32_t need = mDesc.needAccumulatedEvents;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        const float* pPixel = pFrame + i * C;
+        const float nowI = C == 4 ? 0.299f * pPixel[0] + 0.587f * pPixel[1] + 0.114f * pPixel[2] : pPixel[0];
+        const float preI = mLastEvent[i];
+        for (uint32_t k = 0; k < kRecentCount; ++k)
+        {
+            mRecentSum[k][i] += nowI;
+            mRecentCount[k][i]++;
+        }
+
+        // Polarity 1 is a brightness increase, which the shader calls type false.
+        const float diff = nowI / preI;
+        int8_t polarity = 0;
+        if (diff > threshold)
+            polarity = 1;
+        else if (diff < 1.0f / threshold)
+            polarity = -1;
+
+        const int8_t lastPolarity = mRecentSum[0][i] > preI * float(mRecentCount[0][i]) ? 1 : -1;
+        if (polarity == 0 || polarity != lastPolarity)
+        {
+            // Miss: shift the recent status by one frame.
+            for (uint32_t k = kRecentCount - 1; k > 0; --k)
+            {
+                mRecentSum[k][i] = mRecentSum[k - 1][i];
+                mRecentCount[k][i] = mRecentCount[k - 1][i];
+            }
+            mRecentSum[0][i] = 0.f;
+            mRecentCount[0][i] = 0;
+            mPolarity[i] = 0;
+            continue;
+        }
+
+        if (mRecentCount[tolerance][i] == need)
+        {
+            mLastEvent[i] = mRecentSum[tolerance][i] / float(need);
+            for (uint32_t k = 0; k < kRecentCount; ++k)
+            {
+                mRecentSum[k][i] = 0.f;
+                mRecentCount[k][i] = 0;
+            }
+            mPolarity[i] = polarity;
+        }
+        else
+        {
+            mPolarity[i] = 0;
+        }
+    }
+}
+
+void EventSimulator::simulateLogThreshold(const float* pFrame, uint32_t frame, size_t begin, size_t end, std::vector<uint2>& events)
+{
+    const uint32_t C = mDesc.channelCount;
+    const uint32_t channels = C == 4 ? 3 : 1;
+    const uint32_t window = mDesc.window;
+    const uint32_t newest = mFrameIndex % window;
+    const float linLogThreshold = mDesc.linLogThreshold;
+    const float f = (1.f / linLogThreshold) * std::log(linLogThreshold);
+    const float step = mDesc.contrastThreshold;
+    const float rounding = 1e8f;
+    // The first frame after a reset has no previous frame, its events are stamped with its own time.
+    const uint32_t prevFrame = mFrameIndex > 0 ? mPrevFrame : frame;
+    const float duration = float(frame - prevFrame);
+    const uint32_t maxEvents = mDesc.maxEventsPerFrame;
+    const DvsFrameConstants sensor = getDvsFrameConstants(mDesc.sensor, frame - prevFrame, mDesc.ticksPerSecond);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        // Box filter over the window, summed from the oldest to the newest frame as in the shader.
+        const float* pPixel = pFrame + i * C;
+        float color[3];
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            mHistory[newest * channels + c][i] = pPixel[c];
+            float sum = 0.f;
+            for (uint32_t k = 1; k <= window; ++k)
+                sum += mHistory[((newest + k) % window) * channels + c][i];
+            color[c] = sum / float(window);
+        }
+
+        const float x = (channels == 3 ? 0.2126f * color[0] + 0.7152f * color[1] + 0.0722f * color[2] : color[0]) * 255.f;
+        float y = x <= linLogThreshold ? x * f : std::log(x);
+        y = std::nearbyint(y * rounding) / rounding;
+
+        float& state = mInternalState[i];
+        if (mDesc.sensor.enabled)
+        {
+            simulateSensor(i, x, y, prevFrame, frame, sensor, events);
+            continue;
+        }
+        if (mDesc.interpolate)
+        {
+            // Emit the crossings of the luminance interpolated from the previous frame, each at the level it crosses.
+            const float yPrev = mLastLog[i];
+            mLastLog[i] = y;
+            const float dy = y - yPrev;
+            auto emit = [&](uint32_t polarityBit)
+            {
+                const float t = dy != 0.f ? std::clamp((state - yPrev) / dy, 0.f, 1.f) : 0.f;
+                events.push_back({prevFrame + uint32_t(std::nearbyint(t * duration)), uint32_t(i) * 2 + polarityBit});
+            };
+            uint32_t count = 0;
+            for (; count < maxEvents && state < y - step; ++count)
+            {
+                state += step;
+                emit(1);
+            }
+            for (; count < maxEvents && state > y + step; ++count)
+            {
+                state -= step;
+                emit(0);
+            }
+            continue;
+        }
+
+        if (state < y - step)
+        {
+            state += step;
+            mPolarity[i] = 1;
+        }
+        else if (state > y + step)
+        {
+            state -= step;
+            mPolarity[i] = -1;
+        }
+        else
+        {
+            mPolarity[i] = 0;
+        }
+    }
+}
+
+void EventSimulator::simulateSensor(
+    size_t i,
+    float x,
+    float y,
+    uint32_t prevFrame,
+    uint32_t frame,
+    const DvsFrameConstants& constants,
+    std::vector<uint2>& events
+)
+{
+    float& lp = mLastLog[i];
+    float& base = mInternalState[i];
+    if (mFrameIndex == 0)
+    {
+        lp = y;
+        base = y;
+        return;
+    }
+
+    const float4 params = mPixelParams[i];
+    const uint32_t address = uint32_t(i) * 2;
+    const uint32_t maxEvents = mDesc.maxEventsPerFrame;
+
+    // Photoreceptor low-pass filter with a bandwidth proportional to the intensity.
+    const float yPrev = lp;
+    if (constants.lowpassGain > 0.f)
+    {
+        const float eps = std::min(1.f, (x + 20.f) / 275.f * constants.lowpassGain);
+        lp = (1.f - eps) * lp + eps * y;
+    }
+    else
+    {
+        lp = y;
+    }
+    const float dy = lp - yPrev;
+
+    // Leak events are ON events caused by the reference level drifting down.
+    base -= params.z * constants.dt * params.x;
+
+    const float duration = float(frame - prevFrame);
+    auto getCrossingTime = [&](float level)
+    {
+        const float t = dy != 0.f ? std::clamp((level - yPrev) / dy, 0.f, 1.f) : 0.f;
+        return prevFrame + uint32_t(std::nearbyint(t * duration));
+    };
+
+    // Threshold crossings, stopped by the refractory period of the last event.
+    uint32_t& last = mLastEventTime[i];
+    uint32_t count = 0;
+    for (; count < maxEvents && base < lp - params.x; ++count)
+    {
+        const float level = base + params.x;
+        const uint32_t t = getCrossingTime(level);
+        if (last != kDvsNoEvent && t - last < constants.refractoryTicks)
+            break;
+        base = level;
+        last = t;
+        events.push_back({t, address + 1});
+    }
+    for (; count < maxEvents && base > lp + params.y; ++count)
+    {
+        const float level = base - params.y;
+        const uint32_t t = getCrossingTime(level);
+        if (last != kDvsNoEvent && t - last < constants.refractoryTicks)
+            break;
+        base = level;
+        last = t;
+        events.push_back({t, address});
+    }
+
+    // Shot noise events at the frame time.
+    const float u = dvsUniform(mDesc.sensor.seed, uint32_t(i), mFrameIndex);
+    const bool on = u < constants.shotProbability;
+    const bool off = u >= 1.f - constants.shotProbability;
+    if ((on || off) && count < maxEvents && (last == kDvsNoEvent || frame - last >= constants.refractoryTicks))
+    {
+        base += on ? params.x : -params.y;
+        last = frame;
+        events.push_back({frame, address + (on ? 1 : 0)});
+    }
+}
+
+void EventSimulator::simulateLeakyIntegrateFire(const float* pFrame, size_t begin, size_t end)
+{
+    const uint32_t C = mDesc.channelCount;
+    const uint32_t width = mDesc.frameDim.x;
+    const uint32_t height = mDesc.frameDim.y;
+    const float tau = mDesc.tau;
+    const float threshold = mDesc.threshold;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        // The network output is indexed like in NetworkOutput.cs.slang, the state and events are row-major.
+        const size_t input = (i % width) * height + i / width;
+        const float x = math::float16ToFloat32(math::float32ToFloat16(pFrame[input * C]));
+        float v = mPotential[i];
+        v = v * (1.f - 1.f / tau) + x;
+        const float posSpike = v >= threshold ? 1.f : 0.f;
+        const float negSpike = v <= -threshold ? 1.f : 0.f;
+        v = v - (posSpike - negSpike) * threshold;
+        mPotential[i] = v;
+        const float spike = posSpike - negSpike;
+        mPolarity[i] = spike > 0.f ? 1 : (spike < 0.f ? -1 : 0);
+    }
+}
+
+namespace
+{
+/// Create a numpy array of shape (N, 2) holding the events.
+pybind11::ndarray<pybind11::numpy> eventsToNumpy(std::vector<uint2>&& events)
+{
+    auto pEvents = new std::vector<uint2>(std::move(events));
+    pybind11::capsule owner(pEvents, [](void* p) noexcept { delete reinterpret_cast<std::vector<uint2>*>(p); });
+    pybind11::size_t shape[2] = {pEvents->size(), 2};
+    return pybind11::ndarray<pybind11::numpy>(
+        pEvents->data(), 2, shape, owner, nullptr, pybind11::dtype<uint32_t>(), pybind11::device::cpu::value
+    );
+}
+} // namespace
+
+FALCOR_SCRIPT_BINDING(EventSimulator)
+{
+    using namespace pybind11::literals;
+
+    FALCOR_SCRIPT_BINDING_DEPENDENCY(BlockStorageReader)
+
+    pybind11::falcor_enum<EventModel>(m, "EventModel");
+
+    pybind11::class_<EventSimulator> simulator(m, "EventSimulator");
+    simulator.def(
+        pybind11::init(
+            [](EventModel model,
+               uint2 frame_dim,
+               uint32_t channel_count,
+               float ratio_threshold,
+               uint32_t need_accumulated_events,
+               uint32_t tolerance_events,
+               uint32_t window,
+               float contrast_threshold,
+               float lin_log_threshold,
+               bool interpolate,
+               uint32_t max_events_per_frame,
+               double ticks_per_second,
+               bool sensor,
+               float threshold_sigma,
+               float cutoff_hz,
+               float leak_rate_hz,
+               float leak_jitter,
+               float shot_noise_rate_hz,
+               float refractory_period,
+               uint32_t seed,
+               float tau,
+               float threshold,
+               uint32_t thread_count)
+            {
+                EventSimulatorDesc desc;
+                desc.model = model;
+                desc.frameDim = frame_dim;
+                desc.channelCount = channel_count;
+                desc.ratioThreshold = ratio_threshold;
+                desc.needAccumulatedEvents = need_accumulated_events;
+                desc.toleranceEvents = tolerance_events;
+                desc.window = window;
+                desc.contrastThreshold = contrast_threshold;
+                desc.linLogThreshold = lin_log_threshold;
+                desc.interpolate = interpolate;
+                desc.maxEventsPerFrame = max_events_per_frame;
+                desc.ticksPerSecond = ticks_per_second;
+                desc.sensor.enabled = sensor;
+                desc.sensor.thresholdSigma = threshold_sigma;
+                desc.sensor.cutoffHz = cutoff_hz;
+                desc.sensor.leakRateHz = leak_rate_hz;
+                desc.sensor.leakJitter = leak_jitter;
+                desc.sensor.shotNoiseRateHz = shot_noise_rate_hz;
+                desc.sensor.refractoryPeriod = refractory_period;
+                desc.sensor.seed = seed;
+                desc.tau = tau;
+                desc.threshold = threshold;
+                return std::make_unique<EventSimulator>(desc, thread_count);
+            }
+        ),
+        "model"_a,
+        "frame_dim"_a,
+        "channel_count"_a = EventSimulatorDesc().channelCount,
+        "ratio_threshold"_a = EventSimulatorDesc().ratioThreshold,
+        "need_accumulated_events"_a = EventSimulatorDesc().needAccumulatedEvents,
+        "tolerance_events"_a = EventSimulatorDesc().toleranceEvents,
+        "window"_a = EventSimulatorDesc().window,
+        "contrast_threshold"_a = EventSimulatorDesc().contrastThreshold,
+        "lin_log_threshold"_a = EventSimulatorDesc().linLogThreshold,
+        "interpolate"_a = EventSimulatorDesc().interpolate,
+        "max_events_per_frame"_a = EventSimulatorDesc().maxEventsPerFrame,
+        "ticks_per_second"_a = EventSimulatorDesc().ticksPerSecond,
+        "sensor"_a = DvsSensorDesc().enabled,
+        "threshold_sigma"_a = DvsSensorDesc().thresholdSigma,
+        "cutoff_hz"_a = DvsSensorDesc().cutoffHz,
+        "leak_rate_hz"_a = DvsSensorDesc().leakRateHz,
+        "leak_jitter"_a = DvsSensorDesc().leakJitter,
+        "shot_noise_rate_hz"_a = DvsSensorDesc().shotNoiseRateHz,
+        "refractory_period"_a = DvsSensorDesc().refractoryPeriod,
+        "seed"_a = DvsSensorDesc().seed,
+        "tau"_a = EventSimulatorDesc().tau,
+        "threshold"_a = EventSimulatorDesc().threshold,
+        "thread_count"_a = 0
+    );
+    simulator.def_property_readonly("model", [](const EventSimulator& self) { return self.getDesc().model; });
+    simulator.def_property_readonly("frame_dim", [](const EventSimulator& self) { return self.getDesc().frameDim; });
+    simulator.def_property_readonly("channel_count", [](const EventSimulator& self) { return self.getDesc().channelCount; });
+    simulator.def("reset", &EventSimulator::reset);
+
+    // Events are returned as uint32 arrays of shape (N, 2) holding (frame, address) pairs.
+    // Frames are float32 arrays of shape (height, width[, channels]), except for the LeakyIntegrateFire model, which
+    // takes the network output in the layout of the Network pass buffer, of shape (width, height).
+    simulator.def(
+        "simulate",
+        [](EventSimulator& self, pybind11::ndarray<pybind11::numpy> frame, uint32_t frame_index)
+        {
+            FALCOR_CHECK(isNdarrayContiguous(frame), "frame array is not contiguous");
+            FALCOR_CHECK(frame.dtype() == pybind11::dtype<float>(), "frame array must be of type float32");
+            const EventSimulatorDesc& desc = self.getDesc();
+            const size_t expectedSize = size_t(desc.frameDim.x) * desc.frameDim.y * desc.channelCount * sizeof(float);
+            FALCOR_CHECK(
+                getNdarrayByteSize(frame) == expectedSize,
+                "frame array has {} bytes, expected {} bytes.",
+                getNdarrayByteSize(frame),
+                expectedSize
+            );
+            std::vector<uint2> events;
+            self.simulate(reinterpret_cast<const float*>(frame.data()), frame_index, events);
+            return eventsToNumpy(std::move(events));
+        },
+        "frame"_a,
+        "frame_index"_a
+    );
+    simulator.def(
+        "simulate_storage",
+        [](EventSimulator& self, const BlockStorageReader& reader, uint32_t first_frame, std::optional<uint32_t> frame_count)
+        {
+            const uint32_t frameCount = frame_count ? *frame_count : reader.getDim().z - std::min(first_frame, reader.getDim().z);
+            std::vector<uint2> events;
+            self.simulate(reader, first_frame, frameCount, events);
+            return eventsToNumpy(std::move(events));
+        },
+        "reader"_a,
+        "first_frame"_a = 0,
+        "frame_count"_a = pybind11::none()
+    );
+    simulator.def(
+        "get_stats",
+        [](const EventSimulator& self)
+        {
+            const EventSimulator::Stats& stats = self.getStats();
+            pybind11::dict d;
+            d["frames"] = stats.frames;
+            d["pixel_frames"] = stats.pixelFrames;
+            d["events"] = stats.events;
+            d["seconds"] = stats.seconds;
+            d["pixel_frames_per_second"] = stats.getThroughput();
+            return d;
+        }
+    );
+}
+} // namespace Falcor
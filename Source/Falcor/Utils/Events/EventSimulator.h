@@ -0,0 +1,200 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "DvsSensor.h"
+#include "Utils/Math/Vector.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+class BlockStorageReader;
+
+/**
+ * Event generation models of the event passes.
+ */
+enum class EventModel : uint32_t
+{
+    RatioThreshold,    ///< Luminance ratio against the last event with recent-sum tolerance (ErrorMeasurer.cs.slang).
+    LogThreshold,      ///< Lin-log luminance of a box filtered window against a stepped internal state (Denoise.slang).
+    LeakyIntegrateFire, ///< Leaky integrate-and-fire neurons driven by the network output (NetworkOutput.cs.slang).
+};
+FALCOR_ENUM_INFO(
+    EventModel,
+    {
+        {EventModel::RatioThreshold, "RatioThreshold"},
+        {EventModel::LogThreshold, "LogThreshold"},
+        {EventModel::LeakyIntegrateFire, "LeakyIntegrateFire"},
+    }
+);
+FALCOR_ENUM_REGISTER(EventModel);
+
+/**
+ * Parameters of the event simulation. The defaults match the defaults of the event passes where they have one.
+ */
+struct EventSimulatorDesc
+{
+    EventModel model = EventModel::LogThreshold;
+    uint2 frameDim = {0, 0};
+    /// Values per pixel of the input frames. 4 for RGBA frames, 1 for frames that already hold the luminance
+    /// (or the network output for EventModel::LeakyIntegrateFire). Frames are in row-major order, except for
+    /// EventModel::LeakyIntegrateFire whose input is laid out like the network output buffer of the Network pass,
+    /// in column-major order (pixel (x, y) at x * frameDim.y + y).
+    uint32_t channelCount = 4;
+
+    // EventModel::RatioThreshold
+    float ratioThreshold = 0.5f;         ///< Luminance ratio to the last event that triggers an event.
+    uint32_t needAccumulatedEvents = 1;  ///< Number of consistent frames averaged into the new reference luminance.
+    uint32_t toleranceEvents = 0;        ///< Number of missed frames tolerated (0 to 4).
+
+    // EventModel::LogThreshold
+    uint32_t window = 1;                 ///< Number of frames of the box filter.
+    float contrastThreshold = 0.2f;      ///< Step of the internal state.
+    float linLogThreshold = 3.f;         ///< Threshold of the lin-log mapping.
+    /// Interpolate the lin-log luminance between consecutive frames and emit every threshold crossing with an
+    /// interpolated timestamp, instead of at most one event per frame stamped with the frame.
+    bool interpolate = false;
+    uint32_t maxEventsPerFrame = 4;      ///< Maximum number of interpolated events per pixel and frame.
+    double ticksPerSecond = 1e6;         ///< Timestamp ticks per second of interpolated events, used by the sensor model.
+    /// Sensor non-idealities, requires interpolation. The ON and OFF thresholds of the pixels vary around contrastThreshold.
+    DvsSensorDesc sensor;
+
+    // EventModel::LeakyIntegrateFire
+    float tau = 2.f;                     ///< Membrane time constant in frames.
+    float threshold = 1.f;               ///< Spike threshold.
+};
+
+/**
+ * CPU implementation of the event models of the event passes.
+ *
+ * The models follow the shaders operation by operation in 32-bit float arithmetic, so events match the GPU passes
+ * as long as the shader compiler does not reorder the arithmetic. Transcendental functions (log) may differ by an ulp.
+ * The LeakyIntegrateFire input is rounded to half precision, as the network output buffer stores halfs.
+ *
+ * Per-pixel state is stored as structure of arrays. Each frame is split into row ranges that are simulated on a
+ * thread pool: the model updates the state and polarities of a range in a tight loop, then the events are collected.
+ * Events are (frame, (y * width + x) * 2 + polarity) with the polarity bit set for brightness increases
+ * (EventPolarity::OddIsOn), sorted by address independent of the number of threads.
+ *
+ * With EventSimulatorDesc::interpolate, the frame passed to simulate() is the timestamp of the frame in ticks.
+ * Each threshold crossing of the linearly interpolated lin-log luminance is stamped with the time between the
+ * previous and the current timestamp at which it occurs, and events are sorted by time and address.
+ * With EventSimulatorDesc::sensor enabled, the crossings are taken from the low-passed luminance against per-pixel
+ * thresholds and completed with leak, shot noise and refractory period as in DvsSensor.slangh. The first frame after
+ * a reset initializes the sensor state and emits no events.
+ */
+class FALCOR_API EventSimulator
+{
+public:
+    struct Stats
+    {
+        uint64_t frames = 0;
+        uint64_t pixelFrames = 0;
+        uint64_t events = 0;
+        double seconds = 0.0; ///< Time spent in simulate().
+
+        /// Throughput in pixel-frames per second.
+        double getThroughput() const { return seconds > 0.0 ? pixelFrames / seconds : 0.0; }
+    };
+
+    /**
+     * Constructor. Throws if the description is invalid.
+     * @param[in] desc Simulation parameters.
+     * @param[in] threadCount Number of worker threads, 0 for the number of hardware threads.
+     */
+    EventSimulator(const EventSimulatorDesc& desc, uint32_t threadCount = 0);
+
+    const EventSimulatorDesc& getDesc() const { return mDesc; }
+
+    /// Reset the per-pixel state to the initial state of the passes.
+    void reset();
+
+    /**
+     * Simulate a frame.
+     * @param[in] pFrame Frame of frameDim.x * frameDim.y pixels with channelCount float values each, in row-major order
+     *                   (column-major for EventModel::LeakyIntegrateFire, see EventSimulatorDesc::channelCount).
+     * @param[in] frame Frame index stored in the events, or timestamp of the frame if events are interpolated.
+     * @param[in,out] events Events of the frame are appended to this buffer.
+     * @return Number of events of the frame.
+     */
+    size_t simulate(const float* pFrame, uint32_t frame, std::vector<uint2>& events);
+
+    /**
+     * Simulate frames stored by the BlockStoragePass. The storage must hold linear values (RGBA or luma formats)
+     * with the frame dimension and channel count of the simulation. Events are stamped with the stored frame index.
+     * Not available for EventModel::LeakyIntegrateFire, as the storage does not hold network outputs.
+     * @param[in] reader Block storage.
+     * @param[in] firstFrame First frame to simulate.
+     * @param[in] frameCount Number of frames to simulate.
+     * @param[in,out] events Events are appended to this buffer.
+     * @return Number of events.
+     */
+    size_t simulate(const BlockStorageReader& reader, uint32_t firstFrame, uint32_t frameCount, std::vector<uint2>& events);
+
+    const Stats& getStats() const { return mStats; }
+
+private:
+    void simulateRows(const float* pFrame, uint32_t frame, uint32_t rowBegin, uint32_t rowEnd, std::vector<uint2>& events);
+    void simulateRatioThreshold(const float* pFrame, size_t begin, size_t end);
+    void simulateLogThreshold(const float* pFrame, uint32_t frame, size_t begin, size_t end, std::vector<uint2>& events);
+    void simulateSensor(
+        size_t i,
+        float x,
+        float y,
+        uint32_t prevFrame,
+        uint32_t frame,
+        const DvsFrameConstants& constants,
+        std::vector<uint2>& events
+    );
+    void simulateLeakyIntegrateFire(const float* pFrame, size_t begin, size_t end);
+
+    EventSimulatorDesc mDesc;
+    size_t mPixelCount = 0;
+    uint32_t mFrameIndex = 0; ///< Number of frames simulated since the last reset.
+    uint32_t mPrevFrame = 0;  ///< Frame passed to the previous simulate() call.
+
+    // Per-pixel state, see the shaders.
+    std::vector<float> mLastEvent;        ///< RatioThreshold: luminance of the last event.
+    std::vector<float> mRecentSum[5];     ///< RatioThreshold: luminance sums of the recent frames.
+    std::vector<uint32_t> mRecentCount[5];
+    std::vector<std::vector<float>> mHistory; ///< LogThreshold: last window frames per channel, used as a ring buffer.
+    std::vector<float> mInternalState;    ///< LogThreshold: stepped lin-log luminance.
+    std::vector<float> mLastLog;          ///< LogThreshold: lin-log luminance of the previous frame, used for interpolation.
+    std::vector<uint32_t> mLastEventTime; ///< LogThreshold with sensor: time of the last event.
+    std::vector<float4> mPixelParams;     ///< LogThreshold with sensor: ON threshold, OFF threshold and leak rate.
+    std::vector<float> mPotential;        ///< LeakyIntegrateFire: membrane potential.
+
+    std::vector<int8_t> mPolarity; ///< Per-pixel result of the current frame: 1 for ON, -1 for OFF, 0 for no event.
+    std::vector<std::vector<uint2>> mRangeEvents;
+    BS::thread_pool mThreadPool;
+    Stats mStats;
+};
+} // namespace Falcor
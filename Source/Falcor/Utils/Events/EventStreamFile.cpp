@@ -0,0 +1,282 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EventStreamFile.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFileMagic = 0x53564546;  // 'FEVS'
+const uint32_t kChunkMagic = 0x43564546; // 'FEVC'
+const uint32_t kIndexMagic = 0x49564546; // 'FEVI'
+const uint32_t kFileVersion = 1;
+const uint64_t kPayloadAlignment = 8;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    double timeScale;
+    uint32_t encoding;
+    uint32_t polarity;
+    uint32_t reserved[8];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct ChunkHeader
+{
+    uint32_t magic;
+    uint32_t frame;
+    uint64_t timestamp;
+    uint32_t eventCount;
+    uint32_t padding; ///< Number of padding bytes after the payload.
+    uint64_t size;
+};
+static_assert(sizeof(ChunkHeader) == 32);
+
+struct IndexEntry
+{
+    uint32_t frame;
+    uint32_t eventCount;
+    uint64_t timestamp;
+    uint64_t offset;
+    uint64_t size;
+};
+static_assert(sizeof(IndexEntry) == 32);
+
+struct Footer
+{
+    uint64_t indexOffset;
+    uint32_t chunkCount;
+    uint32_t magic;
+};
+static_assert(sizeof(Footer) == 16);
+
+uint64_t getPadding(uint64_t size)
+{
+    return (kPayloadAlignment - size % kPayloadAlignment) % kPayloadAlignment;
+}
+} // namespace
+
+EventStreamWriter::EventStreamWriter(const std::filesystem::path& path, const EventStreamDesc& desc) : mPath(path), mDesc(desc)
+{
+    mStream.open(path, std::ios::binary | std::ios::trunc);
+    if (!mStream)
+        FALCOR_THROW("Failed to create event stream file '{}'.", path);
+
+    FileHeader header = {};
+    header.magic = kFileMagic;
+    header.version = kFileVersion;
+    header.width = desc.width;
+    header.height = desc.height;
+    header.timeScale = desc.timeScale;
+    header.encoding = (uint32_t)desc.encoding;
+    header.polarity = (uint32_t)desc.polarity;
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    mOffset = sizeof(header);
+}
+
+EventStreamWriter::~EventStreamWriter()
+{
+    close();
+}
+
+void EventStreamWriter::appendChunk(uint32_t frame, uint64_t timestamp, uint32_t eventCount, const void* pData, size_t size)
+{
+    FALCOR_CHECK(mStream.is_open(), "Event stream '{}' is closed.", mPath);
+    FALCOR_CHECK(
+        mChunks.empty() || timestamp >= mChunks.back().timestamp,
+        "Event stream timestamps must be non-decreasing ({} < {}).",
+        timestamp,
+        mChunks.back().timestamp
+    );
+
+    ChunkHeader header = {};
+    header.magic = kChunkMagic;
+    header.frame = frame;
+    header.timestamp = timestamp;
+    header.eventCount = eventCount;
+    header.padding = (uint32_t)getPadding(size);
+    header.size = size;
+
+    static const char kZeros[kPayloadAlignment] = {};
+    mStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (size > 0)
+        mStream.write(reinterpret_cast<const char*>(pData), size);
+    mStream.write(kZeros, header.padding);
+    if (!mStream)
+        FALCOR_THROW("Failed to write to event stream file '{}'.", mPath);
+
+    mChunks.push_back({frame, eventCount, timestamp, mOffset + sizeof(header), size});
+    mOffset += sizeof(header) + size + header.padding;
+}
+
+void EventStreamWriter::close()
+{
+    if (!mStream.is_open())
+        return;
+
+    for (const auto& chunk : mChunks)
+    {
+        IndexEntry entry = {chunk.frame, chunk.eventCount, chunk.timestamp, chunk.offset, chunk.size};
+        mStream.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    Footer footer = {mOffset, (uint32_t)mChunks.size(), kIndexMagic};
+    mStream.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    mStream.close();
+    if (!mStream)
+        logError("Failed to write index of event stream file '{}'.", mPath);
+}
+
+bool EventStreamReader::open(const std::filesystem::path& path)
+{
+    close();
+
+    if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+        return false;
+
+    FileHeader header;
+    if (mFile.getSize() < sizeof(header))
+    {
+        logWarning("Event stream file '{}' is too small.", path);
+        close();
+        return false;
+    }
+    std::memcpy(&header, mFile.getData(), sizeof(header));
+    if (header.magic != kFileMagic || header.version != kFileVersion)
+    {
+        logWarning("'{}' is not an event stream file (version {}).", path, kFileVersion);
+        close();
+        return false;
+    }
+
+    mDesc.width = header.width;
+    mDesc.height = header.height;
+    mDesc.timeScale = header.timeScale;
+    mDesc.encoding = (EventEncoding)header.encoding;
+    mDesc.polarity = (EventPolarity)header.polarity;
+
+    if (!readIndex())
+    {
+        logWarning("Event stream file '{}' has no valid index, rebuilding it from the chunk headers.", path);
+        rebuildIndex();
+        mRecovered = true;
+    }
+    return true;
+}
+
+void EventStreamReader::close()
+{
+    mFile.close();
+    mDesc = {};
+    mChunks.clear();
+    mRecovered = false;
+}
+
+uint64_t EventStreamReader::getEventCount() const
+{
+    uint64_t count = 0;
+    for (const auto& chunk : mChunks)
+        count += chunk.eventCount;
+    return count;
+}
+
+const void* EventStreamReader::getChunkData(size_t index) const
+{
+    FALCOR_CHECK(index < mChunks.size(), "Chunk index {} out of range.", index);
+    return reinterpret_cast<const uint8_t*>(mFile.getData()) + mChunks[index].offset;
+}
+
+size_t EventStreamReader::findChunk(uint64_t timestamp) const
+{
+    auto it = std::lower_bound(
+        mChunks.begin(), mChunks.end(), timestamp, [](const EventChunkInfo& chunk, uint64_t t) { return chunk.timestamp < t; }
+    );
+    return it - mChunks.begin();
+}
+
+std::pair<size_t, size_t> EventStreamReader::findChunks(uint64_t beginTimestamp, uint64_t endTimestamp) const
+{
+    size_t begin = findChunk(beginTimestamp);
+    size_t end = std::max(begin, findChunk(endTimestamp));
+    return {begin, end};
+}
+
+bool EventStreamReader::readIndex()
+{
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(mFile.getData());
+    const uint64_t fileSize = mFile.getSize();
+    if (fileSize < sizeof(FileHeader) + sizeof(Footer))
+        return false;
+
+    Footer footer;
+    std::memcpy(&footer, pData + fileSize - sizeof(footer), sizeof(footer));
+    if (footer.magic != kIndexMagic || footer.indexOffset < sizeof(FileHeader) ||
+        footer.indexOffset + uint64_t(footer.chunkCount) * sizeof(IndexEntry) + sizeof(Footer) != fileSize)
+        return false;
+
+    mChunks.resize(footer.chunkCount);
+    for (uint32_t i = 0; i < footer.chunkCount; ++i)
+    {
+        IndexEntry entry;
+        std::memcpy(&entry, pData + footer.indexOffset + i * sizeof(IndexEntry), sizeof(entry));
+        if (entry.offset + entry.size > footer.indexOffset)
+        {
+            mChunks.clear();
+            return false;
+        }
+        mChunks[i] = {entry.frame, entry.eventCount, entry.timestamp, entry.offset, entry.size};
+    }
+    return true;
+}
+
+void EventStreamReader::rebuildIndex()
+{
+    const uint8_t* pData = reinterpret_cast<const uint8_t*>(mFile.getData());
+    const uint64_t fileSize = mFile.getSize();
+
+    mChunks.clear();
+    uint64_t offset = sizeof(FileHeader);
+    while (offset + sizeof(ChunkHeader) <= fileSize)
+    {
+        ChunkHeader header;
+        std::memcpy(&header, pData + offset, sizeof(header));
+        // Stop at the first incomplete or corrupt chunk, it was likely being written when the run was interrupted.
+        if (header.magic != kChunkMagic || header.size + header.padding > fileSize - offset - sizeof(header))
+            break;
+        mChunks.push_back({header.frame, header.eventCount, header.timestamp, offset + sizeof(header), header.size});
+        offset += sizeof(header) + header.size + header.padding;
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,224 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Layout of the events stored in a chunk payload.
+ */
+enum class EventEncoding : uint32_t
+{
+    Address32 = 0,      ///< One uint32 per event: (y * width + x) * 2 + polarity bit. The frame is given by the chunk.
+    FrameAddress64 = 1, ///< One uint2 per event: (frame, (y * width + x) * 2 + polarity bit).
+    Compact = 2,        ///< Delta and run-length coded varint tokens, see EventCodec.
+};
+FALCOR_ENUM_INFO(
+    EventEncoding,
+    {
+        {EventEncoding::Address32, "Address32"},
+        {EventEncoding::FrameAddress64, "FrameAddress64"},
+        {EventEncoding::Compact, "Compact"},
+    }
+);
+FALCOR_ENUM_REGISTER(EventEncoding);
+
+/**
+ * Meaning of the polarity bit (lowest address bit) of an event.
+ */
+enum class EventPolarity : uint32_t
+{
+    OddIsOn = 0,  ///< Polarity bit set means a brightness increase (ON event).
+    EvenIsOn = 1, ///< Polarity bit cleared means a brightness increase (ON event).
+};
+FALCOR_ENUM_INFO(
+    EventPolarity,
+    {
+        {EventPolarity::OddIsOn, "OddIsOn"},
+        {EventPolarity::EvenIsOn, "EvenIsOn"},
+    }
+);
+FALCOR_ENUM_REGISTER(EventPolarity);
+
+/**
+ * How event passes write their output to disk.
+ */
+enum class EventOutputFormat : uint32_t
+{
+    Files,  ///< One data-<frame>.bin file per frame.
+    Stream, ///< A single append-only event stream file per run.
+};
+FALCOR_ENUM_INFO(
+    EventOutputFormat,
+    {
+        {EventOutputFormat::Files, "Files"},
+        {EventOutputFormat::Stream, "Stream"},
+    }
+);
+FALCOR_ENUM_REGISTER(EventOutputFormat);
+
+/**
+ * Description stored in the header of an event stream file.
+ */
+struct EventStreamDesc
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double timeScale = 1.0; ///< Number of timestamp ticks per second.
+    EventEncoding encoding = EventEncoding::FrameAddress64;
+    EventPolarity polarity = EventPolarity::OddIsOn;
+};
+
+/**
+ * Entry of the seek index. There is one chunk per written frame.
+ */
+struct EventChunkInfo
+{
+    uint32_t frame = 0;      ///< Render frame that produced the chunk.
+    uint32_t eventCount = 0; ///< Number of events in the chunk.
+    uint64_t timestamp = 0;  ///< Timestamp of the chunk in ticks (see EventStreamDesc::timeScale).
+    uint64_t offset = 0;     ///< Byte offset of the payload from the start of the file.
+    uint64_t size = 0;       ///< Payload size in bytes.
+};
+
+/**
+ * Writer for single-file, append-only event streams.
+ *
+ * File layout (all values little-endian):
+ *  - 64 byte file header with the EventStreamDesc.
+ *  - A sequence of chunks, each a 32 byte chunk header followed by the payload padded to 8 bytes.
+ *  - The seek index (one EventChunkInfo per chunk) and a 16 byte footer pointing to it, written by close().
+ *
+ * Chunk timestamps must be non-decreasing so that readers can binary search the index.
+ * If a run is interrupted before close(), readers rebuild the index from the chunk headers.
+ */
+class FALCOR_API EventStreamWriter
+{
+public:
+    /**
+     * Create a new event stream file. Throws if the file cannot be created.
+     * @param[in] path File path. An existing file is overwritten.
+     * @param[in] desc Stream description stored in the header.
+     */
+    EventStreamWriter(const std::filesystem::path& path, const EventStreamDesc& desc);
+
+    /// Destructor. Closes the file.
+    ~EventStreamWriter();
+
+    /**
+     * Append a chunk of events.
+     * @param[in] frame Render frame that produced the events.
+     * @param[in] timestamp Timestamp in ticks, must not be smaller than the one of the previous chunk.
+     * @param[in] eventCount Number of events in the payload.
+     * @param[in] pData Payload data encoded as specified in the header.
+     * @param[in] size Payload size in bytes.
+     */
+    void appendChunk(uint32_t frame, uint64_t timestamp, uint32_t eventCount, const void* pData, size_t size);
+
+    /// Write the seek index and close the file. Does nothing if already closed.
+    void close();
+
+    bool isOpen() const { return mStream.is_open(); }
+    const std::filesystem::path& getPath() const { return mPath; }
+    const EventStreamDesc& getDesc() const { return mDesc; }
+    size_t getChunkCount() const { return mChunks.size(); }
+    uint64_t getBytesWritten() const { return mOffset; }
+
+private:
+    EventStreamWriter(const EventStreamWriter&) = delete;
+    EventStreamWriter& operator=(const EventStreamWriter&) = delete;
+
+    std::filesystem::path mPath;
+    EventStreamDesc mDesc;
+    std::ofstream mStream;
+    uint64_t mOffset = 0;
+    std::vector<EventChunkInfo> mChunks;
+};
+
+/**
+ * Reader for event stream files written by EventStreamWriter.
+ * The file is memory mapped, chunk payloads are accessed without copies.
+ */
+class FALCOR_API EventStreamReader
+{
+public:
+    EventStreamReader() = default;
+
+    /**
+     * Constructor opening a file. Use isOpen() to check if successful.
+     */
+    EventStreamReader(const std::filesystem::path& path) { open(path); }
+
+    /**
+     * Open an event stream file.
+     * @return True if the file was successfully opened.
+     */
+    bool open(const std::filesystem::path& path);
+
+    void close();
+
+    bool isOpen() const { return mFile.isOpen(); }
+
+    /// True if the index was rebuilt because the file was not closed properly.
+    bool wasRecovered() const { return mRecovered; }
+
+    const EventStreamDesc& getDesc() const { return mDesc; }
+    const std::vector<EventChunkInfo>& getChunks() const { return mChunks; }
+    size_t getChunkCount() const { return mChunks.size(); }
+    uint64_t getEventCount() const;
+
+    /// Get the mapped payload of a chunk.
+    const void* getChunkData(size_t index) const;
+
+    /// Find the first chunk with a timestamp greater or equal than the given one. Returns getChunkCount() if there is none.
+    size_t findChunk(uint64_t timestamp) const;
+
+    /// Find the chunks with timestamps in [begin, end). Returns the half-open range of chunk indices.
+    std::pair<size_t, size_t> findChunks(uint64_t beginTimestamp, uint64_t endTimestamp) const;
+
+private:
+    EventStreamReader(const EventStreamReader&) = delete;
+    EventStreamReader& operator=(const EventStreamReader&) = delete;
+
+    bool readIndex();
+    void rebuildIndex();
+
+    MemoryMappedFile mFile;
+    EventStreamDesc mDesc;
+    std::vector<EventChunkInfo> mChunks;
+    bool mRecovered = false;
+};
+} // namespace Falcor
@@ -0,0 +1,81 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Error.h"
+#include "Core/Program/ShaderVar.h"
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Head of a ring buffer holding the last entries of a temporal history, shared by all pixels (see RingHistory.slangh).
+ *
+ * Instead of shifting all entries every frame, advance() moves the head to the slot of the oldest entry, which the
+ * shaders then overwrite with the newest one. Slots are indexed by age, the newest entry has age 0.
+ */
+class RingHistory
+{
+public:
+    explicit RingHistory(uint32_t length = 1) { reset(length); }
+
+    /// Set the number of entries. The next advance() moves the head to slot 0.
+    void reset(uint32_t length)
+    {
+        FALCOR_CHECK(length > 0, "RingHistory: length must be non-zero.");
+        mLength = length;
+        mHead = length - 1;
+    }
+
+    /// Move the head to the slot of the oldest entry, which becomes the newest.
+    void advance() { mHead = (mHead + 1) % mLength; }
+
+    /// Slot of the entry of the given age, 0 is the newest entry.
+    uint32_t getSlot(uint32_t age) const { return (mHead + mLength - age % mLength) % mLength; }
+
+    uint32_t getHead() const { return mHead; }
+    uint32_t getLength() const { return mLength; }
+
+    /// Restore a head returned by getHead(), e.g. from a checkpoint.
+    void setHead(uint32_t head)
+    {
+        FALCOR_CHECK(head < mLength, "RingHistory: head {} is out of range for length {}.", head, mLength);
+        mHead = head;
+    }
+
+    /// Bind the head to a shader variable of type RingHistory.
+    void bindShaderData(const ShaderVar& var) const
+    {
+        var["head"] = mHead;
+        var["length"] = mLength;
+    }
+
+private:
+    uint32_t mLength = 1;
+    uint32_t mHead = 0;
+};
+} // namespace Falcor
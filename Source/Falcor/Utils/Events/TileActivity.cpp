@@ -0,0 +1,256 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TileActivity.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/API/IndirectCommands.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+namespace
+{
+const char kShaderFile[] = "Utils/Events/TileActivity.cs.slang";
+
+/// Number of updates whose statistics can be in flight.
+const uint32_t kStatsSlotCount = 4;
+
+/// Maximum number of thread groups of a dispatch in one dimension.
+const uint32_t kMaxGroupCount = 65535;
+} // namespace
+
+TileActivity::TileActivity(ref<Device> pDevice, const Desc& desc) : mpDevice(pDevice), mDesc(desc), mPrefixSum(pDevice)
+{
+    DefineList defines;
+    defines.add("TILE_SIZE", std::to_string(kTileSize));
+    mpMotionPass = ComputePass::create(mpDevice, kShaderFile, "addMotion", defines);
+    mpColorPass = ComputePass::create(mpDevice, kShaderFile, "addColor", defines);
+    mpUpdatePass = ComputePass::create(mpDevice, kShaderFile, "update", defines);
+    mpCompactPass = ComputePass::create(mpDevice, kShaderFile, "compact", defines);
+
+    const DispatchArguments args = {0, 1, 1};
+    mpDispatchArgs = mpDevice->createBuffer(
+        sizeof(DispatchArguments), ResourceBindFlags::IndirectArg | ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal, &args
+    );
+    mpActiveCount = mpDevice->createBuffer(sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, MemoryType::DeviceLocal);
+
+    mpFence = mpDevice->createFence();
+    mStatsSlots.resize(kStatsSlotCount);
+    for (auto& slot : mStatsSlots)
+        slot.pStaging = mpDevice->createBuffer(2 * sizeof(uint32_t), ResourceBindFlags::None, MemoryType::ReadBack);
+}
+
+void TileActivity::resize(uint2 frameDim)
+{
+    FALCOR_CHECK(all(frameDim > 0u), "TileActivity: frame dimension must be non-zero.");
+    if (all(frameDim == mFrameDim))
+        return;
+
+    const uint2 tileCount = div_round_up(frameDim, uint2(kTileSize));
+    FALCOR_CHECK(
+        tileCount.x * tileCount.y <= kMaxGroupCount,
+        "TileActivity: {}x{} tiles exceed the maximum of {} thread groups per dispatch.",
+        tileCount.x,
+        tileCount.y,
+        kMaxGroupCount
+    );
+
+    mFrameDim = frameDim;
+    mTileCount = tileCount;
+    mUpdateCount = 0;
+    mStats = {};
+    for (auto& slot : mStatsSlots)
+        slot.update = 0;
+
+    // Zero-initialized, so nothing is active in the previous update of the first one.
+    const std::vector<uint32_t> zeros(size_t(mTileCount.x) * mTileCount.y, 0);
+    const size_t size = zeros.size() * sizeof(uint32_t);
+    const ResourceBindFlags flags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+    mpMotion = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    mpEvents = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    mpFlags = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    mpListed = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    mpOffsets = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    mpTiles = mpDevice->createBuffer(size, flags, MemoryType::DeviceLocal, zeros.data());
+    // The luminance is set by the first addColor(), which marks every tile.
+    mpLuma = mpDevice->createTexture2D(mFrameDim.x, mFrameDim.y, ResourceFormat::R32Float, 1, 1, nullptr, flags);
+    mLumaValid = false;
+}
+
+void TileActivity::addMotion(RenderContext* pRenderContext, const ref<Texture>& pMotionVectors)
+{
+    FALCOR_PROFILE(pRenderContext, "TileActivity::addMotion");
+    FALCOR_CHECK(mpMotion, "TileActivity: resize() must be called before addMotion().");
+    FALCOR_CHECK(
+        pMotionVectors && pMotionVectors->getWidth() == mFrameDim.x && pMotionVectors->getHeight() == mFrameDim.y,
+        "TileActivity: motion vectors must match the frame dimension {}.",
+        mFrameDim
+    );
+
+    auto var = mpMotionPass->getRootVar();
+    var["CB"]["gFrameDim"] = mFrameDim;
+    var["CB"]["gTileCount"] = mTileCount;
+    var["CB"]["gMotionThreshold"] = mDesc.motionThreshold;
+    var["gMotionVectors"] = pMotionVectors;
+    var["gMotion"] = mpMotion;
+    mpMotionPass->execute(pRenderContext, uint3(mFrameDim, 1));
+}
+
+void TileActivity::addColor(RenderContext* pRenderContext, const ref<Texture>& pColor)
+{
+    FALCOR_PROFILE(pRenderContext, "TileActivity::addColor");
+    FALCOR_CHECK(mpMotion, "TileActivity: resize() must be called before addColor().");
+    FALCOR_CHECK(
+        pColor && pColor->getWidth() == mFrameDim.x && pColor->getHeight() == mFrameDim.y,
+        "TileActivity: color must match the frame dimension {}.",
+        mFrameDim
+    );
+
+    auto var = mpColorPass->getRootVar();
+    var["CB"]["gFrameDim"] = mFrameDim;
+    var["CB"]["gTileCount"] = mTileCount;
+    var["CB"]["gLumaThreshold"] = mDesc.lumaThreshold;
+    var["CB"]["gLumaValid"] = mLumaValid ? 1u : 0u;
+    var["gColor"] = pColor;
+    var["gLuma"] = mpLuma;
+    var["gMotion"] = mpMotion;
+    mpColorPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    mLumaValid = true;
+}
+
+void TileActivity::update(RenderContext* pRenderContext)
+{
+    FALCOR_PROFILE(pRenderContext, "TileActivity::update");
+    FALCOR_CHECK(mpMotion, "TileActivity: resize() must be called before update().");
+
+    const uint32_t tileCount = mTileCount.x * mTileCount.y;
+    const bool refresh = mUpdateCount == 0 || (mDesc.refreshPeriod > 0 && mUpdateCount % mDesc.refreshPeriod == 0);
+    mUpdateCount++;
+
+    auto setConstants = [&](const ShaderVar& var)
+    {
+        var["CB"]["gFrameDim"] = mFrameDim;
+        var["CB"]["gTileCount"] = mTileCount;
+        var["CB"]["gEventThreshold"] = std::max(1u, mDesc.eventThreshold);
+        var["CB"]["gDilation"] = int32_t(mDesc.dilation);
+        var["CB"]["gRefresh"] = refresh ? 1u : 0u;
+    };
+
+    // Pass 1: tile flags.
+    pRenderContext->clearUAV(mpActiveCount->getUAV().get(), uint4(0));
+    {
+        auto var = mpUpdatePass->getRootVar();
+        setConstants(var);
+        var["gMotion"] = mpMotion;
+        var["gEvents"] = mpEvents;
+        var["gFlags"] = mpFlags;
+        var["gListed"] = mpListed;
+        var["gActiveCount"] = mpActiveCount;
+        mpUpdatePass->execute(pRenderContext, uint3(tileCount, 1, 1));
+    }
+
+    // Pass 2: offsets of the listed tiles, the total is the thread group count of the dispatch.
+    pRenderContext->copyBufferRegion(mpOffsets.get(), 0, mpListed.get(), 0, tileCount * sizeof(uint32_t));
+    mPrefixSum.execute(pRenderContext, mpOffsets, tileCount, nullptr, mpDispatchArgs, 0);
+
+    // Pass 3: tile list.
+    {
+        auto var = mpCompactPass->getRootVar();
+        setConstants(var);
+        var["gFlags"] = mpFlags;
+        var["gListed"] = mpListed;
+        var["gOffsets"] = mpOffsets;
+        var["gTiles"] = mpTiles;
+        mpCompactPass->execute(pRenderContext, uint3(tileCount, 1, 1));
+    }
+
+    // Collect the motion and events for the next update.
+    pRenderContext->clearUAV(mpMotion->getUAV().get(), uint4(0));
+    pRenderContext->clearUAV(mpEvents->getUAV().get(), uint4(0));
+
+    // Read back the tile counts for the statistics without waiting. Updates are skipped if all slots are in flight.
+    const Stats stats = getStats();
+    if (stats.update > 0)
+    {
+        // Counters lag a few updates behind.
+        Profiler* pProfiler = pRenderContext->getProfiler();
+        pProfiler->setCounter("activeTiles", float(stats.activeTiles));
+        pProfiler->setCounter("skippedFraction", float(stats.tileCount - stats.listedTiles) / float(stats.tileCount));
+    }
+    StatsSlot& slot = mStatsSlots[mUpdateCount % kStatsSlotCount];
+    if (slot.update == 0)
+    {
+        pRenderContext->copyBufferRegion(slot.pStaging.get(), 0, mpDispatchArgs.get(), 0, sizeof(uint32_t));
+        pRenderContext->copyBufferRegion(slot.pStaging.get(), sizeof(uint32_t), mpActiveCount.get(), 0, sizeof(uint32_t));
+        pRenderContext->submit(false);
+        slot.fenceValue = pRenderContext->signal(mpFence.get());
+        slot.update = mUpdateCount;
+    }
+}
+
+void TileActivity::bindShaderData(const ShaderVar& var, bool allTiles) const
+{
+    FALCOR_CHECK(mpTiles, "TileActivity: resize() must be called before binding the tiles.");
+    var["tiles"] = mpTiles;
+    var["events"] = mpEvents;
+    var["tileCount"] = mTileCount;
+    var["allTiles"] = allTiles ? 1u : 0u;
+}
+
+void TileActivity::dispatch(RenderContext* pRenderContext, ComputePass* pPass, bool allTiles) const
+{
+    FALCOR_CHECK(all(pPass->getThreadGroupSize() == uint3(kTileSize, kTileSize, 1)), "TileActivity: pass must use {0}x{0} thread groups.", kTileSize);
+    if (allTiles)
+        pPass->execute(pRenderContext, uint3(mTileCount.x * mTileCount.y * kTileSize, kTileSize, 1));
+    else
+        pPass->executeIndirect(pRenderContext, mpDispatchArgs.get());
+}
+
+TileActivity::Stats TileActivity::getStats()
+{
+    const uint64_t completedValue = mpFence->getCurrentValue();
+    for (auto& slot : mStatsSlots)
+    {
+        if (slot.update == 0 || slot.fenceValue > completedValue)
+            continue;
+        const uint32_t* pCounts = static_cast<const uint32_t*>(slot.pStaging->map());
+        if (slot.update > mStats.update)
+        {
+            mStats.update = slot.update;
+            mStats.tileCount = mTileCount.x * mTileCount.y;
+            mStats.listedTiles = pCounts[0];
+            mStats.activeTiles = pCounts[1];
+        }
+        slot.pStaging->unmap();
+        slot.update = 0;
+    }
+    return mStats;
+}
+} // namespace Falcor
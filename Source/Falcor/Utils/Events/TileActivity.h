@@ -0,0 +1,172 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Fence.h"
+#include "Core/API/Texture.h"
+#include "Core/Pass/ComputePass.h"
+#include "Core/Program/ShaderVar.h"
+#include "Utils/Algorithm/PrefixSum.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+class RenderContext;
+
+/**
+ * Coarse map of the screen tiles that can change, used by event passes to skip static regions.
+ *
+ * Every frame addMotion() marks the tiles with motion vectors above a threshold, both where the geometry is and where it
+ * was in the previous frame. addColor() marks the tiles whose luminance changed without motion, e.g. under a moving light
+ * or shadow: each pixel keeps the luminance it had when it last marked its tile, so slow changes are caught once they
+ * add up. Event passes report the number of events per tile (see TileActivity.slangh).
+ * update() then marks a tile active if it or a tile within the dilation radius moved, changed or had events since the
+ * last update, lists the active tiles and the tiles that were active in the previous update, and clears the motion and
+ * events. All tiles are active on the first update after a resize and every refreshPeriod updates, which catches
+ * changes that are not observed, e.g. if addColor() is not used.
+ *
+ * The list is built with a prefix sum over the tiles, so it is in tile order independent of the GPU scheduling.
+ * Event passes dispatch one thread group of kTileSize x kTileSize threads per listed tile with dispatch(). Tiles that
+ * were only active in the previous update are listed once more so that the passes clear their per-pixel event counts.
+ */
+class FALCOR_API TileActivity : public Object
+{
+    FALCOR_OBJECT(TileActivity)
+public:
+    /// Tile size in pixels, matches the thread group size of the passes dispatched over tiles.
+    static constexpr uint32_t kTileSize = 16;
+
+    struct Desc
+    {
+        float motionThreshold = 0.05f; ///< Motion in pixels per frame above which a tile is active.
+        uint32_t eventThreshold = 1;   ///< Number of events per tile from which a tile is active.
+        uint32_t dilation = 1;         ///< Radius in tiles around moving tiles and tiles with events that is active.
+        float lumaThreshold = 0.05f;   ///< Change of the log luminance of a pixel above which its tile is active (addColor()).
+        uint32_t refreshPeriod = 16;   ///< Number of updates after which all tiles are active once, 0 to disable.
+    };
+
+    /// Statistics of an update, read back a few frames later.
+    struct Stats
+    {
+        uint32_t update = 0;      ///< Number of the update the statistics are from, counted from 1 (0 if none is available yet).
+        uint32_t tileCount = 0;   ///< Number of tiles.
+        uint32_t activeTiles = 0; ///< Number of active tiles.
+        uint32_t listedTiles = 0; ///< Number of tiles dispatched, the active tiles and the tiles that are cleared.
+    };
+
+    /**
+     * Constructor. Throws an exception if creation failed.
+     * @param[in] pDevice GPU device.
+     * @param[in] desc Activity thresholds.
+     */
+    TileActivity(ref<Device> pDevice, const Desc& desc);
+
+    /// Set the frame dimension. Reallocates the tiles if it changed, the next update lists all tiles.
+    void resize(uint2 frameDim);
+
+    /**
+     * Mark the tiles with motion.
+     * @param[in] pRenderContext The render context.
+     * @param[in] pMotionVectors Screen space motion vectors (RG, in UV units from the current to the previous position).
+     */
+    void addMotion(RenderContext* pRenderContext, const ref<Texture>& pMotionVectors);
+
+    /**
+     * Mark the tiles whose luminance changed.
+     * @param[in] pRenderContext The render context.
+     * @param[in] pColor Color the event passes consume (RGB).
+     */
+    void addColor(RenderContext* pRenderContext, const ref<Texture>& pColor);
+
+    /// Build the tile list from the motion and events since the last update.
+    void update(RenderContext* pRenderContext);
+
+    /// Bind the tile list to a shader variable of type TileActivity. If allTiles is set, all tiles are dispatched as active.
+    void bindShaderData(const ShaderVar& var, bool allTiles = false) const;
+
+    /// Dispatch a pass compiled with TILE_ACTIVITY over the listed tiles, or over all tiles if allTiles is set.
+    void dispatch(RenderContext* pRenderContext, ComputePass* pPass, bool allTiles = false) const;
+
+    /// Get the statistics of the latest update that has been read back. Does not block.
+    Stats getStats();
+
+    const Desc& getDesc() const { return mDesc; }
+    void setDesc(const Desc& desc) { mDesc = desc; }
+    uint2 getFrameDim() const { return mFrameDim; }
+    uint2 getTileCount() const { return mTileCount; }
+    uint32_t getUpdateCount() const { return mUpdateCount; }
+
+    /// Per-tile flags, bit 0 is set for active tiles and bit 1 for tiles that were active in the previous update.
+    const ref<Buffer>& getFlagBuffer() const { return mpFlags; }
+    /// Listed tiles, x | y << 16 with bit 31 set for active tiles.
+    const ref<Buffer>& getTileBuffer() const { return mpTiles; }
+    /// Number of events per tile since the last update.
+    const ref<Buffer>& getEventBuffer() const { return mpEvents; }
+    /// Dispatch arguments, one thread group per listed tile.
+    const ref<Buffer>& getDispatchArgs() const { return mpDispatchArgs; }
+
+private:
+    struct StatsSlot
+    {
+        ref<Buffer> pStaging;
+        uint64_t fenceValue = 0;
+        uint32_t update = 0;
+    };
+
+    ref<Device> mpDevice;
+    Desc mDesc;
+    uint2 mFrameDim = {0, 0};
+    uint2 mTileCount = {0, 0};
+    uint32_t mUpdateCount = 0;
+
+    ref<ComputePass> mpMotionPass;
+    ref<ComputePass> mpColorPass;
+    ref<ComputePass> mpUpdatePass;
+    ref<ComputePass> mpCompactPass;
+    PrefixSum mPrefixSum;
+
+    ref<Buffer> mpMotion;
+    ref<Texture> mpLuma; ///< Per-pixel luminance when the pixel last marked its tile in addColor().
+    bool mLumaValid = false;
+    ref<Buffer> mpEvents;
+    ref<Buffer> mpFlags;
+    ref<Buffer> mpListed;
+    ref<Buffer> mpOffsets;
+    ref<Buffer> mpTiles;
+    ref<Buffer> mpActiveCount;
+    ref<Buffer> mpDispatchArgs;
+
+    ref<Fence> mpFence;
+    std::vector<StatsSlot> mStatsSlots;
+    Stats mStats;
+};
+} // namespace Falcor
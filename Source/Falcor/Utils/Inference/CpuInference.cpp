@@ -0,0 +1,903 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuInference.h"
+#include "Core/Error.h"
+#include "Core/API/PythonHelpers.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+/// Minimum number of multiply-adds of a convolution or matrix product that is split over the thread pool.
+const size_t kMinParallelWork = size_t(1) << 16;
+/// Target number of columns of the matrix products of a convolution, see CpuInference::conv().
+const int64_t kConvChunkColumns = 512;
+
+using Shape = std::vector<int64_t>;
+
+size_t getElementCount(const Shape& shape)
+{
+    size_t count = 1;
+    for (int64_t dim : shape)
+        count *= size_t(dim);
+    return count;
+}
+
+/// Row-major strides of a shape.
+Shape getStrides(const Shape& shape)
+{
+    Shape strides(shape.size(), 1);
+    for (size_t i = shape.size(); i-- > 1;)
+        strides[i - 1] = strides[i] * shape[i];
+    return strides;
+}
+
+/// Strides of a tensor broadcast to a shape of higher or equal rank, 0 in broadcast dimensions.
+Shape getBroadcastStrides(const Shape& shape, const Shape& outputShape)
+{
+    const Shape strides = getStrides(shape);
+    Shape result(outputShape.size(), 0);
+    const size_t offset = outputShape.size() - shape.size();
+    for (size_t i = 0; i < shape.size(); ++i)
+        result[offset + i] = shape[i] == 1 ? 0 : strides[i];
+    return result;
+}
+
+Shape getBroadcastShape(const Shape& a, const Shape& b)
+{
+    Shape shape(std::max(a.size(), b.size()));
+    for (size_t i = 0; i < shape.size(); ++i)
+    {
+        const int64_t dimA = i < shape.size() - a.size() ? 1 : a[i - (shape.size() - a.size())];
+        const int64_t dimB = i < shape.size() - b.size() ? 1 : b[i - (shape.size() - b.size())];
+        FALCOR_CHECK(dimA == dimB || dimA == 1 || dimB == 1, "Shapes cannot be broadcast ({} and {}).", dimA, dimB);
+        shape[i] = std::max(dimA, dimB);
+    }
+    return shape;
+}
+
+/**
+ * Call func(outputOffset, offsetA, offsetB) for every element of a shape in row-major order, where the input offsets
+ * advance by the given per-dimension strides.
+ */
+template<typename F>
+void forEachElement(const Shape& shape, const Shape& stridesA, const Shape& stridesB, F func)
+{
+    const size_t count = getElementCount(shape);
+    if (count == 0)
+        return;
+    const size_t rank = shape.size();
+    std::vector<int64_t> index(rank, 0);
+    size_t offsetA = 0;
+    size_t offsetB = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        func(i, offsetA, offsetB);
+        for (size_t d = rank; d-- > 0;)
+        {
+            offsetA += stridesA[d];
+            offsetB += stridesB[d];
+            if (++index[d] < shape[d])
+                break;
+            offsetA -= stridesA[d] * shape[d];
+            offsetB -= stridesB[d] * shape[d];
+            index[d] = 0;
+        }
+    }
+}
+
+int64_t normalizeAxis(int64_t axis, size_t rank)
+{
+    const int64_t normalized = axis < 0 ? axis + int64_t(rank) : axis;
+    FALCOR_CHECK(normalized >= 0 && normalized < int64_t(std::max<size_t>(rank, 1)), "Axis {} out of range for rank {}.", axis, rank);
+    return normalized;
+}
+
+/**
+ * Compute C += A * B for row-major matrices A [rows, inner], B [inner, cols] and C [rows, cols].
+ * The columns are processed in strips that stay in cache. Four rows of C are updated together, so each value of B
+ * is loaded once for four multiply-adds. The contiguous inner loop is vectorized by the compiler.
+ */
+void multiplyAdd(const float* pA, const float* pB, float* pC, int64_t rows, int64_t inner, int64_t cols)
+{
+    constexpr int64_t kStripWidth = 256;
+    for (int64_t strip = 0; strip < cols; strip += kStripWidth)
+    {
+        const int64_t width = std::min(kStripWidth, cols - strip);
+        int64_t i = 0;
+        for (; i + 4 <= rows; i += 4)
+        {
+            float* __restrict pC0 = pC + i * cols + strip;
+            float* __restrict pC1 = pC0 + cols;
+            float* __restrict pC2 = pC1 + cols;
+            float* __restrict pC3 = pC2 + cols;
+            const float* pRowA = pA + i * inner;
+            for (int64_t k = 0; k < inner; ++k)
+            {
+                const float a0 = pRowA[k];
+                const float a1 = pRowA[inner + k];
+                const float a2 = pRowA[2 * inner + k];
+                const float a3 = pRowA[3 * inner + k];
+                const float* __restrict pRowB = pB + k * cols + strip;
+                for (int64_t c = 0; c < width; ++c)
+                {
+                    const float b = pRowB[c];
+                    pC0[c] += a0 * b;
+                    pC1[c] += a1 * b;
+                    pC2[c] += a2 * b;
+                    pC3[c] += a3 * b;
+                }
+            }
+        }
+        for (; i < rows; ++i)
+        {
+            float* __restrict pRowC = pC + i * cols + strip;
+            for (int64_t k = 0; k < inner; ++k)
+            {
+                const float a = pA[i * inner + k];
+                const float* __restrict pRowB = pB + k * cols + strip;
+                for (int64_t c = 0; c < width; ++c)
+                    pRowC[c] += a * pRowB[c];
+            }
+        }
+    }
+}
+
+std::vector<int64_t> toInts(const std::vector<float>& values)
+{
+    return std::vector<int64_t>(values.begin(), values.end());
+}
+} // namespace
+
+CpuInference::CpuInference(const OnnxModel& model, std::vector<int64_t> inputShape, InferencePrecision precision, uint32_t threadCount)
+    : mInputShape(std::move(inputShape)), mPrecision(precision), mNodes(model.getNodes()), mThreadPool(threadCount)
+{
+    FALCOR_CHECK(model.getInputs().size() == 1, "CPU inference requires a model with one input, the model has {}.", model.getInputs().size());
+    FALCOR_CHECK(model.getOutputs().size() == 1, "CPU inference requires a model with one output, the model has {}.", model.getOutputs().size());
+
+    const OnnxValueInfo& input = model.getInputs()[0];
+    if (mInputShape.empty())
+        mInputShape = input.shape;
+    FALCOR_CHECK(mInputShape.size() == input.shape.size(), "Input shape has rank {}, the model input has rank {}.", mInputShape.size(), input.shape.size());
+    for (size_t i = 0; i < mInputShape.size(); ++i)
+    {
+        FALCOR_CHECK(mInputShape[i] > 0, "Input dimension {} has no fixed size, an input shape is required.", i);
+        FALCOR_CHECK(
+            input.shape[i] < 0 || input.shape[i] == mInputShape[i],
+            "Input dimension {} is {}, the model requires {}.",
+            i,
+            mInputShape[i],
+            input.shape[i]
+        );
+    }
+    mInputSize = getElementCount(mInputShape);
+
+    static const std::map<std::string, Op> kOps = {
+        {"Identity", Op::Identity},
+        {"Dropout", Op::Identity},
+        {"Cast", Op::Cast},
+        {"Relu", Op::Relu},
+        {"LeakyRelu", Op::LeakyRelu},
+        {"Sigmoid", Op::Sigmoid},
+        {"Tanh", Op::Tanh},
+        {"Add", Op::Add},
+        {"Sub", Op::Sub},
+        {"Mul", Op::Mul},
+        {"Div", Op::Div},
+        {"Greater", Op::Greater},
+        {"GreaterOrEqual", Op::GreaterOrEqual},
+        {"Less", Op::Less},
+        {"LessOrEqual", Op::LessOrEqual},
+        {"Equal", Op::Equal},
+        {"Conv", Op::Conv},
+        {"Gemm", Op::Gemm},
+        {"MatMul", Op::MatMul},
+        {"Gather", Op::Gather},
+        {"ScatterElements", Op::ScatterElements},
+        {"Transpose", Op::Transpose},
+        {"Reshape", Op::Reshape},
+        {"Flatten", Op::Flatten},
+        {"Squeeze", Op::Squeeze},
+        {"Unsqueeze", Op::Unsqueeze},
+        {"Concat", Op::Concat},
+    };
+
+    // Values are first numbered in order of definition, then mapped to buffers once their lifetime is known.
+    std::map<std::string, Value> values;
+    for (const auto& [name, initializer] : model.getInitializers())
+    {
+        values[name] = {true, uint32_t(mConstants.size())};
+        mConstants.push_back({initializer.shape, initializer.data});
+        roundToHalf(mConstants.back().data);
+    }
+    uint32_t activationCount = 0;
+    std::set<std::string> consumed = {model.getOutputs()[0].name};
+    for (const OnnxNode& node : mNodes)
+        consumed.insert(node.inputs.begin(), node.inputs.end());
+    values[input.name] = {false, activationCount++};
+
+    for (const OnnxNode& node : mNodes)
+    {
+        FALCOR_CHECK(!node.outputs.empty(), "Node '{}' has no outputs.", node.name);
+        if (node.opType == "Constant")
+        {
+            Tensor tensor;
+            if (node.hasAttribute("value"))
+                tensor = {node.attributes.at("value").t.shape, node.attributes.at("value").t.data};
+            else if (node.hasAttribute("value_float"))
+                tensor = {{}, {node.getFloat("value_float", 0.f)}};
+            else if (node.hasAttribute("value_floats"))
+                tensor = {{int64_t(node.attributes.at("value_floats").floats.size())}, node.attributes.at("value_floats").floats};
+            else if (node.hasAttribute("value_int"))
+                tensor = {{}, {float(node.getInt("value_int", 0))}};
+            else if (node.hasAttribute("value_ints"))
+            {
+                const auto& ints = node.attributes.at("value_ints").ints;
+                tensor = {{int64_t(ints.size())}, std::vector<float>(ints.begin(), ints.end())};
+            }
+            else
+                FALCOR_THROW("Constant node '{}' has an unsupported value type.", node.name);
+            roundToHalf(tensor.data);
+            values[node.outputs[0]] = {true, uint32_t(mConstants.size())};
+            mConstants.push_back(std::move(tensor));
+            continue;
+        }
+
+        auto op = kOps.find(node.opType);
+        FALCOR_CHECK(op != kOps.end(), "Node '{}' has unsupported operator '{}'.", node.name, node.opType);
+
+        Step step = {op->second, &node, {}, {}};
+        bool isConstant = true;
+        size_t inputCount = node.inputs.size();
+        while (inputCount > 0 && node.inputs[inputCount - 1].empty())
+            inputCount--;
+        for (size_t i = 0; i < inputCount; ++i)
+        {
+            auto it = values.find(node.inputs[i]);
+            FALCOR_CHECK(it != values.end(), "Input '{}' of node '{}' is not defined.", node.inputs[i], node.name);
+            step.inputs.push_back(it->second);
+            isConstant = isConstant && it->second.isConstant;
+        }
+
+        // Only the first output is computed, e.g. the mask of Dropout is not supported.
+        for (size_t i = 1; i < node.outputs.size(); ++i)
+            FALCOR_CHECK(consumed.count(node.outputs[i]) == 0, "Output {} of node '{}' is not supported.", i, node.name);
+
+        if (isConstant)
+        {
+            // Fold nodes with constant inputs, e.g. shape computations.
+            Tensor tensor;
+            execute(step, tensor);
+            values[node.outputs[0]] = {true, uint32_t(mConstants.size())};
+            mConstants.push_back(std::move(tensor));
+            continue;
+        }
+
+        step.output = {false, activationCount++};
+        values[node.outputs[0]] = step.output;
+        mSteps.push_back(std::move(step));
+    }
+
+    auto output = values.find(model.getOutputs()[0].name);
+    FALCOR_CHECK(output != values.end(), "Model output '{}' is not defined.", model.getOutputs()[0].name);
+    FALCOR_CHECK(!output->second.isConstant, "Model output '{}' does not depend on the input.", model.getOutputs()[0].name);
+
+    // Assign activations to buffers. A buffer is released after the last step reading it and reused by later steps.
+    // The output of a step is allocated before its inputs are released, so a step never overwrites its inputs.
+    const uint32_t kNeverReleased = uint32_t(-1);
+    std::vector<uint32_t> lastUse(activationCount, 0);
+    for (uint32_t i = 0; i < mSteps.size(); ++i)
+    {
+        lastUse[mSteps[i].output.index] = i;
+        for (const Value& value : mSteps[i].inputs)
+            if (!value.isConstant)
+                lastUse[value.index] = i;
+    }
+    lastUse[output->second.index] = kNeverReleased;
+
+    std::vector<uint32_t> bufferIndex(activationCount, kNeverReleased);
+    std::vector<uint32_t> freeBuffers;
+    uint32_t bufferCount = 0;
+    auto allocate = [&](uint32_t activation)
+    {
+        if (freeBuffers.empty())
+            bufferIndex[activation] = bufferCount++;
+        else
+        {
+            bufferIndex[activation] = freeBuffers.back();
+            freeBuffers.pop_back();
+        }
+    };
+    allocate(0);
+    for (uint32_t i = 0; i < mSteps.size(); ++i)
+    {
+        const uint32_t activation = mSteps[i].output.index;
+        allocate(activation);
+        for (Value& value : mSteps[i].inputs)
+        {
+            if (value.isConstant)
+                continue;
+            const uint32_t inputActivation = value.index;
+            value.index = bufferIndex[inputActivation];
+            if (lastUse[inputActivation] == i && std::find(freeBuffers.begin(), freeBuffers.end(), value.index) == freeBuffers.end())
+                freeBuffers.push_back(value.index);
+        }
+        if (lastUse[activation] == i)
+            freeBuffers.push_back(bufferIndex[activation]);
+        mSteps[i].output.index = bufferIndex[activation];
+    }
+    mInput = {false, bufferIndex[0]};
+    mOutput = {false, bufferIndex[output->second.index]};
+    mBuffers.resize(bufferCount);
+
+    // A run on a zero input validates the shapes and determines the output shape.
+    std::vector<float> zeros(mInputSize, 0.f);
+    Tensor& inputTensor = mBuffers[mInput.index];
+    inputTensor = {mInputShape, zeros};
+    for (const Step& step : mSteps)
+        execute(step, mBuffers[step.output.index]);
+    mOutputShape = mBuffers[mOutput.index].shape;
+    mOutputSize = getElementCount(mOutputShape);
+}
+
+void CpuInference::infer(const float* pInput, float* pOutput, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Tensor& input = mBuffers[mInput.index];
+        input.shape = mInputShape;
+        input.data.assign(pInput + i * mInputSize, pInput + (i + 1) * mInputSize);
+        roundToHalf(input.data);
+        for (const Step& step : mSteps)
+            execute(step, mBuffers[step.output.index]);
+        const Tensor& output = mBuffers[mOutput.index];
+        std::copy(output.data.begin(), output.data.end(), pOutput + i * mOutputSize);
+    }
+}
+
+void CpuInference::execute(const Step& step, Tensor& output)
+{
+    const OnnxNode& node = *step.pNode;
+    auto input = [&](size_t i) -> const Tensor&
+    {
+        FALCOR_CHECK(i < step.inputs.size(), "Node '{}' is missing input {}.", node.name, i);
+        return get(step.inputs[i]);
+    };
+    auto unary = [&](auto func)
+    {
+        const Tensor& x = input(0);
+        output.shape = x.shape;
+        output.data.resize(x.data.size());
+        for (size_t i = 0; i < x.data.size(); ++i)
+            output.data[i] = func(x.data[i]);
+    };
+    auto binary = [&](auto func)
+    {
+        const Tensor& a = input(0);
+        const Tensor& b = input(1);
+        if (a.shape == b.shape)
+        {
+            output.shape = a.shape;
+            output.data.resize(a.data.size());
+            for (size_t i = 0; i < a.data.size(); ++i)
+                output.data[i] = func(a.data[i], b.data[i]);
+            return;
+        }
+        output.shape = getBroadcastShape(a.shape, b.shape);
+        output.data.resize(getElementCount(output.shape));
+        if (b.data.size() == 1)
+        {
+            const float valueB = b.data[0];
+            for (size_t i = 0; i < a.data.size(); ++i)
+                output.data[i] = func(a.data[i], valueB);
+            return;
+        }
+        forEachElement(
+            output.shape,
+            getBroadcastStrides(a.shape, output.shape),
+            getBroadcastStrides(b.shape, output.shape),
+            [&](size_t i, size_t offsetA, size_t offsetB) { output.data[i] = func(a.data[offsetA], b.data[offsetB]); }
+        );
+    };
+    auto copyWithShape = [&](const Tensor& x, Shape shape)
+    {
+        FALCOR_CHECK(getElementCount(shape) == x.data.size(), "Node '{}' changes the number of elements.", node.name);
+        output.shape = std::move(shape);
+        output.data = x.data;
+    };
+    // Axes of Squeeze and Unsqueeze are attributes before opset 13 and inputs since.
+    auto getAxes = [&]() { return step.inputs.size() > 1 ? toInts(input(1).data) : node.getInts("axes"); };
+
+    switch (step.op)
+    {
+    case Op::Identity:
+        output = input(0);
+        break;
+    case Op::Cast:
+    {
+        const int64_t to = node.getInt("to", 1);
+        if (to == 9) // bool
+            unary([](float x) { return x != 0.f ? 1.f : 0.f; });
+        else if (to == 1 || to == 11) // float, double
+            output = input(0);
+        else if (to == 10) // float16
+        {
+            output = input(0);
+            for (float& value : output.data)
+                value = math::float16ToFloat32(math::float32ToFloat16(value));
+        }
+        else // integer types
+            unary([](float x) { return std::trunc(x); });
+        break;
+    }
+    case Op::Relu:
+        unary([](float x) { return std::max(x, 0.f); });
+        break;
+    case Op::LeakyRelu:
+    {
+        const float alpha = node.getFloat("alpha", 0.01f);
+        unary([alpha](float x) { return x >= 0.f ? x : alpha * x; });
+        break;
+    }
+    case Op::Sigmoid:
+        unary([](float x) { return 1.f / (1.f + std::exp(-x)); });
+        break;
+    case Op::Tanh:
+        unary([](float x) { return std::tanh(x); });
+        break;
+    case Op::Add:
+        binary([](float a, float b) { return a + b; });
+        break;
+    case Op::Sub:
+        binary([](float a, float b) { return a - b; });
+        break;
+    case Op::Mul:
+        binary([](float a, float b) { return a * b; });
+        break;
+    case Op::Div:
+        binary([](float a, float b) { return a / b; });
+        break;
+    case Op::Greater:
+        binary([](float a, float b) { return a > b ? 1.f : 0.f; });
+        break;
+    case Op::GreaterOrEqual:
+        binary([](float a, float b) { return a >= b ? 1.f : 0.f; });
+        break;
+    case Op::Less:
+        binary([](float a, float b) { return a < b ? 1.f : 0.f; });
+        break;
+    case Op::LessOrEqual:
+        binary([](float a, float b) { return a <= b ? 1.f : 0.f; });
+        break;
+    case Op::Equal:
+        binary([](float a, float b) { return a == b ? 1.f : 0.f; });
+        break;
+    case Op::Conv:
+        conv(node, input(0), input(1), step.inputs.size() > 2 ? &input(2) : nullptr, output);
+        break;
+    case Op::Gemm:
+        gemm(node, input(0), input(1), step.inputs.size() > 2 ? &input(2) : nullptr, output);
+        break;
+    case Op::MatMul:
+        matMul(input(0), input(1), output);
+        break;
+    case Op::Gather:
+    {
+        const Tensor& data = input(0);
+        const Tensor& indices = input(1);
+        const int64_t axis = normalizeAxis(node.getInt("axis", 0), data.shape.size());
+        const int64_t axisSize = data.shape[axis];
+        const size_t outer = getElementCount(Shape(data.shape.begin(), data.shape.begin() + axis));
+        const size_t inner = getElementCount(Shape(data.shape.begin() + axis + 1, data.shape.end()));
+        output.shape.assign(data.shape.begin(), data.shape.begin() + axis);
+        output.shape.insert(output.shape.end(), indices.shape.begin(), indices.shape.end());
+        output.shape.insert(output.shape.end(), data.shape.begin() + axis + 1, data.shape.end());
+        output.data.resize(outer * indices.data.size() * inner);
+        float* pDst = output.data.data();
+        for (size_t o = 0; o < outer; ++o)
+        {
+            for (float indexValue : indices.data)
+            {
+                int64_t index = int64_t(indexValue);
+                index = index < 0 ? index + axisSize : index;
+                FALCOR_CHECK(index >= 0 && index < axisSize, "Gather index {} out of range in node '{}'.", indexValue, node.name);
+                const float* pSrc = data.data.data() + (o * axisSize + index) * inner;
+                pDst = std::copy(pSrc, pSrc + inner, pDst);
+            }
+        }
+        break;
+    }
+    case Op::ScatterElements:
+    {
+        const Tensor& data = input(0);
+        const Tensor& indices = input(1);
+        const Tensor& updates = input(2);
+        FALCOR_CHECK(indices.shape == updates.shape, "Indices and updates of node '{}' differ in shape.", node.name);
+        FALCOR_CHECK(indices.shape.size() == data.shape.size(), "Indices and data of node '{}' differ in rank.", node.name);
+        const int64_t axis = normalizeAxis(node.getInt("axis", 0), data.shape.size());
+        const std::string reduction = node.hasAttribute("reduction") ? node.attributes.at("reduction").s : "none";
+        FALCOR_CHECK(reduction == "none" || reduction == "add" || reduction == "mul", "Unsupported reduction '{}' in node '{}'.", reduction, node.name);
+        output = data;
+        // The offset along the axis is added from the index, so the axis stride is excluded here.
+        const Shape dataStrides = getStrides(data.shape);
+        Shape strides = dataStrides;
+        strides[axis] = 0;
+        forEachElement(
+            indices.shape,
+            strides,
+            Shape(indices.shape.size(), 0),
+            [&](size_t i, size_t offset, size_t)
+            {
+                int64_t index = int64_t(indices.data[i]);
+                index = index < 0 ? index + data.shape[axis] : index;
+                FALCOR_CHECK(index >= 0 && index < data.shape[axis], "Scatter index out of range in node '{}'.", node.name);
+                float& dst = output.data[offset + index * dataStrides[axis]];
+                if (reduction == "add")
+                    dst += updates.data[i];
+                else if (reduction == "mul")
+                    dst *= updates.data[i];
+                else
+                    dst = updates.data[i];
+            }
+        );
+        break;
+    }
+    case Op::Transpose:
+    {
+        const Tensor& x = input(0);
+        const size_t rank = x.shape.size();
+        Shape perm = node.getInts("perm");
+        if (perm.empty())
+            for (size_t i = rank; i-- > 0;)
+                perm.push_back(int64_t(i));
+        FALCOR_CHECK(perm.size() == rank, "Permutation of node '{}' does not match the rank.", node.name);
+        const Shape inStrides = getStrides(x.shape);
+        Shape strides(rank);
+        output.shape.resize(rank);
+        for (size_t i = 0; i < rank; ++i)
+        {
+            output.shape[i] = x.shape[perm[i]];
+            strides[i] = inStrides[perm[i]];
+        }
+        output.data.resize(x.data.size());
+        forEachElement(
+            output.shape, strides, Shape(rank, 0), [&](size_t i, size_t offset, size_t) { output.data[i] = x.data[offset]; }
+        );
+        break;
+    }
+    case Op::Reshape:
+    {
+        const Tensor& x = input(0);
+        Shape shape = toInts(input(1).data);
+        const bool allowZero = node.getInt("allowzero", 0) != 0;
+        int64_t inferred = -1;
+        size_t known = 1;
+        for (size_t i = 0; i < shape.size(); ++i)
+        {
+            if (shape[i] == 0 && !allowZero)
+                shape[i] = x.shape.at(i);
+            if (shape[i] == -1)
+                inferred = int64_t(i);
+            else
+                known *= size_t(shape[i]);
+        }
+        if (inferred >= 0)
+            shape[inferred] = known > 0 ? int64_t(x.data.size() / known) : 0;
+        copyWithShape(x, std::move(shape));
+        break;
+    }
+    case Op::Flatten:
+    {
+        const Tensor& x = input(0);
+        const int64_t axis = node.getInt("axis", 1) + (node.getInt("axis", 1) < 0 ? int64_t(x.shape.size()) : 0);
+        const size_t outer = getElementCount(Shape(x.shape.begin(), x.shape.begin() + axis));
+        copyWithShape(x, {int64_t(outer), int64_t(x.data.size() / std::max<size_t>(outer, 1))});
+        break;
+    }
+    case Op::Squeeze:
+    {
+        const Tensor& x = input(0);
+        Shape axes = getAxes();
+        for (int64_t& axis : axes)
+            axis = normalizeAxis(axis, x.shape.size());
+        Shape shape;
+        for (size_t i = 0; i < x.shape.size(); ++i)
+        {
+            const bool squeeze = axes.empty() ? x.shape[i] == 1 : std::find(axes.begin(), axes.end(), int64_t(i)) != axes.end();
+            FALCOR_CHECK(!squeeze || x.shape[i] == 1, "Node '{}' squeezes dimension {} of size {}.", node.name, i, x.shape[i]);
+            if (!squeeze)
+                shape.push_back(x.shape[i]);
+        }
+        copyWithShape(x, std::move(shape));
+        break;
+    }
+    case Op::Unsqueeze:
+    {
+        const Tensor& x = input(0);
+        Shape axes = getAxes();
+        const size_t rank = x.shape.size() + axes.size();
+        for (int64_t& axis : axes)
+            axis = normalizeAxis(axis, rank);
+        Shape shape;
+        size_t next = 0;
+        for (size_t i = 0; i < rank; ++i)
+            shape.push_back(std::find(axes.begin(), axes.end(), int64_t(i)) != axes.end() ? 1 : x.shape.at(next++));
+        copyWithShape(x, std::move(shape));
+        break;
+    }
+    case Op::Concat:
+    {
+        const Tensor& first = input(0);
+        const int64_t axis = normalizeAxis(node.getInt("axis", 0), first.shape.size());
+        output.shape = first.shape;
+        output.shape[axis] = 0;
+        for (const Value& value : step.inputs)
+            output.shape[axis] += get(value).shape[axis];
+        const size_t outer = getElementCount(Shape(first.shape.begin(), first.shape.begin() + axis));
+        output.data.resize(getElementCount(output.shape));
+        float* pDst = output.data.data();
+        for (size_t o = 0; o < outer; ++o)
+        {
+            for (const Value& value : step.inputs)
+            {
+                const Tensor& x = get(value);
+                const size_t block = x.data.size() / std::max<size_t>(outer, 1);
+                pDst = std::copy(x.data.begin() + o * block, x.data.begin() + (o + 1) * block, pDst);
+            }
+        }
+        break;
+    }
+    }
+    roundToHalf(output.data);
+}
+
+void CpuInference::conv(const OnnxNode& node, const Tensor& input, const Tensor& weight, const Tensor* pBias, Tensor& output)
+{
+    FALCOR_CHECK(input.shape.size() == 3 && weight.shape.size() == 3, "Node '{}' is not a 1-D convolution.", node.name);
+    const std::string autoPad = node.hasAttribute("auto_pad") ? node.attributes.at("auto_pad").s : "NOTSET";
+    FALCOR_CHECK(autoPad == "NOTSET" || autoPad == "VALID", "Unsupported auto_pad '{}' in node '{}'.", autoPad, node.name);
+
+    const int64_t batch = input.shape[0];
+    const int64_t channels = input.shape[1];
+    const int64_t length = input.shape[2];
+    const int64_t outChannels = weight.shape[0];
+    const int64_t kernelSize = weight.shape[2];
+    const int64_t group = node.getInt("group", 1);
+    const int64_t groupChannels = weight.shape[1];
+    const int64_t groupOutChannels = outChannels / group;
+    FALCOR_CHECK(groupChannels * group == channels && outChannels % group == 0, "Channels of node '{}' do not match the weights.", node.name);
+    const Shape pads = autoPad == "VALID" ? Shape{0, 0} : node.getInts("pads", {0, 0});
+    const int64_t stride = node.getInts("strides", {1})[0];
+    const int64_t dilation = node.getInts("dilations", {1})[0];
+    const int64_t outLength = (length + pads[0] + pads[1] - dilation * (kernelSize - 1) - 1) / stride + 1;
+    FALCOR_CHECK(outLength > 0, "Node '{}' has an empty output.", node.name);
+
+    output.shape = {batch, outChannels, outLength};
+    output.data.resize(getElementCount(output.shape));
+
+    // The convolution of a group is the product of the weights [outChannels, channels * kernelSize] with the
+    // unfolded input [channels * kernelSize, outLength], whose rows are the input channels shifted by each tap.
+    // Several batch items are unfolded side by side, so the rows of the product are long enough to vectorize well.
+    const int64_t unfoldedRows = groupChannels * kernelSize;
+    const int64_t chunkSize = std::max<int64_t>(1, kConvChunkColumns / outLength);
+    const int64_t chunkCount = (batch + chunkSize - 1) / chunkSize;
+    auto convChunks = [&](int64_t begin, int64_t end)
+    {
+        std::vector<float> unfolded(unfoldedRows * chunkSize * outLength);
+        std::vector<float> product(groupOutChannels * chunkSize * outLength);
+        for (int64_t chunk = begin; chunk < end; ++chunk)
+        {
+            const int64_t firstItem = chunk * chunkSize;
+            const int64_t itemCount = std::min(chunkSize, batch - firstItem);
+            const int64_t cols = itemCount * outLength;
+            for (int64_t g = 0; g < group; ++g)
+            {
+                for (int64_t c = 0; c < groupChannels; ++c)
+                {
+                    for (int64_t k = 0; k < kernelSize; ++k)
+                    {
+                        const int64_t offset = k * dilation - pads[0];
+                        for (int64_t item = 0; item < itemCount; ++item)
+                        {
+                            const float* pSrc = input.data.data() + ((firstItem + item) * channels + g * groupChannels + c) * length;
+                            float* pDst = unfolded.data() + (c * kernelSize + k) * cols + item * outLength;
+                            for (int64_t t = 0; t < outLength; ++t)
+                            {
+                                const int64_t x = t * stride + offset;
+                                pDst[t] = x >= 0 && x < length ? pSrc[x] : 0.f;
+                            }
+                        }
+                    }
+                }
+
+                for (int64_t m = 0; m < groupOutChannels; ++m)
+                    std::fill_n(product.data() + m * cols, cols, pBias ? pBias->data[g * groupOutChannels + m] : 0.f);
+                multiplyAdd(weight.data.data() + g * groupOutChannels * unfoldedRows, unfolded.data(), product.data(), groupOutChannels, unfoldedRows, cols);
+
+                for (int64_t item = 0; item < itemCount; ++item)
+                {
+                    for (int64_t m = 0; m < groupOutChannels; ++m)
+                    {
+                        const float* pSrc = product.data() + m * cols + item * outLength;
+                        float* pDst = output.data.data() + ((firstItem + item) * outChannels + g * groupOutChannels + m) * outLength;
+                        std::copy_n(pSrc, outLength, pDst);
+                    }
+                }
+            }
+        }
+    };
+
+    if (size_t(batch * outChannels * unfoldedRows * outLength) < kMinParallelWork)
+        convChunks(0, chunkCount);
+    else
+        mThreadPool.parallelize_loop(chunkCount, convChunks).get();
+}
+
+void CpuInference::matMul(const Tensor& a, const Tensor& b, Tensor& output)
+{
+    FALCOR_CHECK(a.shape.size() >= 2 && b.shape.size() >= 2, "MatMul requires inputs of rank 2 or higher.");
+    const int64_t rows = a.shape[a.shape.size() - 2];
+    const int64_t inner = a.shape.back();
+    const int64_t cols = b.shape.back();
+    FALCOR_CHECK(b.shape[b.shape.size() - 2] == inner, "MatMul inner dimensions differ ({} and {}).", inner, b.shape[b.shape.size() - 2]);
+    const size_t batch = a.data.size() / size_t(rows * inner);
+    const size_t batchB = b.data.size() / size_t(inner * cols);
+    FALCOR_CHECK(batchB == 1 || batchB == batch, "MatMul batch dimensions cannot be broadcast.");
+
+    output.shape = a.shape.size() >= b.shape.size() ? a.shape : b.shape;
+    output.shape[output.shape.size() - 2] = rows;
+    output.shape.back() = cols;
+    output.data.assign(batch * rows * cols, 0.f);
+
+    // Rows of all matrices are split over the threads. A range of rows is split at the matrix boundaries.
+    auto multiplyRows = [&](int64_t begin, int64_t end)
+    {
+        while (begin < end)
+        {
+            const int64_t matrix = begin / rows;
+            const int64_t rowEnd = std::min(end, (matrix + 1) * rows);
+            multiplyAdd(
+                a.data.data() + begin * inner,
+                b.data.data() + (batchB == 1 ? 0 : matrix * inner * cols),
+                output.data.data() + begin * cols,
+                rowEnd - begin,
+                inner,
+                cols
+            );
+            begin = rowEnd;
+        }
+    };
+
+    const int64_t rowCount = int64_t(batch) * rows;
+    if (size_t(rowCount * inner * cols) < kMinParallelWork)
+        multiplyRows(0, rowCount);
+    else
+        mThreadPool.parallelize_loop(rowCount, multiplyRows).get();
+}
+
+void CpuInference::gemm(const OnnxNode& node, const Tensor& a, const Tensor& b, const Tensor* pC, Tensor& output)
+{
+    FALCOR_CHECK(a.shape.size() == 2 && b.shape.size() == 2, "Gemm node '{}' requires inputs of rank 2.", node.name);
+    const bool transA = node.getInt("transA", 0) != 0;
+    const bool transB = node.getInt("transB", 0) != 0;
+    const float alpha = node.getFloat("alpha", 1.f);
+    const float beta = node.getFloat("beta", 1.f);
+
+    // Bring the operands into row-major [M, K] and [K, N] layout, so the product is computed like MatMul.
+    auto transpose = [](const Tensor& x)
+    {
+        Tensor result{{x.shape[1], x.shape[0]}, std::vector<float>(x.data.size())};
+        for (int64_t i = 0; i < x.shape[0]; ++i)
+            for (int64_t j = 0; j < x.shape[1]; ++j)
+                result.data[j * x.shape[0] + i] = x.data[i * x.shape[1] + j];
+        return result;
+    };
+    if (transA || transB)
+        matMul(transA ? transpose(a) : a, transB ? transpose(b) : b, output);
+    else
+        matMul(a, b, output);
+
+    if (alpha != 1.f)
+        for (float& value : output.data)
+            value *= alpha;
+    if (pC)
+    {
+        forEachElement(
+            output.shape,
+            getBroadcastStrides(pC->shape, output.shape),
+            Shape(output.shape.size(), 0),
+            [&](size_t i, size_t offset, size_t) { output.data[i] += beta * pC->data[offset]; }
+        );
+    }
+}
+
+void CpuInference::roundToHalf(std::vector<float>& data) const
+{
+    if (mPrecision != InferencePrecision::Float16)
+        return;
+    for (float& value : data)
+        value = math::float16ToFloat32(math::float32ToFloat16(value));
+}
+
+FALCOR_SCRIPT_BINDING(CpuInference)
+{
+    using namespace pybind11::literals;
+
+    pybind11::falcor_enum<InferencePrecision>(m, "InferencePrecision");
+
+    pybind11::class_<CpuInference> inference(m, "CpuInference");
+    inference.def(
+        pybind11::init(
+            [](const std::filesystem::path& model_path, std::vector<int64_t> input_shape, InferencePrecision precision, uint32_t thread_count)
+            { return std::make_unique<CpuInference>(OnnxModel::load(model_path), std::move(input_shape), precision, thread_count); }
+        ),
+        "model_path"_a,
+        "input_shape"_a = std::vector<int64_t>(),
+        "precision"_a = InferencePrecision::Float32,
+        "thread_count"_a = 0
+    );
+    inference.def_property_readonly("input_shape", &CpuInference::getInputShape);
+    inference.def_property_readonly("output_shape", &CpuInference::getOutputShape);
+    inference.def_property_readonly("precision", &CpuInference::getPrecision);
+
+    // The input holds one or more inputs of the model input shape, the result has shape (count, *output_shape).
+    inference.def(
+        "infer",
+        [](CpuInference& self, pybind11::ndarray<pybind11::numpy> input)
+        {
+            FALCOR_CHECK(isNdarrayContiguous(input), "input array is not contiguous");
+            FALCOR_CHECK(input.dtype() == pybind11::dtype<float>(), "input array must be of type float32");
+            const size_t inputBytes = self.getInputSize() * sizeof(float);
+            FALCOR_CHECK(
+                getNdarrayByteSize(input) % inputBytes == 0 && getNdarrayByteSize(input) > 0,
+                "input array has {} bytes, expected a multiple of {} bytes.",
+                getNdarrayByteSize(input),
+                inputBytes
+            );
+            const uint32_t count = uint32_t(getNdarrayByteSize(input) / inputBytes);
+            auto pOutput = new std::vector<float>(count * self.getOutputSize());
+            self.infer(reinterpret_cast<const float*>(input.data()), pOutput->data(), count);
+
+            pybind11::capsule owner(pOutput, [](void* p) noexcept { delete reinterpret_cast<std::vector<float>*>(p); });
+            std::vector<size_t> shape = {count};
+            shape.insert(shape.end(), self.getOutputShape().begin(), self.getOutputShape().end());
+            return pybind11::ndarray<pybind11::numpy>(
+                pOutput->data(), shape.size(), shape.data(), owner, nullptr, pybind11::dtype<float>(), pybind11::device::cpu::value
+            );
+        },
+        "input"_a
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,178 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "OnnxModel.h"
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Arithmetic precision of CPU inference.
+ */
+enum class InferencePrecision : uint32_t
+{
+    Float32, ///< Weights and activations in 32-bit float.
+    Float16, ///< Weights, inputs and the output of every node rounded to half precision, like a TensorRT FP16 engine.
+};
+FALCOR_ENUM_INFO(
+    InferencePrecision,
+    {
+        {InferencePrecision::Float32, "Float32"},
+        {InferencePrecision::Float16, "Float16"},
+    }
+);
+FALCOR_ENUM_REGISTER(InferencePrecision);
+
+/**
+ * Native CPU inference of ONNX models, for machines without CUDA and TensorRT.
+ *
+ * Supports the operators of the event networks: Conv (1-D), Gemm, MatMul, the activations Relu, LeakyRelu, Sigmoid
+ * and Tanh, elementwise arithmetic and comparisons with broadcasting, Cast, and the tensor operators Gather,
+ * ScatterElements, Transpose, Reshape, Flatten, Squeeze, Unsqueeze and Concat. This covers the convolutional models
+ * and the LIF recurrences the exporter unrolls into elementwise operators. Loops are not supported. Unsupported
+ * operators throw at construction.
+ *
+ * The graph is compiled once for a fixed input shape: nodes with constant inputs are folded, and activations share a
+ * pool of buffers based on their lifetime. Convolutions and matrix products are split over the batch and the output
+ * channels on a thread pool. Their inner loops run over contiguous rows, so the compiler vectorizes them.
+ * Activations are kept in 32-bit float. With InferencePrecision::Float16 they are rounded to half precision after
+ * every node, which matches a TensorRT FP16 engine within the rounding of its fused kernels.
+ */
+class FALCOR_API CpuInference
+{
+public:
+    /**
+     * Constructor. Throws if the model uses unsupported operators or the input shape does not match the model.
+     * @param[in] model ONNX model with one input and one output.
+     * @param[in] inputShape Input shape. Required if the model input has dimensions without a fixed size.
+     *                       Empty to use the model input shape.
+     * @param[in] precision Arithmetic precision.
+     * @param[in] threadCount Number of worker threads, 0 for the number of hardware threads.
+     */
+    CpuInference(
+        const OnnxModel& model,
+        std::vector<int64_t> inputShape = {},
+        InferencePrecision precision = InferencePrecision::Float32,
+        uint32_t threadCount = 0
+    );
+
+    const std::vector<int64_t>& getInputShape() const { return mInputShape; }
+    const std::vector<int64_t>& getOutputShape() const { return mOutputShape; }
+    /// Number of values of one input.
+    size_t getInputSize() const { return mInputSize; }
+    /// Number of values of one output.
+    size_t getOutputSize() const { return mOutputSize; }
+    InferencePrecision getPrecision() const { return mPrecision; }
+
+    /**
+     * Run the model on consecutive inputs.
+     * @param[in] pInput count * getInputSize() values.
+     * @param[out] pOutput count * getOutputSize() values.
+     * @param[in] count Number of inputs.
+     */
+    void infer(const float* pInput, float* pOutput, uint32_t count = 1);
+
+private:
+    struct Tensor
+    {
+        std::vector<int64_t> shape;
+        std::vector<float> data;
+    };
+
+    /// Reference to a constant or to an activation buffer.
+    struct Value
+    {
+        bool isConstant = false;
+        uint32_t index = 0;
+    };
+
+    enum class Op
+    {
+        Identity,
+        Cast,
+        Relu,
+        LeakyRelu,
+        Sigmoid,
+        Tanh,
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Greater,
+        GreaterOrEqual,
+        Less,
+        LessOrEqual,
+        Equal,
+        Conv,
+        Gemm,
+        MatMul,
+        Gather,
+        ScatterElements,
+        Transpose,
+        Reshape,
+        Flatten,
+        Squeeze,
+        Unsqueeze,
+        Concat,
+    };
+
+    struct Step
+    {
+        Op op;
+        const OnnxNode* pNode;
+        std::vector<Value> inputs;
+        Value output;
+    };
+
+    const Tensor& get(const Value& value) const { return value.isConstant ? mConstants[value.index] : mBuffers[value.index]; }
+    void execute(const Step& step, Tensor& output);
+    void conv(const OnnxNode& node, const Tensor& input, const Tensor& weight, const Tensor* pBias, Tensor& output);
+    void matMul(const Tensor& a, const Tensor& b, Tensor& output);
+    void gemm(const OnnxNode& node, const Tensor& a, const Tensor& b, const Tensor* pC, Tensor& output);
+    void roundToHalf(std::vector<float>& data) const;
+
+    std::vector<int64_t> mInputShape;
+    std::vector<int64_t> mOutputShape;
+    size_t mInputSize = 0;
+    size_t mOutputSize = 0;
+    InferencePrecision mPrecision;
+
+    std::vector<OnnxNode> mNodes;
+    std::vector<Step> mSteps;
+    std::vector<Tensor> mConstants;
+    std::vector<Tensor> mBuffers; ///< Activation buffers, shared by activations with disjoint lifetimes.
+    Value mInput;
+    Value mOutput;
+    BS::thread_pool mThreadPool;
+};
+} // namespace Falcor
@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EngineCache.h"
+#include "Core/Error.h"
+#include "Core/Platform/LockFile.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Logger.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const char kEngineExtension[] = ".plan";
+const char kTempExtension[] = ".tmp";
+const char kLockExtension[] = ".lock";
+} // namespace
+
+EngineCache::EngineCache(std::filesystem::path directory) : mDirectory(std::move(directory))
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mDirectory, ec);
+    FALCOR_CHECK(std::filesystem::is_directory(mDirectory), "Failed to create engine cache directory '{}'.", mDirectory);
+}
+
+std::string EngineCache::computeKey(const void* pModelData, size_t modelSize, const Params& params)
+{
+    SHA1 sha1;
+    sha1.update(uint64_t(modelSize));
+    sha1.update(pModelData, modelSize);
+    // Lengths separate the strings, so ("ab", "c") and ("a", "bc") hash differently.
+    for (const auto& [name, value] : params)
+    {
+        sha1.update(uint64_t(name.size()));
+        sha1.update(name);
+        sha1.update(uint64_t(value.size()));
+        sha1.update(value);
+    }
+    return SHA1::toString(sha1.finalize());
+}
+
+std::filesystem::path EngineCache::getPath(const std::string& key) const
+{
+    return mDirectory / (key + kEngineExtension);
+}
+
+std::optional<std::vector<uint8_t>> EngineCache::load(const std::string& key) const
+{
+    const std::filesystem::path path = getPath(key);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0)
+    {
+        logWarning("Ignoring empty engine cache file '{}'.", path);
+        return {};
+    }
+    std::vector<uint8_t> engine(size);
+    file.seekg(0, std::ios::beg);
+    if (!file.read(reinterpret_cast<char*>(engine.data()), size))
+    {
+        logWarning("Failed to read engine cache file '{}'.", path);
+        return {};
+    }
+    return engine;
+}
+
+void EngineCache::store(const std::string& key, const std::vector<uint8_t>& engine) const
+{
+    const std::filesystem::path path = getPath(key);
+    std::filesystem::path tempPath = path;
+    tempPath += kTempExtension;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(engine.data()), engine.size()) || !file.flush())
+            FALCOR_THROW("Failed to write engine cache file '{}'.", tempPath);
+    }
+
+    // Readers see either no engine or the complete one.
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        FALCOR_THROW("Failed to write engine cache file '{}'.", path);
+    }
+}
+
+void EngineCache::remove(const std::string& key) const
+{
+    std::error_code ec;
+    std::filesystem::remove(getPath(key), ec);
+}
+
+std::vector<uint8_t> EngineCache::getOrBuild(const std::string& key, const BuildFunc& build, bool* pBuilt) const
+{
+    if (pBuilt)
+        *pBuilt = false;
+    if (auto engine = load(key))
+        return std::move(*engine);
+
+    std::filesystem::path lockPath = getPath(key);
+    lockPath += kLockExtension;
+    LockFile lockFile(lockPath);
+    if (!lockFile.isOpen() || !lockFile.lock())
+        logWarning("Failed to lock '{}', building the engine without a lock.", lockPath);
+
+    // Another process may have built the engine while this one waited for the lock.
+    if (auto engine = load(key))
+        return std::move(*engine);
+
+    std::vector<uint8_t> engine = build();
+    FALCOR_CHECK(!engine.empty(), "Engine build returned an empty engine.");
+    store(key, engine);
+    if (pBuilt)
+        *pBuilt = true;
+    return engine;
+}
+} // namespace Falcor
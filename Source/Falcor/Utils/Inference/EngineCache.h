@@ -0,0 +1,98 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Persistent cache of serialized inference engines, such as TensorRT plans.
+ *
+ * Engines are stored as <key>.plan in the cache directory. The key is a hash of the model and all parameters that
+ * affect the built engine, e.g. batch size, precision and library version, so a changed model or build parameter never
+ * loads a stale engine. Engines are written to a temporary file and renamed, and getOrBuild() builds under a lock file,
+ * so concurrent processes sharing the cache build an engine only once and never read a partially written one.
+ */
+class FALCOR_API EngineCache
+{
+public:
+    /// Build parameters that are part of the key, sorted by name so the key does not depend on the insertion order.
+    using Params = std::map<std::string, std::string>;
+    /// Builds a serialized engine. Throws an exception on failure.
+    using BuildFunc = std::function<std::vector<uint8_t>()>;
+
+    /**
+     * Constructor. Creates the cache directory if it does not exist.
+     * @param[in] directory Cache directory.
+     */
+    explicit EngineCache(std::filesystem::path directory);
+
+    /**
+     * Compute the key of an engine.
+     * @param[in] pModelData Serialized model, e.g. the bytes of an ONNX file.
+     * @param[in] modelSize Size of the model in bytes.
+     * @param[in] params Build parameters.
+     * @return 40-character hexadecimal key.
+     */
+    static std::string computeKey(const void* pModelData, size_t modelSize, const Params& params);
+
+    /// Get the path of the engine with the given key.
+    std::filesystem::path getPath(const std::string& key) const;
+
+    /// Load the engine with the given key. Returns an empty optional if it is not cached.
+    std::optional<std::vector<uint8_t>> load(const std::string& key) const;
+
+    /// Store an engine, replacing a cached one atomically. Throws an exception if the file cannot be written.
+    void store(const std::string& key, const std::vector<uint8_t>& engine) const;
+
+    /// Remove the engine with the given key, e.g. after it failed to deserialize.
+    void remove(const std::string& key) const;
+
+    /**
+     * Load the engine with the given key, or build and store it. Building holds a lock file, so a process waiting for
+     * another one building the same engine loads the engine once it is stored.
+     * @param[in] key Engine key.
+     * @param[in] build Function building the engine.
+     * @param[out] pBuilt Set to true if the engine was built, false if it was loaded (optional).
+     * @return The serialized engine.
+     */
+    std::vector<uint8_t> getOrBuild(const std::string& key, const BuildFunc& build, bool* pBuilt = nullptr) const;
+
+    const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+private:
+    std::filesystem::path mDirectory;
+};
+} // namespace Falcor
@@ -0,0 +1,545 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "OnnxModel.h"
+#include "Core/Error.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/StringFormatters.h"
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+// Protobuf wire types.
+enum WireType : uint32_t
+{
+    kVarint = 0,
+    kFixed64 = 1,
+    kLengthDelimited = 2,
+    kFixed32 = 5,
+};
+
+// ONNX TensorProto::DataType.
+enum OnnxDataType : int64_t
+{
+    kFloat = 1,
+    kUint8 = 2,
+    kInt8 = 3,
+    kUint16 = 4,
+    kInt16 = 5,
+    kInt32 = 6,
+    kInt64 = 7,
+    kBool = 9,
+    kFloat16 = 10,
+    kDouble = 11,
+    kUint32 = 12,
+    kUint64 = 13,
+};
+
+/**
+ * Reader of a protobuf message. Fields are read in order with next(), followed by one of the read functions matching
+ * the wire type, or skip().
+ */
+class ProtoReader
+{
+public:
+    ProtoReader(const uint8_t* pData, size_t size) : mpData(pData), mpEnd(pData + size) {}
+    explicit ProtoReader(const std::string_view& message) : ProtoReader(reinterpret_cast<const uint8_t*>(message.data()), message.size())
+    {}
+
+    bool next()
+    {
+        if (mpData == mpEnd)
+            return false;
+        const uint64_t key = readVarint();
+        mField = uint32_t(key >> 3);
+        mWireType = uint32_t(key & 7);
+        return true;
+    }
+
+    bool hasData() const { return mpData < mpEnd; }
+    uint32_t getField() const { return mField; }
+    uint32_t getWireType() const { return mWireType; }
+
+    uint64_t readVarint()
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            FALCOR_CHECK(mpData < mpEnd, "Truncated ONNX model.");
+            const uint8_t byte = *mpData++;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        FALCOR_THROW("Invalid varint in ONNX model.");
+    }
+
+    float readFloat()
+    {
+        float value;
+        std::memcpy(&value, readBytes(sizeof(float)), sizeof(float));
+        return value;
+    }
+
+    double readDouble()
+    {
+        double value;
+        std::memcpy(&value, readBytes(sizeof(double)), sizeof(double));
+        return value;
+    }
+
+    std::string_view readLengthDelimited()
+    {
+        const uint64_t size = readVarint();
+        FALCOR_CHECK(size <= uint64_t(mpEnd - mpData), "Truncated ONNX model.");
+        return std::string_view(reinterpret_cast<const char*>(readBytes(size_t(size))), size_t(size));
+    }
+
+    /// Read a repeated integer field, which is either packed or stored as one field per value.
+    void readInts(std::vector<int64_t>& values)
+    {
+        if (mWireType == kLengthDelimited)
+        {
+            ProtoReader packed(readLengthDelimited());
+            while (packed.hasData())
+                values.push_back(int64_t(packed.readVarint()));
+        }
+        else
+            values.push_back(int64_t(readVarint()));
+    }
+
+    /// Read a repeated float field, which is either packed or stored as one field per value.
+    void readFloats(std::vector<float>& values)
+    {
+        if (mWireType == kLengthDelimited)
+        {
+            ProtoReader packed(readLengthDelimited());
+            while (packed.hasData())
+                values.push_back(packed.readFloat());
+        }
+        else
+            values.push_back(readFloat());
+    }
+
+    void skip()
+    {
+        switch (mWireType)
+        {
+        case kVarint:
+            readVarint();
+            break;
+        case kFixed64:
+            readBytes(8);
+            break;
+        case kLengthDelimited:
+            readLengthDelimited();
+            break;
+        case kFixed32:
+            readBytes(4);
+            break;
+        default:
+            FALCOR_THROW("Unsupported protobuf wire type {} in ONNX model.", mWireType);
+        }
+    }
+
+private:
+    const uint8_t* readBytes(size_t size)
+    {
+        FALCOR_CHECK(size <= size_t(mpEnd - mpData), "Truncated ONNX model.");
+        const uint8_t* pBytes = mpData;
+        mpData += size;
+        return pBytes;
+    }
+
+    const uint8_t* mpData;
+    const uint8_t* mpEnd;
+    uint32_t mField = 0;
+    uint32_t mWireType = 0;
+};
+
+template<typename T>
+void convertRawData(const std::string_view& raw, std::vector<float>& data)
+{
+    FALCOR_CHECK(raw.size() % sizeof(T) == 0, "Invalid raw tensor data size {}.", raw.size());
+    data.resize(raw.size() / sizeof(T));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        T value;
+        std::memcpy(&value, raw.data() + i * sizeof(T), sizeof(T));
+        data[i] = float(value);
+    }
+}
+
+OnnxTensor parseTensor(const std::string_view& message)
+{
+    OnnxTensor tensor;
+    int64_t dataType = kFloat;
+    std::string_view raw;
+    std::vector<int64_t> ints;
+    std::vector<double> doubles;
+    ProtoReader reader(message);
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: // dims
+            reader.readInts(tensor.shape);
+            break;
+        case 2: // data_type
+            dataType = int64_t(reader.readVarint());
+            break;
+        case 4: // float_data
+            reader.readFloats(tensor.data);
+            break;
+        case 5:  // int32_data, also holds the bits of float16 and the values of small integer types
+        case 7:  // int64_data
+        case 11: // uint64_data
+            reader.readInts(ints);
+            break;
+        case 8: // name
+            tensor.name = reader.readLengthDelimited();
+            break;
+        case 9: // raw_data
+            raw = reader.readLengthDelimited();
+            break;
+        case 10: // double_data
+            if (reader.getWireType() == kLengthDelimited)
+            {
+                ProtoReader packed(reader.readLengthDelimited());
+                while (packed.hasData())
+                    doubles.push_back(packed.readDouble());
+            }
+            else
+                doubles.push_back(reader.readDouble());
+            break;
+        case 13: // external_data
+        case 14: // data_location
+            FALCOR_THROW("Tensor '{}' uses external data, which is not supported.", tensor.name);
+        default:
+            reader.skip();
+        }
+    }
+
+    if (!raw.empty())
+    {
+        switch (dataType)
+        {
+        case kFloat:
+            convertRawData<float>(raw, tensor.data);
+            break;
+        case kUint8:
+        case kBool:
+            convertRawData<uint8_t>(raw, tensor.data);
+            break;
+        case kInt8:
+            convertRawData<int8_t>(raw, tensor.data);
+            break;
+        case kUint16:
+            convertRawData<uint16_t>(raw, tensor.data);
+            break;
+        case kInt16:
+            convertRawData<int16_t>(raw, tensor.data);
+            break;
+        case kInt32:
+            convertRawData<int32_t>(raw, tensor.data);
+            break;
+        case kInt64:
+            convertRawData<int64_t>(raw, tensor.data);
+            break;
+        case kFloat16:
+            convertRawData<uint16_t>(raw, tensor.data);
+            for (float& value : tensor.data)
+                value = math::float16ToFloat32(uint16_t(value));
+            break;
+        case kDouble:
+            convertRawData<double>(raw, tensor.data);
+            break;
+        case kUint32:
+            convertRawData<uint32_t>(raw, tensor.data);
+            break;
+        case kUint64:
+            convertRawData<uint64_t>(raw, tensor.data);
+            break;
+        default:
+            FALCOR_THROW("Tensor '{}' has unsupported data type {}.", tensor.name, dataType);
+        }
+    }
+    else if (!ints.empty())
+    {
+        tensor.data.resize(ints.size());
+        for (size_t i = 0; i < ints.size(); ++i)
+            tensor.data[i] = dataType == kFloat16 ? math::float16ToFloat32(uint16_t(ints[i])) : float(ints[i]);
+    }
+    else if (!doubles.empty())
+        tensor.data.assign(doubles.begin(), doubles.end());
+
+    size_t elementCount = 1;
+    for (int64_t dim : tensor.shape)
+        elementCount *= size_t(dim);
+    FALCOR_CHECK(
+        tensor.data.size() == elementCount,
+        "Tensor '{}' has {} values, expected {}.",
+        tensor.name,
+        tensor.data.size(),
+        elementCount
+    );
+    return tensor;
+}
+
+OnnxAttribute parseAttribute(const std::string_view& message, std::string& name)
+{
+    OnnxAttribute attribute;
+    ProtoReader reader(message);
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: // name
+            name = reader.readLengthDelimited();
+            break;
+        case 2: // f
+            attribute.f = reader.readFloat();
+            break;
+        case 3: // i
+            attribute.i = int64_t(reader.readVarint());
+            break;
+        case 4: // s
+            attribute.s = reader.readLengthDelimited();
+            break;
+        case 5: // t
+            attribute.t = parseTensor(reader.readLengthDelimited());
+            break;
+        case 6:  // g
+        case 10: // graphs
+            FALCOR_THROW("Attribute '{}' holds a subgraph, which is not supported.", name);
+        case 7: // floats
+            reader.readFloats(attribute.floats);
+            break;
+        case 8: // ints
+            reader.readInts(attribute.ints);
+            break;
+        default:
+            reader.skip();
+        }
+    }
+    return attribute;
+}
+
+OnnxNode parseNode(const std::string_view& message)
+{
+    OnnxNode node;
+    ProtoReader reader(message);
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: // input
+            node.inputs.emplace_back(reader.readLengthDelimited());
+            break;
+        case 2: // output
+            node.outputs.emplace_back(reader.readLengthDelimited());
+            break;
+        case 3: // name
+            node.name = reader.readLengthDelimited();
+            break;
+        case 4: // op_type
+            node.opType = reader.readLengthDelimited();
+            break;
+        case 5: // attribute
+        {
+            std::string name;
+            OnnxAttribute attribute = parseAttribute(reader.readLengthDelimited(), name);
+            node.attributes[name] = std::move(attribute);
+            break;
+        }
+        case 7: // domain
+        {
+            const std::string_view domain = reader.readLengthDelimited();
+            FALCOR_CHECK(domain.empty() || domain == "ai.onnx", "Node '{}' uses unsupported domain '{}'.", node.name, domain);
+            break;
+        }
+        default:
+            reader.skip();
+        }
+    }
+    return node;
+}
+
+OnnxValueInfo parseValueInfo(const std::string_view& message)
+{
+    OnnxValueInfo info;
+    ProtoReader reader(message);
+    while (reader.next())
+    {
+        if (reader.getField() == 1) // name
+            info.name = reader.readLengthDelimited();
+        else if (reader.getField() == 2) // type
+        {
+            ProtoReader type(reader.readLengthDelimited());
+            while (type.next())
+            {
+                if (type.getField() != 1) // tensor_type
+                {
+                    type.skip();
+                    continue;
+                }
+                ProtoReader tensorType(type.readLengthDelimited());
+                while (tensorType.next())
+                {
+                    if (tensorType.getField() != 2) // shape
+                    {
+                        tensorType.skip();
+                        continue;
+                    }
+                    ProtoReader shape(tensorType.readLengthDelimited());
+                    while (shape.next())
+                    {
+                        if (shape.getField() != 1) // dim
+                        {
+                            shape.skip();
+                            continue;
+                        }
+                        int64_t size = -1;
+                        ProtoReader dim(shape.readLengthDelimited());
+                        while (dim.next())
+                        {
+                            if (dim.getField() == 1) // dim_value
+                                size = int64_t(dim.readVarint());
+                            else
+                                dim.skip();
+                        }
+                        info.shape.push_back(size);
+                    }
+                }
+            }
+        }
+        else
+            reader.skip();
+    }
+    return info;
+}
+} // namespace
+
+int64_t OnnxNode::getInt(const std::string& attribute, int64_t defaultValue) const
+{
+    auto it = attributes.find(attribute);
+    return it != attributes.end() ? it->second.i : defaultValue;
+}
+
+float OnnxNode::getFloat(const std::string& attribute, float defaultValue) const
+{
+    auto it = attributes.find(attribute);
+    return it != attributes.end() ? it->second.f : defaultValue;
+}
+
+std::vector<int64_t> OnnxNode::getInts(const std::string& attribute, std::vector<int64_t> defaultValue) const
+{
+    auto it = attributes.find(attribute);
+    return it != attributes.end() ? it->second.ints : defaultValue;
+}
+
+OnnxModel::OnnxModel(const void* pData, size_t size)
+{
+    std::string_view graph;
+    ProtoReader model(static_cast<const uint8_t*>(pData), size);
+    while (model.next())
+    {
+        if (model.getField() == 7) // graph
+            graph = model.readLengthDelimited();
+        else if (model.getField() == 8) // opset_import
+        {
+            std::string_view domain;
+            int64_t version = 0;
+            ProtoReader opset(model.readLengthDelimited());
+            while (opset.next())
+            {
+                if (opset.getField() == 1)
+                    domain = opset.readLengthDelimited();
+                else if (opset.getField() == 2)
+                    version = int64_t(opset.readVarint());
+                else
+                    opset.skip();
+            }
+            if (domain.empty() || domain == "ai.onnx")
+                mOpsetVersion = version;
+        }
+        else
+            model.skip();
+    }
+    FALCOR_CHECK(!graph.empty(), "ONNX model has no graph.");
+
+    std::vector<OnnxValueInfo> inputs;
+    ProtoReader reader(graph);
+    while (reader.next())
+    {
+        switch (reader.getField())
+        {
+        case 1: // node
+            mNodes.push_back(parseNode(reader.readLengthDelimited()));
+            break;
+        case 5: // initializer
+        {
+            OnnxTensor tensor = parseTensor(reader.readLengthDelimited());
+            mInitializers[tensor.name] = std::move(tensor);
+            break;
+        }
+        case 11: // input
+            inputs.push_back(parseValueInfo(reader.readLengthDelimited()));
+            break;
+        case 12: // output
+            mOutputs.push_back(parseValueInfo(reader.readLengthDelimited()));
+            break;
+        case 15: // sparse_initializer
+            FALCOR_THROW("ONNX model has sparse initializers, which are not supported.");
+        default:
+            reader.skip();
+        }
+    }
+
+    for (auto& input : inputs)
+    {
+        if (mInitializers.count(input.name) == 0)
+            mInputs.push_back(std::move(input));
+    }
+}
+
+OnnxModel OnnxModel::load(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    FALCOR_CHECK(file.is_open(), "Failed to open ONNX model '{}'.", path);
+    const std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<char> data(size_t(std::max<std::streamsize>(size, 0)));
+    FALCOR_CHECK(file.read(data.data(), data.size()), "Failed to read ONNX model '{}'.", path);
+    return OnnxModel(data.data(), data.size());
+}
+} // namespace Falcor
@@ -0,0 +1,124 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Tensor of an ONNX model. Values of all element types are converted to float, which is exact for the integer
+ * tensors of the supported models (indices, axes and shapes).
+ */
+struct OnnxTensor
+{
+    std::string name;
+    std::vector<int64_t> shape;
+    std::vector<float> data;
+};
+
+/**
+ * Attribute of an ONNX node. Only the member matching the attribute type is set.
+ */
+struct OnnxAttribute
+{
+    int64_t i = 0;
+    float f = 0.f;
+    std::string s;
+    std::vector<int64_t> ints;
+    std::vector<float> floats;
+    OnnxTensor t;
+};
+
+/**
+ * Node of an ONNX graph.
+ */
+struct OnnxNode
+{
+    std::string name;
+    std::string opType;
+    std::vector<std::string> inputs;  ///< Input value names, empty for omitted optional inputs.
+    std::vector<std::string> outputs; ///< Output value names.
+    std::map<std::string, OnnxAttribute> attributes;
+
+    bool hasAttribute(const std::string& attribute) const { return attributes.count(attribute) != 0; }
+    int64_t getInt(const std::string& attribute, int64_t defaultValue) const;
+    float getFloat(const std::string& attribute, float defaultValue) const;
+    std::vector<int64_t> getInts(const std::string& attribute, std::vector<int64_t> defaultValue = {}) const;
+};
+
+/**
+ * Input or output of an ONNX graph. Dimensions without a fixed size (e.g. a named batch dimension) are -1.
+ */
+struct OnnxValueInfo
+{
+    std::string name;
+    std::vector<int64_t> shape;
+};
+
+/**
+ * ONNX model loaded without the ONNX and protobuf libraries.
+ *
+ * The reader decodes the protobuf wire format of the fields used by inference: the graph nodes with their attributes,
+ * the initializers and the graph inputs and outputs. Subgraphs (Loop, If), sparse initializers and external tensor
+ * data are not supported and throw. Graph inputs that have an initializer (exported parameters) are not listed in
+ * getInputs().
+ */
+class FALCOR_API OnnxModel
+{
+public:
+    /**
+     * Parse a serialized model. Throws if the model is malformed or uses unsupported features.
+     * @param[in] pData Contents of an ONNX file.
+     * @param[in] size Size in bytes.
+     */
+    OnnxModel(const void* pData, size_t size);
+
+    /// Load a model from a file. Throws if the file cannot be read.
+    static OnnxModel load(const std::filesystem::path& path);
+
+    /// Opset version of the default (ai.onnx) domain.
+    int64_t getOpsetVersion() const { return mOpsetVersion; }
+    /// Nodes in topological order.
+    const std::vector<OnnxNode>& getNodes() const { return mNodes; }
+    const std::map<std::string, OnnxTensor>& getInitializers() const { return mInitializers; }
+    const std::vector<OnnxValueInfo>& getInputs() const { return mInputs; }
+    const std::vector<OnnxValueInfo>& getOutputs() const { return mOutputs; }
+
+private:
+    int64_t mOpsetVersion = 0;
+    std::vector<OnnxNode> mNodes;
+    std::map<std::string, OnnxTensor> mInitializers;
+    std::vector<OnnxValueInfo> mInputs;
+    std::vector<OnnxValueInfo> mOutputs;
+};
+} // namespace Falcor
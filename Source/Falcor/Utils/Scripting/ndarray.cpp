@@ -125,6 +125,7 @@ struct ndarray_handle
     bool free_shape;
     bool free_strides;
     bool call_deleter;
+    bool ro; ///< Read-only, exported as a read-only buffer.
 };
 
 void nb_ndarray_dealloc(PyObject* self)
@@ -141,7 +142,7 @@ void nb_ndarray_dealloc(PyObject* self)
     tp_free(self);
 }
 
-int nb_ndarray_getbuffer(PyObject* exporter, Py_buffer* view, int)
+int nb_ndarray_getbuffer(PyObject* exporter, Py_buffer* view, int flags)
 {
     nb_ndarray* self = (nb_ndarray*)exporter;
 
@@ -157,6 +158,12 @@ int nb_ndarray_getbuffer(PyObject* exporter, Py_buffer* view, int)
         return -1;
     }
 
+    if (self->th->ro && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "Attempted to create a writable buffer from a read-only ndarray!");
+        return -1;
+    }
+
     const char* format = nullptr;
     switch ((dlpack::dtype_code)t.dtype.code)
     {
@@ -238,7 +245,7 @@ int nb_ndarray_getbuffer(PyObject* exporter, Py_buffer* view, int)
 
     view->ndim = t.ndim;
     view->len = len;
-    view->readonly = false;
+    view->readonly = self->th->ro;
     view->suboffsets = nullptr;
     view->internal = nullptr;
     view->strides = strides.release();
@@ -620,6 +627,7 @@ ndarray_handle* ndarray_import(PyObject* o, const ndarray_req* req, bool convert
     result->owner = nullptr;
     result->free_shape = false;
     result->call_deleter = true;
+    result->ro = false;
 
     // Ensure that the strides member is always initialized
     if (t.strides)
@@ -695,7 +703,8 @@ ndarray_handle* ndarray_create(
     const int64_t* strides_in,
     dlpack::dtype* dtype,
     int32_t device_type,
-    int32_t device_id
+    int32_t device_id,
+    bool ro
 )
 {
     /* DLPack mandates 256-byte alignment of the 'DLTensor::data' field, but
@@ -757,6 +766,7 @@ ndarray_handle* ndarray_create(
     result->free_shape = true;
     result->free_strides = true;
     result->call_deleter = false;
+    result->ro = ro;
     Py_XINCREF(owner);
     return result.release();
 }
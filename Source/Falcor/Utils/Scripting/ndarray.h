@@ -75,7 +75,8 @@ FALCOR_API ndarray_handle* ndarray_create(
     const int64_t* strides,
     dlpack::dtype* dtype,
     int32_t device,
-    int32_t device_id
+    int32_t device_id,
+    bool ro
 );
 
 /// Increase the reference count of the given tensor object; returns a pointer
@@ -180,6 +181,10 @@ struct pytorch
 {};
 struct jax
 {};
+/// Read-only ndarray. NumPy arrays created from it are not writeable. DLPack has no read-only flag, so arrays
+/// exported to other frameworks are writable.
+struct ro
+{};
 
 template<typename T>
 constexpr dlpack::dtype dtype()
@@ -318,6 +323,7 @@ struct ndarray_info
     using shape_type = void;
     constexpr static auto name = const_name("ndarray");
     constexpr static ndarray_framework framework = ndarray_framework::none;
+    constexpr static bool readonly = false;
 };
 
 template<typename T, typename... Ts>
@@ -332,6 +338,12 @@ struct ndarray_info<shape<Is...>, Ts...> : ndarray_info<Ts...>
     using shape_type = shape<Is...>;
 };
 
+template<typename... Ts>
+struct ndarray_info<ro, Ts...> : ndarray_info<Ts...>
+{
+    constexpr static bool readonly = true;
+};
+
 template<typename... Ts>
 struct ndarray_info<numpy, Ts...> : ndarray_info<Ts...>
 {
@@ -388,7 +400,7 @@ public:
         int32_t device_id = 0
     )
     {
-        m_handle = detail::ndarray_create(value, ndim, shape, owner.ptr(), strides, &dtype, device_type, device_id);
+        m_handle = detail::ndarray_create(value, ndim, shape, owner.ptr(), strides, &dtype, device_type, device_id, Info::readonly);
         m_dltensor = *detail::ndarray_inc_ref(m_handle);
     }
 
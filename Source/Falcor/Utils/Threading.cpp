@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Error.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
 
 namespace Falcor
 {
@@ -43,6 +44,10 @@ struct ThreadingData
 static std::mutex sThreadingInitMutex;
 static uint32_t sThreadingInitCount = 0;
 
+// Only a weak reference is kept, so no threads are left to join when the library is unloaded.
+static std::mutex sSharedPoolMutex;
+static std::weak_ptr<BS::thread_pool> sSharedPool;
+
 void Threading::start(uint32_t threadCount)
 {
     std::lock_guard<std::mutex> lock(sThreadingInitMutex);
@@ -90,6 +95,18 @@ void Threading::finish()
     }
 }
 
+std::shared_ptr<BS::thread_pool> Threading::getSharedPool()
+{
+    std::lock_guard<std::mutex> lock(sSharedPoolMutex);
+    std::shared_ptr<BS::thread_pool> pPool = sSharedPool.lock();
+    if (!pPool)
+    {
+        pPool = std::make_shared<BS::thread_pool>();
+        sSharedPool = pPool;
+    }
+    return pPool;
+}
+
 Threading::Task::Task() {}
 
 bool Threading::Task::isRunning()
@@ -29,10 +29,16 @@
 #include "Core/Macros.h"
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <cstdint>
 
+namespace BS
+{
+class thread_pool;
+}
+
 namespace Falcor
 {
 class FALCOR_API Threading
@@ -85,6 +91,14 @@ public:
      * @return Handle to the task
      */
     static Task dispatchTask(const std::function<void(void)>& func);
+
+    /**
+     * Get the worker pool shared by the CPU work of the event and block storage utilities.
+     * The pool has one thread per logical core. It is created on first use and destroyed, joining its threads, when
+     * the last reference is released. Holders must release it before their module is unloaded.
+     * @return Reference to the shared pool.
+     */
+    static std::shared_ptr<BS::thread_pool> getSharedPool();
 };
 
 /**
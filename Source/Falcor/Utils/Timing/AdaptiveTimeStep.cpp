@@ -0,0 +1,79 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AdaptiveTimeStep.h"
+#include "Core/Error.h"
+
+namespace Falcor
+{
+AdaptiveTimeStep::AdaptiveTimeStep(double basePeriod, const Desc& desc) : mDesc(desc), mBasePeriod(basePeriod)
+{
+    FALCOR_CHECK(basePeriod > 0.0, "Invalid base period {}.", basePeriod);
+    FALCOR_CHECK(desc.maxSubdivision + desc.maxMerge < 32, "Too many step levels ({} subdivisions, {} merges).", desc.maxSubdivision, desc.maxMerge);
+    FALCOR_CHECK(
+        desc.lowActivity < desc.highActivity,
+        "Low activity {} must be less than the high activity {}.",
+        desc.lowActivity,
+        desc.highActivity
+    );
+}
+
+void AdaptiveTimeStep::reset(double time)
+{
+    mOrigin = time;
+    mTicks = 0;
+    mLevel = 0;
+}
+
+double AdaptiveTimeStep::step()
+{
+    mTicks += getStepTicks(mLevel);
+    return getTime();
+}
+
+void AdaptiveTimeStep::reportActivity(double activity)
+{
+    if (activity > mDesc.highActivity && mLevel > -int32_t(mDesc.maxSubdivision))
+    {
+        mLevel--;
+    }
+    else if (activity < mDesc.lowActivity && mLevel < int32_t(mDesc.maxMerge) && mTicks % getStepTicks(mLevel + 1) == 0)
+    {
+        mLevel++;
+    }
+}
+
+double AdaptiveTimeStep::getPeriod() const
+{
+    return mBasePeriod * double(getStepTicks(mLevel)) / double(getStepTicks(0));
+}
+
+double AdaptiveTimeStep::getTime() const
+{
+    return mOrigin + mBasePeriod * double(mTicks) / double(getStepTicks(0));
+}
+} // namespace Falcor
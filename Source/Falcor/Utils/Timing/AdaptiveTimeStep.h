@@ -0,0 +1,90 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+
+namespace Falcor
+{
+/**
+ * Adaptive time step driven by activity feedback.
+ *
+ * The step is the base period scaled by a power of two, between base / 2^maxSubdivision and base * 2^maxMerge.
+ * Time is counted in integer ticks of the finest step, so the sequence of times only depends on the sequence of
+ * reported activities. The step is halved when the reported activity exceeds the high threshold and doubled
+ * when it falls below the low threshold. A doubled step is only taken once the time is a multiple of it, which
+ * keeps the times on the same hierarchical grid independent of when the activity changes.
+ */
+class FALCOR_API AdaptiveTimeStep
+{
+public:
+    struct Desc
+    {
+        uint32_t maxSubdivision = 4; ///< Maximum number of times the base period is halved.
+        uint32_t maxMerge = 4;       ///< Maximum number of times the base period is doubled.
+        double lowActivity = 0.5;    ///< Activity below which the step grows.
+        double highActivity = 2.0;   ///< Activity above which the step shrinks.
+    };
+
+    /**
+     * Constructor. Throws if the description is invalid.
+     * @param[in] basePeriod Base time step in seconds.
+     * @param[in] desc Step bounds and activity thresholds.
+     */
+    AdaptiveTimeStep(double basePeriod, const Desc& desc);
+
+    /// Restart at the given time with the base step.
+    void reset(double time);
+
+    /// Advance the time by the current step and return the new time.
+    double step();
+
+    /**
+     * Report the activity of the last step, which determines the next step.
+     * The activity is typically the maximum number of event threshold crossings of a pixel in the last step.
+     */
+    void reportActivity(double activity);
+
+    const Desc& getDesc() const { return mDesc; }
+    double getBasePeriod() const { return mBasePeriod; }
+    /// Current step relative to the base period as a power of two, negative if subdivided.
+    int32_t getLevel() const { return mLevel; }
+    /// Current step in seconds.
+    double getPeriod() const;
+    double getTime() const;
+
+private:
+    uint64_t getStepTicks(int32_t level) const { return uint64_t(1) << uint32_t(level + int32_t(mDesc.maxSubdivision)); }
+
+    Desc mDesc;
+    double mBasePeriod;
+    double mOrigin = 0.0;
+    uint64_t mTicks = 0; ///< Time since the origin in finest steps.
+    int32_t mLevel = 0;
+};
+} // namespace Falcor
@@ -46,6 +46,11 @@ constexpr char kPause[] = "pause";
 constexpr char kPlay[] = "play";
 constexpr char kStop[] = "stop";
 constexpr char kStep[] = "step";
+constexpr char kSetAdaptiveStep[] = "setAdaptiveStep";
+constexpr char kDisableAdaptiveStep[] = "disableAdaptiveStep";
+constexpr char kAdaptiveStep[] = "adaptiveStep";
+constexpr char kStepPeriod[] = "stepPeriod";
+constexpr char kReportActivity[] = "reportActivity";
 
 std::optional<uint32_t> fpsDropdown(Gui::Window& w, uint32_t curVal)
 {
@@ -207,10 +212,32 @@ Clock& Clock::setTime(double seconds, bool deferToNextTick)
 
         mTime.delta = mTime.now - seconds;
         mTime.now = seconds;
+        if (mAdaptiveStep)
+            mAdaptiveStep->reset(seconds);
     }
     return *this;
 }
 
+Clock& Clock::setAdaptiveStep(const AdaptiveTimeStep::Desc& desc)
+{
+    mAdaptiveStep.emplace(mStepPeriod, desc);
+    mAdaptiveStep->reset(mTime.now);
+    return *this;
+}
+
+Clock& Clock::disableAdaptiveStep()
+{
+    mAdaptiveStep.reset();
+    return *this;
+}
+
+Clock& Clock::reportActivity(double activity)
+{
+    if (mAdaptiveStep)
+        mAdaptiveStep->reportActivity(activity);
+    return *this;
+}
+
 Clock& Clock::setFrame(uint64_t f, bool deferToNextTick)
 {
     resetDeferredObjects();
@@ -258,6 +285,20 @@ Clock& Clock::step(int64_t frames)
 
     updateTimer();
     double t = isSimulatingFps() ? timeFromFrame(mFrames, mTicksPerFrame) : ((mTimer.delta() * mScale) + mTime.now);
+    if (mAdaptiveStep && !isSimulatingFps())
+    {
+        // The adaptive step only moves forward, stepping backward restarts it at the previous time.
+        if (frames > 0)
+        {
+            for (int64_t i = 0; i < frames; ++i)
+                t = mAdaptiveStep->step();
+        }
+        else
+        {
+            t = std::max(0.0, mTime.now - double(-frames) * mAdaptiveStep->getPeriod());
+            mAdaptiveStep->reset(t);
+        }
+    }
     t = clampTime(t);
     mTime.update(t);
     return *this;
@@ -278,6 +319,8 @@ void Clock::renderUI(Gui::Window& w)
         setTime(time);
     if (!isSimulatingFps() && w.var("Scale", scale))
         setTimeScale(scale);
+    if (mAdaptiveStep && !isSimulatingFps())
+        w.text(fmt::format("Adaptive step: {:.6f} s (level {})", mAdaptiveStep->getPeriod(), mAdaptiveStep->getLevel()));
     bool showStep = mPaused && isSimulatingFps();
 
     float indent = showStep ? 10.0f : 60.0f;
@@ -334,6 +377,27 @@ FALCOR_SCRIPT_BINDING(Clock)
     clock.def(kPlay, &Clock::play);
     clock.def(kStop, &Clock::stop);
     clock.def(kStep, &Clock::step, "frames"_a = 1);
+
+    clock.def(
+        kSetAdaptiveStep,
+        [](Clock* pClock, uint32_t maxSubdivision, uint32_t maxMerge, double lowActivity, double highActivity)
+        {
+            AdaptiveTimeStep::Desc desc;
+            desc.maxSubdivision = maxSubdivision;
+            desc.maxMerge = maxMerge;
+            desc.lowActivity = lowActivity;
+            desc.highActivity = highActivity;
+            pClock->setAdaptiveStep(desc);
+        },
+        "maxSubdivision"_a = AdaptiveTimeStep::Desc().maxSubdivision,
+        "maxMerge"_a = AdaptiveTimeStep::Desc().maxMerge,
+        "lowActivity"_a = AdaptiveTimeStep::Desc().lowActivity,
+        "highActivity"_a = AdaptiveTimeStep::Desc().highActivity
+    );
+    clock.def(kDisableAdaptiveStep, &Clock::disableAdaptiveStep);
+    clock.def_property_readonly(kAdaptiveStep, &Clock::isAdaptiveStep);
+    clock.def_property_readonly(kStepPeriod, &Clock::getStepPeriod);
+    clock.def(kReportActivity, &Clock::reportActivity, "activity"_a);
 }
 
 std::string Clock::getScript(const std::string& var) const
@@ -347,6 +411,11 @@ std::string Clock::getScript(const std::string& var) const
         s += ScriptWriter::makeSetProperty(var, kExitFrame, mExitFrame);
     s += std::string("# If ") + kFramerate + " is not zero, you can use the frame property to set the start frame\n";
     s += "# " + ScriptWriter::makeSetProperty(var, kFrame, 0);
+    if (mAdaptiveStep)
+    {
+        const AdaptiveTimeStep::Desc& desc = mAdaptiveStep->getDesc();
+        s += ScriptWriter::makeMemberFunc(var, kSetAdaptiveStep, desc.maxSubdivision, desc.maxMerge, desc.lowActivity, desc.highActivity);
+    }
     if (mPaused)
         s += ScriptWriter::makeMemberFunc(var, kPause);
     return s;
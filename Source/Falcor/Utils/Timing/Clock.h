@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "AdaptiveTimeStep.h"
 #include "CpuTimer.h"
 #include "Core/Macros.h"
 #include "Utils/UI/Gui.h"
@@ -235,9 +236,39 @@ public:
     {
         // mScale = scale;
         mTimer = StableTimer(1.0 / scale);
+        mStepPeriod = 1.0 / scale;
+        if (mAdaptiveStep)
+            setAdaptiveStep(mAdaptiveStep->getDesc());
         return *this;
     }
 
+    /**
+     * Enable the adaptive time step. Each tick advances the time by a power-of-two multiple of 1 / timeScale that is
+     * adjusted by reportActivity(), see AdaptiveTimeStep. Ignored when simulating FPS. Restarts at the current time.
+     */
+    Clock& setAdaptiveStep(const AdaptiveTimeStep::Desc& desc);
+
+    /**
+     * Disable the adaptive time step.
+     */
+    Clock& disableAdaptiveStep();
+
+    /**
+     * Check if the adaptive time step is enabled
+     */
+    bool isAdaptiveStep() const { return mAdaptiveStep.has_value(); }
+
+    /**
+     * Report the activity of the last frame, which determines the next adaptive time step.
+     * Ignored if the adaptive time step is disabled.
+     */
+    Clock& reportActivity(double activity);
+
+    /**
+     * Get the time step of the next tick in seconds. This value is ignored when simulating FPS
+     */
+    double getStepPeriod() const { return mAdaptiveStep ? mAdaptiveStep->getPeriod() : mStepPeriod; }
+
     /**
      * Get the scale
      */
@@ -281,6 +312,8 @@ private:
     uint64_t mFrames = 0;
     uint64_t mTicksPerFrame = 0;
     StableTimer mTimer;
+    double mStepPeriod = 1.0 / 60.0;
+    std::optional<AdaptiveTimeStep> mAdaptiveStep;
 
     bool mPaused = false;
     double mScale = 1;
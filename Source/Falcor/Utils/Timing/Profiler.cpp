@@ -31,6 +31,7 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -98,6 +99,14 @@ pybind11::dict toPython(const std::vector<Profiler::Event*>& events)
 
     return result;
 }
+
+pybind11::dict toPython(const std::vector<std::pair<std::string, float>>& counters)
+{
+    pybind11::dict result;
+    for (const auto& [name, value] : counters)
+        result[name.c_str()] = value;
+    return result;
+}
 } // namespace
 
 // Profiler::Stats
@@ -265,7 +274,7 @@ Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames) : mRese
         lane.records.reserve(reservedFrames);
 }
 
-void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
+void Profiler::Capture::captureEvents(const std::vector<Event*>& events, const std::vector<std::pair<std::string, float>>& counters)
 {
     if (events.empty())
         return;
@@ -274,7 +283,7 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
     if (mEvents.empty())
     {
         mEvents = events;
-        mLanes.resize(mEvents.size() * 2);
+        mLanes.resize(mEvents.size() * 2 + counters.size());
         for (size_t i = 0; i < mEvents.size(); ++i)
         {
             auto& pEvent = mEvents[i];
@@ -283,6 +292,13 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
             mLanes[i * 2 + 1].name = pEvent->getName() + "/gpu_time";
             mLanes[i * 2 + 1].records.reserve(mReservedFrames);
         }
+        // Counters set on the first captured frame get a lane, they are recorded as zero in frames they are not set.
+        for (size_t i = 0; i < counters.size(); ++i)
+        {
+            mCounters.push_back(counters[i].first);
+            mLanes[mEvents.size() * 2 + i].name = counters[i].first;
+            mLanes[mEvents.size() * 2 + i].records.reserve(mReservedFrames);
+        }
         return; // Exit as no data is available on first capture.
     }
 
@@ -293,6 +309,11 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
         mLanes[i * 2].records.push_back(pEvent->getCpuTime());
         mLanes[i * 2 + 1].records.push_back(pEvent->getGpuTime());
     }
+    for (size_t i = 0; i < mCounters.size(); ++i)
+    {
+        auto it = std::find_if(counters.begin(), counters.end(), [&](const auto& counter) { return counter.first == mCounters[i]; });
+        mLanes[mEvents.size() * 2 + i].records.push_back(it != counters.end() ? it->second : 0.f);
+    }
 
     ++mFrameCount;
 }
@@ -370,6 +391,28 @@ void Profiler::endEvent(RenderContext* pRenderContext, const std::string& name,
     }
 }
 
+void Profiler::setCounter(const std::string& name, float value)
+{
+    if (!mEnabled || mPaused)
+        return;
+
+    // '/' is used as a "path delimiter", so it cannot be used in the counter name.
+    if (name.find('/') != std::string::npos)
+    {
+        logWarning("Profiler counter names must not contain '/'. Ignoring this profiler counter.");
+        return;
+    }
+
+    const std::string path = mCurrentEventName + "/" + name;
+    auto it = std::find_if(
+        mCurrentFrameCounters.begin(), mCurrentFrameCounters.end(), [&](const auto& counter) { return counter.first == path; }
+    );
+    if (it != mCurrentFrameCounters.end())
+        it->second = value;
+    else
+        mCurrentFrameCounters.emplace_back(path, value);
+}
+
 Profiler::Event* Profiler::getEvent(const std::string& name)
 {
     auto event = findEvent(name);
@@ -397,9 +440,11 @@ void Profiler::endFrame(RenderContext* pRenderContext)
     mFenceValue = pRenderContext->signal(mpFence.get());
 
     if (mpCapture)
-        mpCapture->captureEvents(mCurrentFrameEvents);
+        mpCapture->captureEvents(mCurrentFrameEvents, mCurrentFrameCounters);
 
     mLastFrameEvents = std::move(mCurrentFrameEvents);
+    mLastFrameCounters = std::move(mCurrentFrameCounters);
+    mCurrentFrameCounters.clear();
     ++mFrameIndex;
 
     if (mPendingReset)
@@ -498,6 +543,7 @@ FALCOR_SCRIPT_BINDING(Profiler)
     profiler.def_property("paused", &Profiler::isPaused, &Profiler::setPaused);
     profiler.def_property_readonly("is_capturing", &Profiler::isCapturing);
     profiler.def_property_readonly("events", [](const Profiler& profiler) { return toPython(profiler.getEvents()); });
+    profiler.def_property_readonly("counters", [](const Profiler& profiler) { return toPython(profiler.getCounters()); });
     profiler.def("start_capture", &Profiler::startCapture, "reserved_frames"_a = 1000);
     profiler.def("end_capture", endCapture);
     profiler.def("end_frame", [](Profiler& self) { self.endFrame(self.getDevice()->getRenderContext()); });
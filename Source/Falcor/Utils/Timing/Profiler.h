@@ -34,6 +34,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -142,12 +143,13 @@ public:
         void writeToFile(const std::filesystem::path& path) const;
 
     private:
-        void captureEvents(const std::vector<Event*>& events);
+        void captureEvents(const std::vector<Event*>& events, const std::vector<std::pair<std::string, float>>& counters);
         void finalize();
 
         size_t mReservedFrames = 0;
         size_t mFrameCount = 0;
         std::vector<Event*> mEvents;
+        std::vector<std::string> mCounters;
         std::vector<Lane> mLanes;
         bool mFinalized = false;
 
@@ -239,6 +241,19 @@ public:
      */
     const std::vector<Event*>& getEvents() const { return mLastFrameEvents; }
 
+    /**
+     * Set a counter for the current frame, such as the amount of work a pass skipped.
+     * The counter is nested in the current event like a child event and recorded in captures next to the event times.
+     * @param[in] name The counter name.
+     * @param[in] value The counter value.
+     */
+    void setCounter(const std::string& name, float value);
+
+    /**
+     * Get the profiler counters (previous frame).
+     */
+    const std::vector<std::pair<std::string, float>>& getCounters() const { return mLastFrameCounters; }
+
     /**
      * Reset profiler stats at the next call to endFrame().
      */
@@ -269,6 +284,8 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Event>> mEvents; ///< Events by name.
     std::vector<Event*> mCurrentFrameEvents;                         ///< Events registered for current frame.
     std::vector<Event*> mLastFrameEvents;                            ///< Events from last frame.
+    std::vector<std::pair<std::string, float>> mCurrentFrameCounters; ///< Counters set in the current frame.
+    std::vector<std::pair<std::string, float>> mLastFrameCounters;    ///< Counters from last frame.
     std::string mCurrentEventName;                                   ///< Current nested event name.
     uint32_t mCurrentLevel = 0;                                      ///< Current nesting level.
     uint32_t mFrameIndex = 0;                                        ///< Current frame index.
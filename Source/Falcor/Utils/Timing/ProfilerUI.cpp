@@ -249,6 +249,17 @@ void ProfilerUI::render()
         renderGraph(graphSize, mHighlightIndex, newHighlightIndex);
         mHighlightIndex = newHighlightIndex;
     }
+
+    // List the counters below the events.
+    const auto& counters = mpProfiler->getCounters();
+    if (!counters.empty())
+    {
+        ImGui::Columns(1);
+        ImGui::Dummy(ImVec2(0.f, kHeaderSpacing));
+        ImGui::TextUnformatted("Counters");
+        for (const auto& [name, value] : counters)
+            ImGui::Text("%s: %g", name.c_str(), value);
+    }
 }
 
 void ProfilerUI::renderOptions()
@@ -0,0 +1,114 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BatchJobs.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+using json = nlohmann::ordered_json;
+
+using namespace Falcor;
+
+namespace Mogwai
+{
+    namespace
+    {
+        const char kJobs[] = "jobs";
+        const char kScene[] = "scene";
+        const char kScript[] = "script";
+        const char kProperties[] = "properties";
+        const char kStartFrame[] = "startFrame";
+        const char kExitFrame[] = "exitFrame";
+        const char kOutputDir[] = "outputDir";
+        const char kReloadScene[] = "reloadScene";
+
+        std::filesystem::path resolvePath(const std::filesystem::path& directory, const json& value)
+        {
+            std::filesystem::path path = value.get<std::string>();
+            if (path.empty() || path.is_absolute()) return path;
+            return (directory / path).lexically_normal();
+        }
+
+        BatchJob parseJob(const std::filesystem::path& directory, const json& j)
+        {
+            FALCOR_CHECK(j.is_object(), "Batch job must be an object.");
+
+            BatchJob job;
+            for (const auto& [key, value] : j.items())
+            {
+                if (key == kScene) job.scene = resolvePath(directory, value);
+                else if (key == kScript) job.script = resolvePath(directory, value);
+                else if (key == kProperties)
+                {
+                    FALCOR_CHECK(value.is_object(), "Batch job '{}' must map pass names to properties.", kProperties);
+                    for (const auto& [passName, props] : value.items())
+                    {
+                        FALCOR_CHECK(props.is_object(), "Batch job properties of pass '{}' must be an object.", passName);
+                        job.properties.emplace(passName, Properties(props));
+                    }
+                }
+                else if (key == kStartFrame) job.startFrame = value.get<uint64_t>();
+                else if (key == kExitFrame) job.exitFrame = value.get<uint64_t>();
+                else if (key == kOutputDir) job.outputDir = resolvePath(directory, value);
+                else if (key == kReloadScene) job.reloadScene = value.get<bool>();
+                else logWarning("Unknown batch job field '{}'.", key);
+            }
+
+            FALCOR_CHECK(!job.script.empty(), "Batch job has no '{}'.", kScript);
+            return job;
+        }
+    }
+
+    std::vector<BatchJob> loadBatchJobs(const std::filesystem::path& path)
+    {
+        std::ifstream ifs(path);
+        FALCOR_CHECK(ifs.good(), "Failed to open batch file '{}'.", path);
+
+        const auto directory = std::filesystem::absolute(path).parent_path();
+        std::vector<BatchJob> jobs;
+        try
+        {
+            const json j = json::parse(ifs);
+            FALCOR_CHECK(j.is_object() && j.contains(kJobs) && j[kJobs].is_array(), "Batch file has no '{}' array.", kJobs);
+            for (const auto& jobJson : j[kJobs]) jobs.push_back(parseJob(directory, jobJson));
+        }
+        catch (const json::exception& e)
+        {
+            FALCOR_THROW("Failed to parse batch file '{}': {}", path, e.what());
+        }
+
+        FALCOR_CHECK(!jobs.empty(), "Batch file '{}' has no jobs.", path);
+        return jobs;
+    }
+
+    Properties mergeProperties(const Properties& props, const Properties& overrides)
+    {
+        json j = props.toJson();
+        for (const auto& [key, value] : overrides.toJson().items()) j[key] = value;
+        return Properties(std::move(j));
+    }
+}
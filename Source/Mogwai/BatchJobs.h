@@ -0,0 +1,75 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "Utils/Properties.h"
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Mogwai
+{
+    /** A job of a Mogwai batch, which runs a graph script on a scene for a range of frames.
+        Jobs run sequentially in one process. The device, the compiled programs and the scene are kept across jobs,
+        the graphs and thereby all render pass state are recreated for every job.
+    */
+    struct BatchJob
+    {
+        std::filesystem::path scene;                          ///< Scene file. The scene of the previous job is kept if the paths match.
+        std::filesystem::path script;                         ///< Python script setting up the graphs and the clock.
+        std::map<std::string, Falcor::Properties> properties; ///< Render pass properties by pass name, overriding the ones set by the script.
+        std::optional<uint64_t> startFrame;                   ///< Clock frame to start at, overriding the one set by the script.
+        std::optional<uint64_t> exitFrame;                    ///< Clock frame to end at, overriding the one set by the script.
+        std::filesystem::path outputDir;                      ///< Output directory, created before the script runs and passed to it as `outputDir`.
+        bool reloadScene = false;                             ///< Reload the scene even if the previous job used the same one.
+    };
+
+    /** Load a batch file.
+        The file is a JSON object with a "jobs" array holding an object per job, for example:
+        {
+            "jobs": [
+                {
+                    "scene": "Bistro/BistroExterior.pyscene",
+                    "script": "scripts/Network.py",
+                    "properties": { "Network": { "directory": "Dataset/BistroExterior/bin" } },
+                    "startFrame": 0,
+                    "exitFrame": 200000,
+                    "outputDir": "Dataset/BistroExterior"
+                }
+            ]
+        }
+        Relative paths are relative to the directory of the batch file. Throws if the file is invalid.
+    */
+    std::vector<BatchJob> loadBatchJobs(const std::filesystem::path& path);
+
+    /** Return the properties with the values of the given overrides replaced or added.
+    */
+    Falcor::Properties mergeProperties(const Falcor::Properties& props, const Falcor::Properties& overrides);
+}
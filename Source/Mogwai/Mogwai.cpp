@@ -88,6 +88,7 @@ namespace Mogwai
         resetEditor();
         getDevice()->wait(); // Need to do that because clearing the graphs will try to release some state objects which might be in use
         mGraphs.clear();
+        mpBatchContext.reset();
         if (mPipedOutput)
         {
 #if FALCOR_WINDOWS
@@ -113,6 +114,15 @@ namespace Mogwai
         auto regBinding = [this](pybind11::module& m) {this->registerScriptBindings(m); };
         ScriptBindings::registerBinding(regBinding);
 
+        // Load batch provided via command line. The script of the first job is run at the start of the first frame.
+        if (!mOptions.batchFile.empty())
+        {
+            mBatchJobs = loadBatchJobs(mOptions.batchFile);
+            mBatchClock = getGlobalClock();
+            loadBatchScene();
+            return;
+        }
+
         // Load script provided via command line.
         if (!mOptions.scriptFile.empty())
         {
@@ -454,6 +464,11 @@ namespace Mogwai
     }
 
     void Renderer::loadScript(const std::filesystem::path& path)
+    {
+        loadScript(path, Scripting::getDefaultContext());
+    }
+
+    void Renderer::loadScript(const std::filesystem::path& path, Scripting::Context& context)
     {
         FALCOR_ASSERT(!path.empty());
 
@@ -467,7 +482,7 @@ namespace Mogwai
             auto directory = std::filesystem::absolute(path).parent_path();
             AssetResolver::getDefaultResolver().addSearchPath(directory, SearchPathPriority::First);
 
-            Scripting::runScriptFromFile(path);
+            Scripting::runScriptFromFile(path, context);
 
             // Restore asset resolver.
             AssetResolver::getDefaultResolver() = oldResolver;
@@ -603,6 +618,103 @@ namespace Mogwai
         return mpScene;
     }
 
+    void Renderer::loadBatchScene()
+    {
+        const BatchJob& job = mBatchJobs[mBatchJobIndex];
+
+        // Restore the clock, so that the job starts like a separate run.
+        getGlobalClock() = mBatchClock;
+
+        if (job.scene != mBatchScenePath || job.reloadScene)
+        {
+            if (job.scene.empty()) unloadScene();
+            else loadScene(job.scene);
+            mBatchScenePath = job.scene;
+        }
+        else
+        {
+            // Setting the scene resets the time like loading it does.
+            setScene(mpScene);
+        }
+
+        mBatchScriptPending = true;
+    }
+
+    void Renderer::startBatchJob()
+    {
+        mBatchScriptPending = false;
+        mBatchExitPending = false;
+        mBatchJobStartTime = CpuTimer::getCurrentTimePoint();
+
+        const BatchJob& job = mBatchJobs[mBatchJobIndex];
+        logInfo("Starting batch job {}/{}: script '{}', scene '{}'.", mBatchJobIndex + 1, mBatchJobs.size(), job.script, job.scene);
+
+        if (!job.outputDir.empty()) std::filesystem::create_directories(job.outputDir);
+
+        // Run the script in a context of its own, so that no objects of previous jobs are kept alive by its globals.
+        mpBatchContext = std::make_unique<Scripting::Context>();
+        mpBatchContext->setObject("m", this);
+        mpBatchContext->setObject("t", &getGlobalClock()); // PYTHONDEPRECATED
+        mpBatchContext->setObject("outputDir", job.outputDir.generic_string());
+        loadScript(job.script, *mpBatchContext);
+
+        for (const auto& [passName, props] : job.properties)
+        {
+            bool found = false;
+            for (auto& g : mGraphs)
+            {
+                if (!g.pGraph->doesPassExist(passName)) continue;
+                g.pGraph->updatePass(passName, mergeProperties(g.pGraph->getPass(passName)->getProperties(), props));
+                found = true;
+            }
+            if (!found) logWarning("Batch job {}: no graph has a pass named '{}'.", mBatchJobIndex + 1, passName);
+        }
+
+        auto& clock = getGlobalClock();
+        if (job.startFrame) clock.setFrame(*job.startFrame);
+        if (job.exitFrame) clock.setExitFrame(*job.exitFrame);
+    }
+
+    void Renderer::endBatchJob()
+    {
+        // Destroy the graphs and their passes, which resets all pass state and flushes their output.
+        getDevice()->wait();
+        while (!mGraphs.empty())
+        {
+            ref<RenderGraph> pGraph = mGraphs.back().pGraph;
+            removeGraph(pGraph);
+        }
+        mActiveGraph = 0;
+        mpBatchContext.reset();
+        mKeyCallback = nullptr;
+        mSceneUpdateCallback = nullptr;
+
+        double duration = CpuTimer::calcDuration(mBatchJobStartTime, CpuTimer::getCurrentTimePoint());
+        logInfo("Finished batch job {}/{} in {:.2f} s.", mBatchJobIndex + 1, mBatchJobs.size(), duration * 1e-3);
+    }
+
+    void Renderer::updateBatch()
+    {
+        // The last job ends the application through the clock's exit condition like a single run does.
+        if (mBatchJobIndex + 1 == mBatchJobs.size()) return;
+
+        if (mBatchExitPending)
+        {
+            endBatchJob();
+            mBatchJobIndex++;
+            loadBatchScene();
+            return;
+        }
+
+        // A single run still renders the frame in which it shuts down, so the job does the same before the next starts.
+        auto& clock = getGlobalClock();
+        if (clock.shouldExit())
+        {
+            clock.setExitFrame(0);
+            mBatchExitPending = true;
+        }
+    }
+
     void Renderer::applyEditorChanges()
     {
         if (!mEditorProcess) return;
@@ -653,8 +765,15 @@ namespace Mogwai
         }
 
         // Execute graph.
-        pGraph->getPassesDictionary()[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        auto& dict = pGraph->getPassesDictionary();
+        dict[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        dict[kRenderPassFrameTime] = getGlobalClock().getTime();
+        dict[kRenderPassEventActivity] = -1.0;
         pGraph->execute(pRenderContext);
+
+        // Feed the event activity back to the adaptive clock.
+        const double activity = dict.getValue(kRenderPassEventActivity, -1.0);
+        if (activity >= 0.0) getGlobalClock().reportActivity(activity);
     }
 
     void Renderer::beginFrame(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo)
@@ -669,6 +788,8 @@ namespace Mogwai
 
     void Renderer::onFrameRender(RenderContext* pRenderContext, const ref<Fbo>& pTargetFbo)
     {
+        if (mBatchScriptPending) startBatchJob();
+
         if (!mScriptPath.empty())
         {
             auto path = mScriptPath;
@@ -749,6 +870,8 @@ namespace Mogwai
         }
 
         endFrame(pRenderContext, pTargetFbo);
+
+        if (!mBatchJobs.empty()) updateBatch();
     }
 
     bool Renderer::onMouseEvent(const MouseEvent& mouseEvent)
@@ -838,6 +961,7 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> scriptFlag(parser, "path", "Python script file to run.", {'s', "script"});
     args::Flag deferredFlag(parser, "deferred", "The script is loaded deferred.", {"deferred"});
     args::ValueFlag<std::string> sceneFlag(parser, "path", "Scene file (for example, a .pyscene file) to open.", { 'S', "scene" });
+    args::ValueFlag<std::string> batchFlag(parser, "path", "JSON batch file with jobs to run one after another in this process.", { 'b', "batch" });
     args::ValueFlag<std::string> shaderCacheFlag(parser, "shadercache", "Path to the GFX shader cache.", { "shadercache" });
     args::ValueFlag<std::string> logfileFlag(parser, "path", "File to write log into.", {'l', "logfile"});
     args::ValueFlag<int32_t> verbosityFlag(parser, "verbosity", "Logging verbosity (0=disabled, 1=fatal errors, 2=errors, 3=warnings, 4=infos, 5=debugging)", { 'v', "verbosity" }, 4);
@@ -963,6 +1087,15 @@ int runMain(int argc, char** argv)
     if (silentFlag) options.silentMode = true;
     if (useSceneCacheFlag) options.useSceneCache = true;
     if (rebuildSceneCacheFlag) options.rebuildSceneCache = true;
+    if (batchFlag)
+    {
+        if (scriptFlag || sceneFlag)
+        {
+            std::cerr << "The --batch flag can't be combined with --script or --scene." << std::endl;
+            return 1;
+        }
+        options.batchFile = args::get(batchFlag);
+    }
 
     Mogwai::Renderer renderer(config, options);
     return renderer.run();
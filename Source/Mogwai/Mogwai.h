@@ -30,7 +30,11 @@
 #include "Core/SampleApp.h"
 #include "Scene/SceneBuilder.h"
 #include "RenderGraph/RenderGraph.h"
+#include "Utils/Scripting/Scripting.h"
+#include "Utils/Timing/Clock.h"
+#include "Utils/Timing/CpuTimer.h"
 #include "AppData.h"
+#include "BatchJobs.h"
 
 namespace Falcor
 {
@@ -87,6 +91,7 @@ namespace Mogwai
             bool silentMode = false;
             bool useSceneCache = false;
             bool rebuildSceneCache = false;
+            std::string batchFile;
         };
 
         using KeyCallback = std::function<bool(bool pressed, uint32_t key)>;
@@ -110,6 +115,7 @@ namespace Mogwai
         void loadScriptDialog();
         void loadScriptDeferred(const std::filesystem::path& path);
         void loadScript(const std::filesystem::path& path);
+        void loadScript(const std::filesystem::path& path, Scripting::Context& context);
         void saveConfigDialog();
         void saveConfig(const std::filesystem::path& path) const;
         static std::string getVersionString();
@@ -212,6 +218,21 @@ namespace Mogwai
         // Scripting
         void registerScriptBindings(pybind11::module& m);
 
+        // Batch
+        void loadBatchScene();
+        void startBatchJob();
+        void endBatchJob();
+        void updateBatch();
+
+        std::vector<BatchJob> mBatchJobs;
+        size_t mBatchJobIndex = 0;
+        Clock mBatchClock;                                  ///< Clock state before the first job, restored for every job.
+        std::filesystem::path mBatchScenePath;              ///< Scene file loaded for the last job.
+        std::unique_ptr<Scripting::Context> mpBatchContext; ///< Script context of the current job.
+        CpuTimer::TimePoint mBatchJobStartTime;
+        bool mBatchScriptPending = false;                   ///< Run the script of the current job at the start of the next frame.
+        bool mBatchExitPending = false;                     ///< The current job reached its exit condition and renders its last frame.
+
         void handleGamepadInput(float deltaTimeSeconds);
     };
 
@@ -128,7 +128,7 @@ namespace Mogwai
         using namespace pybind11::literals;
 
         pybind11::class_<Renderer> renderer(m, "Renderer");
-        renderer.def(kRunScript.c_str(), &Renderer::loadScript, "path"_a);
+        renderer.def(kRunScript.c_str(), pybind11::overload_cast<const std::filesystem::path&>(&Renderer::loadScript), "path"_a);
         renderer.def(kLoadScene.c_str(), &Renderer::loadScene, "path"_a, "buildFlags"_a = SceneBuilder::Flags::Default);
         renderer.def(kUnloadScene.c_str(), &Renderer::unloadScene);
         renderer.def(kSaveConfig.c_str(), &Renderer::saveConfig, "path"_a);
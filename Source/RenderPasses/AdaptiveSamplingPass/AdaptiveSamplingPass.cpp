@@ -0,0 +1,218 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AdaptiveSamplingPass.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<RenderPass, AdaptiveSamplingPass>();
+}
+
+namespace
+{
+const std::string kShaderFile = "RenderPasses/AdaptiveSamplingPass/AdaptiveSampling.cs.slang";
+
+const std::string kInput = "input";
+const std::string kOutputSampleCount = "sampleCount";
+
+const std::string kEnabled = "enabled";
+const std::string kAccumulatePass = "accumulatePass";
+const std::string kContrastThreshold = "contrastThreshold";
+const std::string kTargetSamples = "targetSamples";
+const std::string kMinSamples = "minSamples";
+const std::string kMaxSamples = "maxSamples";
+const std::string kSmoothing = "smoothing";
+const std::string kMinSigma = "minSigma";
+
+/// Maximum sample count supported by the PathTracer (kMaxSamplesPerPixel in Params.slang).
+const uint32_t kMaxSamplesPerPixel = 64;
+} // namespace
+
+AdaptiveSamplingPass::AdaptiveSamplingPass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
+{
+    for (const auto& [key, value] : props)
+    {
+        if (key == kEnabled)
+            mEnabled = value;
+        else if (key == kAccumulatePass)
+            mAccumulatePass = std::max(1u, (uint32_t)value);
+        else if (key == kContrastThreshold)
+            mContrastThreshold = value;
+        else if (key == kTargetSamples)
+            mTargetSamples = value;
+        else if (key == kMinSamples)
+            mMinSamples = value;
+        else if (key == kMaxSamples)
+            mMaxSamples = value;
+        else if (key == kSmoothing)
+            mSmoothing = value;
+        else if (key == kMinSigma)
+            mMinSigma = value;
+        else
+            logWarning("Unknown property '{}' in AdaptiveSamplingPass properties.", key);
+    }
+
+    if (mMaxSamples < 1 || mMaxSamples > kMaxSamplesPerPixel)
+    {
+        logWarning("'maxSamples' must be in the range [1, {}]. Clamping to this range.", kMaxSamplesPerPixel);
+        mMaxSamples = std::clamp(mMaxSamples, 1u, kMaxSamplesPerPixel);
+    }
+    if (mMinSamples < 1 || mMinSamples > mMaxSamples)
+    {
+        // Pixels without samples would be accumulated as black.
+        logWarning("'minSamples' must be in the range [1, {}]. Clamping to this range.", mMaxSamples);
+        mMinSamples = std::clamp(mMinSamples, 1u, mMaxSamples);
+    }
+    mTargetSamples = std::clamp(mTargetSamples, float(mMinSamples), float(mMaxSamples));
+    mContrastThreshold = std::max(1e-3f, mContrastThreshold);
+    mSmoothing = std::clamp(mSmoothing, 1e-3f, 1.f);
+    mMinSigma = std::max(1e-6f, mMinSigma);
+
+    mpUpdateWeightsPass = ComputePass::create(mpDevice, kShaderFile, "updateWeights");
+    mpAllocateSamplesPass = ComputePass::create(mpDevice, kShaderFile, "allocateSamples");
+    mpParallelReduction = std::make_unique<ParallelReduction>(mpDevice);
+    mpWeightSum = mpDevice->createBuffer(sizeof(float4), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal);
+}
+
+Properties AdaptiveSamplingPass::getProperties() const
+{
+    Properties props;
+    props[kEnabled] = mEnabled;
+    props[kAccumulatePass] = mAccumulatePass;
+    props[kContrastThreshold] = mContrastThreshold;
+    props[kTargetSamples] = mTargetSamples;
+    props[kMinSamples] = mMinSamples;
+    props[kMaxSamples] = mMaxSamples;
+    props[kSmoothing] = mSmoothing;
+    props[kMinSigma] = mMinSigma;
+    return props;
+}
+
+RenderPassReflection AdaptiveSamplingPass::reflect(const CompileData& compileData)
+{
+    RenderPassReflection reflector;
+    reflector.addInput(kInput, "Accumulated color of the output frame").bindFlags(ResourceBindFlags::ShaderResource);
+    reflector.addOutput(kOutputSampleCount, "Sample count per pixel and frame (for visualization)")
+        .format(ResourceFormat::R8Uint)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    return reflector;
+}
+
+void AdaptiveSamplingPass::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
+{
+    // Restart the prediction in a new scene.
+    mInitialize = true;
+}
+
+void AdaptiveSamplingPass::execute(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    auto& dict = renderData.getDictionary();
+    if (!mEnabled)
+    {
+        dict[kRenderPassSampleCount] = ref<Texture>();
+        return;
+    }
+
+    ref<Texture> pInput = renderData.getTexture(kInput);
+    const uint2 resolution = uint2(pInput->getWidth(), pInput->getHeight());
+    if (any(resolution != mFrameDim))
+    {
+        mFrameDim = resolution;
+        prepareResources();
+    }
+
+    updateSampleCount(pRenderContext, pInput);
+
+    dict[kRenderPassSampleCount] = mpSampleCount;
+    if (ref<Texture> pOutput = renderData.getTexture(kOutputSampleCount))
+        pRenderContext->copyResource(pOutput.get(), mpSampleCount.get());
+}
+
+void AdaptiveSamplingPass::renderUI(Gui::Widgets& widget)
+{
+    widget.checkbox("Enabled", mEnabled);
+    widget.var("Target samples/pixel", mTargetSamples, float(mMinSamples), float(mMaxSamples), 0.5f);
+    widget.tooltip("Average number of samples per pixel and frame, used from the next output frame on.");
+    if (widget.var("Contrast threshold", mContrastThreshold, 1e-3f, 2.f, 0.01f))
+        mInitialize = true;
+    widget.var("Smoothing", mSmoothing, 1e-3f, 1.f, 0.01f);
+    widget.var("Min sigma", mMinSigma, 1e-6f, 1.f, 0.001f);
+}
+
+void AdaptiveSamplingPass::prepareResources()
+{
+    const ResourceBindFlags flags = ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource;
+    mpState = mpDevice->createTexture2D(mFrameDim.x, mFrameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, flags);
+    mpWeight = mpDevice->createTexture2D(mFrameDim.x, mFrameDim.y, ResourceFormat::R32Float, 1, 1, nullptr, flags);
+
+    // Until the first output frame has been seen every pixel gets the target sample count.
+    const std::vector<uint8_t> sampleCount(size_t(mFrameDim.x) * mFrameDim.y, uint8_t(std::lround(mTargetSamples)));
+    mpSampleCount = mpDevice->createTexture2D(mFrameDim.x, mFrameDim.y, ResourceFormat::R8Uint, 1, 1, sampleCount.data(), flags);
+
+    mInitialize = true;
+}
+
+void AdaptiveSamplingPass::updateSampleCount(RenderContext* pRenderContext, const ref<Texture>& pInput)
+{
+    FALCOR_PROFILE(pRenderContext, "AdaptiveSamplingPass::updateSampleCount");
+
+    auto setConstants = [&](const ShaderVar& var)
+    {
+        var["PerFrameCB"]["gResolution"] = mFrameDim;
+        var["PerFrameCB"]["gContrastThreshold"] = mContrastThreshold;
+        var["PerFrameCB"]["gSmoothing"] = mSmoothing;
+        var["PerFrameCB"]["gMinSigma"] = mMinSigma;
+        var["PerFrameCB"]["gInitialize"] = mInitialize ? 1u : 0u;
+        var["PerFrameCB"]["gMinSamples"] = mMinSamples;
+        var["PerFrameCB"]["gMaxSamples"] = mMaxSamples;
+        var["PerFrameCB"]["gTargetSamples"] = mTargetSamples;
+    };
+
+    {
+        auto var = mpUpdateWeightsPass->getRootVar();
+        setConstants(var);
+        var["gInput"] = pInput;
+        var["gState"] = mpState;
+        var["gWeight"] = mpWeight;
+        mpUpdateWeightsPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    }
+
+    // The sum stays on the GPU, the allocation reads it directly.
+    mpParallelReduction->execute<float4>(pRenderContext, mpWeight, ParallelReduction::Type::Sum, nullptr, mpWeightSum);
+
+    {
+        auto var = mpAllocateSamplesPass->getRootVar();
+        setConstants(var);
+        var["gWeight"] = mpWeight;
+        var["gWeightSum"] = mpWeightSum;
+        var["gSampleCount"] = mpSampleCount;
+        mpAllocateSamplesPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    }
+
+    mInitialize = false;
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "RenderGraph/RenderPass.h"
+#include "Utils/Algorithm/ParallelReduction.h"
+#include <memory>
+
+using namespace Falcor;
+
+/**
+ * Allocates path tracing samples where events are likely to be ambiguous.
+ *
+ * The pass takes the accumulated color of an output frame and predicts for every pixel how close the next output frame
+ * lands to a threshold crossing of the event model. Pixels far from a crossing get the minimum sample count, the
+ * remaining budget is distributed proportionally to the crossing likelihood.
+ *
+ * The sample counts are published in the render graph dictionary (kRenderPassSampleCount), which the PathTracer uses
+ * in the next frames when its sample count input is not connected. This closes the loop without a cycle in the graph.
+ * Mark the sampleCount output so that the graph executes the pass. Like the event passes, it is scheduled on the last
+ * frame of every output frame, when the accumulated color is complete.
+ * The counts are per PathTracer frame, so with accumulatePass frames per output frame a pixel receives between
+ * accumulatePass * minSamples and accumulatePass * maxSamples samples.
+ */
+class AdaptiveSamplingPass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(AdaptiveSamplingPass, "AdaptiveSamplingPass", "Event-likelihood-driven per-pixel sample allocation.");
+
+    static ref<AdaptiveSamplingPass> create(ref<Device> pDevice, const Properties& props)
+    {
+        return make_ref<AdaptiveSamplingPass>(pDevice, props);
+    }
+
+    AdaptiveSamplingPass(ref<Device> pDevice, const Properties& props);
+
+    virtual Properties getProperties() const override;
+    virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual RenderPassSchedule getSchedule() const override { return RenderPassSchedule::every(mAccumulatePass, mAccumulatePass - 1); }
+    virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
+    virtual void renderUI(Gui::Widgets& widget) override;
+    virtual void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
+
+private:
+    void prepareResources();
+    void updateSampleCount(RenderContext* pRenderContext, const ref<Texture>& pInput);
+
+    /// Publish the sample counts for the PathTracer
+    bool mEnabled = true;
+    /// Number of frames accumulated into an output frame, the sample counts are updated once per output frame
+    uint32_t mAccumulatePass = 1;
+    /// Contrast threshold of the event model in lin-log units
+    float mContrastThreshold = 0.2f;
+    /// Average number of samples per pixel and frame
+    float mTargetSamples = 16.f;
+    /// Minimum number of samples per pixel and frame
+    uint32_t mMinSamples = 1;
+    /// Maximum number of samples per pixel and frame
+    uint32_t mMaxSamples = 64;
+    /// Weight of the current frame in the moving mean and variance of the luminance change
+    float mSmoothing = 0.2f;
+    /// Lower bound of the standard deviation of the predicted luminance in lin-log units
+    float mMinSigma = 0.02f;
+
+    ref<ComputePass> mpUpdateWeightsPass;
+    ref<ComputePass> mpAllocateSamplesPass;
+    std::unique_ptr<ParallelReduction> mpParallelReduction;
+
+    /// Current frame dimension in pixels.
+    uint2 mFrameDim = {0, 0};
+    /// True until the state has been initialized from an output frame
+    bool mInitialize = true;
+
+    ref<Texture> mpState;
+    ref<Texture> mpWeight;
+    ref<Texture> mpSampleCount;
+    ref<Buffer> mpWeightSum;
+};
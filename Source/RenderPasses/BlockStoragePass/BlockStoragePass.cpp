@@ -26,37 +26,248 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "BlockStoragePass.h"
-#include <fstream>
+#include "RenderGraph/RenderPassStandardFlags.h"
+#include "Utils/BlockStorage/BlockStorageReader.h"
+#include "Utils/BlockStorage/PixelSeries.h"
+
+namespace
+{
+void regBlockStoragePass(pybind11::module& m)
+{
+    pybind11::class_<BlockStoragePass, RenderPass, ref<BlockStoragePass>> pass(m, "BlockStoragePass");
+    pass.def("flush", &BlockStoragePass::flush);
+    pass.def_property_readonly(
+        "stats",
+        [](const BlockStoragePass& self)
+        {
+            const auto stats = self.getWriterStats();
+            pybind11::dict d;
+            d["batches"] = stats.batchesWritten;
+            d["blocks"] = stats.blocksWritten;
+            d["bytes_raw"] = stats.rawBytes;
+            d["bytes_stored"] = stats.bytesWritten;
+            d["encode_time"] = stats.encodeTime;
+            d["stalls"] = stats.stalls;
+            return d;
+        }
+    );
+}
+} // namespace
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, BlockStoragePass>();
+    ScriptBindings::registerBinding(regBlockStoragePass);
 }
 
 namespace
 {
 const std::string kInputChannelEventImage = "input";
+const std::string kInputTileActivity = "tileActivity";
 const std::string kOutputChannelEventImage = "output";
 const std::string kEnabled = "enabled";
 const std::string kDirectory = "directory";
 const std::string kAccumulatePass = "accumulatePass";
+const std::string kStorageMode = "storageMode";
+const std::string kCompression = "compression";
+const std::string kElideConstantBlocks = "elideConstantBlocks";
+const std::string kFormat = "format";
+const std::string kLogThreshold = "logThreshold";
+const std::string kTileSize = "tileSize";
+const std::string kPixelSeries = "pixelSeries";
+const std::string kTileActivity = "tileActivity";
+const std::string kPixelSeriesFilename = "series.fps";
+
+/// Texture arrays are limited to 2048 slices.
+const uint32_t kMaxTileDepth = 2048;
+
+const std::string kShaderFile = "RenderPasses/BlockStoragePass/BlockStoragePass.cs.slang";
+const std::string kQuantizeShaderFile = "RenderPasses/BlockStoragePass/BlockQuantize.cs.slang";
+
+/// Format of the storage texture array. Quantized formats store float values that are quantized per batch.
+ResourceFormat getStorageFormat(BlockFormat format)
+{
+    switch (format)
+    {
+    case BlockFormat::RGBA32Float:
+        return ResourceFormat::RGBA32Float;
+    case BlockFormat::RGBA16Float:
+        return ResourceFormat::RGBA16Float;
+    case BlockFormat::Luma32Float:
+    case BlockFormat::LogLuma16:
+    case BlockFormat::LogLuma8:
+        return ResourceFormat::R32Float;
+    case BlockFormat::Luma16Float:
+        return ResourceFormat::R16Float;
+    default:
+        FALCOR_UNREACHABLE();
+        return ResourceFormat::Unknown;
+    }
+}
 } // namespace
 
 void BlockStoragePass::prepareResources()
 {
+    // Finish the batch in flight before the storage is recreated.
+    finishStorage();
+    mFlushed = false;
     if (mFrameDim.x == 0 || mFrameDim.y == 0)
         return;
 
-    // Create a 2D texture array with 100 slices to store frames
+    // Host and device memory follow the tile depth, one slice is stored per frame of a batch.
+    const uint32_t frameCapacity = mTileSize.z;
+    mFirstFrame = mFrame;
+
+    // Create a 2D texture array with one slice per frame of a batch
     mpStorageTexture = mpDevice->createTexture2D(
         mFrameDim.x,
         mFrameDim.y,
-        ResourceFormat::RGBA32Float,
+        getStorageFormat(mFormat),
         frameCapacity, // arraySize - storing multiple frames
         1,             // mipLevels
         nullptr,       // pInitData
         ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
     );
+
+    BlockArchiveDesc desc;
+    desc.frameDim = mFrameDim;
+    desc.blockSize = mTileSize;
+    desc.format = mFormat;
+    desc.bytesPerPixel = getBlockFormatBytesPerPixel(mFormat);
+    desc.logThreshold = mLogThreshold;
+
+    // Quantized formats are converted into a second array at the end of each batch, only that one is read back.
+    mpQuantizedTexture = nullptr;
+    mpRangeBuffer = nullptr;
+    if (isQuantizedBlockFormat(mFormat))
+    {
+        mpQuantizedTexture = mpDevice->createTexture2D(
+            mFrameDim.x,
+            mFrameDim.y,
+            mFormat == BlockFormat::LogLuma16 ? ResourceFormat::R16Unorm : ResourceFormat::R8Unorm,
+            frameCapacity,
+            1,
+            nullptr,
+            ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess
+        );
+        const uint2 blockCount = desc.getBlockCount();
+        mpRangeBuffer = mpDevice->createStructuredBuffer(sizeof(float2), blockCount.x * blockCount.y);
+    }
+
+    // A resolution change starts a new archive, so the frames stored before are kept.
+    if (!mDirectoryPath.empty())
+    {
+        const std::string archiveFilename = mFirstFrame == 0 ? BlockWriter::kArchiveFilename : fmt::format("blocks-{}.fba", mFirstFrame);
+        mPixelSeriesFilename = mFirstFrame == 0 ? kPixelSeriesFilename : fmt::format("series-{}.fps", mFirstFrame);
+        mpBlockWriter =
+            std::make_unique<BlockWriter>(mDirectoryPath, desc, mStorageMode, mCompression, mElideConstantBlocks, archiveFilename);
+    }
+}
+
+void BlockStoragePass::finishStorage()
+{
+    if (!mpBlockWriter)
+        return;
+
+    // Closing the writer completes the archive, so it can be read back.
+    mpBlockWriter->wait();
+    const std::filesystem::path storagePath = mpBlockWriter->getStoragePath();
+    const BlockArchiveDesc desc = mpBlockWriter->getDesc();
+    const bool isArchive = mStorageMode == BlockStorageMode::Archive;
+    mFinishedStats = mpBlockWriter->getStats();
+    const bool hasFrames = mFinishedStats.batchesWritten > 0;
+    mpBlockWriter.reset();
+    if (mPixelSeriesMode == PixelSeriesMode::Off || !hasFrames)
+        return;
+
+    // The storage is transposed on a worker thread, so a resolution change does not stall the rendering. Only one
+    // transposition runs at a time, the destructor waits for the last one. Failures are reported instead of thrown.
+    waitPixelSeries();
+    const std::filesystem::path seriesPath = std::filesystem::path(mDirectoryPath) / mPixelSeriesFilename;
+    const bool removeArchive = mPixelSeriesMode == PixelSeriesMode::ReplaceArchive && isArchive;
+    mPixelSeriesThread = std::thread(
+        [storagePath, desc, seriesPath, removeArchive]()
+        {
+            try
+            {
+                const auto start = CpuTimer::getCurrentTimePoint();
+                ref<BlockStorageReader> pReader = BlockStorageReader::create(storagePath, desc);
+                writePixelSeries(*pReader, seriesPath);
+                pReader = nullptr;
+                logInfo("Wrote pixel series '{}' in {:.2f} s.", seriesPath, CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) * 1e-3);
+
+                if (removeArchive)
+                    std::filesystem::remove(storagePath);
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to write pixel series '{}': {}", seriesPath, e.what());
+            }
+        }
+    );
+}
+
+void BlockStoragePass::waitPixelSeries()
+{
+    if (mPixelSeriesThread.joinable())
+        mPixelSeriesThread.join();
+}
+
+void BlockStoragePass::writeBatch(RenderContext* pRenderContext, uint32_t frameCount)
+{
+    FALCOR_PROFILE(pRenderContext, "writeBatch");
+    const uint32_t blockZ = (mFrame - 1 - mFirstFrame) / mTileSize.z; // Which group of frames this is (0-based)
+    if (isQuantizedBlockFormat(mFormat))
+    {
+        quantizeBatch(pRenderContext, frameCount);
+        mpBlockWriter->writeBatch(pRenderContext, mpQuantizedTexture, frameCount, blockZ, mpRangeBuffer);
+    }
+    else
+    {
+        mpBlockWriter->writeBatch(pRenderContext, mpStorageTexture, frameCount, blockZ);
+    }
+}
+
+void BlockStoragePass::flush()
+{
+    if (!mpBlockWriter)
+        return;
+
+    // Write the frames of the partially filled batch and close the storage, every batch is written exactly once.
+    const uint32_t frameCount = (mFrame - mFirstFrame) % mTileSize.z;
+    if (frameCount > 0)
+        writeBatch(mpDevice->getRenderContext(), frameCount);
+    finishStorage();
+    mFlushed = true;
+}
+
+void BlockStoragePass::quantizeBatch(RenderContext* pRenderContext, uint32_t frameCount)
+{
+    FALCOR_PROFILE(pRenderContext, "quantizeBatch");
+
+    if (!mpReduceRangePass)
+    {
+        mpReduceRangePass = ComputePass::create(mpDevice, kQuantizeShaderFile, "reduceRange");
+        mpQuantizePass = ComputePass::create(mpDevice, kQuantizeShaderFile, "quantize");
+    }
+
+    const uint3 blockSize = mTileSize;
+    const uint2 blockCount = (mFrameDim + blockSize.xy() - 1u) / blockSize.xy();
+    for (const auto& pPass : {mpReduceRangePass, mpQuantizePass})
+    {
+        auto var = pPass->getRootVar();
+        var["gValues"] = mpStorageTexture;
+        var["gQuantized"] = mpQuantizedTexture;
+        var["gRanges"] = mpRangeBuffer;
+        var["CB"]["gResolution"] = mFrameDim;
+        var["CB"]["gBlockSize"] = blockSize;
+        var["CB"]["gBlockCountX"] = blockCount.x;
+        var["CB"]["gFrameCount"] = frameCount;
+    }
+
+    // One thread group of 256 threads per block.
+    mpReduceRangePass->execute(pRenderContext, uint3(blockCount.x * 256, blockCount.y, 1));
+    mpQuantizePass->execute(pRenderContext, uint3(mFrameDim, frameCount));
 }
 
 BlockStoragePass::BlockStoragePass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
@@ -68,20 +279,54 @@ BlockStoragePass::BlockStoragePass(ref<Device> pDevice, const Properties& props)
         else if (key == kDirectory)
             mDirectoryPath = props.get<std::string>(key);
         else if (key == kAccumulatePass)
-            mAccumulatePass = value;
+            mAccumulatePass = std::max(1u, (uint32_t)value);
+        else if (key == kStorageMode)
+            mStorageMode = value;
+        else if (key == kCompression)
+            mCompression = value;
+        else if (key == kElideConstantBlocks)
+            mElideConstantBlocks = value;
+        else if (key == kFormat)
+            mFormat = value;
+        else if (key == kLogThreshold)
+            mLogThreshold = value;
+        else if (key == kTileSize)
+            mTileSize = value;
+        else if (key == kPixelSeries)
+            mPixelSeriesMode = value;
+        else if (key == kTileActivity)
+            mTileActivity = value;
         else
             logWarning("Unknown property '{}' in BlockStoragePass properties.", key);
     }
+    FALCOR_CHECK(all(mTileSize > 0u) && mTileSize.z <= kMaxTileDepth, "Invalid tile size {}.", mTileSize);
+    if (mPixelSeriesMode == PixelSeriesMode::ReplaceArchive && mStorageMode != BlockStorageMode::Archive)
+        logWarning("Pixel series mode 'ReplaceArchive' only removes block archives, block files are kept.");
 
     prepareResources();
 }
 
+BlockStoragePass::~BlockStoragePass()
+{
+    // Write the tail of the run, Mogwai destroys the render graph when it exits.
+    flush();
+    waitPixelSeries();
+}
+
 Properties BlockStoragePass::getProperties() const
 {
     Properties props;
     props[kEnabled] = mEnabled;
     props[kDirectory] = mDirectoryPath;
     props[kAccumulatePass] = mAccumulatePass;
+    props[kStorageMode] = mStorageMode;
+    props[kCompression] = mCompression;
+    props[kElideConstantBlocks] = mElideConstantBlocks;
+    props[kFormat] = mFormat;
+    props[kLogThreshold] = mLogThreshold;
+    props[kTileSize] = mTileSize;
+    props[kPixelSeries] = mPixelSeriesMode;
+    props[kTileActivity] = mTileActivity;
     return props;
 }
 
@@ -89,6 +334,9 @@ RenderPassReflection BlockStoragePass::reflect(const CompileData& compileData)
 {
     RenderPassReflection reflector;
     reflector.addInput(kInputChannelEventImage, "Event image").bindFlags(ResourceBindFlags::ShaderResource);
+    reflector.addInput(kInputTileActivity, "Tile activity of TileActivityPass, only connected to execute after it")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
     reflector.addOutput(kOutputChannelEventImage, "Empty buffer")
         .bindFlags(ResourceBindFlags::UnorderedAccess)
         .format(ResourceFormat::RGBA32Float);
@@ -99,13 +347,24 @@ void BlockStoragePass::execute(RenderContext* pRenderContext, const RenderData&
     if (mpScene == nullptr)
         return;
 
+    // Switching the tile flags on or off recompiles the shader.
+    ref<TileActivity> pTileActivity = getTileActivity(renderData);
+    if (mUseTiles != (pTileActivity != nullptr))
+    {
+        mUseTiles = pTileActivity != nullptr;
+        mpComputePass = nullptr;
+    }
+
     if (!mpComputePass)
     {
         DefineList defines;
         mpScene->getShaderDefines(defines);
+        defines.add("STORE_LUMA", mFormat == BlockFormat::Luma32Float || mFormat == BlockFormat::Luma16Float ? "1" : "0");
+        defines.add("STORE_LOG_LUMA", isQuantizedBlockFormat(mFormat) ? "1" : "0");
+        defines.add("TILE_ACTIVITY", mUseTiles ? "1" : "0");
         ProgramDesc desc;
         mpScene->getShaderModules(desc.shaderModules);
-        desc.addShaderLibrary("RenderPasses/BlockStoragePass/BlockStoragePass.cs.slang");
+        desc.addShaderLibrary(kShaderFile);
         desc.csEntry("main");
         mpScene->getTypeConformances(desc.typeConformances);
         mpComputePass = ComputePass::create(mpDevice, desc, defines);
@@ -114,93 +373,83 @@ void BlockStoragePass::execute(RenderContext* pRenderContext, const RenderData&
     if (!mEnabled)
         return;
 
-    mAccumulateFrame++;
-    if (mAccumulateFrame < mAccumulatePass)
-        return;
-    mAccumulateFrame = 0;
-
     ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
     const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
     if (any(resolution != mFrameDim))
     {
+        flush();
         mFrameDim = resolution;
         prepareResources();
     }
+    if (mFlushed)
+    {
+        logWarningOnce("BlockStoragePass storage was flushed, the following frames are not stored.");
+        return;
+    }
 
     auto vars = mpComputePass->getRootVar();
     vars["input"] = inputTexture;
     vars["output"] = mpStorageTexture;
     vars["PerFrameCB"]["gResolution"] = mFrameDim;
-    vars["PerFrameCB"]["frame_id"] = mFrame % frameCapacity;
+    vars["PerFrameCB"]["frame_id"] = (mFrame - mFirstFrame) % mTileSize.z;
+    vars["PerFrameCB"]["gLogThreshold"] = mLogThreshold;
+    if (pTileActivity)
+    {
+        // The full frame is still written, blocks only become constant if they are aligned to the tiles.
+        vars["gTileFlags"] = pTileActivity->getFlagBuffer();
+        vars["PerFrameCB"]["gPrevFrameId"] = (mFrame - mFirstFrame + mTileSize.z - 1) % mTileSize.z;
+        vars["PerFrameCB"]["gTileCountX"] = pTileActivity->getTileCount().x;
+        vars["PerFrameCB"]["gHoldStatic"] = mFrame > mFirstFrame ? 1u : 0u;
+    }
 
     mpComputePass->execute(pRenderContext, uint3(mFrameDim, 1));
 
     mFrame++;
 
-    // When we reach capacity, write to file in 64x64x64 blocks
-    if (mFrame % frameCapacity == 0 && !mDirectoryPath.empty())
-    {
-        std::vector<uint8_t> whole_buffer(mFrameDim.x * mFrameDim.y * frameCapacity * sizeof(float) * 4);
-
-        // Write the texture data to the file
-        for (uint32_t i = 0; i < frameCapacity; i++)
-        {
-            auto data = pRenderContext->readTextureSubresource(mpStorageTexture.get(), mpStorageTexture->getSubresourceIndex(i, 0));
-            memcpy(whole_buffer.data() + i * mFrameDim.x * mFrameDim.y * sizeof(float) * 4, data.data(), data.size());
-        }
+    // When we reach capacity, the batch is transposed into tiles and written while the next frames render.
+    if ((mFrame - mFirstFrame) % mTileSize.z == 0 && mpBlockWriter)
+        writeBatch(pRenderContext, mTileSize.z);
 
-        // Calculate number of blocks in each dimension
-        uint32_t blocksX = (mFrameDim.x + 63) / 64;
-        uint32_t blocksY = (mFrameDim.y + 63) / 64;
-        uint32_t blockZ = mFrame / frameCapacity - 1; // Which group of frames this is (0-based)
-
-        for (uint32_t by = 0; by < blocksY; by++)
-        {
-            for (uint32_t bx = 0; bx < blocksX; bx++)
-            {
-                // Create a buffer for this block
-                std::vector<uint8_t> blockBuffer(64 * 64 * 64 * sizeof(float) * 4, 0);
-
-                // Fill the block buffer
-                for (uint32_t z = 0; z < 64; z++) // z now iterates through the frames in this batch
-                {
-                    for (uint32_t y = 0; y < 64 && (by * 64 + y) < mFrameDim.y; y++)
-                    {
-                        for (uint32_t x = 0; x < 64 && (bx * 64 + x) < mFrameDim.x; x++)
-                        {
-                            uint32_t srcIdx = (z * mFrameDim.y + (by * 64 + y)) * mFrameDim.x + (bx * 64 + x);
-                            uint32_t dstIdx = (z * 64 + y) * 64 + x;
-
-                            // Copy RGBA (4 floats)
-                            memcpy(
-                                blockBuffer.data() + dstIdx * sizeof(float) * 4,
-                                whole_buffer.data() + srcIdx * sizeof(float) * 4,
-                                sizeof(float) * 4
-                            );
-                        }
-                    }
-                }
-
-                // Write this block to file
-                std::string filename =
-                    mDirectoryPath + "/block_" + std::to_string(bx) + "_" + std::to_string(by) + "_" + std::to_string(blockZ) + ".bin";
-
-                std::ofstream file(filename, std::ios::binary);
-                if (file.is_open())
-                {
-                    file.write(reinterpret_cast<char*>(blockBuffer.data()), blockBuffer.size());
-                    file.close();
-                }
-                else
-                {
-                    logError("Failed to write block to file: {}", filename);
-                }
-            }
-        }
+    // Counters of the blocks written so far, they lag behind the batch in flight.
+    if (mpBlockWriter)
+    {
+        const auto stats = mpBlockWriter->getStats();
+        Profiler* pProfiler = pRenderContext->getProfiler();
+        pProfiler->setCounter("blocksWritten", float(stats.blocksWritten));
+        pProfiler->setCounter("zeroBlocks", float(stats.zeroBlocks));
+        pProfiler->setCounter("constantBlocks", float(stats.constantBlocks));
+        pProfiler->setCounter("compressionRatio", stats.bytesWritten > 0 ? float(double(stats.rawBytes) / stats.bytesWritten) : 0.f);
     }
 }
 
+ref<TileActivity> BlockStoragePass::getTileActivity(const RenderData& renderData) const
+{
+    if (!mTileActivity || renderData[kInputTileActivity] == nullptr)
+        return nullptr;
+    ref<TileActivity> pTileActivity = renderData.getDictionary().getValue(kRenderPassTileActivity, ref<TileActivity>());
+    if (pTileActivity && any(pTileActivity->getFrameDim() != mFrameDim))
+        return nullptr;
+    return pTileActivity;
+}
+
 void BlockStoragePass::renderUI(Gui::Widgets& widget)
 {
     widget.checkbox("Enabled", mEnabled);
+    if (mpBlockWriter)
+    {
+        const auto stats = mpBlockWriter->getStats();
+        widget.text(fmt::format(
+            "Batches written: {}\nBlocks written: {} ({} zero, {} constant)\nBytes written: {}\nCompression ratio: {:.2f}\n"
+            "Encode throughput: {:.1f} MB/s\nLast batch: {:.2f} s\nStalls: {}",
+            stats.batchesWritten,
+            stats.blocksWritten,
+            stats.zeroBlocks,
+            stats.constantBlocks,
+            stats.bytesWritten,
+            stats.bytesWritten > 0 ? double(stats.rawBytes) / stats.bytesWritten : 0.0,
+            stats.encodeTime > 0.0 ? stats.rawBytes / stats.encodeTime * 1e-6 : 0.0,
+            stats.lastBatchTime,
+            stats.stalls
+        ));
+    }
 }
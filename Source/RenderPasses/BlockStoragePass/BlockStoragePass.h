@@ -28,9 +28,34 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
+#include "BlockWriter.h"
+#include "Utils/Events/TileActivity.h"
+#include <memory>
+#include <thread>
 
 using namespace Falcor;
 
+/**
+ * Pixel-major copy of the stored frames, see PixelSeries.h.
+ */
+enum class PixelSeriesMode : uint32_t
+{
+    Off,       ///< Only blocks are stored.
+    Alongside, ///< The blocks are transposed into a pixel series file when the storage is finished.
+    /// As Alongside, but the block archive is removed once the pixel series file is written. The archive is still
+    /// written in full first, so the peak disk use is the size of the archive plus the size of the pixel series.
+    ReplaceArchive,
+};
+FALCOR_ENUM_INFO(
+    PixelSeriesMode,
+    {
+        {PixelSeriesMode::Off, "Off"},
+        {PixelSeriesMode::Alongside, "Alongside"},
+        {PixelSeriesMode::ReplaceArchive, "ReplaceArchive"},
+    }
+);
+FALCOR_ENUM_REGISTER(PixelSeriesMode);
+
 class BlockStoragePass : public RenderPass
 {
 public:
@@ -39,9 +64,11 @@ public:
     static ref<BlockStoragePass> create(ref<Device> pDevice, const Properties& props) { return make_ref<BlockStoragePass>(pDevice, props); }
 
     BlockStoragePass(ref<Device> pDevice, const Properties& props);
+    virtual ~BlockStoragePass() override;
 
     virtual Properties getProperties() const override;
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual RenderPassSchedule getSchedule() const override { return RenderPassSchedule::every(mAccumulatePass, mAccumulatePass - 1); }
     virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) override {}
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
     virtual void renderUI(Gui::Widgets& widget) override;
@@ -49,13 +76,37 @@ public:
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
+    /// Write the partially filled batch, if any, and close the storage. Frames rendered afterwards are not stored,
+    /// until a resolution change starts a new storage.
+    void flush();
+
+    /// Get the statistics of the blocks written to the current storage, or to the last one once it is closed.
+    BlockWriter::Stats getWriterStats() const { return mpBlockWriter ? mpBlockWriter->getStats() : mFinishedStats; }
+
 private:
     void prepareResources();
+    void finishStorage();
+    void waitPixelSeries();
+    void writeBatch(RenderContext* pRenderContext, uint32_t frameCount);
+    void quantizeBatch(RenderContext* pRenderContext, uint32_t frameCount);
+    ref<TileActivity> getTileActivity(const RenderData& renderData) const;
 
-    const uint32_t frameCapacity = 64;
     ref<Texture> mpStorageTexture;
+    /// Quantized copy of the storage texture for quantized formats
+    ref<Texture> mpQuantizedTexture;
+    /// Value range per block for quantized formats
+    ref<Buffer> mpRangeBuffer;
+    /// Transposes full batches into blocks and writes them to disk on worker threads
+    std::unique_ptr<BlockWriter> mpBlockWriter;
+    /// Statistics of the last closed writer
+    BlockWriter::Stats mFinishedStats;
+    /// True if the storage was closed by flush()
+    bool mFlushed = false;
     /// Compute pass that performs the compression algorithm
     ref<ComputePass> mpComputePass;
+    /// Compute passes computing the block ranges and quantizing a batch
+    ref<ComputePass> mpReduceRangePass;
+    ref<ComputePass> mpQuantizePass;
     /// The current scene (or nullptr if no scene)
     ref<Scene> mpScene;
 
@@ -65,10 +116,32 @@ private:
     bool mEnabled = true;
     /// Path to the directory where we store compressed data
     std::string mDirectoryPath;
+    /// Store blocks as separate files or packed into a single archive
+    BlockStorageMode mStorageMode = BlockStorageMode::Archive;
+    /// Compression of the blocks in the archive
+    BlockCompression mCompression = BlockCompression::None;
+    /// True if all-zero and constant blocks are stored as a flag without payload
+    bool mElideConstantBlocks = true;
+    /// Pixel format of the stored blocks
+    BlockFormat mFormat = BlockFormat::RGBA32Float;
+    /// Threshold of the lin-log mapping of the LogLuma formats
+    float mLogThreshold = 20.f;
+    /// Repeat the previous frame in tiles that TileActivityPass marks static, so that their blocks are elided
+    bool mTileActivity = false;
+    /// True if the shader is compiled with the tile flags
+    bool mUseTiles = false;
+    /// Transpose the stored blocks into a pixel-major file when the storage is finished
+    PixelSeriesMode mPixelSeriesMode = PixelSeriesMode::Off;
+    /// Name of the pixel series file of the current storage
+    std::string mPixelSeriesFilename;
+    /// Transposes a finished storage while the next one is rendered, joined before the next transposition
+    std::thread mPixelSeriesThread;
+    /// Tile size in pixels (x, y) and frames (z). The storage texture array holds one batch of tileSize.z frames.
+    uint3 mTileSize = uint3(BlockWriter::kDefaultBlockSize);
     /// Number of current frame
     uint32_t mFrame = 0;
-    /// Number of accumulate fram
-    uint32_t mAccumulateFrame = 0;
-    /// Accumulate Pass Frames
+    /// Frame at which the current storage was created, batches are counted from here
+    uint32_t mFirstFrame = 0;
+    /// Accumulate Pass Frames, the pass runs once every this many frames of the graph
     uint32_t mAccumulatePass = 1;
 };
@@ -0,0 +1,312 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockWriter.h"
+#include <BS_thread_pool/BS_thread_pool.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+BlockWriter::BlockWriter(
+    const std::filesystem::path& directory,
+    const BlockArchiveDesc& desc,
+    BlockStorageMode mode,
+    BlockCompression compression,
+    bool elideConstant,
+    const std::string& archiveFilename
+)
+    : mDirectory(directory)
+    , mDesc(desc)
+    , mFrameDim(desc.frameDim)
+    , mBlockSize(desc.blockSize)
+    , mBytesPerPixel(desc.bytesPerPixel)
+    , mCompression(compression)
+    , mElideConstant(elideConstant)
+    , mpWorkerPool(Threading::getSharedPool())
+{
+    FALCOR_CHECK(all(desc.blockSize > 0u), "Invalid block size {}.", desc.blockSize);
+    mBlockCount = desc.getBlockCount();
+
+    if (mode == BlockStorageMode::Archive)
+    {
+        mpArchive = std::make_unique<BlockArchiveWriter>(directory / archiveFilename, desc);
+    }
+    else
+    {
+        if (compression != BlockCompression::None || elideConstant)
+        {
+            logWarning("Block compression and elision require the archive storage mode, writing uncompressed block files.");
+            mCompression = BlockCompression::None;
+            mElideConstant = false;
+        }
+        if (isQuantizedBlockFormat(desc.format))
+            logWarning("Block files do not store the value ranges of format '{}', use the archive storage mode.", desc.format);
+    }
+}
+
+BlockWriter::~BlockWriter()
+{
+    wait();
+}
+
+void BlockWriter::writeBatch(
+    RenderContext* pRenderContext,
+    const ref<Texture>& pFrames,
+    uint32_t frameCount,
+    uint32_t blockZ,
+    const ref<Buffer>& pRanges
+)
+{
+    FALCOR_CHECK(
+        frameCount > 0 && frameCount <= mBlockSize.z && frameCount <= pFrames->getArraySize(), "Invalid frame count {}.", frameCount
+    );
+    FALCOR_CHECK(!isQuantizedBlockFormat(mDesc.format) || pRanges, "Format '{}' requires block ranges.", mDesc.format);
+
+    if (isBusy())
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats.stalls++;
+    }
+    wait();
+
+    // The range copy is recorded before the slice copies, so it has completed once the first slice can be mapped.
+    if (pRanges)
+    {
+        const size_t rangeSize = size_t(mBlockCount.x) * mBlockCount.y * sizeof(float2);
+        FALCOR_CHECK(pRanges->getSize() >= rangeSize, "Block range buffer is too small.");
+        if (!mpRangeReadback)
+            mpRangeReadback = pRenderContext->getDevice()->createBuffer(rangeSize, ResourceBindFlags::None, MemoryType::ReadBack);
+        pRenderContext->copyBufferRegion(mpRangeReadback.get(), 0, pRanges.get(), 0, rangeSize);
+    }
+    mRanges.assign(size_t(mBlockCount.x) * mBlockCount.y, float2(0.f));
+
+    // Issue all copies first, the worker threads then map the slices as their copies finish.
+    mReadTasks.resize(frameCount);
+    for (uint32_t z = 0; z < frameCount; ++z)
+        mReadTasks[z] = pRenderContext->asyncReadTextureSubresource(pFrames.get(), pFrames->getSubresourceIndex(z, 0));
+    mSlices.assign(frameCount, nullptr);
+    mRowPitch = mReadTasks[0]->getRowPitch();
+    mFrameCount = frameCount;
+    mBlockZ = blockZ;
+    mBatchStart = CpuTimer::getCurrentTimePoint();
+    mHasRanges = pRanges != nullptr;
+    mPendingSlices = frameCount;
+    mPendingBlocks = mBlockCount.x * mBlockCount.y;
+    if (mpArchive)
+        mpArchive->beginBatch(blockZ, frameCount);
+
+    for (uint32_t z = 0; z < frameCount; ++z)
+    {
+        addTask(
+            [this, z]()
+            {
+                mSlices[z] = mReadTasks[z]->map();
+                if (--mPendingSlices == 0)
+                    scheduleBlocks();
+            }
+        );
+    }
+}
+
+void BlockWriter::wait()
+{
+    std::unique_lock<std::mutex> lock(mTaskMutex);
+    mTaskCond.wait(lock, [this]() { return mPendingTasks == 0; });
+    std::exception_ptr pException = std::exchange(mTaskException, nullptr);
+    lock.unlock();
+
+    // The staging buffers were unmapped by the worker that wrote the last block of the batch.
+    mReadTasks.clear();
+    mSlices.clear();
+    if (pException)
+        std::rethrow_exception(pException);
+}
+
+void BlockWriter::addTask(std::function<void()>&& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mTaskMutex);
+        ++mPendingTasks;
+    }
+    mpWorkerPool->push_task(
+        [this, task = std::move(task)]()
+        {
+            std::exception_ptr pException;
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                pException = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mTaskMutex);
+            if (pException && !mTaskException)
+                mTaskException = pException;
+            if (--mPendingTasks == 0)
+                mTaskCond.notify_all();
+        }
+    );
+}
+
+BlockWriter::Stats BlockWriter::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    return mStats;
+}
+
+void BlockWriter::scheduleBlocks()
+{
+    if (mHasRanges)
+    {
+        std::memcpy(mRanges.data(), mpRangeReadback->map(), mRanges.size() * sizeof(float2));
+        mpRangeReadback->unmap();
+    }
+
+    for (uint32_t by = 0; by < mBlockCount.y; ++by)
+        for (uint32_t bx = 0; bx < mBlockCount.x; ++bx)
+            addTask([this, bx, by]() { processBlock(bx, by); });
+}
+
+void BlockWriter::processBlock(uint32_t bx, uint32_t by)
+{
+    auto pBlock = acquireBlockBuffer();
+    transposeBlock(bx, by, pBlock->data());
+
+    // Scratch memory for compressed payloads, kept per worker thread to avoid reallocations.
+    thread_local std::vector<uint8_t> scratch;
+    auto encodeStart = CpuTimer::getCurrentTimePoint();
+    EncodedBlock encoded = encodeBlock(pBlock->data(), pBlock->size(), mBytesPerPixel, mCompression, mElideConstant, scratch);
+    const double encodeTime = CpuTimer::calcDuration(encodeStart, CpuTimer::getCurrentTimePoint()) * 1e-3;
+
+    const bool written = storeBlock(bx, by, encoded);
+    const size_t blockSize = pBlock->size();
+    releaseBlockBuffer(std::move(pBlock));
+
+    if (written)
+    {
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats.blocksWritten++;
+        mStats.zeroBlocks += encoded.codec == BlockCodec::Zero ? 1 : 0;
+        mStats.constantBlocks += encoded.codec == BlockCodec::Constant ? 1 : 0;
+        mStats.rawBytes += blockSize;
+        mStats.bytesWritten += encoded.size;
+        mStats.encodeTime += encodeTime;
+    }
+
+    if (--mPendingBlocks == 0)
+    {
+        if (mpArchive)
+        {
+            try
+            {
+                mpArchive->endBatch();
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to finish batch {}: {}", mBlockZ, e.what());
+            }
+        }
+        for (const auto& pTask : mReadTasks)
+            pTask->unmap();
+        std::lock_guard<std::mutex> lock(mStatsMutex);
+        mStats.batchesWritten++;
+        mStats.lastBatchTime = CpuTimer::calcDuration(mBatchStart, CpuTimer::getCurrentTimePoint()) * 1e-3;
+    }
+}
+
+bool BlockWriter::storeBlock(uint32_t bx, uint32_t by, const EncodedBlock& block)
+{
+    if (mpArchive)
+    {
+        try
+        {
+            mpArchive->writeBlock(bx, by, block.codec, block.pData, block.size, mRanges[size_t(by) * mBlockCount.x + bx]);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            logError("Failed to write block ({}, {}, {}): {}", bx, by, mBlockZ, e.what());
+            return false;
+        }
+    }
+
+    std::filesystem::path filename = mDirectory / fmt::format("block_{}_{}_{}.bin", bx, by, mBlockZ);
+    std::ofstream file(filename, std::ios::binary);
+    if (file.is_open())
+        file.write(reinterpret_cast<const char*>(block.pData), block.size);
+    if (!file)
+    {
+        logError("Failed to write block to file: {}", filename);
+        return false;
+    }
+    return true;
+}
+
+void BlockWriter::transposeBlock(uint32_t bx, uint32_t by, uint8_t* pBlock) const
+{
+    const uint32_t x0 = bx * mBlockSize.x;
+    const uint32_t y0 = by * mBlockSize.y;
+    const uint32_t width = std::min(mBlockSize.x, mFrameDim.x - x0);
+    const uint32_t height = std::min(mBlockSize.y, mFrameDim.y - y0);
+    const size_t blockRowSize = size_t(mBlockSize.x) * mBytesPerPixel;
+    const size_t spanSize = size_t(width) * mBytesPerPixel;
+
+    // Pooled buffers hold data of previous blocks, clear the parts not covered by the frames.
+    if (width < mBlockSize.x || height < mBlockSize.y || mFrameCount < mBlockSize.z)
+        std::memset(pBlock, 0, mDesc.getBlockByteSize());
+
+    // Copy one contiguous span per block row. Writes to the block are sequential, reads touch one span per row of each slice.
+    for (uint32_t z = 0; z < mFrameCount; ++z)
+    {
+        const uint8_t* pSrc = mSlices[z] + size_t(y0) * mRowPitch + size_t(x0) * mBytesPerPixel;
+        uint8_t* pDst = pBlock + size_t(z) * mBlockSize.y * blockRowSize;
+        for (uint32_t y = 0; y < height; ++y)
+            std::memcpy(pDst + y * blockRowSize, pSrc + size_t(y) * mRowPitch, spanSize);
+    }
+}
+
+std::unique_ptr<std::vector<uint8_t>> BlockWriter::acquireBlockBuffer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPoolMutex);
+        if (!mBlockBufferPool.empty())
+        {
+            auto pBuffer = std::move(mBlockBufferPool.back());
+            mBlockBufferPool.pop_back();
+            return pBuffer;
+        }
+    }
+    return std::make_unique<std::vector<uint8_t>>(mDesc.getBlockByteSize());
+}
+
+void BlockWriter::releaseBlockBuffer(std::unique_ptr<std::vector<uint8_t>> pBuffer)
+{
+    std::lock_guard<std::mutex> lock(mPoolMutex);
+    mBlockBufferPool.push_back(std::move(pBuffer));
+}
@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "Utils/BlockStorage/BlockArchive.h"
+#include "Utils/BlockStorage/BlockCompression.h"
+#include "Utils/Threading.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace Falcor;
+
+/**
+ * How blocks are stored on disk.
+ */
+enum class BlockStorageMode : uint32_t
+{
+    Files,   ///< One file per block, named block_{bx}_{by}_{bz}.bin.
+    Archive, ///< All blocks packed into a single indexed file, see BlockArchive.h.
+};
+FALCOR_ENUM_INFO(
+    BlockStorageMode,
+    {
+        {BlockStorageMode::Files, "Files"},
+        {BlockStorageMode::Archive, "Archive"},
+    }
+);
+FALCOR_ENUM_REGISTER(BlockStorageMode);
+
+/**
+ * Writes batches of frames stored in a texture array to disk as blocks of blockSize.x * blockSize.y pixels and blockSize.z frames.
+ *
+ * The slices are read back asynchronously. Once a copy has finished, worker threads transpose the frames
+ * into blocks directly from the mapped staging memory, copying whole block rows at a time, and write the
+ * blocks to disk while the next batch of frames is being rendered. At most one batch is in flight.
+ * In archive mode, the worker threads also compress the blocks and elide constant blocks.
+ * The worker threads are the shared pool of Threading, held until the writer is destroyed.
+ */
+class BlockWriter
+{
+public:
+    static constexpr uint32_t kDefaultBlockSize = 64;
+    static constexpr char kArchiveFilename[] = "blocks.fba";
+
+    struct Stats
+    {
+        uint64_t batchesWritten = 0;
+        uint64_t blocksWritten = 0;
+        uint64_t zeroBlocks = 0;     ///< Blocks elided as all zero.
+        uint64_t constantBlocks = 0; ///< Blocks elided as constant.
+        uint64_t rawBytes = 0;       ///< Uncompressed size of the written blocks.
+        uint64_t bytesWritten = 0;   ///< Stored size of the written blocks.
+        double encodeTime = 0.0;     ///< Time in seconds spent encoding blocks, summed over all worker threads.
+        double lastBatchTime = 0.0; ///< Time in seconds from queuing the last batch until all its blocks were written.
+        uint64_t stalls = 0;        ///< Number of times a new batch had to wait for the previous one.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] directory Directory the block files or the archive are written to.
+     * @param[in] desc Frame dimension, block size and pixel format.
+     * @param[in] mode Storage mode. In archive mode, the archive is created immediately and throws on failure.
+     * @param[in] compression Compression of the blocks in archive mode.
+     * @param[in] elideConstant Elide blocks with identical pixels in archive mode.
+     * @param[in] archiveFilename Name of the archive file in the directory.
+     */
+    BlockWriter(
+        const std::filesystem::path& directory,
+        const BlockArchiveDesc& desc,
+        BlockStorageMode mode,
+        BlockCompression compression = BlockCompression::None,
+        bool elideConstant = false,
+        const std::string& archiveFilename = kArchiveFilename
+    );
+
+    /// Destructor. Waits for the batch in flight and closes the archive.
+    ~BlockWriter();
+
+    /**
+     * Queue a batch for writing. Waits for the previous batch if it is still in flight.
+     * @param[in] pRenderContext Render context.
+     * @param[in] pFrames Texture array holding one frame per slice.
+     * @param[in] frameCount Number of slices holding valid frames (at most blockSize.z), the remaining block slices are zero.
+     * @param[in] blockZ Index of the batch, used as z block coordinate.
+     * @param[in] pRanges Buffer of float2 value ranges per block, ordered by (by, bx). Required for quantized formats.
+     */
+    void writeBatch(
+        RenderContext* pRenderContext,
+        const ref<Texture>& pFrames,
+        uint32_t frameCount,
+        uint32_t blockZ,
+        const ref<Buffer>& pRanges = nullptr
+    );
+
+    /// Wait until the batch in flight is written.
+    void wait();
+
+    /// True if a batch is still being written.
+    bool isBusy() const { return mPendingBlocks > 0; }
+
+    Stats getStats() const;
+
+    const BlockArchiveDesc& getDesc() const { return mDesc; }
+
+    /// Path of the archive in archive mode, otherwise the directory of the block files.
+    std::filesystem::path getStoragePath() const { return mpArchive ? mpArchive->getPath() : mDirectory; }
+
+private:
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    /// Run a task on the shared worker threads, counted as pending until it returns.
+    void addTask(std::function<void()>&& task);
+    void scheduleBlocks();
+    void processBlock(uint32_t bx, uint32_t by);
+    void transposeBlock(uint32_t bx, uint32_t by, uint8_t* pBlock) const;
+    bool storeBlock(uint32_t bx, uint32_t by, const EncodedBlock& block);
+    std::unique_ptr<std::vector<uint8_t>> acquireBlockBuffer();
+    void releaseBlockBuffer(std::unique_ptr<std::vector<uint8_t>> pBuffer);
+
+    std::filesystem::path mDirectory;
+    BlockArchiveDesc mDesc;
+    uint2 mFrameDim;
+    uint3 mBlockSize;
+    uint32_t mBytesPerPixel;
+    uint2 mBlockCount;
+    std::unique_ptr<BlockArchiveWriter> mpArchive; ///< Archive the blocks are packed into, nullptr in Files mode.
+    BlockCompression mCompression = BlockCompression::None;
+    bool mElideConstant = false;
+
+    // Tasks of this writer on the shared worker threads.
+    std::mutex mTaskMutex;
+    std::condition_variable mTaskCond;
+    uint32_t mPendingTasks = 0;
+    std::exception_ptr mTaskException;
+    /// Shared worker pool. Declared after the task state, so the last writer joins the workers before that state is destroyed.
+    std::shared_ptr<BS::thread_pool> mpWorkerPool;
+
+    // State of the batch in flight.
+    std::vector<CopyContext::ReadTextureTask::SharedPtr> mReadTasks;
+    std::vector<const uint8_t*> mSlices;
+    ref<Buffer> mpRangeReadback; ///< Readback copy of the block ranges, created on first use.
+    std::vector<float2> mRanges;
+    bool mHasRanges = false;
+    uint32_t mRowPitch = 0;
+    uint32_t mFrameCount = 0;
+    uint32_t mBlockZ = 0;
+    std::atomic<uint32_t> mPendingSlices{0};
+    std::atomic<uint32_t> mPendingBlocks{0};
+    CpuTimer::TimePoint mBatchStart;
+
+    std::mutex mPoolMutex;
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> mBlockBufferPool;
+
+    mutable std::mutex mStatsMutex;
+    Stats mStats;
+};
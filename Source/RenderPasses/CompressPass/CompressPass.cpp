@@ -26,30 +26,61 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "CompressPass.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
 #include <fstream>
 
+namespace
+{
+void regCompressPass(pybind11::module& m)
+{
+    pybind11::class_<CompressPass, RenderPass, ref<CompressPass>> pass(m, "CompressPass");
+    pass.def_property_readonly("stats", [](const CompressPass& self) { return toPython(self.getReadbackStats(), self.getStoredBytes()); });
+}
+} // namespace
+
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, CompressPass>();
+    ScriptBindings::registerBinding(regCompressPass);
 }
 
 namespace
 {
 const std::string kInputChannelEventImage = "input";
+const std::string kInputTileActivity = "tileActivity";
 const std::string kOutputChannelEventImage = "output";
 const std::string kEnabled = "enabled";
 const std::string kDirectory = "directory";
+const std::string kOutputFormat = "outputFormat";
+const std::string kTimeScale = "timeScale";
+const std::string kCompactEvents = "compactEvents";
+const std::string kTileActivity = "tileActivity";
 } // namespace
 
 void CompressPass::prepareResources()
 {
+    // Flush frames still in flight before the buffers are recreated.
+    mpEventReadback.reset();
     if ( mFrameDim.x == 0 || mFrameDim.y == 0 )
         return;
-    auto vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Shared;
-    size_t type_size = sizeof(uint);
-    mpCompressBuffer = mpDevice->createStructuredBuffer(type_size, mFrameDim.x * mFrameDim.y, vbBindFlags, MemoryType::DeviceLocal, nullptr, true);
 
-    mpReadbackBuffer = mpDevice->createBuffer(mpCompressBuffer->getSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+    EventFrameWriter::Desc writerDesc;
+    writerDesc.directory = mDirectoryPath;
+    writerDesc.outputFormat = mOutputFormat;
+    writerDesc.encoding = EventEncoding::Address32;
+    writerDesc.compact = mCompactEvents;
+    writerDesc.polarity = EventPolarity::EvenIsOn;
+    writerDesc.timeScale = mTimeScale;
+    mEventWriter.open(writerDesc, mFrameDim, mFrame);
+
+    if (!mpEventCompaction)
+        mpEventCompaction = std::make_unique<EventCompaction>(mpDevice, sizeof(uint));
+    mpEventCompaction->resize(mFrameDim.x * mFrameDim.y, 1);
+    mWriteAllTiles = true;
+    mpEventReadback = std::make_unique<AsyncEventReadback>(
+        mpDevice, sizeof(uint), mFrameDim.x * mFrameDim.y,
+        [this](uint32_t frame, const void* pData, size_t size) { mEventWriter.write(frame, frame, pData, size); }
+    );
 }
 
 CompressPass::CompressPass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
@@ -58,8 +89,16 @@ CompressPass::CompressPass(ref<Device> pDevice, const Properties& props) : Rende
     {
         if (key == kEnabled)
             mEnabled = value;
-        if (key == kDirectory)
+        else if (key == kDirectory)
             mDirectoryPath = props.get<std::string>(key);
+        else if (key == kOutputFormat)
+            mOutputFormat = value;
+        else if (key == kTimeScale)
+            mTimeScale = value;
+        else if (key == kCompactEvents)
+            mCompactEvents = value;
+        else if (key == kTileActivity)
+            mTileActivity = value;
         else
             logWarning("Unknown property '{}' in CompressPass properties.", key);
     }
@@ -67,11 +106,22 @@ CompressPass::CompressPass(ref<Device> pDevice, const Properties& props) : Rende
     prepareResources();
 }
 
+CompressPass::~CompressPass()
+{
+    // Write out the remaining frames while the members used by the write callback are still alive.
+    mpEventReadback.reset();
+    mEventWriter.close();
+}
+
 Properties CompressPass::getProperties() const
 {
     Properties props;
     props[kEnabled] = mEnabled;
     props[kDirectory] = mDirectoryPath;
+    props[kOutputFormat] = mOutputFormat;
+    props[kTimeScale] = mTimeScale;
+    props[kCompactEvents] = mCompactEvents;
+    props[kTileActivity] = mTileActivity;
     return props;
 }
 
@@ -79,9 +129,14 @@ RenderPassReflection CompressPass::reflect(const CompileData& compileData)
 {
     RenderPassReflection reflector;
     reflector.addInput(kInputChannelEventImage, "Event image").bindFlags(ResourceBindFlags::ShaderResource);
+    reflector.addInput(kInputTileActivity, "Tile activity of TileActivityPass, only connected to execute after it")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    // With tile activity, static tiles are not written and keep the output of the last frame.
     reflector.addOutput(kOutputChannelEventImage, "Empty buffer")
         .bindFlags(ResourceBindFlags::UnorderedAccess)
-        .format(ResourceFormat::RGBA32Float);
+        .format(ResourceFormat::RGBA32Float)
+        .flags(mTileActivity ? RenderPassReflection::Field::Flags::Persistent : RenderPassReflection::Field::Flags::None);
     return reflector;
 }
 
@@ -90,10 +145,27 @@ void CompressPass::execute(RenderContext* pRenderContext, const RenderData& rend
     if (mpScene == nullptr)
         return;
 
+    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
+    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
+    if (mEnabled && any(resolution != mFrameDim))
+    {
+        mFrameDim = resolution;
+        prepareResources();
+    }
+
+    // Switching between the full and the tile dispatch recompiles the shader.
+    ref<TileActivity> pTileActivity = getTileActivity(renderData);
+    if (mUseTiles != (pTileActivity != nullptr))
+    {
+        mUseTiles = pTileActivity != nullptr;
+        mpComputePass = nullptr;
+    }
+
     if (!mpComputePass)
     {
         DefineList defines;
         mpScene->getShaderDefines(defines);
+        defines.add("TILE_ACTIVITY", mUseTiles ? "1" : "0");
         ProgramDesc desc;
         mpScene->getShaderModules(desc.shaderModules);
         desc.addShaderLibrary("RenderPasses/CompressPass/BufferPass.cs.slang");
@@ -106,40 +178,42 @@ void CompressPass::execute(RenderContext* pRenderContext, const RenderData& rend
         return ;
     mFrame ++;
 
-    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
-    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
-    if (any(resolution != mFrameDim))
-    {
-        mFrameDim = resolution;
-        prepareResources();
-    }
-
     auto vars = mpComputePass->getRootVar();
-    pRenderContext->clearUAVCounter(mpCompressBuffer, 0);
     vars["input"] = inputTexture;
-    vars["buffer_output"] = mpCompressBuffer;
+    mpEventCompaction->bindShaderData(vars["gEventSlots"]);
     vars["PerFrameCB"]["gResolution"] = mFrameDim;
 
-    mpComputePass->execute(pRenderContext, uint3(mFrameDim, 1));
-
-    ref<Buffer> pCounterBuffer = mpCompressBuffer->getUAVCounter();
-    pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, pCounterBuffer.get(), 0, pCounterBuffer->getSize());
-    mpDevice->wait();
-    const uint32_t pCounterValue = *static_cast<const uint32_t*>(mpReadbackBuffer->map());
-    const uint32_t pDataSize = pCounterValue* sizeof(uint);
-    mpReadbackBuffer->unmap();
-
-    // Map the CPU buffer and write to file
-    pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, mpCompressBuffer.get(), 0, pDataSize);
-    mpDevice->wait();
-    const uint* data = reinterpret_cast<const uint*>(mpReadbackBuffer->map());
-    std::string filename = mDirectoryPath + "\\data-" + std::to_string(mFrame) + ".bin";
-    std::ofstream file(filename, std::ios::binary);
-    file.write(reinterpret_cast<const char*>(data), pDataSize);
-    file.close();
-    mpReadbackBuffer->unmap();
+    if (pTileActivity)
+    {
+        // Pixels outside the listed tiles keep the event count of zero they were cleared to.
+        pTileActivity->bindShaderData(vars["gTileActivity"], mWriteAllTiles);
+        pTileActivity->dispatch(pRenderContext, mpComputePass.get(), mWriteAllTiles);
+    }
+    else
+        mpComputePass->execute(pRenderContext, uint3(mFrameDim, 1));
+    mWriteAllTiles = pTileActivity == nullptr;
+    mpEventCompaction->execute(pRenderContext, mpEventReadback->beginFrame(pRenderContext));
+
+    // The event count and payload are read back a few frames later and written on a background thread.
+    mpEventReadback->endFrame(pRenderContext, mFrame);
+}
+
+ref<TileActivity> CompressPass::getTileActivity(const RenderData& renderData) const
+{
+    // The map is only up to date if this pass executes after TileActivityPass, and ignored until it matches the frame dimension.
+    if (!mTileActivity || renderData[kInputTileActivity] == nullptr)
+        return nullptr;
+    ref<TileActivity> pTileActivity = renderData.getDictionary().getValue(kRenderPassTileActivity, ref<TileActivity>());
+    if (pTileActivity && any(pTileActivity->getFrameDim() != mFrameDim))
+        return nullptr;
+    return pTileActivity;
 }
 
 void CompressPass::renderUI(Gui::Widgets& widget) {
     widget.checkbox("Enabled", mEnabled);
+    if (mpEventReadback)
+    {
+        const auto stats = mpEventReadback->getStats();
+        widget.text(fmt::format("Frames written: {}\nBytes written: {}\nReadback stalls: {}", stats.framesWritten, stats.bytesWritten, stats.stalls));
+    }
 }
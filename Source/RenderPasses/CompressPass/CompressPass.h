@@ -28,6 +28,11 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
+#include "Utils/Events/AsyncEventReadback.h"
+#include "Utils/Events/EventCompaction.h"
+#include "Utils/Events/EventFrameWriter.h"
+#include "Utils/Events/TileActivity.h"
+#include <memory>
 
 using namespace Falcor;
 
@@ -39,6 +44,7 @@ public:
     static ref<CompressPass> create(ref<Device> pDevice, const Properties& props) { return make_ref<CompressPass>(pDevice, props); }
 
     CompressPass(ref<Device> pDevice, const Properties& props);
+    ~CompressPass();
 
     virtual Properties getProperties() const override;
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
@@ -49,13 +55,24 @@ public:
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
+    /// Get the statistics of the events read back so far.
+    AsyncEventReadback::Stats getReadbackStats() const
+    {
+        return mpEventReadback ? mpEventReadback->getStats() : AsyncEventReadback::Stats();
+    }
+    /// Get the number of bytes stored on disk so far, after encoding.
+    uint64_t getStoredBytes() const { return mEventWriter.getStoredBytes(); }
+
 private:
     void prepareResources();
+    ref<TileActivity> getTileActivity(const RenderData& renderData) const;
 
-    /// GPU buffer used for compression operations
-    ref<Buffer> mpCompressBuffer;
-    /// CPU-readable buffer for transferring compressed data from GPU
-    ref<Buffer> mpReadbackBuffer;
+    /// Ring of GPU event buffers that are read back and written to disk asynchronously
+    std::unique_ptr<AsyncEventReadback> mpEventReadback;
+    /// Compaction of the per-pixel event slots into the readback buffers
+    std::unique_ptr<EventCompaction> mpEventCompaction;
+    /// Stream or per-frame files the events are written to on the readback writer thread
+    EventFrameWriter mEventWriter;
     /// Compute pass that performs the compression algorithm
     ref<ComputePass> mpComputePass;
     /// The current scene (or nullptr if no scene)
@@ -67,6 +84,18 @@ private:
     bool mEnabled = true;
     /// Path to the directory where we store compressed data
     std::string mDirectoryPath;
+    /// How events are written to disk
+    EventOutputFormat mOutputFormat = EventOutputFormat::Stream;
+    /// True if event streams use the compact encoding
+    bool mCompactEvents = true;
+    /// Frames per second, stored in the event stream header
+    double mTimeScale = 1.0;
+    /// Only process the tiles listed by TileActivityPass
+    bool mTileActivity = false;
+    /// True if the shader is compiled for the tile dispatch
+    bool mUseTiles = false;
+    /// True if all tiles have to be written once, after the event slots were recreated
+    bool mWriteAllTiles = true;
     /// Number of current frame
     uint32_t mFrame = 0;
 };
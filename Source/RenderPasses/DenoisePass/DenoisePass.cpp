@@ -26,25 +26,64 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "DenoisePass.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
 #include <fstream>
 #include <Utils/CudaRuntime.h>
 #include <Utils/CudaUtils.h>
 #include <filesystem>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+void regDenoisePass(pybind11::module& m)
+{
+    pybind11::class_<DenoisePass, RenderPass, ref<DenoisePass>> pass(m, "DenoisePass");
+    pass.def_property_readonly("stats", [](const DenoisePass& self) { return toPython(self.getReadbackStats(), self.getStoredBytes()); });
+}
+} // namespace
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, DenoisePass>();
+    ScriptBindings::registerBinding(regDenoisePass);
 }
 
 namespace
 {
 const std::string kInputChannelEventImage = "input";
+const std::string kInputTileActivity = "tileActivity";
 const std::string kColorChannelEventImage = "color";
 const std::string kOutputChannelEventImage = "output";
 const std::string kAccumulatePass = "accumulatePass";
 const std::string kDirectory = "directory";
+const std::string kOutputFormat = "outputFormat";
+const std::string kTimeScale = "timeScale";
+const std::string kCompactEvents = "compactEvents";
 const std::string kWindow = "window";
+const std::string kInterpolateEvents = "interpolateEvents";
+const std::string kMaxEventsPerFrame = "maxEventsPerFrame";
+const std::string kClockTime = "clockTime";
+const std::string kReportActivity = "reportActivity";
+const std::string kSensorModel = "sensorModel";
+const std::string kThresholdSigma = "thresholdSigma";
+const std::string kCutoffHz = "cutoffHz";
+const std::string kLeakRate = "leakRate";
+const std::string kLeakJitter = "leakJitter";
+const std::string kShotNoiseRate = "shotNoiseRate";
+const std::string kRefractoryPeriod = "refractoryPeriod";
+const std::string kSeed = "seed";
+const std::string kTileActivity = "tileActivity";
+const std::string kFrameOffset = "frameOffset";
+const std::string kBeginFrame = "beginFrame";
+const std::string kEndFrame = "endFrame";
+const std::string kLoadCheckpoint = "loadCheckpoint";
+const std::string kSaveCheckpoint = "saveCheckpoint";
+const std::string kCheckpointFrame = "checkpointFrame";
+
+/// Contrast threshold of Denoise.slang, the mean of the per-pixel thresholds of the sensor model.
+const float kContrastThreshold = 0.2f;
 } // namespace
 
 DenoisePass::DenoisePass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
@@ -52,14 +91,80 @@ DenoisePass::DenoisePass(ref<Device> pDevice, const Properties& props) : RenderP
     for (const auto& [key, value] : props)
     {
         if (key == kAccumulatePass)
-            mAccumulatePass = value;
+            mAccumulatePass = std::max(1u, (uint32_t)value);
         else if (key == kWindow)
             mWindowSize = value;
         else if (key == kDirectory)
             mDirectoryPath = props.get<std::string>(key);
+        else if (key == kOutputFormat)
+            mOutputFormat = value;
+        else if (key == kTimeScale)
+            mTimeScale = value;
+        else if (key == kCompactEvents)
+            mCompactEvents = value;
+        else if (key == kInterpolateEvents)
+            mInterpolateEvents = value;
+        else if (key == kMaxEventsPerFrame)
+            mMaxEventsPerFrame = std::max(1u, (uint32_t)value);
+        else if (key == kClockTime)
+            mClockTime = value;
+        else if (key == kReportActivity)
+            mReportActivity = value;
+        else if (key == kSensorModel)
+            mSensor.enabled = value;
+        else if (key == kThresholdSigma)
+            mSensor.thresholdSigma = std::max(0.f, (float)value);
+        else if (key == kCutoffHz)
+            mSensor.cutoffHz = std::max(0.f, (float)value);
+        else if (key == kLeakRate)
+            mSensor.leakRateHz = std::max(0.f, (float)value);
+        else if (key == kLeakJitter)
+            mSensor.leakJitter = std::max(0.f, (float)value);
+        else if (key == kShotNoiseRate)
+            mSensor.shotNoiseRateHz = std::max(0.f, (float)value);
+        else if (key == kRefractoryPeriod)
+            mSensor.refractoryPeriod = std::max(0.f, (float)value);
+        else if (key == kSeed)
+            mSensor.seed = value;
+        else if (key == kTileActivity)
+            mTileActivity = value;
+        else if (key == kFrameOffset)
+            mShard.frameOffset = value;
+        else if (key == kBeginFrame)
+            mShard.beginFrame = value;
+        else if (key == kEndFrame)
+            mShard.endFrame = value;
+        else if (key == kLoadCheckpoint)
+            mShard.loadCheckpoint = props.get<std::string>(key);
+        else if (key == kSaveCheckpoint)
+            mShard.saveCheckpoint = props.get<std::string>(key);
+        else if (key == kCheckpointFrame)
+            mShard.checkpointFrame = value;
         else
             logWarning("Unknown property '{}' in Denoise properties.", key);
     }
+
+    // Frames are numbered from the start of the sequence, also in a shard that starts later.
+    mFrame = mShard.frameOffset;
+    mRestorePending = !mShard.loadCheckpoint.empty();
+
+    FALCOR_CHECK(
+        mWindowSize >= 1 && mWindowSize <= std::size(mpLastFrames), "Denoise window must be between 1 and {}.", std::size(mpLastFrames)
+    );
+
+    // The sensor model works on the interpolated log intensity.
+    if (mSensor.enabled && !mInterpolateEvents)
+    {
+        logWarning("Denoise sensor model requires interpolated events, enabling 'interpolateEvents'.");
+        mInterpolateEvents = true;
+    }
+}
+
+DenoisePass::~DenoisePass()
+{
+    // Write out the remaining frames while the members used by the write callback are still alive.
+    mpEventReadback.reset();
+    mEventWriter.close();
 }
 
 Properties DenoisePass::getProperties() const
@@ -68,6 +173,28 @@ Properties DenoisePass::getProperties() const
     props[kAccumulatePass] = mAccumulatePass;
     props[kWindow] = mWindowSize;
     props[kDirectory] = mDirectoryPath;
+    props[kOutputFormat] = mOutputFormat;
+    props[kTimeScale] = mTimeScale;
+    props[kCompactEvents] = mCompactEvents;
+    props[kInterpolateEvents] = mInterpolateEvents;
+    props[kMaxEventsPerFrame] = mMaxEventsPerFrame;
+    props[kClockTime] = mClockTime;
+    props[kReportActivity] = mReportActivity;
+    props[kSensorModel] = mSensor.enabled;
+    props[kThresholdSigma] = mSensor.thresholdSigma;
+    props[kCutoffHz] = mSensor.cutoffHz;
+    props[kLeakRate] = mSensor.leakRateHz;
+    props[kLeakJitter] = mSensor.leakJitter;
+    props[kShotNoiseRate] = mSensor.shotNoiseRateHz;
+    props[kRefractoryPeriod] = mSensor.refractoryPeriod;
+    props[kSeed] = mSensor.seed;
+    props[kTileActivity] = mTileActivity;
+    props[kFrameOffset] = mShard.frameOffset;
+    props[kBeginFrame] = mShard.beginFrame;
+    props[kEndFrame] = mShard.endFrame;
+    props[kLoadCheckpoint] = mShard.loadCheckpoint.string();
+    props[kSaveCheckpoint] = mShard.saveCheckpoint.string();
+    props[kCheckpointFrame] = mShard.checkpointFrame;
     return props;
 }
 
@@ -75,12 +202,19 @@ RenderPassReflection DenoisePass::reflect(const CompileData& compileData)
 {
     RenderPassReflection reflector;
     reflector.addInput(kInputChannelEventImage, "Input accumulate image").bindFlags(ResourceBindFlags::ShaderResource);
+    reflector.addInput(kInputTileActivity, "Tile activity of TileActivityPass, only connected to execute after it")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    // With tile activity, static tiles are not written and keep the output of the last frame.
+    const auto outputFlags = mTileActivity ? RenderPassReflection::Field::Flags::Persistent : RenderPassReflection::Field::Flags::None;
     reflector.addOutput(kColorChannelEventImage, "Output color image")
         .bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
-        .format(ResourceFormat::RGBA32Float);
+        .format(ResourceFormat::RGBA32Float)
+        .flags(outputFlags);
     reflector.addOutput(kOutputChannelEventImage, "Output event image")
         .bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
-        .format(ResourceFormat::RGBA32Float);
+        .format(ResourceFormat::RGBA32Float)
+        .flags(outputFlags);
     return reflector;
 }
 
@@ -89,17 +223,40 @@ void DenoisePass::execute(RenderContext* pRenderContext, const RenderData& rende
     if (mpScene == nullptr)
         return;
 
-    mAccumulateFrame++;
-    if (mAccumulateFrame < mAccumulatePass)
-        return;
-    mAccumulateFrame = 0;
     mFrame++;
+    auto& dict = renderData.getDictionary();
+
+    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
+    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
+    if (any(resolution != mFrameDim))
+    {
+        mFrameDim = resolution;
+        prepareResources();
+    }
+    if (mRestorePending)
+    {
+        loadCheckpoint(pRenderContext);
+        mRestorePending = false;
+    }
+    mFrameTimes[mFrame % mFrameTimes.size()] = uint32_t(std::llround(dict.getValue(kRenderPassFrameTime, 0.0) * 1e6));
+
+    // Switching between the full and the tile dispatch recompiles the shader.
+    ref<TileActivity> pTileActivity = getTileActivity(renderData);
+    if (mUseTiles != (pTileActivity != nullptr))
+    {
+        mUseTiles = pTileActivity != nullptr;
+        mpDenoisePass = nullptr;
+    }
 
     // -------------------- Do the denoise pass --------------------
     if (!mpDenoisePass)
     {
         DefineList defines;
         mpScene->getShaderDefines(defines);
+        defines.add("INTERPOLATE_EVENTS", mInterpolateEvents ? "1" : "0");
+        defines.add("DVS_SENSOR", mSensor.enabled ? "1" : "0");
+        defines.add("REPORT_ACTIVITY", mReportActivity ? "1" : "0");
+        defines.add("TILE_ACTIVITY", mUseTiles ? "1" : "0");
         ProgramDesc desc;
         mpScene->getShaderModules(desc.shaderModules);
         desc.addShaderLibrary("RenderPasses/DenoisePass/Denoise.slang");
@@ -108,50 +265,147 @@ void DenoisePass::execute(RenderContext* pRenderContext, const RenderData& rende
         mpDenoisePass = ComputePass::create(mpDevice, desc, defines);
     }
 
-    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
-    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
-    if (any(resolution != mFrameDim))
-    {
-        mFrameDim = resolution;
-        prepareResources();
-    }
-
     auto vars = mpDenoisePass->getRootVar();
     vars["input"] = inputTexture;
     vars["color"] = renderData.getTexture(kColorChannelEventImage);
     vars["output"] = renderData.getTexture(kOutputChannelEventImage);
+    const uint32_t eventFrame = mFrame - mWindowSize / 2;
     vars["PerFrameCB"]["gResolution"] = mFrameDim;
-    vars["PerFrameCB"]["gFrame"] = mFrame - mWindowSize / 2;
-    vars["PerFrameCB"]["gWindow"] = mWindowSize;
+    vars["PerFrameCB"]["gFrame"] = mClockTime ? getEventTime(eventFrame) : eventFrame;
+    mHistory.advance();
+    mHistory.bindShaderData(vars["PerFrameCB"]["gHistory"]);
+    if (mInterpolateEvents)
+    {
+        vars["PerFrameCB"]["gTime"] = getEventTime(eventFrame);
+        vars["PerFrameCB"]["gPrevTime"] = getEventTime(eventFrame - 1);
+        vars["lastLog"] = mpLastLog;
+    }
+    if (mSensor.enabled)
+    {
+        const uint32_t time = getEventTime(eventFrame);
+        const uint32_t prevTime = getEventTime(eventFrame - 1);
+        const DvsFrameConstants constants = getDvsFrameConstants(mSensor, time - prevTime, 1e6);
+        auto sensor = vars["gSensor"];
+        sensor["lastEventTime"] = mpLastEventTime;
+        sensor["pixelParams"] = mpSensorParams;
+        sensor["dt"] = constants.dt;
+        sensor["lowpassGain"] = constants.lowpassGain;
+        sensor["shotProbability"] = constants.shotProbability;
+        sensor["refractoryTicks"] = constants.refractoryTicks;
+        sensor["seed"] = mSensor.seed;
+        sensor["frame"] = mSensorFrame;
+        sensor["initialize"] = mSensorFrame == 0 ? 1u : 0u;
+        mSensorFrame++;
+    }
     for (int i = 0; i < 10; ++ i)
         vars["LastFrames"][i] = mpLastFrames[i];
-    pRenderContext->clearUAVCounter(mpCompressBuffer, 0);
-    vars["buffer_output"] = mpCompressBuffer;
+    mpEventCompaction->bindShaderData(vars["gEventSlots"]);
     vars["internalState"] = mpInternalState;
-    mpDenoisePass->execute(pRenderContext, uint3(mFrameDim, 1));
+    if (mReportActivity)
+    {
+        if (!mpActivity)
+            mpActivity = mpDevice->createBuffer(sizeof(uint32_t), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal);
+        pRenderContext->clearUAV(mpActivity->getUAV().get(), uint4(0));
+        vars["gActivity"] = mpActivity;
+    }
+    if (pTileActivity)
+    {
+        // Static tiles keep their window and internal state, only their output and event counts are cleared.
+        pTileActivity->bindShaderData(vars["gTileActivity"], mWriteAllTiles);
+        pTileActivity->dispatch(pRenderContext, mpDenoisePass.get(), mWriteAllTiles);
+    }
+    else
+        mpDenoisePass->execute(pRenderContext, uint3(mFrameDim, 1));
+    mWriteAllTiles = pTileActivity == nullptr;
 
     // -------------------- Read back the compressed data --------------------
+    // The window is not filled during the first frames, their events are discarded. So are the events of the
+    // warm-up frames of a shard, which still report their activity to the clock.
     if (mFrame >= 10)
     {
-        ref<Buffer> pCounterBuffer = mpCompressBuffer->getUAVCounter();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, pCounterBuffer.get(), 0, pCounterBuffer->getSize());
-        mpDevice->wait();
-        const uint32_t pCounterValue = *static_cast<const uint32_t*>(mpReadbackBuffer->map());
-        const uint32_t pDataSize = pCounterValue * sizeof(uint2);
-        mpReadbackBuffer->unmap();
-
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, mpCompressBuffer.get(), 0, pDataSize);
-        mpDevice->wait();
-        const uint* data = reinterpret_cast<const uint*>(mpReadbackBuffer->map());
-        std::string filename = mDirectoryPath + "\\data-" + std::to_string(mFrame) + ".bin";
-        std::ofstream file(filename, std::ios::binary);
-        file.write(reinterpret_cast<const char*>(data), pDataSize);
-        file.close();
-        mpReadbackBuffer->unmap();
+        if (mShard.isWritten(mFrame))
+        {
+            mpEventCompaction->execute(pRenderContext, mpEventReadback->beginFrame(pRenderContext));
+            mpEventReadback->endFrame(pRenderContext, mFrame);
+        }
+
+        // The clock needs the activity before the next tick, which requires waiting for the GPU.
+        if (mReportActivity)
+            dict[kRenderPassEventActivity] = double(mpActivity->getElement<float>(0));
     }
+    if (mShard.isCheckpointFrame(mFrame))
+        saveCheckpoint(pRenderContext);
 }
 
-void DenoisePass::renderUI(Gui::Widgets& widget) {}
+ref<TileActivity> DenoisePass::getTileActivity(const RenderData& renderData) const
+{
+    // Sensor noise fires in static regions, the sensor model always processes the full frame.
+    if (!mTileActivity || mSensor.enabled || renderData[kInputTileActivity] == nullptr)
+        return nullptr;
+    ref<TileActivity> pTileActivity = renderData.getDictionary().getValue(kRenderPassTileActivity, ref<TileActivity>());
+    if (pTileActivity && any(pTileActivity->getFrameDim() != mFrameDim))
+        return nullptr;
+    return pTileActivity;
+}
+
+void DenoisePass::loadCheckpoint(RenderContext* pRenderContext)
+{
+    // The checkpoint holds the state after its frame, the current frame is the one after it.
+    EventCheckpoint checkpoint = EventCheckpoint::load(mShard.loadCheckpoint, "DenoisePass");
+    FALCOR_CHECK(
+        checkpoint.getValue<uint32_t>("window") == mWindowSize,
+        "Checkpoint '{}' has a window of {}, the pass uses {}.",
+        mShard.loadCheckpoint,
+        checkpoint.getValue<uint32_t>("window"),
+        mWindowSize
+    );
+    if (checkpoint.getFrame() + 1 != mFrame)
+        logWarning("Checkpoint '{}' is at frame {}, continuing from there instead of frame {}.", mShard.loadCheckpoint, checkpoint.getFrame(), mFrame - 1);
+    mFrame = checkpoint.getFrame() + 1;
+    checkpoint.restoreTexture(pRenderContext, "internalState", mpInternalState.get());
+    for (uint32_t i = 0; i < mWindowSize; ++i)
+        checkpoint.restoreTexture(pRenderContext, fmt::format("lastFrames{}", i), mpLastFrames[i].get());
+    mHistory.setHead(checkpoint.getValue<uint32_t>("historyHead"));
+    mFrameTimes = checkpoint.getValue<decltype(mFrameTimes)>("frameTimes");
+    if (mInterpolateEvents)
+        checkpoint.restoreTexture(pRenderContext, "lastLog", mpLastLog.get());
+    if (mSensor.enabled)
+    {
+        checkpoint.restoreTexture(pRenderContext, "lastEventTime", mpLastEventTime.get());
+        mSensorFrame = checkpoint.getValue<uint32_t>("sensorFrame");
+    }
+    logInfo("DenoisePass restored checkpoint '{}' at frame {}.", mShard.loadCheckpoint, checkpoint.getFrame());
+}
+
+void DenoisePass::saveCheckpoint(RenderContext* pRenderContext)
+{
+    // The sensor parameters are drawn from the seed and are not stored.
+    EventCheckpoint checkpoint("DenoisePass", mFrame);
+    checkpoint.setValue("window", mWindowSize);
+    checkpoint.setValue("historyHead", mHistory.getHead());
+    checkpoint.setValue("frameTimes", mFrameTimes);
+    checkpoint.storeTexture(pRenderContext, "internalState", mpInternalState.get());
+    for (uint32_t i = 0; i < mWindowSize; ++i)
+        checkpoint.storeTexture(pRenderContext, fmt::format("lastFrames{}", i), mpLastFrames[i].get());
+    if (mInterpolateEvents)
+        checkpoint.storeTexture(pRenderContext, "lastLog", mpLastLog.get());
+    if (mSensor.enabled)
+    {
+        checkpoint.storeTexture(pRenderContext, "lastEventTime", mpLastEventTime.get());
+        checkpoint.setValue("sensorFrame", mSensorFrame);
+    }
+    checkpoint.save(mShard.saveCheckpoint);
+    logInfo("DenoisePass saved checkpoint '{}' at frame {}.", mShard.saveCheckpoint, mFrame);
+}
+
+void DenoisePass::renderUI(Gui::Widgets& widget)
+{
+    if (mpEventReadback)
+    {
+        const auto stats = mpEventReadback->getStats();
+        widget.text(fmt::format("Frames written: {}\nBytes written: {}\nReadback stalls: {}", stats.framesWritten, stats.bytesWritten, stats.stalls));
+    }
+}
 
 void DenoisePass::prepareResources()
 {
@@ -163,9 +417,76 @@ void DenoisePass::prepareResources()
         mpLastFrames[i] = mpDevice->createTexture2D(
             mFrameDim.x, mFrameDim.y, ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
         );
+    mHistory.reset(mWindowSize);
+
+    if (mInterpolateEvents)
+        mpLastLog = mpDevice->createTexture2D(
+            mFrameDim.x, mFrameDim.y, ResourceFormat::R32Float, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
+        );
+
+    if (mSensor.enabled)
+    {
+        // The per-pixel parameters are drawn on the CPU so that they match the EventSimulator for the same seed.
+        const std::vector<float4> params = createDvsPixelParams(mSensor, kContrastThreshold, mFrameDim.x * mFrameDim.y);
+        mpSensorParams = mpDevice->createTexture2D(
+            mFrameDim.x, mFrameDim.y, ResourceFormat::RGBA32Float, 1, 1, params.data(), ResourceBindFlags::ShaderResource
+        );
+        mpLastEventTime = mpDevice->createTexture2D(
+            mFrameDim.x, mFrameDim.y, ResourceFormat::R32Uint, 1, 1, nullptr, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource
+        );
+        mSensorFrame = 0;
+    }
+
+    // Flush frames still in flight before the buffers are recreated.
+    mpEventReadback.reset();
+
+    EventFrameWriter::Desc writerDesc;
+    writerDesc.directory = mDirectoryPath;
+    writerDesc.outputFormat = mOutputFormat;
+    writerDesc.encoding = EventEncoding::FrameAddress64;
+    writerDesc.compact = mCompactEvents;
+    writerDesc.polarity = EventPolarity::OddIsOn;
+    // Interpolated events and events stamped with the clock time are in microseconds instead of frames.
+    writerDesc.timeScale = useEventTime() ? 1e6 : mTimeScale;
+    mEventWriter.open(writerDesc, mFrameDim, mFrame);
+
+    const uint32_t maxEventsPerPixel = mInterpolateEvents ? mMaxEventsPerFrame : 1;
+    if (!mpEventCompaction)
+        mpEventCompaction = std::make_unique<EventCompaction>(mpDevice, sizeof(uint2));
+    mpEventCompaction->resize(mFrameDim.x * mFrameDim.y, maxEventsPerPixel);
+    mWriteAllTiles = true;
+    mpEventReadback = std::make_unique<AsyncEventReadback>(
+        mpDevice, sizeof(uint2), mFrameDim.x * mFrameDim.y * maxEventsPerPixel,
+        [this](uint32_t frame, const void* pData, size_t size) { writeEvents(frame, pData, size); }
+    );
+}
+
+uint32_t DenoisePass::getEventTime(uint32_t eventFrame) const
+{
+    if (mClockTime)
+        return mFrameTimes[eventFrame % mFrameTimes.size()];
+    return uint32_t(std::llround(eventFrame * 1e6 / mTimeScale));
+}
+
+void DenoisePass::writeEvents(uint32_t frame, const void* pData, size_t size)
+{
+    // Called on the readback writer thread.
+    if (mInterpolateEvents)
+    {
+        // Compacted events are ordered by address, sort the interpolated events by time and address.
+        const uint2* pEvents = reinterpret_cast<const uint2*>(pData);
+        mSortedEvents.assign(pEvents, pEvents + size / sizeof(uint2));
+        std::sort(
+            mSortedEvents.begin(),
+            mSortedEvents.end(),
+            [](uint2 a, uint2 b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+        );
+        pData = mSortedEvents.data();
+    }
 
-    size_t type_size = sizeof(uint2);
-    auto vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Shared;
-    mpCompressBuffer = mpDevice->createStructuredBuffer(type_size, mFrameDim.x * mFrameDim.y, vbBindFlags, MemoryType::DeviceLocal, nullptr, true);
-    mpReadbackBuffer = mpDevice->createBuffer(mpCompressBuffer->getSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+    // Timestamp the chunk with the frame stored in its events, which lags behind by half the window.
+    // Interpolated events lie between the previous and the current frame, the chunk starts at the previous frame.
+    const uint32_t eventFrame = frame - mWindowSize / 2;
+    const uint64_t timestamp = mInterpolateEvents ? getEventTime(eventFrame - 1) : (mClockTime ? getEventTime(eventFrame) : eventFrame);
+    mEventWriter.write(frame, timestamp, pData, size);
 }
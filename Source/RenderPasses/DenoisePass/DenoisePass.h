@@ -28,6 +28,16 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
+#include "Utils/Events/AsyncEventReadback.h"
+#include "Utils/Events/EventCheckpoint.h"
+#include "Utils/Events/DvsSensor.h"
+#include "Utils/Events/EventCompaction.h"
+#include "Utils/Events/EventFrameWriter.h"
+#include "Utils/Events/RingHistory.h"
+#include "Utils/Events/TileActivity.h"
+#include <array>
+#include <memory>
+#include <vector>
 
 using namespace Falcor;
 
@@ -42,9 +52,11 @@ public:
     }
 
     DenoisePass(ref<Device> pDevice, const Properties& props);
+    ~DenoisePass();
 
     virtual Properties getProperties() const override;
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual RenderPassSchedule getSchedule() const override { return RenderPassSchedule::every(mAccumulatePass, mAccumulatePass - 1); }
     virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) override {}
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
     virtual void renderUI(Gui::Widgets& widget) override;
@@ -52,15 +64,61 @@ public:
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
+    /// Get the statistics of the events read back so far.
+    AsyncEventReadback::Stats getReadbackStats() const
+    {
+        return mpEventReadback ? mpEventReadback->getStats() : AsyncEventReadback::Stats();
+    }
+    /// Get the number of bytes stored on disk so far, after encoding.
+    uint64_t getStoredBytes() const { return mEventWriter.getStoredBytes(); }
+
 private:
     void prepareResources();
+    void writeEvents(uint32_t frame, const void* pData, size_t size);
+    ref<TileActivity> getTileActivity(const RenderData& renderData) const;
+    void loadCheckpoint(RenderContext* pRenderContext);
+    void saveCheckpoint(RenderContext* pRenderContext);
+    /// Time of an event frame in microseconds, used with interpolated events and clock time. Wraps after about 71 minutes.
+    uint32_t getEventTime(uint32_t eventFrame) const;
+    /// True if events are stamped with times in microseconds instead of frames
+    bool useEventTime() const { return mInterpolateEvents || mClockTime; }
 
     /// Path to the directory where we store compressed data
     std::string mDirectoryPath;
-    /// GPU buffer used for compression operations
-    ref<Buffer> mpCompressBuffer;
-    /// CPU-readable buffer for transferring compressed data from GPU
-    ref<Buffer> mpReadbackBuffer;
+    /// Ring of GPU event buffers that are read back and written to disk asynchronously
+    std::unique_ptr<AsyncEventReadback> mpEventReadback;
+    /// Compaction of the per-pixel event slots into the readback buffers
+    std::unique_ptr<EventCompaction> mpEventCompaction;
+    /// Stream or per-frame files the events are written to on the readback writer thread
+    EventFrameWriter mEventWriter;
+    /// Scratch buffer for sorting interpolated events by time (only used on the readback writer thread)
+    std::vector<uint2> mSortedEvents;
+    /// How events are written to disk
+    EventOutputFormat mOutputFormat = EventOutputFormat::Stream;
+    /// True if event streams use the compact encoding
+    bool mCompactEvents = true;
+    /// Output frames per second, stored in the event stream header
+    double mTimeScale = 1.0;
+    /// Emit every threshold crossing between frames stamped with an interpolated time in microseconds
+    bool mInterpolateEvents = false;
+    /// Maximum number of interpolated events per pixel and frame
+    uint32_t mMaxEventsPerFrame = 4;
+    /// Stamp events with the clock time instead of the frame index scaled by timeScale (required with an adaptive clock)
+    bool mClockTime = false;
+    /// Report the maximum number of threshold crossings of a pixel per frame to the adaptive clock
+    bool mReportActivity = false;
+    /// Clock times of the recent frames in microseconds, indexed by frame. The writer thread lags a few frames behind.
+    std::array<uint32_t, 64> mFrameTimes = {};
+    /// DVS sensor non-idealities applied to the interpolated events
+    DvsSensorDesc mSensor;
+    /// Number of frames simulated by the sensor model since its state was created
+    uint32_t mSensorFrame = 0;
+    /// Only process the tiles listed by TileActivityPass (ignored with the sensor model, whose noise events fire in static regions)
+    bool mTileActivity = false;
+    /// True if the shader is compiled for the tile dispatch
+    bool mUseTiles = false;
+    /// True if all tiles have to be written once, after the event slots were recreated
+    bool mWriteAllTiles = true;
 
     /// Compute pass that performs the denoise
     ref<ComputePass> mpDenoisePass;
@@ -71,14 +129,22 @@ private:
     uint2 mFrameDim = {0, 0};
     /// Number of current frame (didn't consider the accumulate pass)
     uint32_t mFrame = 0;
-    /// Number of accumulate frame
-    uint32_t mAccumulateFrame = 0;
-    /// Accumulate Pass Frames
+    /// Accumulate Pass Frames, the pass runs once every this many frames of the graph
     uint32_t mAccumulatePass = 1;
+    /// Frames rendered by this process when the sequence is split into shards
+    EventShardDesc mShard;
+    /// True until the checkpoint of the shard is restored, which requires the resources of the first frame
+    bool mRestorePending = false;
 
     /// Window size
     uint32_t mWindowSize = 1;
+    /// Slot of the current frame in mpLastFrames
+    RingHistory mHistory;
 
     ref<Texture> mpLastFrames[10];
     ref<Texture> mpInternalState;
+    ref<Texture> mpLastLog;
+    ref<Texture> mpLastEventTime;
+    ref<Texture> mpSensorParams;
+    ref<Buffer> mpActivity;
 };
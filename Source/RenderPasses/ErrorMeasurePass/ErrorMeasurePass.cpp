@@ -56,6 +56,12 @@ const std::string kSelectedOutputId = "SelectedOutputId";
 const std::string kThreshold = "threshold";
 const std::string kNeedAccumulatedEvents = "needAccumulatedEvents";
 const std::string kToleranceEvents = "toleranceEvents";
+const std::string kFrameOffset = "frameOffset";
+const std::string kBeginFrame = "beginFrame";
+const std::string kEndFrame = "endFrame";
+const std::string kLoadCheckpoint = "loadCheckpoint";
+const std::string kSaveCheckpoint = "saveCheckpoint";
+const std::string kCheckpointFrame = "checkpointFrame";
 } // namespace
 
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
@@ -98,11 +104,26 @@ ErrorMeasurePass::ErrorMeasurePass(ref<Device> pDevice, const Properties& props)
             mNeedAccumulatedEvents = value;
         else if (key == kToleranceEvents)
             mToleranceEvents = value;
+        else if (key == kFrameOffset)
+            mShard.frameOffset = value;
+        else if (key == kBeginFrame)
+            mShard.beginFrame = value;
+        else if (key == kEndFrame)
+            mShard.endFrame = value;
+        else if (key == kLoadCheckpoint)
+            mShard.loadCheckpoint = value.operator std::filesystem::path();
+        else if (key == kSaveCheckpoint)
+            mShard.saveCheckpoint = value.operator std::filesystem::path();
+        else if (key == kCheckpointFrame)
+            mShard.checkpointFrame = value;
         else
         {
             logWarning("Unknown property '{}' in ErrorMeasurePass properties.", key);
         }
     }
+    // Frames are numbered from the start of the sequence, also in a shard that starts later.
+    mFrame = mShard.frameOffset;
+    mRestorePending = !mShard.loadCheckpoint.empty();
 
     // Load/create files (if specified in config).
     loadReference();
@@ -127,6 +148,12 @@ Properties ErrorMeasurePass::getProperties() const
     props[kThreshold] = threshold;
     props[kNeedAccumulatedEvents] = mNeedAccumulatedEvents;
     props[kToleranceEvents] = mToleranceEvents;
+    props[kFrameOffset] = mShard.frameOffset;
+    props[kBeginFrame] = mShard.beginFrame;
+    props[kEndFrame] = mShard.endFrame;
+    props[kLoadCheckpoint] = mShard.loadCheckpoint;
+    props[kSaveCheckpoint] = mShard.saveCheckpoint;
+    props[kCheckpointFrame] = mShard.checkpointFrame;
     return props;
 }
 
@@ -151,6 +178,7 @@ void ErrorMeasurePass::setScene(RenderContext* pRenderContext, const ref<Scene>&
 
 void ErrorMeasurePass::execute(RenderContext* pRenderContext, const RenderData& renderData)
 {
+    mFrame++;
     ref<Texture> pSourceImageTexture = renderData.getTexture(kInputChannelSourceImage);
     ref<Texture> pOutputImageTexture = renderData.getTexture(kOutputChannelImage);
 
@@ -193,6 +221,8 @@ void ErrorMeasurePass::execute(RenderContext* pRenderContext, const RenderData&
 
     runDifferencePass(pRenderContext, renderData);
     mMeasurements.valid = true;
+    if (mShard.isCheckpointFrame(mFrame))
+        saveCheckpoint(pRenderContext);
     // runReductionPasses(pRenderContext, renderData);
 
     switch (mSelectedOutputId)
@@ -210,7 +240,8 @@ void ErrorMeasurePass::execute(RenderContext* pRenderContext, const RenderData&
         FALCOR_THROW("ErrorMeasurePass: Unhandled OutputId case");
     }
 
-    saveMeasurementsToFile();
+    if (mShard.isWritten(mFrame))
+        saveMeasurementsToFile();
 }
 
 void ErrorMeasurePass::runDifferencePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -225,6 +256,11 @@ void ErrorMeasurePass::runDifferencePass(RenderContext* pRenderContext, const Re
     var["gResult"] = mpDifferenceTexture;
 
     prepareAccumulation(pRenderContext, pSourceTexture->getWidth(), pSourceTexture->getHeight());
+    if (mRestorePending)
+    {
+        loadCheckpoint(pRenderContext);
+        mRestorePending = false;
+    }
 
     // Set constant buffer parameters.
     const uint2 resolution = uint2(pSourceTexture->getWidth(), pSourceTexture->getHeight());
@@ -236,6 +272,7 @@ void ErrorMeasurePass::runDifferencePass(RenderContext* pRenderContext, const Re
     var["gLastEvent"] = mpLastEvent;
     var["gRecentSum"] = mpRecentSum;
     var["gRecentCount"] = mpRecentCount;
+    var["gCurrentIndex"] = mpCurrentIndex;
 
     // Run the compute shader.
     mpErrorMeasurerPass->execute(pRenderContext, resolution.x, resolution.y);
@@ -444,11 +481,37 @@ void ErrorMeasurePass::prepareAccumulation(RenderContext* pRenderContext, uint32
                 pRenderContext->clearUAV(pBuf->getUAV().get(), float4(0.f));
             else
                 pRenderContext->clearUAV(pBuf->getUAV().get(), uint4(0));
-            mReset = false;
         }
     };
 
     prepareBuffer(mpLastEvent, ResourceFormat::R32Float, true);
-    prepareBuffer(mpRecentCount, ResourceFormat::R32Float, true, 5);
-    prepareBuffer(mpRecentSum, ResourceFormat::R32Uint, true, 5);
+    prepareBuffer(mpRecentSum, ResourceFormat::R32Float, true, 5);
+    prepareBuffer(mpRecentCount, ResourceFormat::R32Uint, true, 5);
+    prepareBuffer(mpCurrentIndex, ResourceFormat::R32Uint, true);
+    mReset = false;
+}
+
+void ErrorMeasurePass::loadCheckpoint(RenderContext* pRenderContext)
+{
+    // The checkpoint holds the state after its frame, the current frame is the one after it.
+    EventCheckpoint checkpoint = EventCheckpoint::load(mShard.loadCheckpoint, "ErrorMeasurePass");
+    if (checkpoint.getFrame() + 1 != mFrame)
+        logWarning("Checkpoint '{}' is at frame {}, continuing from there instead of frame {}.", mShard.loadCheckpoint, checkpoint.getFrame(), mFrame - 1);
+    mFrame = checkpoint.getFrame() + 1;
+    checkpoint.restoreTexture(pRenderContext, "lastEvent", mpLastEvent.get());
+    checkpoint.restoreTexture(pRenderContext, "recentSum", mpRecentSum.get());
+    checkpoint.restoreTexture(pRenderContext, "recentCount", mpRecentCount.get());
+    checkpoint.restoreTexture(pRenderContext, "currentIndex", mpCurrentIndex.get());
+    logInfo("ErrorMeasurePass restored checkpoint '{}' at frame {}.", mShard.loadCheckpoint, checkpoint.getFrame());
+}
+
+void ErrorMeasurePass::saveCheckpoint(RenderContext* pRenderContext)
+{
+    EventCheckpoint checkpoint("ErrorMeasurePass", mFrame);
+    checkpoint.storeTexture(pRenderContext, "lastEvent", mpLastEvent.get());
+    checkpoint.storeTexture(pRenderContext, "recentSum", mpRecentSum.get());
+    checkpoint.storeTexture(pRenderContext, "recentCount", mpRecentCount.get());
+    checkpoint.storeTexture(pRenderContext, "currentIndex", mpCurrentIndex.get());
+    checkpoint.save(mShard.saveCheckpoint);
+    logInfo("ErrorMeasurePass saved checkpoint '{}' at frame {}.", mShard.saveCheckpoint, mFrame);
 }
@@ -29,6 +29,7 @@
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
 #include "Utils/Algorithm/ParallelReduction.h"
+#include "Utils/Events/EventCheckpoint.h"
 #include <fstream>
 
 using namespace Falcor;
@@ -88,6 +89,8 @@ private:
     void saveMeasurementsToFile();
     void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height);
     void reset();
+    void loadCheckpoint(RenderContext* pRenderContext);
+    void saveCheckpoint(RenderContext* pRenderContext);
 
     void runDifferencePass(RenderContext* pRenderContext, const RenderData& renderData);
     void runReductionPasses(RenderContext* pRenderContext, const RenderData& renderData);
@@ -147,9 +150,18 @@ private:
     ref<Texture> mpLastEvent;
     ref<Texture> mpRecentSum;
     ref<Texture> mpRecentCount;
+    /// Per-pixel slot of the current recent sum, the recent sums are a ring buffer
+    ref<Texture> mpCurrentIndex;
 
     Method mMethod = Method::GroundTructh;
 
+    /// Number of the current frame, counted from the start of the sequence
+    uint32_t mFrame = 0;
+    /// Frames rendered by this process when the sequence is split into shards
+    EventShardDesc mShard;
+    /// True until the checkpoint of the shard is restored, which requires the accumulation textures
+    bool mRestorePending = false;
+
     OutputId mSelectedOutputId = OutputId::Difference;
 
     static const Gui::RadioButtonGroup sOutputSelectionButtons;
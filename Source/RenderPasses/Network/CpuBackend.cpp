@@ -0,0 +1,70 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuBackend.h"
+
+CpuBackend::CpuBackend(const Desc& desc) : mBatchSize(desc.batchSize), mNetworkInputLength(desc.networkInputLength)
+{
+    const OnnxModel model = OnnxModel::load(desc.modelPath);
+    mpInference = std::make_unique<CpuInference>(
+        model, std::vector<int64_t>{int64_t(mBatchSize), 1, int64_t(mNetworkInputLength)}, desc.precision, desc.threadCount
+    );
+    FALCOR_CHECK(
+        mpInference->getOutputSize() == mBatchSize,
+        "Network output has {} values per batch, expected one per pixel ({}).",
+        mpInference->getOutputSize(),
+        mBatchSize
+    );
+    logInfo("CPU inference of '{}' in {}.", desc.modelPath, enumToString(desc.precision));
+}
+
+void CpuBackend::infer(RenderContext* pRenderContext, const ref<Buffer>& pInput, const ref<Buffer>& pOutput, uint32_t batchCount, uint32_t oldestSlot)
+{
+    const size_t batchInputSize = size_t(mBatchSize) * mNetworkInputLength;
+    const size_t historySize = size_t(batchCount) * 2 * batchInputSize;
+    mHistory.resize(historySize);
+    pInput->getBlob(mHistory.data(), 0, historySize * sizeof(float16_t));
+
+    // Transpose the last networkInputLength entries of each batch from [time, pixel] to the model input [pixel, 1, time].
+    mInput.resize(batchCount * batchInputSize);
+    for (uint32_t i = 0; i < batchCount; ++i)
+    {
+        const float16_t* pHistory = mHistory.data() + (size_t(i) * 2 * mNetworkInputLength + oldestSlot) * mBatchSize;
+        float* pBatch = mInput.data() + i * batchInputSize;
+        for (uint32_t t = 0; t < mNetworkInputLength; ++t)
+            for (uint32_t p = 0; p < mBatchSize; ++p)
+                pBatch[size_t(p) * mNetworkInputLength + t] = float(pHistory[size_t(t) * mBatchSize + p]);
+    }
+
+    mOutput.resize(size_t(batchCount) * mBatchSize);
+    mpInference->infer(mInput.data(), mOutput.data(), batchCount);
+
+    mOutputHalf.resize(mOutput.size());
+    for (size_t i = 0; i < mOutput.size(); ++i)
+        mOutputHalf[i] = float16_t(mOutput[i]);
+    pOutput->setBlob(mOutputHalf.data(), 0, mOutputHalf.size() * sizeof(float16_t));
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "InferenceBackend.h"
+#include "Utils/Math/Float16.h"
+#include <memory>
+#include <vector>
+
+/**
+ * CPU inference with CpuInference. The network input is read back each frame, converted from the time-major history
+ * to the model input layout and the output is uploaded to the output buffer.
+ */
+class CpuBackend : public InferenceBackend
+{
+public:
+    explicit CpuBackend(const Desc& desc);
+
+    void infer(RenderContext* pRenderContext, const ref<Buffer>& pInput, const ref<Buffer>& pOutput, uint32_t batchCount, uint32_t oldestSlot)
+        override;
+
+private:
+    uint32_t mBatchSize;
+    uint32_t mNetworkInputLength;
+    std::unique_ptr<CpuInference> mpInference;
+    std::vector<float16_t> mHistory;
+    std::vector<float> mInput;
+    std::vector<float> mOutput;
+    std::vector<float16_t> mOutputHalf;
+};
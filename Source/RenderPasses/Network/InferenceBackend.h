@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "Utils/Inference/CpuInference.h"
+#include <filesystem>
+
+using namespace Falcor;
+
+/**
+ * Inference backends of the Network pass.
+ */
+enum class InferenceBackendType : uint32_t
+{
+    TensorRT, ///< TensorRT engine on the GPU, reading the network buffers through CUDA.
+    CPU,      ///< Native CPU inference (CpuInference), for machines without CUDA and TensorRT.
+};
+FALCOR_ENUM_INFO(
+    InferenceBackendType,
+    {
+        {InferenceBackendType::TensorRT, "TensorRT"},
+        {InferenceBackendType::CPU, "CPU"},
+    }
+);
+FALCOR_ENUM_REGISTER(InferenceBackendType);
+
+/**
+ * Inference of the event network over the network input history.
+ *
+ * The input buffer holds the history of NetworkInput.cs.slang in half precision: each batch of batchSize pixels
+ * has 2 * networkInputLength slots of batchSize values, and the last networkInputLength entries are contiguous from
+ * the oldest slot. The model input is [batchSize, 1, networkInputLength]. The output buffer receives batchSize halfs
+ * per batch.
+ */
+class InferenceBackend
+{
+public:
+    struct Desc
+    {
+        std::filesystem::path modelPath;
+        uint32_t batchSize = 0;
+        uint32_t networkInputLength = 0;
+        /// TensorRT: directory of cached engines, empty for "engines" next to the model.
+        std::filesystem::path engineCacheDirectory;
+        /// CPU: arithmetic precision. Float16 matches the FP16 TensorRT engine.
+        InferencePrecision precision = InferencePrecision::Float16;
+        /// CPU: number of worker threads, 0 for the number of hardware threads.
+        uint32_t threadCount = 0;
+    };
+
+    virtual ~InferenceBackend() = default;
+
+    /// Bind flags the network input and output buffers need in addition to shader access.
+    virtual ResourceBindFlags getBufferBindFlags() const { return ResourceBindFlags::None; }
+
+    /**
+     * Run the network on all batches.
+     * @param[in] pRenderContext Render context, the input buffer is written by the network input pass.
+     * @param[in] pInput Network input history.
+     * @param[in] pOutput Network output.
+     * @param[in] batchCount Number of batches.
+     * @param[in] oldestSlot Slot of the oldest history entry in the network input.
+     */
+    virtual void infer(
+        RenderContext* pRenderContext,
+        const ref<Buffer>& pInput,
+        const ref<Buffer>& pOutput,
+        uint32_t batchCount,
+        uint32_t oldestSlot
+    ) = 0;
+};
@@ -25,29 +25,57 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
-#include <Utils/CudaRuntime.h>
-#include <Utils/CudaUtils.h>
 #include "Network.h"
+#include "CpuBackend.h"
+#if FALCOR_HAS_TENSORRT
+#include "TensorRTBackend.h"
+#endif
+#include "RenderGraph/RenderPassStandardFlags.h"
 #include <fstream>
 #include <filesystem>
 #include <chrono>
 
+namespace
+{
+void regNetwork(pybind11::module& m)
+{
+    pybind11::class_<Network, RenderPass, ref<Network>> pass(m, "Network");
+    pass.def_property_readonly("stats", [](const Network& self) { return toPython(self.getReadbackStats(), self.getStoredBytes()); });
+}
+} // namespace
+
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, Network>();
+    ScriptBindings::registerBinding(regNetwork);
 }
 
 namespace
 {
 const std::string kInputChannelEventImage = "input";
+const std::string kInputTileActivity = "tileActivity";
 const std::string kOutputChannelEventImage = "output";
 const std::string kAccumulatePass = "accumulatePass";
 const std::string kONNXModelPath = "model_path";
 const std::string kDirectory = "directory";
+const std::string kOutputFormat = "outputFormat";
+const std::string kTimeScale = "timeScale";
+const std::string kCompactEvents = "compactEvents";
 const std::string kNetworkInputLength = "networkInputLength";
 const std::string kBatchSize = "batchSize";
 const std::string kTau = "tau";
 const std::string kThreshold = "threshold";
+const std::string kTileActivity = "tileActivity";
+const std::string kEngineCache = "engineCache";
+const std::string kBackend = "backend";
+const std::string kCpuPrecision = "cpuPrecision";
+const std::string kCpuThreadCount = "cpuThreadCount";
+const std::string kFrameOffset = "frameOffset";
+const std::string kBeginFrame = "beginFrame";
+const std::string kEndFrame = "endFrame";
+const std::string kLoadCheckpoint = "loadCheckpoint";
+const std::string kSaveCheckpoint = "saveCheckpoint";
+const std::string kCheckpointFrame = "checkpointFrame";
 } // namespace
 
 void Network::prepareResources()
@@ -55,52 +83,65 @@ void Network::prepareResources()
     if (mFrameDim.x == 0 || mFrameDim.y == 0)
         return;
 
-    auto vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Shared;
+    auto vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | mpBackend->getBufferBindFlags();
     size_t type_size = sizeof(float) / 2;
     size_t storage = (mFrameDim.x * mFrameDim.y / batchSize + 1) * batchSize * type_size;
-    mpNetworkInputBuffer = mpDevice->createBuffer(storage * networkInputLength, vbBindFlags);
+    // Every history entry is stored twice, see NetworkInput.cs.slang.
+    mpNetworkInputBuffer = mpDevice->createBuffer(storage * networkInputLength * 2, vbBindFlags);
+    mHistory.reset(networkInputLength);
     mpNetworkOutputBuffer = mpDevice->createBuffer(storage, vbBindFlags);
     mpVBuffer = mpDevice->createBuffer(storage * 2, vbBindFlags);
+    std::vector<uint32_t> lastUpdate(storage * 2 / sizeof(uint32_t), 0);
+    mpLastUpdateBuffer = mpDevice->createBuffer(storage * 2, vbBindFlags, MemoryType::DeviceLocal, lastUpdate.data());
     mpLastTexture = mpDevice->createTexture2D(
         mFrameDim.x, mFrameDim.y, ResourceFormat::R32Float, 1, 1, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
 
-    type_size = sizeof(uint2);
-    mpCompressBuffer = mpDevice->createStructuredBuffer(type_size, mFrameDim.x * mFrameDim.y, vbBindFlags, MemoryType::DeviceLocal, nullptr, true);
-    mpReadbackBuffer = mpDevice->createBuffer(mpCompressBuffer->getSize(), ResourceBindFlags::None, MemoryType::ReadBack);
+    // Flush frames still in flight before the buffers are recreated.
+    mpEventReadback.reset();
+
+    EventFrameWriter::Desc writerDesc;
+    writerDesc.directory = mDirectoryPath;
+    writerDesc.outputFormat = mOutputFormat;
+    writerDesc.encoding = EventEncoding::FrameAddress64;
+    writerDesc.compact = mCompactEvents;
+    writerDesc.polarity = EventPolarity::OddIsOn;
+    writerDesc.timeScale = mTimeScale;
+    mEventWriter.open(writerDesc, mFrameDim, mFrame);
+
+    if (!mpEventCompaction)
+        mpEventCompaction = std::make_unique<EventCompaction>(mpDevice, sizeof(uint2));
+    mpEventCompaction->resize(mFrameDim.x * mFrameDim.y, 1);
+    mWriteAllTiles = true;
+    mpEventReadback = std::make_unique<AsyncEventReadback>(
+        mpDevice, sizeof(uint2), mFrameDim.x * mFrameDim.y,
+        [this](uint32_t frame, const void* pData, size_t size) { writeEvents(frame, pData, size); }
+    );
 }
 
-inline void checkCudaErrorCode(cudaError_t code)
+void Network::writeEvents(uint32_t frame, const void* pData, size_t size)
 {
-    if (code != cudaSuccess)
-    {
-        std::string errMsg = "CUDA operation failed with code: " + std::to_string(code) + " (" + cudaGetErrorName(code) +
-                             "), with message: " + cudaGetErrorString(code);
-        throw std::runtime_error(errMsg);
-    }
+    // Called on the readback writer thread.
+    // Timestamp the chunk with the frame stored in its events, which lags behind by half the window.
+    mEventWriter.write(frame, frame - networkInputLength / 2, pData, size);
 }
 
-class MyLogger : public nvinfer1::ILogger
-{
-    void log(Severity severity, const char* msg) noexcept override
-    {
-        if (severity <= Severity::kWARNING)
-        {
-            Falcor::logInfo(msg);
-        }
-    }
-} mylogger;
-
 Network::Network(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice) {
     std::string onnxModelPath = "";
 
     for (const auto& [key, value] : props)
     {
         if (key == kAccumulatePass)
-            mAccumulatePass = value;
+            mAccumulatePass = std::max(1u, (uint32_t)value);
         else if (key == kONNXModelPath)
             onnxModelPath = props.get<std::string>(key);
         else if (key == kDirectory)
             mDirectoryPath = props.get<std::string>(key);
+        else if (key == kOutputFormat)
+            mOutputFormat = value;
+        else if (key == kTimeScale)
+            mTimeScale = value;
+        else if (key == kCompactEvents)
+            mCompactEvents = value;
         else if (key == kNetworkInputLength)
             networkInputLength = value;
         else if (key == kBatchSize)
@@ -109,148 +150,55 @@ Network::Network(ref<Device> pDevice, const Properties& props) : RenderPass(pDev
             tau = value;
         else if (key == kThreshold)
             threshold = value;
+        else if (key == kTileActivity)
+            mTileActivity = value;
+        else if (key == kEngineCache)
+            mEngineCacheDirectory = props.get<std::string>(key);
+        else if (key == kBackend)
+            mBackend = value;
+        else if (key == kCpuPrecision)
+            mCpuPrecision = value;
+        else if (key == kCpuThreadCount)
+            mCpuThreadCount = value;
+        else if (key == kFrameOffset)
+            mShard.frameOffset = value;
+        else if (key == kBeginFrame)
+            mShard.beginFrame = value;
+        else if (key == kEndFrame)
+            mShard.endFrame = value;
+        else if (key == kLoadCheckpoint)
+            mShard.loadCheckpoint = props.get<std::string>(key);
+        else if (key == kSaveCheckpoint)
+            mShard.saveCheckpoint = props.get<std::string>(key);
+        else if (key == kCheckpointFrame)
+            mShard.checkpointFrame = value;
         else
             logWarning("Unknown property '{}' in Network properties.", key);
     }
-    prepareResources();
-
-    FALCOR_CHECK(onnxModelPath != "", "no model specified!");
-    // TensorRT
-    auto builder = std::unique_ptr<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(mylogger));
-    if (builder.get() == nullptr)
-        logFatal("builder is null");
-    auto explicitBatch = 1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
-    auto network = std::unique_ptr<nvinfer1::INetworkDefinition>(builder->createNetworkV2(explicitBatch));
-    if (network.get() == nullptr)
-        logFatal("network is null");
-    auto parser = std::unique_ptr<nvonnxparser::IParser>(nvonnxparser::createParser(*network, mylogger));
-    assert(parser.get() != nullptr);
-
-    std::ifstream file(onnxModelPath, std::ios::binary | std::ios::ate);
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::vector<char> buffer(size);
-    if (!file.read(buffer.data(), size))
-    {
-        auto msg = "Error, unable to read model file";
-        logError(msg);
-        throw std::runtime_error(msg);
-    }
-
-    // Parse the buffer we read into memory.
-    auto parsed = parser->parse(buffer.data(), buffer.size());
-    for (int32_t i = 0; i < parser->getNbErrors(); ++i)
-        logError("parser error:", parser->getError(i)->desc());
-    if (!parsed)
-    {
-        auto msg = "Error, unable to parse model file";
-        logError(msg);
-        throw std::runtime_error(msg);
-    }
 
-    auto config = std::unique_ptr<nvinfer1::IBuilderConfig>(builder->createBuilderConfig());
-    if (config == nullptr)
-        logFatal("config is null");
+    // Frames are numbered from the start of the sequence, also in a shard that starts later.
+    mFrame = mShard.frameOffset;
+    mRestorePending = !mShard.loadCheckpoint.empty();
 
-    FALCOR_CHECK(network->getNbInputs() == 1, "input number should be 1");
-
-    // Register a single optimization profile
-    auto optProfile = builder->createOptimizationProfile();
-    for (int i = 0; i < network->getNbInputs(); ++i)
-    {
-        auto inputName = network->getInput(i)->getName();
-        mpInputNames.push_back(inputName);
-        Falcor::logInfo("inputName {} is {}", i, inputName);
-        int32_t inputB = batchSize;
-        int32_t inputC = 1;
-        int32_t inputL = networkInputLength;
-        const auto inputDim = nvinfer1::Dims3(inputB, inputC, inputL);
-        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kMIN, inputDim);
-        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kOPT, inputDim);
-        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kMAX, inputDim);
-    }
-    config->addOptimizationProfile(optProfile);
-    config->setBuilderOptimizationLevel(5);
-    config->setMaxAuxStreams(numAuxStreams);
-    config->setFlag(nvinfer1::BuilderFlag::kGPU_FALLBACK);
-    config->setFlag(nvinfer1::BuilderFlag::kPREFER_PRECISION_CONSTRAINTS);
-    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, 1ULL << 33);
-    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kTACTIC_SHARED_MEMORY, 1ULL << 30);
-    config->setTilingOptimizationLevel(nvinfer1::TilingOptimizationLevel::kFULL);
-
-    /*
-    config->setFlag(nvinfer1::BuilderFlag::kTF32);
-    Falcor::logInfo("Use FP32");
-    */
-    if (!builder->platformHasFastFp16())
-    {
-        auto msg = "Error: GPU does not support FP16 precision";
-        logError(msg);
-        throw std::runtime_error(msg);
-    }
-    config->setFlag(nvinfer1::BuilderFlag::kFP16);
-    for (int i = 0; i < network->getNbInputs(); ++i)
-        network->getInput(i)->setType(nvinfer1::DataType::kHALF);
-    for (int i = 0; i < network->getNbOutputs(); ++i)
-        network->getOutput(i)->setType(nvinfer1::DataType::kHALF);
-    Falcor::logInfo("Use FP16");
-
-    checkCudaErrorCode(cudaStreamCreate(&profileStream));
-    config->setProfileStream(profileStream);
-
-    // Build the engine
-    // If this call fails, it is suggested to increase the logger verbosity to
-    // kVERBOSE and try rebuilding the engine. Doing so will provide you with more
-    // information on why exactly it is failing.
-    std::unique_ptr<nvinfer1::IHostMemory> plan{builder->buildSerializedNetwork(*network, *config)};
-    if (plan.get() == nullptr)
-        logFatal("plan is null");
-
-    std::filesystem::path path(onnxModelPath);
-    std::vector<std::filesystem::path> parts;
-    for (const auto& part : path)
-        parts.push_back(part);
-    std::string model_description = parts[parts.size() - 2].string() + parts[parts.size() - 1].string() + ".plan";
-
-    // Write the engine to disk
-    const auto enginePath = parts[0] / parts[1] / model_description;
-    std::ofstream outfile(enginePath, std::ofstream::binary);
-    outfile.write(reinterpret_cast<const char*>(plan->data()), plan->size());
-    Falcor::logInfo("Create plan Success, saved engine to {}", enginePath.string());
-
-    // TensorRT Runtime
-    mpRuntime = std::unique_ptr<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(mylogger));
-    if (mpRuntime.get() == nullptr)
-        logFatal("runtime is null");
-    auto ret = cudaSetDevice(0);
-    if (ret != 0)
-    {
-        int numGPUs;
-        cudaGetDeviceCount(&numGPUs);
-        auto errMsg = "Unable to set GPU device index to: " + std::to_string(0) + ". Note, your device has " +
-                      std::to_string(numGPUs) + " CUDA-capable GPU(s).";
-        logError(errMsg);
-        throw std::runtime_error(errMsg);
-    }
-
-    auxStreams.resize(numAuxStreams);
-    for (int j = 0; j < numAuxStreams; j++)
-        checkCudaErrorCode(cudaStreamCreate(&auxStreams[j]));
-    mpEngine = std::unique_ptr<nvinfer1::ICudaEngine>(mpRuntime->deserializeCudaEngine(plan->data(), plan->size()));
-    if (mpEngine.get() == nullptr)
-        logFatal("engine is null");
-
-    mpContext = std::unique_ptr<nvinfer1::IExecutionContext>(mpEngine->createExecutionContext());
-    if (mpContext.get() == nullptr)
-        logFatal("context is null");
-
-    mpContext->setAuxStreams(auxStreams.data(), numAuxStreams);
+    FALCOR_CHECK(onnxModelPath != "", "no model specified!");
+    InferenceBackend::Desc desc;
+    desc.modelPath = onnxModelPath;
+    desc.batchSize = batchSize;
+    desc.networkInputLength = networkInputLength;
+    desc.engineCacheDirectory = mEngineCacheDirectory;
+    desc.precision = mCpuPrecision;
+    desc.threadCount = mCpuThreadCount;
+    FALCOR_CHECK(
+        FALCOR_HAS_TENSORRT || mBackend == InferenceBackendType::CPU, "Network pass was built without TensorRT, use the 'CPU' backend."
+    );
+    if (mBackend == InferenceBackendType::CPU)
+        mpBackend = std::make_unique<CpuBackend>(desc);
+#if FALCOR_HAS_TENSORRT
+    else
+        mpBackend = std::make_unique<TensorRTBackend>(desc);
+#endif
 
-    FALCOR_CHECK(1 == network->getNbOutputs(), "output tensor number mismatch!");
-    auto name = mpEngine->getIOTensorName(mpEngine->getNbIOTensors() - 1);
-    Falcor::logInfo("output tensor name {} is {}", 0, name);
-    mpOutputNames.push_back(name);
+    prepareResources();
 }
 
 Properties Network::getProperties() const
@@ -258,10 +206,24 @@ Properties Network::getProperties() const
     Properties props;
     props[kAccumulatePass] = mAccumulatePass;
     props[kDirectory] = mDirectoryPath;
+    props[kOutputFormat] = mOutputFormat;
+    props[kTimeScale] = mTimeScale;
+    props[kCompactEvents] = mCompactEvents;
     props[kNetworkInputLength] = networkInputLength;
     props[kBatchSize] = batchSize;
     props[kTau] = tau;
     props[kThreshold] = threshold;
+    props[kTileActivity] = mTileActivity;
+    props[kEngineCache] = mEngineCacheDirectory;
+    props[kBackend] = mBackend;
+    props[kCpuPrecision] = mCpuPrecision;
+    props[kCpuThreadCount] = mCpuThreadCount;
+    props[kFrameOffset] = mShard.frameOffset;
+    props[kBeginFrame] = mShard.beginFrame;
+    props[kEndFrame] = mShard.endFrame;
+    props[kLoadCheckpoint] = mShard.loadCheckpoint.string();
+    props[kSaveCheckpoint] = mShard.saveCheckpoint.string();
+    props[kCheckpointFrame] = mShard.checkpointFrame;
     return props;
 }
 
@@ -269,9 +231,14 @@ RenderPassReflection Network::reflect(const CompileData& compileData)
 {
     RenderPassReflection reflector;
     reflector.addInput(kInputChannelEventImage, "Input accumulate image").bindFlags(ResourceBindFlags::ShaderResource);
+    reflector.addInput(kInputTileActivity, "Tile activity of TileActivityPass, only connected to execute after it")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    // With tile activity, static tiles are not written and keep the output of the last frame.
     reflector.addOutput(kOutputChannelEventImage, "Output event image")
         .bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
-        .format(ResourceFormat::RGBA32Float);
+        .format(ResourceFormat::RGBA32Float)
+        .flags(mTileActivity ? RenderPassReflection::Field::Flags::Persistent : RenderPassReflection::Field::Flags::None);
     return reflector;
 }
 
@@ -281,17 +248,36 @@ void Network::execute(RenderContext* pRenderContext, const RenderData& renderDat
         return;
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    mAccumulateFrame++;
-    if (mAccumulateFrame < mAccumulatePass)
-        return;
-    mAccumulateFrame = 0;
     mFrame++;
 
+    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
+    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
+    if (any(resolution != mFrameDim))
+    {
+        mFrameDim = resolution;
+        prepareResources();
+    }
+    if (mRestorePending)
+    {
+        loadCheckpoint(pRenderContext);
+        mRestorePending = false;
+    }
+
+    // Switching between the full and the tile dispatch recompiles the shaders.
+    ref<TileActivity> pTileActivity = getTileActivity(renderData);
+    if (mUseTiles != (pTileActivity != nullptr))
+    {
+        mUseTiles = pTileActivity != nullptr;
+        mpNetworkInputPass = nullptr;
+        mpNetworkOutputPass = nullptr;
+    }
+
     // ----------------- Do the input pass -----------------
     if (!mpNetworkInputPass)
     {
         DefineList defines;
         mpScene->getShaderDefines(defines);
+        defines.add("TILE_ACTIVITY", mUseTiles ? "1" : "0");
         ProgramDesc desc;
         mpScene->getShaderModules(desc.shaderModules);
         desc.addShaderLibrary("RenderPasses/Network/NetworkInput.cs.slang");
@@ -300,44 +286,28 @@ void Network::execute(RenderContext* pRenderContext, const RenderData& renderDat
         mpNetworkInputPass = ComputePass::create(mpDevice, desc, defines);
     }
 
-    ref<Texture> inputTexture = renderData.getTexture(kInputChannelEventImage);
-    const uint2 resolution = uint2(inputTexture->getWidth(), inputTexture->getHeight());
-    if (any(resolution != mFrameDim))
-    {
-        mFrameDim = resolution;
-        prepareResources();
-    }
-
     auto vars = mpNetworkInputPass->getRootVar();
     vars["input"] = inputTexture;
     vars["output"] = mpNetworkInputBuffer;
     vars["lastTexture"] = mpLastTexture;
     vars["PerFrameCB"]["gResolution"] = mFrameDim;
-    vars["PerFrameCB"]["gNetworkInputLength"] = networkInputLength;
-    mpNetworkInputPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    vars["PerFrameCB"]["gBatchSize"] = batchSize;
+    mHistory.advance();
+    mHistory.bindShaderData(vars["PerFrameCB"]["gHistory"]);
+    if (pTileActivity)
+    {
+        pTileActivity->bindShaderData(vars["gTileActivity"], mWriteAllTiles);
+        pTileActivity->dispatch(pRenderContext, mpNetworkInputPass.get(), mWriteAllTiles);
+    }
+    else
+        mpNetworkInputPass->execute(pRenderContext, uint3(mFrameDim, 1));
 
 
     // ----------------- Do the inference -----------------
+    // The history is stored per pixel, so all batches are inferred even with tile activity. Static pixels have a zero history.
     uint numPatches = mFrameDim.x * mFrameDim.y / batchSize + 1;
-    float16_t* base_input_ptr = static_cast<float16_t*>(mpNetworkInputBuffer->getCudaMemory()->getMappedData());
-    float16_t* base_output_ptr = static_cast<float16_t*>(mpNetworkOutputBuffer->getCudaMemory()->getMappedData());
-
     auto inference_start_time = std::chrono::high_resolution_clock::now();
-    for (uint i = 0; i < numPatches; i++)
-    {
-        void* inputAddr = base_input_ptr + i * networkInputLength * batchSize;
-        bool res = mpContext->setTensorAddress(mpInputNames[0].c_str(), inputAddr);
-        if (!res)
-            logFatal("Set input tensor {} address failed!", mpInputNames[0]);
-
-        void* outputAddr = base_output_ptr + i * batchSize;
-        res = mpContext->setTensorAddress(mpOutputNames[0].c_str(), outputAddr);
-        if (!res)
-            logFatal("Set output tensor address failed!");
-
-        mpContext->enqueueV3(profileStream);
-    }
-    checkCudaErrorCode(cudaStreamSynchronize(profileStream));
+    mpBackend->infer(pRenderContext, mpNetworkInputBuffer, mpNetworkOutputBuffer, numPatches, mHistory.getSlot(networkInputLength - 1));
 
     auto inference_end_time = std::chrono::high_resolution_clock::now();
 
@@ -346,6 +316,7 @@ void Network::execute(RenderContext* pRenderContext, const RenderData& renderDat
     {
         DefineList defines;
         mpScene->getShaderDefines(defines);
+        defines.add("TILE_ACTIVITY", mUseTiles ? "1" : "0");
         ProgramDesc desc;
         mpScene->getShaderModules(desc.shaderModules);
         desc.addShaderLibrary("RenderPasses/Network/NetworkOutput.cs.slang");
@@ -359,34 +330,33 @@ void Network::execute(RenderContext* pRenderContext, const RenderData& renderDat
     vars["input"] = mpNetworkOutputBuffer;
     vars["output"] = outputTexture;
     vars["vBuffer"] = mpVBuffer;
+    vars["lastUpdate"] = mpLastUpdateBuffer;
     vars["PerFrameCB"]["gResolution"] = mFrameDim;
     vars["PerFrameCB"]["gNetworkInputLength"] = networkInputLength;
     vars["PerFrameCB"]["gFrame"] = mFrame - networkInputLength / 2;
+    vars["PerFrameCB"]["gUpdateFrame"] = mFrame;
     vars["PerFrameCB"]["gTau"] = tau;
     vars["PerFrameCB"]["gThreshold"] = threshold;
-    pRenderContext->clearUAVCounter(mpCompressBuffer, 0);
-    vars["buffer_output"] = mpCompressBuffer;
+    mpEventCompaction->bindShaderData(vars["gEventSlots"]);
 
-    mpNetworkOutputPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    if (pTileActivity)
+    {
+        pTileActivity->bindShaderData(vars["gTileActivity"], mWriteAllTiles);
+        pTileActivity->dispatch(pRenderContext, mpNetworkOutputPass.get(), mWriteAllTiles);
+    }
+    else
+        mpNetworkOutputPass->execute(pRenderContext, uint3(mFrameDim, 1));
+    mWriteAllTiles = pTileActivity == nullptr;
 
-    if ( mFrame >= networkInputLength )
+    // The history is not filled during the first frames, their events are discarded. So are the events of the
+    // warm-up frames of a shard.
+    if (mFrame >= networkInputLength && mShard.isWritten(mFrame))
     {
-        ref<Buffer> pCounterBuffer = mpCompressBuffer->getUAVCounter();
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, pCounterBuffer.get(), 0, pCounterBuffer->getSize());
-        mpDevice->wait();
-        const uint32_t pCounterValue = *static_cast<const uint32_t*>(mpReadbackBuffer->map());
-        const uint32_t pDataSize = pCounterValue * sizeof(uint2);
-        mpReadbackBuffer->unmap();
-
-        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, mpCompressBuffer.get(), 0, pDataSize);
-        mpDevice->wait();
-        const uint* data = reinterpret_cast<const uint*>(mpReadbackBuffer->map());
-        std::string filename = mDirectoryPath + "\\data-" + std::to_string(mFrame) + ".bin";
-        std::ofstream file(filename, std::ios::binary);
-        file.write(reinterpret_cast<const char*>(data), pDataSize);
-        file.close();
-        mpReadbackBuffer->unmap();
+        mpEventCompaction->execute(pRenderContext, mpEventReadback->beginFrame(pRenderContext));
+        mpEventReadback->endFrame(pRenderContext, mFrame);
     }
+    if (mShard.isCheckpointFrame(mFrame))
+        saveCheckpoint(pRenderContext);
 
     auto end_time = std::chrono::high_resolution_clock::now();
     const auto inference_time_milli = 1000.0 * std::chrono::duration_cast<std::chrono::duration<double> >(inference_end_time - inference_start_time).count();
@@ -394,9 +364,67 @@ void Network::execute(RenderContext* pRenderContext, const RenderData& renderDat
     Falcor::logInfo("Inference: {:.6f} ms, MyNetworkPass: {:.6f} ms", inference_time_milli, time_milli);
 }
 
-void Network::renderUI(Gui::Widgets& widget) {}
+ref<TileActivity> Network::getTileActivity(const RenderData& renderData) const
+{
+    if (!mTileActivity || renderData[kInputTileActivity] == nullptr)
+        return nullptr;
+    ref<TileActivity> pTileActivity = renderData.getDictionary().getValue(kRenderPassTileActivity, ref<TileActivity>());
+    if (pTileActivity && any(pTileActivity->getFrameDim() != mFrameDim))
+        return nullptr;
+    return pTileActivity;
+}
+
+void Network::loadCheckpoint(RenderContext* pRenderContext)
+{
+    // The checkpoint holds the state after its frame, the current frame is the one after it.
+    EventCheckpoint checkpoint = EventCheckpoint::load(mShard.loadCheckpoint, "Network");
+    FALCOR_CHECK(
+        checkpoint.getValue<uint32_t>("networkInputLength") == networkInputLength,
+        "Checkpoint '{}' has a network input length of {}, the pass uses {}.",
+        mShard.loadCheckpoint,
+        checkpoint.getValue<uint32_t>("networkInputLength"),
+        networkInputLength
+    );
+    if (checkpoint.getFrame() + 1 != mFrame)
+        logWarning("Checkpoint '{}' is at frame {}, continuing from there instead of frame {}.", mShard.loadCheckpoint, checkpoint.getFrame(), mFrame - 1);
+    mFrame = checkpoint.getFrame() + 1;
+    checkpoint.restoreBuffer(pRenderContext, "networkInput", mpNetworkInputBuffer.get());
+    checkpoint.restoreBuffer(pRenderContext, "vBuffer", mpVBuffer.get());
+    // Checkpoints saved without it continue as if every pixel was updated in the checkpoint frame.
+    if (checkpoint.hasSection("lastUpdate"))
+        checkpoint.restoreBuffer(pRenderContext, "lastUpdate", mpLastUpdateBuffer.get());
+    else
+        pRenderContext->clearUAV(mpLastUpdateBuffer->getUAV().get(), uint4(checkpoint.getFrame()));
+    checkpoint.restoreTexture(pRenderContext, "lastTexture", mpLastTexture.get());
+    mHistory.setHead(checkpoint.getValue<uint32_t>("historyHead"));
+    logInfo("Network restored checkpoint '{}' at frame {}.", mShard.loadCheckpoint, checkpoint.getFrame());
+}
+
+void Network::saveCheckpoint(RenderContext* pRenderContext)
+{
+    EventCheckpoint checkpoint("Network", mFrame);
+    checkpoint.setValue("networkInputLength", networkInputLength);
+    checkpoint.setValue("historyHead", mHistory.getHead());
+    checkpoint.storeBuffer(pRenderContext, "networkInput", mpNetworkInputBuffer.get());
+    checkpoint.storeBuffer(pRenderContext, "vBuffer", mpVBuffer.get());
+    checkpoint.storeBuffer(pRenderContext, "lastUpdate", mpLastUpdateBuffer.get());
+    checkpoint.storeTexture(pRenderContext, "lastTexture", mpLastTexture.get());
+    checkpoint.save(mShard.saveCheckpoint);
+    logInfo("Network saved checkpoint '{}' at frame {}.", mShard.saveCheckpoint, mFrame);
+}
+
+void Network::renderUI(Gui::Widgets& widget)
+{
+    if (mpEventReadback)
+    {
+        const auto stats = mpEventReadback->getStats();
+        widget.text(fmt::format("Frames written: {}\nBytes written: {}\nReadback stalls: {}", stats.framesWritten, stats.bytesWritten, stats.stalls));
+    }
+}
 
 Network::~Network()
 {
-    checkCudaErrorCode(cudaStreamDestroy(profileStream));
+    // Write out the remaining frames while the members used by the write callback are still alive.
+    mpEventReadback.reset();
+    mEventWriter.close();
 }
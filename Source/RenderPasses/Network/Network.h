@@ -28,9 +28,14 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
-#include "NVinfer.h"
-#include "NvOnnxParser.h"
-#include <vector>
+#include "Utils/Events/AsyncEventReadback.h"
+#include "Utils/Events/EventCheckpoint.h"
+#include "Utils/Events/EventCompaction.h"
+#include "Utils/Events/EventFrameWriter.h"
+#include "Utils/Events/RingHistory.h"
+#include "Utils/Events/TileActivity.h"
+#include "InferenceBackend.h"
+#include <memory>
 
 using namespace Falcor;
 
@@ -49,6 +54,7 @@ public:
 
     virtual Properties getProperties() const override;
     virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual RenderPassSchedule getSchedule() const override { return RenderPassSchedule::every(mAccumulatePass, mAccumulatePass - 1); }
     virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) override {}
     virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
     virtual void renderUI(Gui::Widgets& widget) override;
@@ -56,24 +62,57 @@ public:
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
+    /// Get the statistics of the events read back so far.
+    AsyncEventReadback::Stats getReadbackStats() const
+    {
+        return mpEventReadback ? mpEventReadback->getStats() : AsyncEventReadback::Stats();
+    }
+    /// Get the number of bytes stored on disk so far, after encoding.
+    uint64_t getStoredBytes() const { return mEventWriter.getStoredBytes(); }
+
 private:
     void prepareResources();
+    void writeEvents(uint32_t frame, const void* pData, size_t size);
+    ref<TileActivity> getTileActivity(const RenderData& renderData) const;
+    void loadCheckpoint(RenderContext* pRenderContext);
+    void saveCheckpoint(RenderContext* pRenderContext);
 
     uint32_t networkInputLength;
     uint32_t batchSize;
+    /// Slot of the current frame in the network input history
+    RingHistory mHistory;
     ref<Buffer> mpNetworkInputBuffer;
     ref<Buffer> mpNetworkOutputBuffer;
     ref<Buffer> mpVBuffer;
+    /// Frame of the last update of every pixel in mpVBuffer, used to decay pixels of skipped tiles
+    ref<Buffer> mpLastUpdateBuffer;
 
     float tau;
     float threshold;
 
     /// Path to the directory where we store compressed data
     std::string mDirectoryPath;
-    /// GPU buffer used for compression operations
-    ref<Buffer> mpCompressBuffer;
-    /// CPU-readable buffer for transferring compressed data from GPU
-    ref<Buffer> mpReadbackBuffer;
+    /// Ring of GPU event buffers that are read back and written to disk asynchronously
+    std::unique_ptr<AsyncEventReadback> mpEventReadback;
+    /// Compaction of the per-pixel event slots into the readback buffers
+    std::unique_ptr<EventCompaction> mpEventCompaction;
+    /// Stream or per-frame files the events are written to on the readback writer thread
+    EventFrameWriter mEventWriter;
+    /// How events are written to disk
+    EventOutputFormat mOutputFormat = EventOutputFormat::Stream;
+    /// True if event streams use the compact encoding
+    bool mCompactEvents = true;
+    /// Output frames per second, stored in the event stream header
+    double mTimeScale = 1.0;
+    /// Only process the tiles listed by TileActivityPass in the input and output passes. The membrane potential of
+    /// skipped pixels decays as if the network output was zero, which differs from the full pass where it is not.
+    bool mTileActivity = false;
+    /// Directory of cached TensorRT engines, empty for "engines" next to the model.
+    std::string mEngineCacheDirectory;
+    /// True if the shaders are compiled for the tile dispatch
+    bool mUseTiles = false;
+    /// True if all tiles have to be written once, after the buffers were recreated
+    bool mWriteAllTiles = true;
 
     ref<Texture> mpLastTexture;
 
@@ -88,17 +127,16 @@ private:
     uint2 mFrameDim = {0, 0};
     /// Number of current frame (didn't consider the accumulate pass)
     uint32_t mFrame = 0;
-    /// Number of accumulate frame
-    uint32_t mAccumulateFrame = 0;
-    /// Accumulate Pass Frames
+    /// Accumulate Pass Frames, the pass runs once every this many frames of the graph
     uint32_t mAccumulatePass = 1;
+    /// Frames rendered by this process when the sequence is split into shards
+    EventShardDesc mShard;
+    /// True until the checkpoint of the shard is restored, which requires the resources of the first frame
+    bool mRestorePending = false;
 
-    std::vector<std::string> mpOutputNames, mpInputNames;
-    std::unique_ptr<nvinfer1::IRuntime> mpRuntime;
-    std::unique_ptr<nvinfer1::ICudaEngine> mpEngine;
-    std::unique_ptr<nvinfer1::IExecutionContext> mpContext;
-    std::vector<cudaStream_t> mpStream;
-    cudaStream_t profileStream;
-    const int numAuxStreams = 2;
-    std::vector<cudaStream_t> auxStreams;
+    /// Inference backend and its options, TensorRT is only available if the pass was built with it
+    InferenceBackendType mBackend = FALCOR_HAS_TENSORRT ? InferenceBackendType::TensorRT : InferenceBackendType::CPU;
+    InferencePrecision mCpuPrecision = InferencePrecision::Float16;
+    uint32_t mCpuThreadCount = 0;
+    std::unique_ptr<InferenceBackend> mpBackend;
 };
@@ -0,0 +1,279 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TensorRTBackend.h"
+#include <Utils/CudaUtils.h>
+#include <fstream>
+
+namespace
+{
+void checkCudaErrorCode(cudaError_t code)
+{
+    if (code != cudaSuccess)
+    {
+        std::string errMsg = "CUDA operation failed with code: " + std::to_string(code) + " (" + cudaGetErrorName(code) +
+                             "), with message: " + cudaGetErrorString(code);
+        throw std::runtime_error(errMsg);
+    }
+}
+
+class MyLogger : public nvinfer1::ILogger
+{
+    void log(Severity severity, const char* msg) noexcept override
+    {
+        if (severity <= Severity::kWARNING)
+        {
+            Falcor::logInfo(msg);
+        }
+    }
+} mylogger;
+} // namespace
+
+TensorRTBackend::TensorRTBackend(const Desc& desc) : batchSize(desc.batchSize), networkInputLength(desc.networkInputLength)
+{
+    std::ifstream file(desc.modelPath, std::ios::binary | std::ios::ate);
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    std::vector<char> buffer(size);
+    if (!file.read(buffer.data(), size))
+    {
+        auto msg = "Error, unable to read model file";
+        logError(msg);
+        throw std::runtime_error(msg);
+    }
+
+    // TensorRT Runtime
+    mpRuntime = std::unique_ptr<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(mylogger));
+    if (mpRuntime.get() == nullptr)
+        logFatal("runtime is null");
+    auto ret = cudaSetDevice(0);
+    if (ret != 0)
+    {
+        int numGPUs;
+        cudaGetDeviceCount(&numGPUs);
+        auto errMsg = "Unable to set GPU device index to: " + std::to_string(0) + ". Note, your device has " +
+                      std::to_string(numGPUs) + " CUDA-capable GPU(s).";
+        logError(errMsg);
+        throw std::runtime_error(errMsg);
+    }
+
+    auxStreams.resize(numAuxStreams);
+    for (int j = 0; j < numAuxStreams; j++)
+        checkCudaErrorCode(cudaStreamCreate(&auxStreams[j]));
+    checkCudaErrorCode(cudaStreamCreate(&profileStream));
+
+    // Building takes minutes, engines are cached by a hash of the model and everything that affects the build.
+    const std::filesystem::path cacheDirectory =
+        desc.engineCacheDirectory.empty() ? desc.modelPath.parent_path() / "engines" : desc.engineCacheDirectory;
+    EngineCache cache(cacheDirectory);
+    const std::string key = EngineCache::computeKey(buffer.data(), buffer.size(), getEngineParams());
+    auto build = [&]() { return buildEngine(buffer); };
+    bool built = false;
+    std::vector<uint8_t> plan = cache.getOrBuild(key, build, &built);
+    mpEngine = std::unique_ptr<nvinfer1::ICudaEngine>(mpRuntime->deserializeCudaEngine(plan.data(), plan.size()));
+    if (mpEngine.get() == nullptr && !built)
+    {
+        // A plan of another GPU or a corrupted file, replace it.
+        logWarning("Failed to deserialize cached engine '{}', rebuilding it.", cache.getPath(key));
+        cache.remove(key);
+        plan = cache.getOrBuild(key, build, &built);
+        mpEngine = std::unique_ptr<nvinfer1::ICudaEngine>(mpRuntime->deserializeCudaEngine(plan.data(), plan.size()));
+    }
+    if (mpEngine.get() == nullptr)
+        logFatal("engine is null");
+    Falcor::logInfo("{} engine '{}'", built ? "Built and cached" : "Loaded cached", cache.getPath(key).string());
+
+    mpContext = std::unique_ptr<nvinfer1::IExecutionContext>(mpEngine->createExecutionContext());
+    if (mpContext.get() == nullptr)
+        logFatal("context is null");
+
+    mpContext->setAuxStreams(auxStreams.data(), numAuxStreams);
+
+    for (int32_t i = 0; i < mpEngine->getNbIOTensors(); ++i)
+    {
+        const char* name = mpEngine->getIOTensorName(i);
+        const bool isInput = mpEngine->getTensorIOMode(name) == nvinfer1::TensorIOMode::kINPUT;
+        (isInput ? mpInputNames : mpOutputNames).push_back(name);
+        Falcor::logInfo("{} tensor name is {}", isInput ? "input" : "output", name);
+    }
+    FALCOR_CHECK(mpInputNames.size() == 1 && mpOutputNames.size() == 1, "engine must have one input and one output tensor");
+}
+
+TensorRTBackend::~TensorRTBackend()
+{
+    checkCudaErrorCode(cudaStreamDestroy(profileStream));
+}
+
+void TensorRTBackend::infer(
+    RenderContext* pRenderContext,
+    const ref<Buffer>& pInput,
+    const ref<Buffer>& pOutput,
+    uint32_t batchCount,
+    uint32_t oldestSlot
+)
+{
+    float16_t* base_input_ptr = static_cast<float16_t*>(pInput->getCudaMemory()->getMappedData());
+    float16_t* base_output_ptr = static_cast<float16_t*>(pOutput->getCudaMemory()->getMappedData());
+
+    for (uint i = 0; i < batchCount; i++)
+    {
+        // The last networkInputLength entries of a batch are contiguous from the oldest slot.
+        void* inputAddr = base_input_ptr + (size_t(i) * 2 * networkInputLength + oldestSlot) * batchSize;
+        bool res = mpContext->setTensorAddress(mpInputNames[0].c_str(), inputAddr);
+        if (!res)
+            logFatal("Set input tensor {} address failed!", mpInputNames[0]);
+
+        void* outputAddr = base_output_ptr + i * batchSize;
+        res = mpContext->setTensorAddress(mpOutputNames[0].c_str(), outputAddr);
+        if (!res)
+            logFatal("Set output tensor address failed!");
+
+        mpContext->enqueueV3(profileStream);
+    }
+    checkCudaErrorCode(cudaStreamSynchronize(profileStream));
+}
+
+std::vector<uint8_t> TensorRTBackend::buildEngine(const std::vector<char>& model)
+{
+    auto builder = std::unique_ptr<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(mylogger));
+    if (builder.get() == nullptr)
+        logFatal("builder is null");
+    auto explicitBatch = 1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH);
+    auto network = std::unique_ptr<nvinfer1::INetworkDefinition>(builder->createNetworkV2(explicitBatch));
+    if (network.get() == nullptr)
+        logFatal("network is null");
+    auto parser = std::unique_ptr<nvonnxparser::IParser>(nvonnxparser::createParser(*network, mylogger));
+    assert(parser.get() != nullptr);
+
+    // Parse the buffer we read into memory.
+    auto parsed = parser->parse(model.data(), model.size());
+    for (int32_t i = 0; i < parser->getNbErrors(); ++i)
+        logError("parser error:", parser->getError(i)->desc());
+    if (!parsed)
+    {
+        auto msg = "Error, unable to parse model file";
+        logError(msg);
+        throw std::runtime_error(msg);
+    }
+
+    auto config = std::unique_ptr<nvinfer1::IBuilderConfig>(builder->createBuilderConfig());
+    if (config == nullptr)
+        logFatal("config is null");
+
+    FALCOR_CHECK(network->getNbInputs() == 1, "input number should be 1");
+
+    // The history is time-major per batch (see NetworkInput.cs.slang). A transpose in front of the network replaces
+    // the batch-major input, so the history is not reordered every frame.
+    {
+        nvinfer1::ITensor* pBatchMajor = network->getInput(0);
+        const std::string inputName = pBatchMajor->getName();
+        pBatchMajor->setName((inputName + "_batchMajor").c_str());
+        nvinfer1::ITensor* pTimeMajor =
+            network->addInput(inputName.c_str(), pBatchMajor->getType(), nvinfer1::Dims2(networkInputLength, batchSize));
+        nvinfer1::IShuffleLayer* pTranspose = network->addShuffle(*pTimeMajor);
+        pTranspose->setFirstTranspose(nvinfer1::Permutation{{1, 0}});
+        pTranspose->setReshapeDimensions(nvinfer1::Dims3(batchSize, 1, networkInputLength));
+        for (int32_t i = 0; i < network->getNbLayers(); ++i)
+        {
+            nvinfer1::ILayer* pLayer = network->getLayer(i);
+            for (int32_t j = 0; j < pLayer->getNbInputs(); ++j)
+            {
+                if (pLayer->getInput(j) == pBatchMajor)
+                    pLayer->setInput(j, *pTranspose->getOutput(0));
+            }
+        }
+        network->removeTensor(*pBatchMajor);
+        FALCOR_CHECK(network->getNbInputs() == 1, "failed to replace the network input");
+    }
+
+    // Register a single optimization profile
+    auto optProfile = builder->createOptimizationProfile();
+    for (int i = 0; i < network->getNbInputs(); ++i)
+    {
+        auto inputName = network->getInput(i)->getName();
+        int32_t inputB = batchSize;
+        int32_t inputL = networkInputLength;
+        const auto inputDim = nvinfer1::Dims2(inputL, inputB);
+        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kMIN, inputDim);
+        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kOPT, inputDim);
+        optProfile->setDimensions(inputName, nvinfer1::OptProfileSelector::kMAX, inputDim);
+    }
+    config->addOptimizationProfile(optProfile);
+    config->setBuilderOptimizationLevel(5);
+    config->setMaxAuxStreams(numAuxStreams);
+    config->setFlag(nvinfer1::BuilderFlag::kGPU_FALLBACK);
+    config->setFlag(nvinfer1::BuilderFlag::kPREFER_PRECISION_CONSTRAINTS);
+    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kWORKSPACE, 1ULL << 33);
+    config->setMemoryPoolLimit(nvinfer1::MemoryPoolType::kTACTIC_SHARED_MEMORY, 1ULL << 30);
+    config->setTilingOptimizationLevel(nvinfer1::TilingOptimizationLevel::kFULL);
+
+    /*
+    config->setFlag(nvinfer1::BuilderFlag::kTF32);
+    Falcor::logInfo("Use FP32");
+    */
+    if (!builder->platformHasFastFp16())
+    {
+        auto msg = "Error: GPU does not support FP16 precision";
+        logError(msg);
+        throw std::runtime_error(msg);
+    }
+    config->setFlag(nvinfer1::BuilderFlag::kFP16);
+    for (int i = 0; i < network->getNbInputs(); ++i)
+        network->getInput(i)->setType(nvinfer1::DataType::kHALF);
+    for (int i = 0; i < network->getNbOutputs(); ++i)
+        network->getOutput(i)->setType(nvinfer1::DataType::kHALF);
+    Falcor::logInfo("Use FP16");
+
+    config->setProfileStream(profileStream);
+
+    // Build the engine
+    // If this call fails, it is suggested to increase the logger verbosity to
+    // kVERBOSE and try rebuilding the engine. Doing so will provide you with more
+    // information on why exactly it is failing.
+    std::unique_ptr<nvinfer1::IHostMemory> plan{builder->buildSerializedNetwork(*network, *config)};
+    if (plan.get() == nullptr)
+        logFatal("plan is null");
+    FALCOR_CHECK(1 == network->getNbOutputs(), "output tensor number mismatch!");
+
+    const uint8_t* pPlan = static_cast<const uint8_t*>(plan->data());
+    return std::vector<uint8_t>(pPlan, pPlan + plan->size());
+}
+
+EngineCache::Params TensorRTBackend::getEngineParams() const
+{
+    // Everything that changes the engine built by buildEngine(). Bump the layout when the network input changes.
+    EngineCache::Params params;
+    params["tensorrt"] = std::to_string(getInferLibVersion());
+    params["batchSize"] = std::to_string(batchSize);
+    params["networkInputLength"] = std::to_string(networkInputLength);
+    params["precision"] = "fp16";
+    params["optimizationLevel"] = "5";
+    params["auxStreams"] = std::to_string(numAuxStreams);
+    params["inputLayout"] = "timeMajor";
+    return params;
+}
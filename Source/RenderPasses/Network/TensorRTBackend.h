@@ -0,0 +1,68 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "InferenceBackend.h"
+#include "Utils/CudaRuntime.h"
+#include "Utils/Inference/EngineCache.h"
+#include "NVinfer.h"
+#include "NvOnnxParser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * TensorRT inference. Engines are built from the ONNX model in FP16 and cached in an EngineCache.
+ * The network buffers are shared with CUDA and the batches are enqueued on a CUDA stream.
+ */
+class TensorRTBackend : public InferenceBackend
+{
+public:
+    explicit TensorRTBackend(const Desc& desc);
+    ~TensorRTBackend() override;
+
+    ResourceBindFlags getBufferBindFlags() const override { return ResourceBindFlags::Shared; }
+    void infer(RenderContext* pRenderContext, const ref<Buffer>& pInput, const ref<Buffer>& pOutput, uint32_t batchCount, uint32_t oldestSlot)
+        override;
+
+private:
+    /// Builds the serialized TensorRT engine of an ONNX model.
+    std::vector<uint8_t> buildEngine(const std::vector<char>& model);
+    /// Returns the build parameters that are part of the engine cache key.
+    EngineCache::Params getEngineParams() const;
+
+    uint32_t batchSize;
+    uint32_t networkInputLength;
+
+    std::vector<std::string> mpOutputNames, mpInputNames;
+    std::unique_ptr<nvinfer1::IRuntime> mpRuntime;
+    std::unique_ptr<nvinfer1::ICudaEngine> mpEngine;
+    std::unique_ptr<nvinfer1::IExecutionContext> mpContext;
+    cudaStream_t profileStream;
+    const int numAuxStreams = 2;
+    std::vector<cudaStream_t> auxStreams;
+};
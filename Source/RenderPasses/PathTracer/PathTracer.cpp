@@ -1128,7 +1128,7 @@ void PathTracer::bindShaderData(const ShaderVar& var, const RenderData& renderDa
     ref<Texture> pSampleCount;
     if (!mFixedSampleCount)
     {
-        pSampleCount = renderData.getTexture(kInputSampleCount);
+        pSampleCount = getSampleCount(renderData);
         if (!pSampleCount) FALCOR_THROW("PathTracer: Missing sample count input texture");
     }
 
@@ -1229,8 +1229,11 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
         mRecompile = true;
     }
 
-    // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
-    mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
+    // Check if fixed sample count should be used. When the sample count input is connected or a sample count
+    // is published in the dictionary we load the count from there instead.
+    bool prevFixedSampleCount = mFixedSampleCount;
+    mFixedSampleCount = getSampleCount(renderData) == nullptr;
+    if (mFixedSampleCount != prevFixedSampleCount) mRecompile = true;
 
     // Check if guide data should be generated.
     mOutputGuideData = renderData[kOutputAlbedo] != nullptr || renderData[kOutputSpecularAlbedo] != nullptr
@@ -1280,6 +1283,16 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     return true;
 }
 
+ref<Texture> PathTracer::getSampleCount(const RenderData& renderData) const
+{
+    if (renderData[kInputSampleCount] != nullptr) return renderData.getTexture(kInputSampleCount);
+
+    // Sample count published by a later pass in the previous frame, ignored until it matches the frame dimension.
+    ref<Texture> pSampleCount = renderData.getDictionary().getValue(kRenderPassSampleCount, ref<Texture>());
+    if (pSampleCount && (pSampleCount->getWidth() != mParams.frameDim.x || pSampleCount->getHeight() != mParams.frameDim.y)) return nullptr;
+    return pSampleCount;
+}
+
 void PathTracer::endFrame(RenderContext* pRenderContext, const RenderData& renderData)
 {
     mpPixelStats->endFrame(pRenderContext);
@@ -1388,7 +1401,7 @@ void PathTracer::resolvePass(RenderContext* pRenderContext, const RenderData& re
     // Bind resources.
     auto var = mpResolvePass->getRootVar()["CB"]["gResolvePass"];
     var["params"].setBlob(mParams);
-    var["sampleCount"] = renderData.getTexture(kInputSampleCount); // Can be nullptr
+    var["sampleCount"] = getSampleCount(renderData); // Can be nullptr
     var["outputColor"] = renderData.getTexture(kOutputColor);
     var["outputColorDI"] = renderData.getTexture(kOutputDI);
     var["outputColorGI"] = renderData.getTexture(kOutputGI);
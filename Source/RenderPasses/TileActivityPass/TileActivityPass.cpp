@@ -0,0 +1,170 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TileActivityPass.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<RenderPass, TileActivityPass>();
+}
+
+namespace
+{
+const std::string kShaderFile = "RenderPasses/TileActivityPass/TileActivityPass.cs.slang";
+
+const std::string kInputMotionVectors = "mvec";
+const std::string kInputColor = "color";
+const std::string kOutputActivity = "activity";
+
+const std::string kEnabled = "enabled";
+const std::string kAccumulatePass = "accumulatePass";
+const std::string kMotionThreshold = "motionThreshold";
+const std::string kEventThreshold = "eventThreshold";
+const std::string kLumaThreshold = "lumaThreshold";
+const std::string kDilation = "dilation";
+const std::string kRefreshPeriod = "refreshPeriod";
+} // namespace
+
+TileActivityPass::TileActivityPass(ref<Device> pDevice, const Properties& props) : RenderPass(pDevice)
+{
+    for (const auto& [key, value] : props)
+    {
+        if (key == kEnabled)
+            mEnabled = value;
+        else if (key == kAccumulatePass)
+            mAccumulatePass = std::max(1u, (uint32_t)value);
+        else if (key == kMotionThreshold)
+            mDesc.motionThreshold = value;
+        else if (key == kEventThreshold)
+            mDesc.eventThreshold = std::max(1u, (uint32_t)value);
+        else if (key == kLumaThreshold)
+            mDesc.lumaThreshold = value;
+        else if (key == kDilation)
+            mDesc.dilation = value;
+        else if (key == kRefreshPeriod)
+            mDesc.refreshPeriod = value;
+        else
+            logWarning("Unknown property '{}' in TileActivityPass properties.", key);
+    }
+
+    mpTileActivity = make_ref<TileActivity>(mpDevice, mDesc);
+    mpVisualizePass = ComputePass::create(mpDevice, kShaderFile, "main");
+}
+
+Properties TileActivityPass::getProperties() const
+{
+    Properties props;
+    props[kEnabled] = mEnabled;
+    props[kAccumulatePass] = mAccumulatePass;
+    props[kMotionThreshold] = mDesc.motionThreshold;
+    props[kEventThreshold] = mDesc.eventThreshold;
+    props[kLumaThreshold] = mDesc.lumaThreshold;
+    props[kDilation] = mDesc.dilation;
+    props[kRefreshPeriod] = mDesc.refreshPeriod;
+    return props;
+}
+
+RenderPassReflection TileActivityPass::reflect(const CompileData& compileData)
+{
+    RenderPassReflection reflector;
+    reflector.addInput(kInputMotionVectors, "Screen space motion vectors")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    reflector.addInput(kInputColor, "Color the event passes consume, tiles whose luminance changes are active")
+        .bindFlags(ResourceBindFlags::ShaderResource)
+        .flags(RenderPassReflection::Field::Flags::Optional);
+    reflector.addOutput(kOutputActivity, "Tile activity, connect to the tileActivity input of the event passes")
+        .bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource)
+        .format(ResourceFormat::R8Unorm);
+    return reflector;
+}
+
+void TileActivityPass::setScene(RenderContext* pRenderContext, const ref<Scene>& pScene)
+{
+    // Restart with all tiles active in a new scene.
+    mpTileActivity = make_ref<TileActivity>(mpDevice, mDesc);
+}
+
+void TileActivityPass::execute(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    auto& dict = renderData.getDictionary();
+    ref<Texture> pOutput = renderData.getTexture(kOutputActivity);
+    if (!mEnabled)
+    {
+        dict[kRenderPassTileActivity] = ref<TileActivity>();
+        pRenderContext->clearUAV(pOutput->getUAV().get(), float4(1.f));
+        return;
+    }
+
+    mpTileActivity->setDesc(mDesc);
+    mpTileActivity->resize(uint2(pOutput->getWidth(), pOutput->getHeight()));
+    if (ref<Texture> pMotionVectors = renderData.getTexture(kInputMotionVectors))
+        mpTileActivity->addMotion(pRenderContext, pMotionVectors);
+    if (ref<Texture> pColor = renderData.getTexture(kInputColor))
+        mpTileActivity->addColor(pRenderContext, pColor);
+
+    // The event passes are scheduled on the last frame of an output frame, after this pass.
+    const uint64_t frame = dict.getValue(kRenderPassGraphFrame, uint64_t(0));
+    if (frame % mAccumulatePass == mAccumulatePass - 1)
+    {
+        mpTileActivity->update(pRenderContext);
+
+        const uint2 frameDim = mpTileActivity->getFrameDim();
+        auto var = mpVisualizePass->getRootVar();
+        var["CB"]["gFrameDim"] = frameDim;
+        var["CB"]["gTileCountX"] = mpTileActivity->getTileCount().x;
+        var["gFlags"] = mpTileActivity->getFlagBuffer();
+        var["gOutput"] = pOutput;
+        mpVisualizePass->execute(pRenderContext, uint3(frameDim, 1));
+    }
+
+    dict[kRenderPassTileActivity] = mpTileActivity;
+}
+
+void TileActivityPass::renderUI(Gui::Widgets& widget)
+{
+    widget.checkbox("Enabled", mEnabled);
+    widget.var("Motion threshold (pixels)", mDesc.motionThreshold, 0.f, 16.f, 0.01f);
+    widget.var("Event threshold", mDesc.eventThreshold, 1u, 1u << 16);
+    widget.var("Luminance threshold", mDesc.lumaThreshold, 0.f, 4.f, 0.01f);
+    widget.tooltip("Change of the log luminance of a pixel since it last activated its tile, above which the tile is active again.");
+    widget.var("Dilation (tiles)", mDesc.dilation, 0u, 8u);
+    widget.var("Refresh period", mDesc.refreshPeriod, 0u, 1000u);
+    widget.tooltip("Number of output frames after which all tiles are processed once, 0 to disable.");
+
+    const TileActivity::Stats stats = mpTileActivity->getStats();
+    if (stats.tileCount > 0)
+    {
+        widget.text(fmt::format(
+            "Active tiles: {} / {}\nSkipped tiles: {:.1f}%",
+            stats.activeTiles,
+            stats.tileCount,
+            100.0 * (stats.tileCount - stats.listedTiles) / stats.tileCount
+        ));
+    }
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include "RenderGraph/RenderPass.h"
+#include "Utils/Events/TileActivity.h"
+
+using namespace Falcor;
+
+/**
+ * Publishes a tile activity map that lets the event passes skip static screen regions.
+ *
+ * The map is built from the motion vectors and the luminance changes of the color input of every frame, and the events
+ * the event passes reported per tile, see TileActivity. Connect the color the event passes consume, otherwise changes
+ * without motion (moving lights and shadows) are only caught by the periodic refresh. It is updated once per output frame and published in the render graph dictionary
+ * (kRenderPassTileActivity). Event passes with tileActivity enabled use it when their tileActivity input is connected
+ * to the activity output, which makes them execute after this pass.
+ * The activity output shows active tiles as 1, tiles that are only cleared as 0.5 and skipped tiles as 0.
+ */
+class TileActivityPass : public RenderPass
+{
+public:
+    FALCOR_PLUGIN_CLASS(TileActivityPass, "TileActivityPass", "Tile activity map to skip static regions in event passes.");
+
+    static ref<TileActivityPass> create(ref<Device> pDevice, const Properties& props) { return make_ref<TileActivityPass>(pDevice, props); }
+
+    TileActivityPass(ref<Device> pDevice, const Properties& props);
+
+    virtual Properties getProperties() const override;
+    virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
+    virtual void renderUI(Gui::Widgets& widget) override;
+    virtual void setScene(RenderContext* pRenderContext, const ref<Scene>& pScene) override;
+
+private:
+    /// Publish the tile activity map, all tiles are processed if disabled
+    bool mEnabled = true;
+    /// Number of frames accumulated into an output frame, must match the event passes. The tiles are updated on the
+    /// graph frames the event passes are scheduled on.
+    uint32_t mAccumulatePass = 1;
+    TileActivity::Desc mDesc;
+
+    ref<TileActivity> mpTileActivity;
+    ref<ComputePass> mpVisualizePass;
+};
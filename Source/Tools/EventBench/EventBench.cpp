@@ -0,0 +1,316 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PipelineBench.h"
+#include "Utils/Events/EventCodec.h"
+#include "Utils/Events/EventStreamFile.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <args.hxx>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Falcor;
+
+namespace
+{
+/// Events of one chunk in their source encoding.
+struct Chunk
+{
+    uint32_t time = 0;
+    std::vector<uint32_t> addresses; ///< Used by EventEncoding::Address32.
+    std::vector<uint2> events;       ///< Used by EventEncoding::FrameAddress64.
+};
+
+struct Dataset
+{
+    std::string name;
+    EventEncoding encoding = EventEncoding::FrameAddress64;
+    std::vector<Chunk> chunks;
+};
+
+struct Result
+{
+    uint64_t eventCount = 0;
+    uint64_t rawBytes = 0;
+    uint64_t encodedBytes = 0;
+    double encodeSeconds = 0.0;
+    double decodeSeconds = 0.0;
+};
+
+double getSeconds(CpuTimer::TimePoint start)
+{
+    return CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) * 1e-3;
+}
+
+/// Synthetic frames with a given event density, horizontal runs along edges and nearly sorted addresses.
+Dataset createSyntheticDataset(uint32_t width, uint32_t height, uint32_t frameCount, float density, uint32_t seed)
+{
+    Dataset dataset;
+    dataset.name = fmt::format("synthetic {}x{} density {}", width, height, density);
+    dataset.encoding = EventEncoding::FrameAddress64;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u;
+    const uint32_t pixelCount = width * height;
+    for (uint32_t frame = 0; frame < frameCount; ++frame)
+    {
+        Chunk chunk;
+        chunk.time = frame;
+        for (uint32_t pixel = 0; pixel < pixelCount; ++pixel)
+        {
+            if (u(rng) >= density)
+                continue;
+            uint32_t polarity = rng() & 1;
+            uint32_t runLength = u(rng) < 0.3f ? rng() % 16 + 1 : 1;
+            for (uint32_t k = 0; k < runLength && pixel < pixelCount; ++k, ++pixel)
+                chunk.events.push_back({frame, pixel * 2 + polarity});
+        }
+        for (size_t i = 0; i + 1 < chunk.events.size(); i += 5)
+            std::swap(chunk.events[i], chunk.events[i + 1]);
+        dataset.chunks.push_back(std::move(chunk));
+    }
+    return dataset;
+}
+
+/// Load the chunks of a recorded event stream, decoding compact streams to their (time, address) events.
+bool loadDataset(const std::filesystem::path& path, Dataset& dataset)
+{
+    EventStreamReader reader(path);
+    if (!reader.isOpen())
+    {
+        std::cerr << "Failed to open event stream '" << path.string() << "'." << std::endl;
+        return false;
+    }
+
+    const EventStreamDesc& desc = reader.getDesc();
+    dataset.name = path.filename().string();
+    dataset.encoding = desc.encoding == EventEncoding::Address32 ? EventEncoding::Address32 : EventEncoding::FrameAddress64;
+    for (size_t i = 0; i < reader.getChunkCount(); ++i)
+    {
+        const EventChunkInfo& info = reader.getChunks()[i];
+        Chunk chunk;
+        chunk.time = uint32_t(info.timestamp);
+        if (desc.encoding == EventEncoding::Address32)
+        {
+            const uint32_t* pData = reinterpret_cast<const uint32_t*>(reader.getChunkData(i));
+            chunk.addresses.assign(pData, pData + info.size / sizeof(uint32_t));
+        }
+        else if (desc.encoding == EventEncoding::FrameAddress64)
+        {
+            const uint2* pData = reinterpret_cast<const uint2*>(reader.getChunkData(i));
+            chunk.events.assign(pData, pData + info.size / sizeof(uint2));
+        }
+        else if (!EventCodec::decode(reinterpret_cast<const uint8_t*>(reader.getChunkData(i)), info.size, chunk.events))
+        {
+            std::cerr << "Malformed chunk " << i << " in '" << path.string() << "'." << std::endl;
+            return false;
+        }
+        dataset.chunks.push_back(std::move(chunk));
+    }
+    return true;
+}
+
+/// Encode and decode all chunks, keeping the fastest of several repetitions.
+Result runBenchmark(const Dataset& dataset, uint32_t repetitions)
+{
+    Result result;
+    EventCodec codec;
+    std::vector<std::vector<uint8_t>> encoded(dataset.chunks.size());
+    std::vector<uint2> decoded;
+
+    for (const Chunk& chunk : dataset.chunks)
+    {
+        size_t count = dataset.encoding == EventEncoding::Address32 ? chunk.addresses.size() : chunk.events.size();
+        result.eventCount += count;
+        result.rawBytes += count * (dataset.encoding == EventEncoding::Address32 ? sizeof(uint32_t) : sizeof(uint2));
+    }
+
+    result.encodeSeconds = result.decodeSeconds = std::numeric_limits<double>::max();
+    for (uint32_t r = 0; r < repetitions; ++r)
+    {
+        auto start = CpuTimer::getCurrentTimePoint();
+        for (size_t i = 0; i < dataset.chunks.size(); ++i)
+        {
+            const Chunk& chunk = dataset.chunks[i];
+            encoded[i].clear();
+            if (dataset.encoding == EventEncoding::Address32)
+                codec.encodeAddress32(chunk.addresses.data(), chunk.addresses.size(), chunk.time, encoded[i]);
+            else
+                codec.encodeFrameAddress64(chunk.events.data(), chunk.events.size(), encoded[i]);
+        }
+        result.encodeSeconds = std::min(result.encodeSeconds, getSeconds(start));
+
+        start = CpuTimer::getCurrentTimePoint();
+        for (const auto& data : encoded)
+        {
+            decoded.clear();
+            if (!EventCodec::decode(data.data(), data.size(), decoded))
+                std::cerr << "Failed to decode a chunk of '" << dataset.name << "'." << std::endl;
+        }
+        result.decodeSeconds = std::min(result.decodeSeconds, getSeconds(start));
+    }
+
+    for (const auto& data : encoded)
+        result.encodedBytes += data.size();
+    return result;
+}
+
+void printResult(const Dataset& dataset, const Result& result)
+{
+    const double events = double(std::max<uint64_t>(result.eventCount, 1));
+    std::cout << fmt::format("{}\n", dataset.name);
+    std::cout << fmt::format("  chunks:          {}\n", dataset.chunks.size());
+    std::cout << fmt::format("  events:          {}\n", result.eventCount);
+    std::cout << fmt::format("  raw bytes/event: {:.3f} ({})\n", result.rawBytes / events, enumToString(dataset.encoding));
+    std::cout << fmt::format("  compact:         {:.3f} bytes/event, ratio {:.2f}x\n", result.encodedBytes / events,
+                             result.rawBytes / double(std::max<uint64_t>(result.encodedBytes, 1)));
+    // Throughput is given in raw (uncompressed) bytes per second.
+    std::cout << fmt::format("  encode:          {:.3f} GB/s, {:.1f} Mevents/s\n", result.rawBytes / result.encodeSeconds * 1e-9,
+                             events / result.encodeSeconds * 1e-6);
+    std::cout << fmt::format("  decode:          {:.3f} GB/s, {:.1f} Mevents/s\n", result.rawBytes / result.decodeSeconds * 1e-9,
+                             events / result.decodeSeconds * 1e-6);
+}
+
+/// Run the pipeline benchmark and write its report to a file, or to stdout if no path is given.
+int runPipeline(const PipelineBenchDesc& desc, const std::string& reportPath)
+{
+    nlohmann::ordered_json report;
+    try
+    {
+        report = runPipelineBenchmark(desc);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    for (const auto& [name, variant] : report["variants"].items())
+    {
+        std::cout << fmt::format(
+            "{:<13} {:8.1f} frames/s {:8.2f} Mevents/s {:8.2f} MB/s\n",
+            name,
+            variant["framesPerSecond"].get<double>(),
+            variant["eventsPerSecond"].get<double>() * 1e-6,
+            variant["bytesWrittenPerSecond"].get<double>() * 1e-6
+        );
+    }
+
+    if (reportPath.empty())
+    {
+        std::cout << report.dump(4) << std::endl;
+        return 0;
+    }
+    std::ofstream file(reportPath);
+    if (!file)
+    {
+        std::cerr << fmt::format("Failed to write '{}'.", reportPath) << std::endl;
+        return 1;
+    }
+    file << report.dump(4) << std::endl;
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    args::ArgumentParser parser(
+        "Benchmark for the compact event encoding. With --pipeline, benchmark the CPU event pipeline variants instead."
+    );
+    parser.helpParams.programName = "EventBench";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<uint32_t> widthFlag(parser, "width", "Width of the synthetic frames.", {"width"}, 1280);
+    args::ValueFlag<uint32_t> heightFlag(parser, "height", "Height of the synthetic frames.", {"height"}, 720);
+    args::ValueFlag<uint32_t> framesFlag(parser, "frames", "Number of synthetic frames.", {"frames"}, 32);
+    args::ValueFlag<uint32_t> repetitionsFlag(parser, "count", "Number of repetitions, the fastest is reported.", {'r', "repetitions"}, 5);
+    args::PositionalList<std::string> streamsFlag(parser, "streams", "Recorded event stream files (.evs) to benchmark.");
+
+    args::Flag pipelineFlag(parser, "", "Benchmark the CPU event pipeline on a synthetic animation.", {"pipeline"});
+    args::ValueFlagList<std::string> variantFlags(
+        parser, "name", "Variant to run (Compress, Denoise, Network, BlockStorage), all if omitted.", {"variant"}
+    );
+    args::ValueFlag<uint32_t> warmupFlag(parser, "frames", "Number of frames run before measuring.", {"warmup"}, 4);
+    args::ValueFlag<std::string> directoryFlag(parser, "path", "Directory the variants write to.", {"directory"}, "benchmark");
+    args::ValueFlag<std::string> reportFlag(parser, "path", "Path of the JSON report, printed if omitted.", {"report"});
+    args::ValueFlag<std::string> modelFlag(parser, "path", "ONNX model of the Network variant.", {"model"});
+    args::ValueFlag<uint32_t> threadsFlag(parser, "count", "Number of worker threads, 0 for all hardware threads.", {"threads"}, 0);
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (pipelineFlag)
+    {
+        PipelineBenchDesc desc;
+        desc.frameDim = {args::get(widthFlag), args::get(heightFlag)};
+        desc.frameCount = args::get(framesFlag);
+        desc.warmupCount = args::get(warmupFlag);
+        desc.variants = args::get(variantFlags);
+        desc.directory = args::get(directoryFlag);
+        desc.modelPath = args::get(modelFlag);
+        desc.threadCount = args::get(threadsFlag);
+        return runPipeline(desc, args::get(reportFlag));
+    }
+
+    const uint32_t repetitions = std::max(1u, args::get(repetitionsFlag));
+    std::vector<Dataset> datasets;
+    if (!streamsFlag)
+    {
+        for (float density : {0.005f, 0.05f, 0.25f})
+            datasets.push_back(createSyntheticDataset(args::get(widthFlag), args::get(heightFlag), args::get(framesFlag), density, 1));
+    }
+    for (const auto& path : args::get(streamsFlag))
+    {
+        Dataset dataset;
+        if (!loadDataset(path, dataset))
+            return 1;
+        datasets.push_back(std::move(dataset));
+    }
+
+    for (const Dataset& dataset : datasets)
+        printResult(dataset, runBenchmark(dataset, repetitions));
+    return 0;
+}
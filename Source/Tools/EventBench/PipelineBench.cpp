@@ -0,0 +1,471 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PipelineBench.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/BlockStorage/BlockArchive.h"
+#include "Utils/BlockStorage/BlockCompression.h"
+#include "Utils/Events/EventCodec.h"
+#include "Utils/Events/EventSimulator.h"
+#include "Utils/Events/EventStreamFile.h"
+#include "Utils/Inference/CpuInference.h"
+#include "Utils/Inference/OnnxModel.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+using namespace Falcor;
+
+namespace
+{
+const std::string kCompress = "Compress";
+const std::string kDenoise = "Denoise";
+const std::string kNetwork = "Network";
+const std::string kBlockStorage = "BlockStorage";
+
+/// Frame rate of the synthetic animation.
+const double kAnimationFrameRate = 60.0;
+/// Block size of the BlockStorage variant. Fewer frames per batch than the pass keeps the batch in memory small.
+const uint3 kBlockSize = {64, 64, 16};
+/// Number of model inputs per inference call of the Network variant.
+const uint32_t kBatchesPerCall = 256;
+
+using json = nlohmann::ordered_json;
+
+float hashToFloat(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return (x >> 8) * (1.f / float(1u << 24));
+}
+
+float getLuma(const float4& color)
+{
+    return 0.2126f * color.r + 0.7152f * color.g + 0.0722f * color.b;
+}
+
+/**
+ * Render a frame of the synthetic animation: a checkered floor lit from the center, a square spinning once every
+ * 4 seconds and a disc moving back and forth every 2 seconds, seen from above. A little per-pixel noise mimics a
+ * path tracer with one sample per pixel.
+ */
+void renderSyntheticFrame(uint2 frameDim, uint32_t frame, std::vector<float4>& pixels)
+{
+    pixels.resize(size_t(frameDim.x) * frameDim.y);
+    const float time = float(frame / kAnimationFrameRate);
+    const float angle = time * 6.28318531f / 4.f;
+    const float cosAngle = std::cos(angle);
+    const float sinAngle = std::sin(angle);
+    const float phase = std::fmod(time, 2.f);
+    const float discY = 0.6f * (phase < 1.f ? phase : 2.f - phase) - 0.3f;
+    const float aspect = float(frameDim.x) / float(frameDim.y);
+
+    for (uint32_t y = 0; y < frameDim.y; ++y)
+    {
+        for (uint32_t x = 0; x < frameDim.x; ++x)
+        {
+            const float u = (x + 0.5f) / frameDim.y - 0.5f * aspect;
+            const float v = (y + 0.5f) / frameDim.y - 0.5f;
+            const float light = 1.5f / (1.f + 4.f * (u * u + v * v));
+
+            const bool checker = ((int(std::floor(u * 8.f)) + int(std::floor(v * 8.f))) & 1) != 0;
+            float3 color = float3(checker ? 0.6f : 0.3f) * light;
+
+            const float su = cosAngle * (u + 0.3f) + sinAngle * v;
+            const float sv = -sinAngle * (u + 0.3f) + cosAngle * v;
+            if (std::max(std::abs(su), std::abs(sv)) < 0.12f)
+                color = float3(0.8f, 0.2f, 0.1f) * light * (su > 0.f ? 1.f : 0.6f);
+
+            const float r2 = (u - 0.3f) * (u - 0.3f) + (v - discY) * (v - discY);
+            if (r2 < 0.01f)
+                color = float3(0.9f) * light * (1.f - 30.f * r2);
+
+            const uint32_t index = y * frameDim.x + x;
+            const float noise = 1.f + 0.05f * (hashToFloat(index ^ (frame * 0x9e3779b9u)) - 0.5f);
+            pixels[index] = float4(color * noise, 1.f);
+        }
+    }
+}
+
+/// Accumulates the time of the pipeline stages, in the order they first ran.
+class StageTimes
+{
+public:
+    template<typename Func>
+    void run(const std::string& name, bool measured, Func func)
+    {
+        auto start = CpuTimer::getCurrentTimePoint();
+        func();
+        if (!measured)
+            return;
+        const double seconds = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        auto it = std::find_if(mStages.begin(), mStages.end(), [&](const auto& stage) { return stage.first == name; });
+        if (it == mStages.end())
+            mStages.emplace_back(name, seconds);
+        else
+            it->second += seconds;
+    }
+
+    double getTotalSeconds() const
+    {
+        double total = 0.0;
+        for (const auto& stage : mStages)
+            total += stage.second;
+        return total;
+    }
+
+    json toJson(uint32_t frameCount) const
+    {
+        json stages = json::object();
+        for (const auto& [name, seconds] : mStages)
+            stages[name] = {{"cpuTime", seconds * 1e3 / std::max(frameCount, 1u)}};
+        return stages;
+    }
+
+private:
+    std::vector<std::pair<std::string, double>> mStages;
+};
+
+json createVariantReport(const PipelineBenchDesc& desc, const StageTimes& stages, uint64_t eventCount, uint64_t bytesWritten)
+{
+    const double seconds = std::max(stages.getTotalSeconds(), 1e-9);
+    json report;
+    report["frames"] = desc.frameCount;
+    report["seconds"] = seconds;
+    report["framesPerSecond"] = desc.frameCount / seconds;
+    report["events"] = eventCount;
+    report["eventsPerSecond"] = eventCount / seconds;
+    report["bytesWritten"] = bytesWritten;
+    report["bytesWrittenPerSecond"] = bytesWritten / seconds;
+    report["readbackStalls"] = 0; // There is no GPU readback on the CPU.
+    report["stages"] = stages.toJson(desc.frameCount);
+    // The peak is the one of the process so far, so it includes the variants run before.
+    report["peakMemory"] = {{"processPeakBytes", getPeakRSS()}, {"processCurrentBytes", getCurrentRSS()}};
+    return report;
+}
+
+/// Runs the luma history of every pixel through the model of the Network pass.
+class NetworkInference
+{
+public:
+    NetworkInference(const PipelineBenchDesc& desc)
+        : mInputLength(desc.networkInputLength)
+        , mBatchSize(desc.batchSize)
+        , mPixelCount(size_t(desc.frameDim.x) * desc.frameDim.y)
+    {
+        const OnnxModel model = OnnxModel::load(desc.modelPath);
+        mpInference = std::make_unique<CpuInference>(
+            model, std::vector<int64_t>{int64_t(mBatchSize), 1, int64_t(mInputLength)}, InferencePrecision::Float16, desc.threadCount
+        );
+        FALCOR_CHECK(
+            mpInference->getOutputSize() == mBatchSize,
+            "Network output has {} values per batch, expected one per pixel ({}).",
+            mpInference->getOutputSize(),
+            mBatchSize
+        );
+        mHistory.assign(mPixelCount * mInputLength, 0.f);
+    }
+
+    /// Add the luma of a frame to the history and infer the network output of every pixel.
+    void infer(const std::vector<float>& luma, uint32_t frame, std::vector<float>& output)
+    {
+        const uint32_t slot = frame % mInputLength;
+        std::memcpy(mHistory.data() + slot * mPixelCount, luma.data(), mPixelCount * sizeof(float));
+
+        output.resize(mPixelCount);
+        const uint32_t batchCount = uint32_t(div_round_up(mPixelCount, size_t(mBatchSize)));
+        for (uint32_t firstBatch = 0; firstBatch < batchCount; firstBatch += kBatchesPerCall)
+        {
+            const uint32_t count = std::min(kBatchesPerCall, batchCount - firstBatch);
+            const size_t firstPixel = size_t(firstBatch) * mBatchSize;
+            mInput.assign(size_t(count) * mBatchSize * mInputLength, 0.f);
+            for (size_t p = firstPixel; p < std::min(firstPixel + size_t(count) * mBatchSize, mPixelCount); ++p)
+            {
+                // Model input is [pixel, 1, time] from the oldest to the newest entry.
+                float* pInput = mInput.data() + (p - firstPixel) * mInputLength;
+                for (uint32_t t = 0; t < mInputLength; ++t)
+                    pInput[t] = mHistory[((slot + 1 + t) % mInputLength) * mPixelCount + p];
+            }
+            mOutput.resize(size_t(count) * mBatchSize);
+            mpInference->infer(mInput.data(), mOutput.data(), count);
+            const size_t pixelCount = std::min(size_t(count) * mBatchSize, mPixelCount - firstPixel);
+            std::copy(mOutput.begin(), mOutput.begin() + pixelCount, output.begin() + firstPixel);
+        }
+    }
+
+private:
+    uint32_t mInputLength;
+    uint32_t mBatchSize;
+    size_t mPixelCount;
+    std::unique_ptr<CpuInference> mpInference;
+    std::vector<float> mHistory; ///< Luma of the last mInputLength frames, one slot per frame.
+    std::vector<float> mInput;
+    std::vector<float> mOutput;
+};
+
+json runEventVariant(const PipelineBenchDesc& desc, const std::string& variant)
+{
+    const size_t pixelCount = size_t(desc.frameDim.x) * desc.frameDim.y;
+    EventSimulatorDesc simDesc;
+    simDesc.frameDim = desc.frameDim;
+    EventStreamDesc streamDesc;
+    streamDesc.width = desc.frameDim.x;
+    streamDesc.height = desc.frameDim.y;
+    streamDesc.timeScale = kAnimationFrameRate;
+    streamDesc.encoding = EventEncoding::Compact;
+
+    std::unique_ptr<NetworkInference> pNetwork;
+    if (variant == kCompress)
+    {
+        simDesc.model = EventModel::RatioThreshold;
+    }
+    else if (variant == kDenoise)
+    {
+        simDesc.model = EventModel::LogThreshold;
+        simDesc.window = 10;
+    }
+    else
+    {
+        simDesc.model = EventModel::LeakyIntegrateFire;
+        simDesc.channelCount = 1;
+        if (!desc.modelPath.empty())
+            pNetwork = std::make_unique<NetworkInference>(desc);
+    }
+
+    EventSimulator simulator(simDesc, desc.threadCount);
+    std::filesystem::create_directories(desc.directory / variant);
+    EventStreamWriter writer(desc.directory / variant / "events.evs", streamDesc);
+    EventCodec codec;
+
+    StageTimes stages;
+    std::vector<float4> pixels;
+    std::vector<float> luma(pixelCount), lastLogLuma(pixelCount, 0.f), networkOutput;
+    std::vector<uint2> events;
+    std::vector<uint32_t> addresses;
+    std::vector<uint8_t> encoded;
+    uint64_t eventCount = 0;
+
+    for (uint32_t frame = 0; frame < desc.warmupCount + desc.frameCount; ++frame)
+    {
+        const bool measured = frame >= desc.warmupCount;
+        stages.run("render", measured, [&]() { renderSyntheticFrame(desc.frameDim, frame, pixels); });
+
+        const float* pFrame = reinterpret_cast<const float*>(pixels.data());
+        if (simDesc.model == EventModel::LeakyIntegrateFire)
+        {
+            stages.run(
+                "inference",
+                measured,
+                [&]()
+                {
+                    // The network input and output are column-major like the buffers of the Network pass.
+                    for (uint32_t y = 0; y < desc.frameDim.y; ++y)
+                        for (uint32_t x = 0; x < desc.frameDim.x; ++x)
+                            luma[size_t(x) * desc.frameDim.y + y] = getLuma(pixels[size_t(y) * desc.frameDim.x + x]);
+                    if (pNetwork)
+                    {
+                        pNetwork->infer(luma, frame, networkOutput);
+                        return;
+                    }
+                    networkOutput.resize(pixelCount);
+                    for (size_t i = 0; i < pixelCount; ++i)
+                    {
+                        const float logLuma = std::log(luma[i] + 1e-3f);
+                        networkOutput[i] = frame > 0 ? std::abs(logLuma - lastLogLuma[i]) : 0.f;
+                        lastLogLuma[i] = logLuma;
+                    }
+                }
+            );
+            pFrame = networkOutput.data();
+        }
+
+        events.clear();
+        stages.run("events", measured, [&]() { simulator.simulate(pFrame, frame, events); });
+        if (!measured)
+            continue;
+        eventCount += events.size();
+
+        stages.run(
+            "encode",
+            measured,
+            [&]()
+            {
+                encoded.clear();
+                if (variant == kCompress)
+                {
+                    addresses.resize(events.size());
+                    for (size_t i = 0; i < events.size(); ++i)
+                        addresses[i] = events[i].y;
+                    codec.encodeAddress32(addresses.data(), addresses.size(), frame, encoded);
+                }
+                else
+                    codec.encodeFrameAddress64(events.data(), events.size(), encoded);
+            }
+        );
+        stages.run("write", measured, [&]() { writer.appendChunk(frame, frame, uint32_t(events.size()), encoded.data(), encoded.size()); });
+    }
+    stages.run("write", true, [&]() { writer.close(); });
+
+    return createVariantReport(desc, stages, eventCount, writer.getBytesWritten());
+}
+
+json runBlockStorageVariant(const PipelineBenchDesc& desc)
+{
+    const size_t pixelCount = size_t(desc.frameDim.x) * desc.frameDim.y;
+    BlockArchiveDesc archiveDesc;
+    archiveDesc.frameDim = desc.frameDim;
+    archiveDesc.blockSize = kBlockSize;
+    archiveDesc.format = BlockFormat::Luma32Float;
+    archiveDesc.bytesPerPixel = getBlockFormatBytesPerPixel(archiveDesc.format);
+
+    std::filesystem::create_directories(desc.directory / kBlockStorage);
+    BlockArchiveWriter writer(desc.directory / kBlockStorage / "blocks.fba", archiveDesc);
+
+    StageTimes stages;
+    std::vector<float4> pixels;
+    std::vector<float> batch(pixelCount * kBlockSize.z);
+    std::vector<float> block(archiveDesc.getBlockByteSize() / sizeof(float));
+    std::vector<uint8_t> scratch;
+    const uint2 blockCount = archiveDesc.getBlockCount();
+
+    // Write the frames of the batch, block by block.
+    auto writeBatch = [&](uint32_t bz, uint32_t frameCount)
+    {
+        writer.beginBatch(bz, frameCount);
+        for (uint32_t by = 0; by < blockCount.y; ++by)
+        {
+            for (uint32_t bx = 0; bx < blockCount.x; ++bx)
+            {
+                stages.run(
+                    "transpose",
+                    true,
+                    [&]()
+                    {
+                        // Pixels outside of the frame and frames past the end of the batch are zero.
+                        std::fill(block.begin(), block.end(), 0.f);
+                        const uint32_t width = std::min(kBlockSize.x, desc.frameDim.x - bx * kBlockSize.x);
+                        const uint32_t height = std::min(kBlockSize.y, desc.frameDim.y - by * kBlockSize.y);
+                        for (uint32_t z = 0; z < frameCount; ++z)
+                        {
+                            for (uint32_t y = 0; y < height; ++y)
+                            {
+                                const float* pSrc =
+                                    batch.data() + z * pixelCount + size_t(by * kBlockSize.y + y) * desc.frameDim.x + bx * kBlockSize.x;
+                                std::memcpy(block.data() + (size_t(z) * kBlockSize.y + y) * kBlockSize.x, pSrc, width * sizeof(float));
+                            }
+                        }
+                    }
+                );
+                EncodedBlock encodedBlock;
+                stages.run(
+                    "encode",
+                    true,
+                    [&]()
+                    {
+                        encodedBlock = encodeBlock(
+                            block.data(), block.size() * sizeof(float), archiveDesc.bytesPerPixel, BlockCompression::LZ4, true, scratch
+                        );
+                    }
+                );
+                stages.run("write", true, [&]() { writer.writeBlock(bx, by, encodedBlock.codec, encodedBlock.pData, encodedBlock.size); });
+            }
+        }
+        stages.run("write", true, [&]() { writer.endBatch(); });
+    };
+
+    // The pass has no state, warm-up frames are only rendered.
+    uint32_t batchFrame = 0;
+    uint32_t bz = 0;
+    for (uint32_t frame = 0; frame < desc.warmupCount + desc.frameCount; ++frame)
+    {
+        const bool measured = frame >= desc.warmupCount;
+        stages.run("render", measured, [&]() { renderSyntheticFrame(desc.frameDim, frame, pixels); });
+        if (!measured)
+            continue;
+
+        stages.run(
+            "store",
+            true,
+            [&]()
+            {
+                float* pDst = batch.data() + batchFrame * pixelCount;
+                for (size_t i = 0; i < pixelCount; ++i)
+                    pDst[i] = getLuma(pixels[i]);
+            }
+        );
+        if (++batchFrame == kBlockSize.z)
+        {
+            writeBatch(bz++, batchFrame);
+            batchFrame = 0;
+        }
+    }
+    if (batchFrame > 0)
+        writeBatch(bz, batchFrame);
+    stages.run("write", true, [&]() { writer.close(); });
+
+    return createVariantReport(desc, stages, 0, writer.getBytesWritten());
+}
+} // namespace
+
+const std::vector<std::string>& getPipelineVariants()
+{
+    static const std::vector<std::string> kVariants = {kCompress, kDenoise, kNetwork, kBlockStorage};
+    return kVariants;
+}
+
+json runPipelineBenchmark(const PipelineBenchDesc& desc)
+{
+    const auto& variants = desc.variants.empty() ? getPipelineVariants() : desc.variants;
+    for (const auto& variant : variants)
+    {
+        const auto& known = getPipelineVariants();
+        FALCOR_CHECK(std::find(known.begin(), known.end(), variant) != known.end(), "Unknown pipeline variant '{}'.", variant);
+    }
+
+    json report;
+    report["mode"] = "cpu";
+    report["scene"] = "synthetic";
+    report["width"] = desc.frameDim.x;
+    report["height"] = desc.frameDim.y;
+    report["frames"] = desc.frameCount;
+    report["warmup"] = desc.warmupCount;
+    report["variants"] = json::object();
+    for (const auto& variant : variants)
+        report["variants"][variant] = variant == kBlockStorage ? runBlockStorageVariant(desc) : runEventVariant(desc, variant);
+    return report;
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * CPU mode of the event pipeline benchmark, for machines without a GPU.
+ *
+ * Renders a fixed synthetic animation on the CPU, a stand-in for scripts/BenchmarkScene.pyscene, and runs it through
+ * the CPU counterparts of the event graph variants:
+ *  - Compress: ratio threshold events (EventModel::RatioThreshold), compact Address32 event stream.
+ *  - Denoise: log threshold events (EventModel::LogThreshold), compact FrameAddress64 event stream.
+ *  - Network: CPU inference of the luma history (if a model is given) driving leaky integrate-and-fire events,
+ *    compact FrameAddress64 event stream. Without a model, the neurons are driven by the log luma change.
+ *  - BlockStorage: luma frames transposed into blocks, LZ4 compressed and written to a block archive.
+ * The report has the same layout as the one of the GPU mode (scripts/BenchmarkScriptTemplate.py).
+ */
+struct PipelineBenchDesc
+{
+    Falcor::uint2 frameDim = {1280, 720};
+    uint32_t frameCount = 32;              ///< Number of measured frames.
+    uint32_t warmupCount = 4;              ///< Number of frames run before measuring, which are not written.
+    std::vector<std::string> variants;     ///< Variants to run, all if empty.
+    std::filesystem::path directory;       ///< Directory the variants write their output to.
+    std::filesystem::path modelPath;       ///< ONNX model of the Network variant, optional.
+    uint32_t networkInputLength = 43;      ///< Length of the luma history the model is run on.
+    uint32_t batchSize = 64;               ///< Pixels per model input.
+    uint32_t threadCount = 0;              ///< Worker threads of the event models and inference, 0 for all hardware threads.
+};
+
+/// Names of the pipeline variants.
+const std::vector<std::string>& getPipelineVariants();
+
+/**
+ * Run the pipeline benchmark. Throws if a variant is unknown or its output cannot be written.
+ * @return The JSON report.
+ */
+nlohmann::ordered_json runPipelineBenchmark(const PipelineBenchDesc& desc);
@@ -0,0 +1,108 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderPassSchedule.h"
+
+namespace Falcor
+{
+namespace
+{
+// Chain of passes in execution order, each consuming the output of the previous one.
+std::vector<ScheduledPass> createChain(const std::vector<RenderPassSchedule>& schedules)
+{
+    std::vector<ScheduledPass> passes(schedules.size());
+    for (uint32_t i = 0; i < passes.size(); i++)
+    {
+        passes[i].schedule = schedules[i];
+        if (i > 0)
+            passes[i].producers.push_back(i - 1);
+        if (i + 1 < passes.size())
+            passes[i].consumers.push_back(i + 1);
+    }
+    passes.back().hasGraphOutput = true;
+    return passes;
+}
+
+std::vector<uint64_t> getActiveFrames(const std::vector<ScheduledPass>& passes, uint32_t pass, uint64_t frameCount)
+{
+    std::vector<uint64_t> frames;
+    std::vector<bool> active;
+    for (uint64_t frame = 0; frame < frameCount; frame++)
+    {
+        resolveActivePasses(passes, frame, active);
+        if (active[pass])
+            frames.push_back(frame);
+    }
+    return frames;
+}
+} // namespace
+
+CPU_TEST(RenderPassSchedule_Interval)
+{
+    // Path tracer and accumulation every frame, the event pass consumes every 4th accumulated frame.
+    auto passes = createChain({RenderPassSchedule::everyFrame(), RenderPassSchedule::everyFrame(), RenderPassSchedule::every(4, 3)});
+    EXPECT(getActiveFrames(passes, 0, 12) == std::vector<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+    EXPECT(getActiveFrames(passes, 2, 12) == std::vector<uint64_t>({3, 7, 11}));
+
+    EXPECT(RenderPassSchedule::every(4, 3).isValid());
+    EXPECT(!RenderPassSchedule::every(4, 4).isValid());
+    EXPECT(!RenderPassSchedule::every(0).isValid());
+    EXPECT(RenderPassSchedule::every(1).isEveryFrame());
+}
+
+CPU_TEST(RenderPassSchedule_Triggers)
+{
+    // A demand pass feeding only a sub-rate pass, followed by a pass triggered by the sub-rate output.
+    auto passes = createChain(
+        {RenderPassSchedule::everyFrame(),
+         RenderPassSchedule::onDemand(),
+         RenderPassSchedule::every(3, 1),
+         RenderPassSchedule::onInputProduced(),
+         RenderPassSchedule::everyFrame()}
+    );
+    EXPECT(getActiveFrames(passes, 1, 7) == std::vector<uint64_t>({1, 4}));
+    EXPECT(getActiveFrames(passes, 3, 7) == std::vector<uint64_t>({1, 4}));
+    EXPECT_EQ(getActiveFrames(passes, 4, 7).size(), 7);
+
+    // Demand passes with a graph output run every frame.
+    passes[1].hasGraphOutput = true;
+    EXPECT_EQ(getActiveFrames(passes, 1, 7).size(), 7);
+
+    // A demand pass feeding an input-triggered pass runs with it.
+    passes = createChain({RenderPassSchedule::onDemand(), RenderPassSchedule::onInputProduced()});
+    EXPECT_EQ(getActiveFrames(passes, 0, 3).size(), 3);
+    EXPECT_EQ(getActiveFrames(passes, 1, 3).size(), 3);
+}
+
+CPU_TEST(RenderPassSchedule_ToString)
+{
+    EXPECT_EQ(RenderPassSchedule::everyFrame().toString(), "Every frame");
+    EXPECT_EQ(RenderPassSchedule::every(8, 7).toString(), "Every 8 frames, phase 7");
+    EXPECT_EQ(RenderPassSchedule::onDemand().toString(), "Demand");
+}
+} // namespace Falcor
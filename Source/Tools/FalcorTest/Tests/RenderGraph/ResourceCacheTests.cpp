@@ -0,0 +1,74 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/ResourceCache.h"
+
+namespace Falcor
+{
+namespace
+{
+// Check that intervals sharing a slot don't overlap.
+bool isValidAssignment(const std::vector<std::pair<uint32_t, uint32_t>>& intervals, const std::vector<uint32_t>& slots)
+{
+    for (size_t i = 0; i < intervals.size(); i++)
+    {
+        for (size_t j = i + 1; j < intervals.size(); j++)
+        {
+            bool overlap = intervals[i].first <= intervals[j].second && intervals[j].first <= intervals[i].second;
+            if (overlap && slots[i] == slots[j])
+                return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+CPU_TEST(ResourceCache_IntervalSlots)
+{
+    // Chain of passes, each reading the output of the previous one: outputs alternate between two slots.
+    std::vector<std::pair<uint32_t, uint32_t>> chain = {{0, 1}, {1, 2}, {2, 3}, {3, 4}};
+    uint32_t slotCount = 0;
+    auto slots = assignIntervalSlots(chain, slotCount);
+    EXPECT_EQ(slotCount, 2);
+    EXPECT(slots == std::vector<uint32_t>({0, 1, 0, 1}));
+
+    // Intervals sharing an end point overlap.
+    slots = assignIntervalSlots({{0, 2}, {2, 3}}, slotCount);
+    EXPECT_EQ(slotCount, 2);
+
+    // The number of slots is the maximum number of intervals alive at the same time.
+    std::vector<std::pair<uint32_t, uint32_t>> intervals = {{0, 5}, {1, 2}, {3, 4}, {1, 1}, {6, 9}, {2, 7}, {8, 8}, {4, 6}};
+    slots = assignIntervalSlots(intervals, slotCount);
+    EXPECT_EQ(slotCount, 4);
+    EXPECT(isValidAssignment(intervals, slots));
+
+    slots = assignIntervalSlots({}, slotCount);
+    EXPECT_EQ(slotCount, 0);
+    EXPECT(slots.empty());
+}
+} // namespace Falcor
@@ -0,0 +1,149 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/AdaptiveTimeStep.h"
+
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Step through the given activities and return the resulting times.
+std::vector<double> run(AdaptiveTimeStep& step, const std::vector<double>& activities)
+{
+    std::vector<double> times;
+    for (double activity : activities)
+    {
+        times.push_back(step.step());
+        step.reportActivity(activity);
+    }
+    return times;
+}
+} // namespace
+
+CPU_TEST(AdaptiveTimeStep_Bounds)
+{
+    AdaptiveTimeStep::Desc desc;
+    desc.maxSubdivision = 3;
+    desc.maxMerge = 2;
+    AdaptiveTimeStep step(0.1, desc);
+    step.reset(1.0);
+    EXPECT_EQ(step.getLevel(), 0);
+    EXPECT_EQ(step.getPeriod(), 0.1);
+
+    // High activity subdivides down to the finest step.
+    run(step, std::vector<double>(10, 10.0));
+    EXPECT_EQ(step.getLevel(), -3);
+    EXPECT_EQ(step.getPeriod(), 0.1 / 8);
+
+    // Low activity merges up to the coarsest step.
+    run(step, std::vector<double>(20, 0.0));
+    EXPECT_EQ(step.getLevel(), 2);
+    EXPECT_EQ(step.getPeriod(), 0.4);
+
+    // Activity between the thresholds keeps the step.
+    const double time = step.getTime();
+    run(step, std::vector<double>(5, 1.0));
+    EXPECT_EQ(step.getLevel(), 2);
+    EXPECT_EQ(step.getTime(), time + 5 * 0.4);
+
+    step.reset(2.0);
+    EXPECT_EQ(step.getLevel(), 0);
+    EXPECT_EQ(step.getTime(), 2.0);
+}
+
+CPU_TEST(AdaptiveTimeStep_Alignment)
+{
+    AdaptiveTimeStep step(1.0, AdaptiveTimeStep::Desc());
+    step.reset(0.0);
+
+    // Subdivide once, take a single half step, then report low activity.
+    step.step();
+    step.reportActivity(10.0);
+    EXPECT_EQ(step.getTime(), 1.0);
+    step.step();
+    EXPECT_EQ(step.getTime(), 1.5);
+
+    // The step is only doubled again once the time is a multiple of the doubled step.
+    step.reportActivity(0.0);
+    EXPECT_EQ(step.getLevel(), -1);
+    step.step();
+    EXPECT_EQ(step.getTime(), 2.0);
+    step.reportActivity(0.0);
+    EXPECT_EQ(step.getLevel(), 0);
+    step.reportActivity(0.0);
+    EXPECT_EQ(step.getLevel(), 1);
+    step.step();
+    EXPECT_EQ(step.getTime(), 4.0);
+
+    // Random activities keep every time on the grid of the current step.
+    uint32_t state = 1;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        step.reportActivity((state >> 8) * (3.0 / (1 << 24)));
+        const double time = step.step();
+        const double ticks = time / step.getPeriod();
+        EXPECT_EQ(ticks, double(uint64_t(ticks))) << "time " << time << " period " << step.getPeriod();
+    }
+}
+
+CPU_TEST(AdaptiveTimeStep_Determinism)
+{
+    std::vector<double> activities;
+    uint32_t state = 7;
+    for (uint32_t i = 0; i < 500; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        activities.push_back((state >> 8) * (4.0 / (1 << 24)));
+    }
+
+    AdaptiveTimeStep a(1.0 / 60.0, AdaptiveTimeStep::Desc());
+    AdaptiveTimeStep b(1.0 / 60.0, AdaptiveTimeStep::Desc());
+    a.reset(0.5);
+    b.reset(0.5);
+    std::vector<double> timesA = run(a, activities);
+    std::vector<double> timesB = run(b, activities);
+    EXPECT(timesA == timesB);
+    for (size_t i = 1; i < timesA.size(); ++i)
+        EXPECT(timesA[i] > timesA[i - 1]);
+}
+
+CPU_TEST(AdaptiveTimeStep_Invalid)
+{
+    AdaptiveTimeStep::Desc desc;
+    EXPECT_THROW(AdaptiveTimeStep(0.0, desc));
+    desc.maxSubdivision = 20;
+    desc.maxMerge = 12;
+    EXPECT_THROW(AdaptiveTimeStep(1.0, desc));
+    desc = AdaptiveTimeStep::Desc();
+    desc.lowActivity = 2.0;
+    EXPECT_THROW(AdaptiveTimeStep(1.0, desc));
+}
+} // namespace Falcor
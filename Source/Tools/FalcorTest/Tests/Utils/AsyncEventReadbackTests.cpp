@@ -0,0 +1,94 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/AsyncEventReadback.h"
+#include <mutex>
+
+namespace Falcor
+{
+GPU_TEST(AsyncEventReadback)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    const uint32_t kElementCount = 1024;
+    const uint32_t kFrameCount = 8;
+
+    std::mutex mutex;
+    std::vector<uint32_t> frames;
+    std::vector<std::vector<uint32_t>> payloads;
+    auto callback = [&](uint32_t frame, const void* pData, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.push_back(frame);
+        const uint32_t* pElems = static_cast<const uint32_t*>(pData);
+        payloads.emplace_back(pElems, pElems + size / sizeof(uint32_t));
+    };
+
+    {
+        // Use fewer slots than frames to exercise the blocking path.
+        AsyncEventReadback readback(pDevice, sizeof(uint32_t), kElementCount, callback, 3);
+
+        for (uint32_t frame = 0; frame < kFrameCount; frame++)
+        {
+            const ref<Buffer>& pBuffer = readback.beginFrame(pRenderContext);
+
+            // Emulate a shader appending frame + 1 events (frame 3 is skipped).
+            std::vector<uint32_t> data(frame + 1);
+            for (uint32_t i = 0; i < data.size(); i++)
+                data[i] = frame * 100 + i;
+            pBuffer->setBlob(data.data(), 0, data.size() * sizeof(uint32_t));
+            pRenderContext->clearUAVCounter(pBuffer, (uint32_t)data.size());
+
+            if (frame == 3)
+                readback.cancelFrame();
+            else
+                readback.endFrame(pRenderContext, frame);
+        }
+
+        readback.flush(pRenderContext);
+
+        auto stats = readback.getStats();
+        EXPECT_EQ(stats.framesWritten, kFrameCount - 1);
+    }
+
+    // Frames must arrive in submission order with the exact payload.
+    ASSERT_EQ(frames.size(), kFrameCount - 1);
+    size_t index = 0;
+    for (uint32_t frame = 0; frame < kFrameCount; frame++)
+    {
+        if (frame == 3)
+            continue;
+        EXPECT_EQ(frames[index], frame);
+        ASSERT_EQ(payloads[index].size(), frame + 1);
+        for (uint32_t i = 0; i <= frame; i++)
+            EXPECT_EQ(payloads[index][i], frame * 100 + i) << "frame = " << frame << ", i = " << i;
+        index++;
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,214 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "BlockStorageTestUtils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kBatches[] = {0, 2};
+
+/// Block (1, 1) is left out of every batch.
+BlockStorageTestVolume createVolume()
+{
+    BlockStorageTestVolume volume;
+    for (uint32_t bz : kBatches)
+        volume.missingBlocks.push_back({1, 1, bz});
+    return volume;
+}
+
+BlockArchiveDesc createDesc()
+{
+    BlockArchiveDesc desc = createVolume().getDesc();
+    desc.logThreshold = 3.f;
+    return desc;
+}
+
+/// Blocks are compressed, so their payloads have sizes depending on their contents.
+EncodedBlock encodeTestBlock(const std::vector<float>& block, std::vector<uint8_t>& buffer)
+{
+    return encodeBlock(block.data(), block.size() * sizeof(float), 4, BlockCompression::Deflate, false, buffer);
+}
+
+void writeBatch(BlockArchiveWriter& writer, uint32_t bz)
+{
+    const BlockStorageTestVolume volume = createVolume();
+    const uint2 blockCount = writer.getDesc().getBlockCount();
+    std::vector<uint2> coords;
+    for (uint32_t by = 0; by < blockCount.y; ++by)
+        for (uint32_t bx = 0; bx < blockCount.x; ++bx)
+            if (!volume.isMissing({bx, by, bz}))
+                coords.push_back({bx, by});
+    std::shuffle(coords.begin(), coords.end(), std::mt19937(bz));
+
+    // Write blocks concurrently in random order. The last batch is partial.
+    writer.beginBatch(bz, bz == 2 ? 3 : 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&, t]()
+            {
+                std::vector<uint8_t> buffer;
+                for (size_t i = t; i < coords.size(); i += 4)
+                {
+                    const auto block = volume.createBlock({coords[i].x, coords[i].y, bz});
+                    EncodedBlock encoded = encodeTestBlock(block, buffer);
+                    float2 range(float(coords[i].x), float(coords[i].y + bz));
+                    writer.writeBlock(coords[i].x, coords[i].y, encoded.codec, encoded.pData, encoded.size, range);
+                }
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+    writer.endBatch();
+}
+
+void checkArchive(CPUUnitTestContext& ctx, const BlockArchiveReader& reader)
+{
+    const BlockStorageTestVolume volume = createVolume();
+    const BlockArchiveDesc desc = createDesc();
+    EXPECT(all(reader.getDesc().frameDim == desc.frameDim));
+    EXPECT(all(reader.getDesc().blockSize == desc.blockSize));
+    EXPECT(reader.getDesc().format == desc.format);
+    EXPECT_EQ(reader.getDesc().bytesPerPixel, desc.bytesPerPixel);
+    EXPECT_EQ(reader.getDesc().logThreshold, desc.logThreshold);
+    EXPECT(all(reader.getDesc().getBlockCount() == uint2(4, 3)));
+    ASSERT_EQ(reader.getBatchCount(), 3);
+    EXPECT_EQ(reader.getBatchFrameCount(0), 4);
+    EXPECT_EQ(reader.getBatchFrameCount(1), 0);
+    EXPECT_EQ(reader.getBatchFrameCount(2), 3);
+    EXPECT_EQ(reader.getFrameCount(), 11);
+
+    std::vector<uint8_t> buffer;
+    for (uint32_t bz = 0; bz < 4; ++bz)
+    {
+        bool hasBatch = std::find(std::begin(kBatches), std::end(kBatches), bz) != std::end(kBatches);
+        for (uint32_t by = 0; by < 3; ++by)
+        {
+            for (uint32_t bx = 0; bx < 4; ++bx)
+            {
+                const BlockInfo* pInfo = reader.findBlock(bx, by, bz);
+                if (!hasBatch || volume.isMissing({bx, by, bz}))
+                {
+                    EXPECT(pInfo == nullptr) << "block (" << bx << ", " << by << ", " << bz << ")";
+                    continue;
+                }
+                ASSERT(pInfo != nullptr) << "block (" << bx << ", " << by << ", " << bz << ")";
+                EXPECT_EQ(pInfo->bx, bx);
+                EXPECT_EQ(pInfo->by, by);
+                EXPECT_EQ(pInfo->bz, bz);
+                EXPECT_EQ(pInfo->offset % 64, 0);
+                EXPECT(all(pInfo->range == float2(float(bx), float(by + bz))));
+                const auto block = volume.createBlock({bx, by, bz});
+                EncodedBlock encoded = encodeTestBlock(block, buffer);
+                EXPECT(pInfo->codec == encoded.codec);
+                ASSERT_EQ(pInfo->size, encoded.size);
+                EXPECT(volume.matchesBlock(reader, *pInfo)) << "block (" << bx << ", " << by << ", " << bz << ")";
+            }
+        }
+    }
+    EXPECT(reader.findBlock(4, 0, 0) == nullptr);
+    EXPECT(reader.findBlock(0, 3, 0) == nullptr);
+}
+} // namespace
+
+CPU_TEST(BlockArchive_ReadWrite)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_block_archive.fba");
+    {
+        BlockArchiveWriter writer(path, createDesc());
+        for (uint32_t bz : kBatches)
+            writeBatch(writer, bz);
+    }
+
+    {
+        BlockArchiveReader reader(path);
+        ASSERT(reader.isOpen());
+        EXPECT(!reader.wasRecovered());
+        checkArchive(ctx, reader);
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(BlockArchive_Recover)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_block_archive_recover.fba");
+    uint64_t completeSize = 0;
+    {
+        BlockArchiveWriter writer(path, createDesc());
+        for (uint32_t bz : kBatches)
+            writeBatch(writer, bz);
+        completeSize = writer.getBytesWritten();
+
+        // Start another batch that is cut off below.
+        writer.beginBatch(3);
+        auto block = createVolume().createBlock({0, 0, 3});
+        writer.writeBlock(0, 0, BlockCodec::Raw, block.data(), block.size() * sizeof(float));
+    }
+
+    // Simulate an interrupted run by cutting the file in the middle of the last batch.
+    std::filesystem::resize_file(path, completeSize + 80);
+
+    {
+        BlockArchiveReader reader(path);
+        ASSERT(reader.isOpen());
+        EXPECT(reader.wasRecovered());
+        checkArchive(ctx, reader);
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(BlockArchive_Invalid)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_block_archive_invalid.fba");
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        std::vector<char> data(256, 'x');
+        ofs.write(data.data(), data.size());
+    }
+
+    BlockArchiveReader reader;
+    EXPECT(!reader.open(path));
+    EXPECT(!reader.isOpen());
+    EXPECT(!reader.open("__file_that_does_not_exist__"));
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
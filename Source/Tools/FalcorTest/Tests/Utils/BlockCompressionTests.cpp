@@ -0,0 +1,150 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "BlockStorageTestUtils.h"
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kBytesPerPixel = 16;
+const size_t kBlockByteSize = 16 * 16 * 4 * kBytesPerPixel;
+
+/// Smooth RGBA volume of 2x1x3 blocks of 16x16x4 pixels. Blocks with (bx + bz) % 3 == 1 are zero and blocks with
+/// (bx + bz) % 3 == 2 are constant.
+BlockStorageTestVolume createVolume()
+{
+    BlockStorageTestVolume volume;
+    volume.format = BlockFormat::RGBA32Float;
+    volume.dim = {32, 16, 12};
+    volume.blockSize = {16, 16, 4};
+    volume.smooth = true;
+    volume.constantBlocks = {{{1, 0, 0}, 0.f}, {{0, 0, 1}, 0.f}, {{1, 0, 1}, 2.f}, {{0, 0, 2}, 2.f}};
+    return volume;
+}
+
+std::vector<uint8_t> createBlock(uint3 block)
+{
+    const auto values = createVolume().createBlock(block);
+    std::vector<uint8_t> bytes(kBlockByteSize);
+    std::memcpy(bytes.data(), values.data(), kBlockByteSize);
+    return bytes;
+}
+
+std::vector<uint8_t> createNoiseBlock()
+{
+    std::mt19937 rng;
+    std::vector<uint8_t> block(kBlockByteSize);
+    for (auto& b : block)
+        b = uint8_t(rng());
+    return block;
+}
+
+void testRoundTrip(
+    CPUUnitTestContext& ctx,
+    const std::vector<uint8_t>& block,
+    BlockCompression compression,
+    bool elideConstant,
+    BlockCodec expectedCodec
+)
+{
+    std::vector<uint8_t> buffer;
+    EncodedBlock encoded = encodeBlock(block.data(), block.size(), kBytesPerPixel, compression, elideConstant, buffer);
+    EXPECT(encoded.codec == expectedCodec) << "got " << enumToString(encoded.codec) << ", expected " << enumToString(expectedCodec);
+    if (encoded.codec != BlockCodec::Raw)
+        EXPECT_LT(encoded.size, block.size());
+
+    std::vector<uint8_t> decoded(block.size(), 0xcd);
+    decodeBlock(encoded.codec, encoded.pData, encoded.size, decoded.data(), decoded.size(), kBytesPerPixel);
+    EXPECT(decoded == block) << "codec " << enumToString(encoded.codec);
+}
+} // namespace
+
+CPU_TEST(BlockCompression_RoundTrip)
+{
+    const auto smooth = createBlock({0, 0, 0});
+    const auto noise = createNoiseBlock();
+    const auto zero = createBlock({1, 0, 0});
+    const auto constant = createBlock({1, 0, 1});
+
+    testRoundTrip(ctx, smooth, BlockCompression::None, true, BlockCodec::Raw);
+    testRoundTrip(ctx, smooth, BlockCompression::LZ4, true, BlockCodec::LZ4);
+    testRoundTrip(ctx, smooth, BlockCompression::Deflate, true, BlockCodec::Deflate);
+
+    // Incompressible blocks are stored raw.
+    testRoundTrip(ctx, noise, BlockCompression::LZ4, true, BlockCodec::Raw);
+    testRoundTrip(ctx, noise, BlockCompression::Deflate, true, BlockCodec::Raw);
+
+    testRoundTrip(ctx, zero, BlockCompression::None, true, BlockCodec::Zero);
+    testRoundTrip(ctx, constant, BlockCompression::LZ4, true, BlockCodec::Constant);
+    testRoundTrip(ctx, zero, BlockCompression::LZ4, false, BlockCodec::LZ4);
+    testRoundTrip(ctx, constant, BlockCompression::None, false, BlockCodec::Raw);
+}
+
+CPU_TEST(BlockCompression_Corrupt)
+{
+    const auto smooth = createBlock({0, 0, 0});
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> decoded(kBlockByteSize);
+    for (auto compression : {BlockCompression::LZ4, BlockCompression::Deflate})
+    {
+        EncodedBlock encoded = encodeBlock(smooth.data(), smooth.size(), kBytesPerPixel, compression, true, buffer);
+        EXPECT_THROW(decodeBlock(encoded.codec, encoded.pData, encoded.size / 2, decoded.data(), decoded.size(), kBytesPerPixel));
+    }
+}
+
+CPU_TEST(BlockCompression_Archive)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_block_compression.fba");
+    const BlockStorageTestVolume volume = createVolume();
+    volume.writeArchive(path, [](uint3) { return BlockCompression::LZ4; });
+
+    {
+        BlockArchiveReader reader(path);
+        ASSERT(reader.isOpen());
+        const BlockCodec codecs[] = {BlockCodec::LZ4, BlockCodec::Zero, BlockCodec::Constant};
+        for (uint32_t bz = 0; bz < 3; ++bz)
+        {
+            for (uint32_t bx = 0; bx < 2; ++bx)
+            {
+                const BlockInfo* pInfo = reader.findBlock(bx, 0, bz);
+                ASSERT(pInfo != nullptr);
+                EXPECT(pInfo->codec == codecs[(bx + bz) % 3]);
+                EXPECT(volume.matchesBlock(reader, *pInfo)) << "block (" << bx << ", 0, " << bz << ")";
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
@@ -0,0 +1,176 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "BlockStorageTestUtils.h"
+
+#include <cmath>
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Block (1, 1, 1) is missing, block (2, 0, 0) is constant.
+BlockStorageTestVolume createVolume(BlockFormat format = BlockFormat::Luma32Float)
+{
+    BlockStorageTestVolume volume;
+    volume.format = format;
+    volume.missingBlocks = {{1, 1, 1}};
+    volume.constantBlocks = {{{2, 0, 0}, 5.f}};
+    return volume;
+}
+
+void checkQueries(CPUUnitTestContext& ctx, const BlockStorageReader& reader, uint32_t frameCount)
+{
+    const BlockStorageTestVolume volume = createVolume();
+    const uint3 dim = volume.dim;
+    ASSERT_EQ(reader.getChannelCount(), 1);
+    ASSERT(all(reader.getDim() == uint3(dim.xy(), frameCount)));
+
+    // Whole volume and a box crossing block boundaries.
+    EXPECT_EQ(volume.countMismatches(reader, {0, 0, 0}, reader.getDim()), 0);
+    EXPECT_EQ(volume.countMismatches(reader, {30, 20, 3}, {40, 30, 6}), 0);
+
+    float voxel = 0.f;
+    reader.readVoxel(99, 69, 10, &voxel);
+    EXPECT_EQ(voxel, volume.getValue(99, 69, 10));
+
+    std::vector<float> slice(size_t(dim.x) * dim.y);
+    reader.readSlice(5, slice.data());
+    EXPECT_EQ(slice[40 * dim.x + 40], 0.f);
+    EXPECT_EQ(slice[69 * dim.x + 99], volume.getValue(99, 69, 5));
+
+    std::vector<float> column(dim.z);
+    reader.readColumn(70, 10, 0, dim.z, column.data());
+    for (uint32_t z = 0; z < dim.z; ++z)
+        EXPECT_EQ(column[z], volume.getValue(70, 10, z)) << "z = " << z;
+
+    const std::vector<uint2> pixels = {{99, 0}, {0, 0}, {40, 40}, {1, 1}, {70, 10}, {33, 69}};
+    std::vector<float> columns(pixels.size() * 8);
+    reader.readColumns(pixels.data(), pixels.size(), 2, 8, columns.data());
+    for (size_t i = 0; i < pixels.size(); ++i)
+        for (uint32_t z = 0; z < 8; ++z)
+            EXPECT_EQ(columns[i * 8 + z], volume.getValue(pixels[i].x, pixels[i].y, 2 + z)) << "pixel " << i << ", z = " << z;
+
+    std::vector<float> box(11);
+    EXPECT_THROW(reader.readBox({90, 0, 0}, {11, 1, 1}, box.data()));
+    EXPECT_THROW(reader.readColumn(0, 0, 8, frameCount, column.data()));
+}
+} // namespace
+
+CPU_TEST(BlockStorageReader_Archive)
+{
+    // Every other block is compressed, the constant block is elided.
+    const std::filesystem::path path = std::filesystem::absolute("test_block_storage_reader.fba");
+    createVolume().writeArchive(
+        path, [](uint3 block) { return (block.x + block.y) % 2 ? BlockCompression::Deflate : BlockCompression::None; }
+    );
+
+    {
+        ref<BlockStorageReader> pReader = BlockStorageReader::create(path);
+        EXPECT(pReader->isArchive());
+        ASSERT(all(pReader->getBlockCount() == uint3(4, 3, 3)));
+        EXPECT(pReader->getBlock(1, 1, 1) == nullptr);
+
+        // Uncompressed blocks are views of the mapped archive and hold no memory.
+        auto pBlock = pReader->getBlock(0, 0, 0);
+        ASSERT(pBlock != nullptr);
+        EXPECT_EQ(pBlock->byteSize, 0);
+        EXPECT(pBlock->storage.empty());
+        pBlock = pReader->getBlock(2, 0, 0);
+        ASSERT(pBlock != nullptr);
+        EXPECT_EQ(pBlock->byteSize, 32 * 32 * 4 * sizeof(float));
+
+        checkQueries(ctx, *pReader, createVolume().dim.z);
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(BlockStorageReader_Files)
+{
+    const std::filesystem::path directory = std::filesystem::absolute("test_block_storage_reader");
+    const BlockStorageTestVolume volume = createVolume();
+    const BlockArchiveDesc desc = volume.getDesc();
+    volume.writeFiles(directory);
+
+    {
+        // The budget only fits two mapped blocks, queries over the volume evict blocks.
+        const size_t budget = 2 * desc.getBlockByteSize();
+        ref<BlockStorageReader> pReader = BlockStorageReader::create(directory, desc, budget);
+        EXPECT(!pReader->isArchive());
+        checkQueries(ctx, *pReader, 12);
+
+        BlockStorageReader::Stats stats = pReader->getStats();
+        EXPECT_LE(stats.cachedBytes, budget);
+        EXPECT_LE(stats.cachedBlocks, 2);
+        EXPECT_GT(stats.evictions, 0);
+
+        pReader->setCacheBudget(BlockStorageReader::kDefaultCacheBudget);
+        pReader->getBlock(0, 0, 0);
+        pReader->getBlock(0, 0, 0);
+        stats = pReader->getStats();
+        EXPECT_GT(stats.hits, 0);
+        pReader->clearCache();
+        EXPECT_EQ(pReader->getStats().cachedBlocks, 0);
+        EXPECT_EQ(pReader->getStats().cachedBytes, 0);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(BlockStorageReader_Quantized)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_block_storage_reader_quantized.fba");
+    const BlockArchiveDesc desc = createVolume(BlockFormat::LogLuma8).getDesc();
+    {
+        BlockArchiveWriter writer(path, desc);
+        writer.beginBatch(0);
+        std::vector<uint8_t> codes(desc.getBlockByteSize());
+        for (size_t i = 0; i < codes.size(); ++i)
+            codes[i] = uint8_t(i);
+        writer.writeBlock(0, 0, BlockCodec::Raw, codes.data(), codes.size(), float2(-1.f, 4.f));
+        writer.endBatch();
+    }
+
+    {
+        ref<BlockStorageReader> pReader = BlockStorageReader::create(path);
+        auto pBlock = pReader->getBlock(0, 0, 0);
+        ASSERT(pBlock != nullptr);
+        for (size_t i = 0; i < desc.getBlockByteSize(); ++i)
+            EXPECT_LT(std::abs(pBlock->pData[i] - (-1.f + 5.f * (i % 256) / 255.f)), 1e-5f) << "i = " << i;
+
+        float voxel = -1.f;
+        pReader->readVoxel(50, 50, 2, &voxel);
+        EXPECT_EQ(voxel, 0.f);
+    }
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
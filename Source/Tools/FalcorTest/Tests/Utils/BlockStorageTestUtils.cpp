@@ -0,0 +1,157 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlockStorageTestUtils.h"
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace Falcor
+{
+BlockArchiveDesc BlockStorageTestVolume::getDesc() const
+{
+    BlockArchiveDesc desc;
+    desc.frameDim = dim.xy();
+    desc.blockSize = blockSize;
+    desc.format = format;
+    desc.bytesPerPixel = getBlockFormatBytesPerPixel(format);
+    return desc;
+}
+
+bool BlockStorageTestVolume::isMissing(uint3 block) const
+{
+    return std::any_of(missingBlocks.begin(), missingBlocks.end(), [&](uint3 b) { return all(b == block); });
+}
+
+float BlockStorageTestVolume::getValue(uint32_t x, uint32_t y, uint32_t z, uint32_t c) const
+{
+    if (x >= dim.x || y >= dim.y || z >= dim.z)
+        return 0.f;
+    const uint3 block = uint3(x, y, z) / blockSize;
+    if (isMissing(block))
+        return 0.f;
+    for (const auto& constant : constantBlocks)
+        if (all(constant.block == block))
+            return constant.value;
+    if (smooth)
+        return 0.25f * float(x % 16 + c);
+    return float(x + 1000 * y + 100000 * z) + 0.25f * c;
+}
+
+std::vector<float> BlockStorageTestVolume::createBlock(uint3 block) const
+{
+    FALCOR_CHECK(
+        format == BlockFormat::RGBA32Float || format == BlockFormat::Luma32Float, "Test volumes only generate 32-bit float blocks."
+    );
+    const uint32_t C = getChannelCount();
+    std::vector<float> values(size_t(blockSize.x) * blockSize.y * blockSize.z * C);
+    for (uint32_t z = 0; z < blockSize.z; ++z)
+    {
+        for (uint32_t y = 0; y < blockSize.y; ++y)
+        {
+            for (uint32_t x = 0; x < blockSize.x; ++x)
+            {
+                const uint3 p = block * blockSize + uint3(x, y, z);
+                for (uint32_t c = 0; c < C; ++c)
+                    values[((size_t(z) * blockSize.y + y) * blockSize.x + x) * C + c] = getValue(p.x, p.y, p.z, c);
+            }
+        }
+    }
+    return values;
+}
+
+void BlockStorageTestVolume::writeArchive(const std::filesystem::path& path, const std::function<BlockCompression(uint3)>& getCompression)
+    const
+{
+    const BlockArchiveDesc desc = getDesc();
+    const uint3 blockCount = getBlockCount();
+    BlockArchiveWriter writer(path, desc);
+    std::vector<uint8_t> buffer;
+    for (uint32_t bz = 0; bz < blockCount.z; ++bz)
+    {
+        writer.beginBatch(bz, std::min(blockSize.z, dim.z - bz * blockSize.z));
+        for (uint32_t by = 0; by < blockCount.y; ++by)
+        {
+            for (uint32_t bx = 0; bx < blockCount.x; ++bx)
+            {
+                if (isMissing({bx, by, bz}))
+                    continue;
+                const auto block = createBlock({bx, by, bz});
+                const BlockCompression compression = getCompression ? getCompression({bx, by, bz}) : BlockCompression::None;
+                EncodedBlock encoded =
+                    encodeBlock(block.data(), block.size() * sizeof(float), desc.bytesPerPixel, compression, true, buffer);
+                writer.writeBlock(bx, by, encoded.codec, encoded.pData, encoded.size);
+            }
+        }
+        writer.endBatch();
+    }
+}
+
+void BlockStorageTestVolume::writeFiles(const std::filesystem::path& directory) const
+{
+    const uint3 blockCount = getBlockCount();
+    std::filesystem::create_directories(directory);
+    for (uint32_t bz = 0; bz < blockCount.z; ++bz)
+    {
+        for (uint32_t by = 0; by < blockCount.y; ++by)
+        {
+            for (uint32_t bx = 0; bx < blockCount.x; ++bx)
+            {
+                if (isMissing({bx, by, bz}))
+                    continue;
+                const auto block = createBlock({bx, by, bz});
+                std::ofstream ofs(directory / fmt::format("block_{}_{}_{}.bin", bx, by, bz), std::ios::binary);
+                ofs.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(float));
+            }
+        }
+    }
+}
+
+bool BlockStorageTestVolume::matchesBlock(const BlockArchiveReader& reader, const BlockInfo& info) const
+{
+    const auto block = createBlock({info.bx, info.by, info.bz});
+    std::vector<float> decoded(block.size(), -1.f);
+    reader.readBlock(info, decoded.data());
+    return decoded == block;
+}
+
+size_t BlockStorageTestVolume::countMismatches(const BlockStorageReader& reader, uint3 origin, uint3 size) const
+{
+    const uint32_t C = getChannelCount();
+    std::vector<float> box(size_t(size.x) * size.y * size.z * C, -1.f);
+    reader.readBox(origin, size, box.data());
+    size_t mismatches = 0;
+    for (uint32_t z = 0; z < size.z; ++z)
+        for (uint32_t y = 0; y < size.y; ++y)
+            for (uint32_t x = 0; x < size.x; ++x)
+                for (uint32_t c = 0; c < C; ++c)
+                    mismatches += box[((size_t(z) * size.y + y) * size.x + x) * C + c] !=
+                                  getValue(origin.x + x, origin.y + y, origin.z + z, c);
+    return mismatches;
+}
+} // namespace Falcor
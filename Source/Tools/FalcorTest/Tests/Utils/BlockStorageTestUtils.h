@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/BlockStorage/BlockArchive.h"
+#include "Utils/BlockStorage/BlockCompression.h"
+#include "Utils/BlockStorage/BlockStorageReader.h"
+#include "Utils/Math/Vector.h"
+
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Synthetic frame volume shared by the block storage tests.
+ *
+ * Channel c of pixel (x, y) in frame z has the value x + 1000 * y + 100000 * z + 0.25 * c, or 0.25 * (x % 16 + c) in
+ * smooth volumes, which LZ4 compresses. All channels of the constant blocks have the value of the block, the missing
+ * blocks are not stored and read as zero. Frames are stored in blocks of blockSize, the last batch is partial if dim.z
+ * is not a multiple of blockSize.z.
+ * The pixels of blocks are only generated for the 32-bit float formats.
+ */
+struct BlockStorageTestVolume
+{
+    struct ConstantBlock
+    {
+        uint3 block;
+        float value;
+    };
+
+    BlockFormat format = BlockFormat::Luma32Float;
+    uint3 dim = {100, 70, 11};
+    uint3 blockSize = {32, 32, 4};
+    bool smooth = false;
+    std::vector<uint3> missingBlocks;
+    std::vector<ConstantBlock> constantBlocks;
+
+    BlockArchiveDesc getDesc() const;
+    uint32_t getChannelCount() const { return format == BlockFormat::RGBA32Float ? 4 : 1; }
+    uint3 getBlockCount() const { return (dim + blockSize - 1u) / blockSize; }
+    bool isMissing(uint3 block) const;
+
+    /// Value of a voxel, zero outside of the volume.
+    float getValue(uint32_t x, uint32_t y, uint32_t z, uint32_t c = 0) const;
+
+    /// Pixels of a block ordered by frame, row, column and channel, with zeros outside of the volume.
+    std::vector<float> createBlock(uint3 block) const;
+
+    /**
+     * Write all blocks except the missing ones to an archive. Blocks with identical pixels are elided.
+     * @param[in] path Archive path.
+     * @param[in] getCompression Compression of a block, blocks are stored uncompressed if empty.
+     */
+    void writeArchive(const std::filesystem::path& path, const std::function<BlockCompression(uint3)>& getCompression = {}) const;
+
+    /// Write all blocks except the missing ones to block files named block_{bx}_{by}_{bz}.bin.
+    void writeFiles(const std::filesystem::path& directory) const;
+
+    /// Decode a block of an archive and compare it to the generated block.
+    bool matchesBlock(const BlockArchiveReader& reader, const BlockInfo& info) const;
+
+    /// Read a box and count the voxels that differ from the volume, treating frames beyond dim.z as zero.
+    size_t countMismatches(const BlockStorageReader& reader, uint3 origin, uint3 size) const;
+};
+} // namespace Falcor
@@ -0,0 +1,323 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Inference/CpuInference.h"
+#include "Utils/Inference/OnnxModel.h"
+#include "Utils/Math/Float16.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Minimal protobuf writer to build ONNX models in memory.
+struct Proto
+{
+    std::string bytes;
+
+    void varint(uint64_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            bytes.push_back(char(value | 0x80));
+        bytes.push_back(char(value));
+    }
+    Proto& integer(uint32_t field, int64_t value)
+    {
+        varint(field << 3);
+        varint(uint64_t(value));
+        return *this;
+    }
+    Proto& message(uint32_t field, const std::string& value)
+    {
+        varint((field << 3) | 2);
+        varint(value.size());
+        bytes += value;
+        return *this;
+    }
+    Proto& message(uint32_t field, const Proto& value) { return message(field, value.bytes); }
+    Proto& floats(uint32_t field, const std::vector<float>& values)
+    {
+        return message(field, std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float)));
+    }
+};
+
+Proto tensor(const std::string& name, const std::vector<int64_t>& shape, const std::vector<float>& data)
+{
+    Proto proto;
+    for (int64_t dim : shape)
+        proto.integer(1, dim);
+    proto.integer(2, 1); // FLOAT
+    proto.floats(4, data);
+    return proto.message(8, name);
+}
+
+Proto int64Tensor(const std::string& name, const std::vector<int64_t>& shape, const std::vector<int64_t>& data)
+{
+    Proto proto;
+    for (int64_t dim : shape)
+        proto.integer(1, dim);
+    proto.integer(2, 7); // INT64
+    for (int64_t value : data)
+        proto.integer(7, value);
+    return proto.message(8, name);
+}
+
+Proto intAttribute(const std::string& name, int64_t value)
+{
+    return Proto().message(1, name).integer(3, value).integer(20, 2);
+}
+
+Proto intsAttribute(const std::string& name, const std::vector<int64_t>& values)
+{
+    Proto proto;
+    proto.message(1, name);
+    for (int64_t value : values)
+        proto.integer(8, value);
+    return proto.integer(20, 7);
+}
+
+Proto node(const std::string& opType, const std::vector<std::string>& inputs, const std::string& output, const std::vector<Proto>& attributes = {})
+{
+    Proto proto;
+    for (const auto& input : inputs)
+        proto.message(1, input);
+    proto.message(2, output).message(3, output).message(4, opType);
+    for (const auto& attribute : attributes)
+        proto.message(5, attribute);
+    return proto;
+}
+
+/// Value info with a dynamic first dimension.
+Proto valueInfo(const std::string& name, const std::vector<int64_t>& shape)
+{
+    Proto dims;
+    dims.message(1, Proto().message(2, "batch"));
+    for (size_t i = 1; i < shape.size(); ++i)
+        dims.message(1, Proto().integer(1, shape[i]));
+    Proto tensorType = Proto().integer(1, 1).message(2, dims);
+    return Proto().message(1, name).message(2, Proto().message(1, tensorType));
+}
+
+std::string model(const Proto& graph)
+{
+    return Proto().integer(1, 8).message(7, graph).message(8, Proto().integer(2, 17)).bytes;
+}
+
+std::vector<float> randomValues(size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float> values(count);
+    for (float& value : values)
+        value = dist(rng);
+    return values;
+}
+
+const uint32_t kLength = 9;
+const uint32_t kChannels = 3;
+const uint32_t kKernel = 3;
+
+/**
+ * Convolutional network like the event models: input [N, 1, L], Conv(1 -> C, padding 1) + Relu, Conv(C -> 1) + a
+ * residual Add, and the center sample gathered to the output [N, 1].
+ */
+std::string createConvModel(const std::vector<float>& weights0, const std::vector<float>& bias0, const std::vector<float>& weights1)
+{
+    Proto graph;
+    graph.message(1, node("Conv", {"input", "w0", "b0"}, "conv0", {intsAttribute("pads", {1, 1}), intsAttribute("kernel_shape", {kKernel})}));
+    graph.message(1, node("Relu", {"conv0"}, "relu0"));
+    graph.message(1, node("Conv", {"relu0", "w1"}, "conv1", {intsAttribute("pads", {1, 1})}));
+    graph.message(1, node("Add", {"conv1", "input"}, "sum"));
+    graph.message(1, node("Gather", {"sum", "center"}, "output", {intAttribute("axis", 2)}));
+    graph.message(5, tensor("w0", {kChannels, 1, kKernel}, weights0));
+    graph.message(5, tensor("b0", {kChannels}, bias0));
+    graph.message(5, tensor("w1", {1, kChannels, kKernel}, weights1));
+    graph.message(5, int64Tensor("center", {}, {kLength / 2}));
+    graph.message(11, valueInfo("input", {-1, 1, kLength}));
+    graph.message(12, valueInfo("output", {-1, 1}));
+    return model(graph);
+}
+
+std::vector<float> referenceConvModel(
+    const std::vector<float>& input,
+    uint32_t batch,
+    const std::vector<float>& weights0,
+    const std::vector<float>& bias0,
+    const std::vector<float>& weights1
+)
+{
+    std::vector<float> output(batch);
+    for (uint32_t n = 0; n < batch; ++n)
+    {
+        const float* pInput = &input[n * kLength];
+        auto sample = [&](const float* pData, int32_t x) { return x >= 0 && x < int32_t(kLength) ? pData[x] : 0.f; };
+        std::vector<float> hidden(kChannels * kLength);
+        for (uint32_t c = 0; c < kChannels; ++c)
+        {
+            for (int32_t x = 0; x < int32_t(kLength); ++x)
+            {
+                float sum = bias0[c];
+                for (int32_t k = 0; k < int32_t(kKernel); ++k)
+                    sum += weights0[c * kKernel + k] * sample(pInput, x + k - 1);
+                hidden[c * kLength + x] = std::max(sum, 0.f);
+            }
+        }
+        const int32_t x = kLength / 2;
+        float sum = 0.f;
+        for (uint32_t c = 0; c < kChannels; ++c)
+            for (int32_t k = 0; k < int32_t(kKernel); ++k)
+                sum += weights1[c * kKernel + k] * sample(&hidden[c * kLength], x + k - 1);
+        output[n] = sum + pInput[x];
+    }
+    return output;
+}
+} // namespace
+
+CPU_TEST(OnnxModel_Parse)
+{
+    std::mt19937 rng(1);
+    const std::string bytes = createConvModel(randomValues(kChannels * kKernel, rng), randomValues(kChannels, rng), randomValues(kChannels * kKernel, rng));
+    OnnxModel onnx(bytes.data(), bytes.size());
+
+    EXPECT_EQ(onnx.getOpsetVersion(), 17);
+    EXPECT_EQ(onnx.getNodes().size(), 5);
+    EXPECT_EQ(onnx.getNodes()[0].opType, "Conv");
+    EXPECT(onnx.getNodes()[0].getInts("pads") == std::vector<int64_t>({1, 1}));
+    EXPECT_EQ(onnx.getNodes()[4].getInt("axis", 0), 2);
+    EXPECT_EQ(onnx.getInitializers().size(), 4);
+    EXPECT(onnx.getInitializers().at("w1").shape == std::vector<int64_t>({1, kChannels, kKernel}));
+    EXPECT_EQ(onnx.getInitializers().at("center").data[0], float(kLength / 2));
+    EXPECT_EQ(onnx.getInputs().size(), 1);
+    EXPECT(onnx.getInputs()[0].shape == std::vector<int64_t>({-1, 1, kLength}));
+    EXPECT_EQ(onnx.getOutputs()[0].name, "output");
+
+    // Truncated models throw.
+    EXPECT_THROW(OnnxModel(bytes.data(), bytes.size() - 5));
+}
+
+CPU_TEST(CpuInference_Conv)
+{
+    std::mt19937 rng(2);
+    const auto weights0 = randomValues(kChannels * kKernel, rng);
+    const auto bias0 = randomValues(kChannels, rng);
+    const auto weights1 = randomValues(kChannels * kKernel, rng);
+    const std::string bytes = createConvModel(weights0, bias0, weights1);
+    const OnnxModel onnx(bytes.data(), bytes.size());
+
+    // The batch dimension is dynamic, so an input shape is required.
+    EXPECT_THROW(CpuInference{onnx});
+
+    const uint32_t batch = 100;
+    CpuInference inference(onnx, {batch, 1, kLength});
+    EXPECT(inference.getOutputShape() == std::vector<int64_t>({batch, 1}));
+    EXPECT_EQ(inference.getInputSize(), batch * kLength);
+    EXPECT_EQ(inference.getOutputSize(), batch);
+
+    // Run two batches in one call.
+    const auto input = randomValues(2 * batch * kLength, rng);
+    std::vector<float> output(2 * batch);
+    inference.infer(input.data(), output.data(), 2);
+    const auto reference = referenceConvModel(input, 2 * batch, weights0, bias0, weights1);
+    for (uint32_t i = 0; i < 2 * batch; ++i)
+        EXPECT_LE(std::abs(output[i] - reference[i]), 1e-5f) << "i = " << i;
+
+    // The result does not depend on the number of threads.
+    CpuInference singleThreaded(onnx, {batch, 1, kLength}, InferencePrecision::Float32, 1);
+    std::vector<float> singleOutput(2 * batch);
+    singleThreaded.infer(input.data(), singleOutput.data(), 2);
+    EXPECT(singleOutput == output);
+}
+
+CPU_TEST(CpuInference_Float16)
+{
+    std::mt19937 rng(3);
+    const auto weights0 = randomValues(kChannels * kKernel, rng);
+    const auto bias0 = randomValues(kChannels, rng);
+    const auto weights1 = randomValues(kChannels * kKernel, rng);
+    const std::string bytes = createConvModel(weights0, bias0, weights1);
+    const OnnxModel onnx(bytes.data(), bytes.size());
+
+    const uint32_t batch = 64;
+    CpuInference inference(onnx, {batch, 1, kLength}, InferencePrecision::Float16);
+    EXPECT(inference.getPrecision() == InferencePrecision::Float16);
+    const auto input = randomValues(batch * kLength, rng);
+    std::vector<float> output(batch);
+    inference.infer(input.data(), output.data());
+
+    const auto reference = referenceConvModel(input, batch, weights0, bias0, weights1);
+    for (uint32_t i = 0; i < batch; ++i)
+    {
+        // Outputs are representable in half precision and close to the full precision result.
+        EXPECT_EQ(output[i], float(math::float16_t(output[i])));
+        EXPECT_LE(std::abs(output[i] - reference[i]), 1e-2f) << "i = " << i;
+    }
+}
+
+CPU_TEST(CpuInference_Elementwise)
+{
+    // One unrolled LIF step: spike = Cast(v >= threshold), v' = v - spike * threshold, with the spikes of the last
+    // neuron written to the first column by ScatterElements, then transposed.
+    Proto graph;
+    graph.message(1, node("Mul", {"input", "scale"}, "v"));
+    graph.message(1, node("GreaterOrEqual", {"v", "threshold"}, "fired"));
+    graph.message(1, node("Cast", {"fired"}, "spike", {intAttribute("to", 1)}));
+    graph.message(1, node("Mul", {"spike", "threshold"}, "reset"));
+    graph.message(1, node("Sub", {"v", "reset"}, "state"));
+    graph.message(1, node("Gather", {"spike", "last"}, "lastSpike", {intAttribute("axis", 1)}));
+    graph.message(1, node("ScatterElements", {"state", "first", "lastSpike"}, "scattered", {intAttribute("axis", 1)}));
+    graph.message(1, node("Transpose", {"scattered"}, "output", {intsAttribute("perm", {1, 0})}));
+    graph.message(5, tensor("scale", {3}, {1.f, 2.f, 3.f}));
+    graph.message(5, tensor("threshold", {}, {1.f}));
+    graph.message(5, int64Tensor("last", {1}, {2}));
+    graph.message(5, int64Tensor("first", {2, 1}, {0, 0}));
+    graph.message(11, valueInfo("input", {-1, 3}));
+    graph.message(12, valueInfo("output", {3, -1}));
+    const std::string bytes = model(graph);
+    const OnnxModel onnx(bytes.data(), bytes.size());
+
+    CpuInference inference(onnx, {2, 3});
+    EXPECT(inference.getOutputShape() == std::vector<int64_t>({3, 2}));
+    const std::vector<float> input = {0.25f, 0.25f, 0.5f, 0.75f, 0.5f, 0.f};
+    std::vector<float> output(6);
+    inference.infer(input.data(), output.data());
+
+    // v = [[0.25, 0.5, 1.5], [0.75, 1, 0]], spikes = [[0, 0, 1], [0, 1, 0]], state = [[0.25, 0.5, 0.5], [0.75, 0, 0]].
+    const std::vector<float> expected = {1.f, 0.f, 0.5f, 0.f, 0.5f, 0.f};
+    EXPECT(output == expected);
+}
+
+CPU_TEST(CpuInference_Unsupported)
+{
+    Proto graph;
+    graph.message(1, node("Erf", {"input"}, "output"));
+    graph.message(11, valueInfo("input", {-1, 4}));
+    graph.message(12, valueInfo("output", {-1, 4}));
+    const std::string bytes = model(graph);
+    const OnnxModel onnx(bytes.data(), bytes.size());
+    EXPECT_THROW(CpuInference(onnx, {1, 4}));
+}
+} // namespace Falcor
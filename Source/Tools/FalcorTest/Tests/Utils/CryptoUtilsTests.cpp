@@ -58,5 +58,11 @@ CPU_TEST(SHA1)
         SHA1::MD md{0xcd, 0x36, 0xb3, 0x70, 0x75, 0x8a, 0x25, 0x9b, 0x34, 0x84, 0x50, 0x84, 0xa6, 0xcc, 0x38, 0x47, 0x3c, 0xb9, 0x5e, 0x27};
         EXPECT(SHA1::compute(str.data(), str.size()) == md);
     }
+
+    {
+        // Bytes below 0x10 keep their leading zero.
+        std::string str{"Hello World!"};
+        EXPECT_EQ(SHA1::toString(SHA1::compute(str.data(), str.size())), "2ef7bde608ce5404e97d5f042f95f89f1c232871");
+    }
 }
 } // namespace Falcor
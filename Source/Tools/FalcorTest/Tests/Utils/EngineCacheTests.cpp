@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Inference/EngineCache.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const std::vector<uint8_t> kModel = {0x08, 0x07, 0x12, 0x04, 't', 'e', 's', 't'};
+
+EngineCache::Params getParams(uint32_t batchSize)
+{
+    return {{"batchSize", std::to_string(batchSize)}, {"precision", "fp16"}, {"version", "10.0.0"}};
+}
+} // namespace
+
+CPU_TEST(EngineCache_Key)
+{
+    const std::string key = EngineCache::computeKey(kModel.data(), kModel.size(), getParams(4096));
+    EXPECT_EQ(key.size(), 40);
+    EXPECT_EQ(key, EngineCache::computeKey(kModel.data(), kModel.size(), getParams(4096)));
+
+    // Any change of the model or a build parameter changes the key.
+    EXPECT_NE(key, EngineCache::computeKey(kModel.data(), kModel.size(), getParams(2048)));
+    EXPECT_NE(key, EngineCache::computeKey(kModel.data(), kModel.size() - 1, getParams(4096)));
+    EngineCache::Params params = getParams(4096);
+    params["precision"] = "fp32";
+    EXPECT_NE(key, EngineCache::computeKey(kModel.data(), kModel.size(), params));
+
+    // Parameter boundaries are part of the key.
+    EXPECT_NE(
+        EngineCache::computeKey(kModel.data(), kModel.size(), {{"a", "bc"}}),
+        EngineCache::computeKey(kModel.data(), kModel.size(), {{"ab", "c"}})
+    );
+}
+
+CPU_TEST(EngineCache_GetOrBuild)
+{
+    const std::filesystem::path directory = std::filesystem::absolute("test_engine_cache");
+    std::filesystem::remove_all(directory);
+    EngineCache cache(directory);
+    const std::string key = EngineCache::computeKey(kModel.data(), kModel.size(), getParams(4096));
+    EXPECT(!cache.load(key));
+
+    uint32_t buildCount = 0;
+    auto build = [&]()
+    {
+        ++buildCount;
+        return std::vector<uint8_t>{1, 2, 3, 4, 5};
+    };
+
+    // The first call builds and stores the engine, later calls load it.
+    bool built = false;
+    EXPECT(cache.getOrBuild(key, build, &built) == std::vector<uint8_t>({1, 2, 3, 4, 5}));
+    EXPECT(built);
+    EXPECT(std::filesystem::exists(cache.getPath(key)));
+    EXPECT(cache.getOrBuild(key, build, &built) == std::vector<uint8_t>({1, 2, 3, 4, 5}));
+    EXPECT(!built);
+    EXPECT(EngineCache(directory).getOrBuild(key, build) == std::vector<uint8_t>({1, 2, 3, 4, 5}));
+    EXPECT_EQ(buildCount, 1);
+
+    // An engine that is removed, e.g. because it failed to deserialize, is rebuilt.
+    cache.remove(key);
+    EXPECT(cache.getOrBuild(key, build, &built) == std::vector<uint8_t>({1, 2, 3, 4, 5}));
+    EXPECT(built);
+    EXPECT_EQ(buildCount, 2);
+
+    // Empty files are ignored, failed builds store nothing.
+    const std::string otherKey = EngineCache::computeKey(kModel.data(), kModel.size(), getParams(2048));
+    std::ofstream(cache.getPath(otherKey), std::ios::binary).close();
+    EXPECT(!cache.load(otherKey));
+    EXPECT_THROW(cache.getOrBuild(otherKey, []() -> std::vector<uint8_t> { throw RuntimeError("Build failed."); }));
+    EXPECT(!cache.load(otherKey));
+
+    std::filesystem::remove_all(directory);
+}
+} // namespace Falcor
@@ -0,0 +1,159 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/EventCheckpoint.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kPath = std::filesystem::absolute("test_checkpoint.bin");
+} // namespace
+
+CPU_TEST(EventCheckpoint_SaveLoad)
+{
+    EventCheckpoint checkpoint("Network", 42);
+    const std::vector<uint8_t> data = {1, 2, 3, 4, 5};
+    checkpoint.setData("data", data.data(), data.size());
+    checkpoint.setData("empty", nullptr, 0);
+    checkpoint.setValue("head", 7u);
+    checkpoint.setValue("time", 0.25);
+    checkpoint.save(kPath);
+    EXPECT(!std::filesystem::exists(kPath.string() + ".tmp"));
+
+    EventCheckpoint loaded = EventCheckpoint::load(kPath, "Network");
+    EXPECT_EQ(loaded.getPassType(), "Network");
+    EXPECT_EQ(loaded.getFrame(), 42);
+    EXPECT(loaded.getData("data") == data);
+    EXPECT(loaded.getData("empty").empty());
+    EXPECT_EQ(loaded.getValue<uint32_t>("head"), 7);
+    EXPECT_EQ(loaded.getValue<double>("time"), 0.25);
+    EXPECT(!loaded.hasSection("missing"));
+
+    // Missing sections, values of another size and checkpoints of other passes throw.
+    EXPECT_THROW(loaded.getData("missing"));
+    EXPECT_THROW(loaded.getValue<uint64_t>("head"));
+    EXPECT_THROW(EventCheckpoint::load(kPath, "DenoisePass"));
+
+    std::filesystem::remove(kPath);
+}
+
+CPU_TEST(EventCheckpoint_Invalid)
+{
+    EXPECT_THROW(EventCheckpoint::load(kPath, "Network"));
+
+    EventCheckpoint checkpoint("Network", 1);
+    const std::vector<uint8_t> data(100, 3);
+    checkpoint.setData("data", data.data(), data.size());
+    checkpoint.save(kPath);
+
+    // Truncated files throw.
+    std::filesystem::resize_file(kPath, std::filesystem::file_size(kPath) - 10);
+    EXPECT_THROW(EventCheckpoint::load(kPath, "Network"));
+
+    // Files of other types throw.
+    {
+        std::ofstream file(kPath, std::ios::binary | std::ios::trunc);
+        file << "not a checkpoint file";
+    }
+    EXPECT_THROW(EventCheckpoint::load(kPath, "Network"));
+
+    std::filesystem::remove(kPath);
+}
+
+CPU_TEST(EventShardDesc_Frames)
+{
+    EventShardDesc shard;
+    EXPECT(shard.isWritten(1));
+    EXPECT(!shard.isCheckpointFrame(1));
+
+    shard.beginFrame = 100;
+    shard.endFrame = 200;
+    shard.saveCheckpoint = "checkpoint.bin";
+    EXPECT(!shard.isWritten(99));
+    EXPECT(shard.isWritten(100));
+    EXPECT(shard.isWritten(199));
+    EXPECT(!shard.isWritten(200));
+
+    // The checkpoint is saved after the last frame of the shard, unless another frame is given.
+    EXPECT(shard.isCheckpointFrame(199));
+    EXPECT(!shard.isCheckpointFrame(200));
+    shard.checkpointFrame = 150;
+    EXPECT(shard.isCheckpointFrame(150));
+    EXPECT(!shard.isCheckpointFrame(199));
+}
+
+GPU_TEST(EventCheckpoint_Resources)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    const uint32_t width = 13, height = 7, arraySize = 3;
+    std::vector<float> texels(width * height * arraySize);
+    for (size_t i = 0; i < texels.size(); ++i)
+        texels[i] = float(i) * 0.5f;
+    std::vector<uint32_t> elements(100);
+    for (size_t i = 0; i < elements.size(); ++i)
+        elements[i] = uint32_t(i * i);
+
+    const ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+    ref<Texture> pTexture = pDevice->createTexture2D(width, height, ResourceFormat::R32Float, arraySize, 1, texels.data(), bindFlags);
+    ref<Buffer> pBuffer = pDevice->createBuffer(elements.size() * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal, elements.data());
+
+    EventCheckpoint checkpoint("Test", 3);
+    checkpoint.storeTexture(pRenderContext, "texture", pTexture.get());
+    checkpoint.storeBuffer(pRenderContext, "buffer", pBuffer.get());
+    checkpoint.save(kPath);
+
+    // Restore into new resources.
+    EventCheckpoint loaded = EventCheckpoint::load(kPath, "Test");
+    ref<Texture> pRestoredTexture = pDevice->createTexture2D(width, height, ResourceFormat::R32Float, arraySize, 1, nullptr, bindFlags);
+    ref<Buffer> pRestoredBuffer = pDevice->createBuffer(elements.size() * sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal);
+    loaded.restoreTexture(pRenderContext, "texture", pRestoredTexture.get());
+    loaded.restoreBuffer(pRenderContext, "buffer", pRestoredBuffer.get());
+
+    for (uint32_t slice = 0; slice < arraySize; ++slice)
+    {
+        const std::vector<uint8_t> data = pRenderContext->readTextureSubresource(pRestoredTexture.get(), slice);
+        EXPECT_EQ(data.size(), width * height * sizeof(float));
+        EXPECT_EQ(std::memcmp(data.data(), texels.data() + slice * width * height, data.size()), 0) << "slice = " << slice;
+    }
+    EXPECT(pRestoredBuffer->getElements<uint32_t>() == elements);
+
+    // Resources of another size or format throw.
+    ref<Texture> pSmallTexture = pDevice->createTexture2D(width - 1, height, ResourceFormat::R32Float, arraySize, 1, nullptr, bindFlags);
+    ref<Texture> pUintTexture = pDevice->createTexture2D(width, height, ResourceFormat::R32Uint, arraySize, 1, nullptr, bindFlags);
+    ref<Buffer> pSmallBuffer = pDevice->createBuffer(sizeof(uint32_t), bindFlags, MemoryType::DeviceLocal);
+    EXPECT_THROW(loaded.restoreTexture(pRenderContext, "texture", pSmallTexture.get()));
+    EXPECT_THROW(loaded.restoreTexture(pRenderContext, "texture", pUintTexture.get()));
+    EXPECT_THROW(loaded.restoreBuffer(pRenderContext, "buffer", pSmallBuffer.get()));
+
+    std::filesystem::remove(kPath);
+}
+} // namespace Falcor
@@ -0,0 +1,141 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/EventCodec.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Generate events of one frame with the given pixel density and occasional horizontal runs.
+std::vector<uint32_t> createFrame(std::mt19937& rng, uint32_t pixelCount, float density)
+{
+    std::uniform_real_distribution<float> u;
+    std::vector<uint32_t> addresses;
+    for (uint32_t pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        if (u(rng) >= density)
+            continue;
+        uint32_t polarity = rng() & 1;
+        uint32_t runLength = u(rng) < 0.2f ? rng() % 50 + 1 : 1;
+        for (uint32_t k = 0; k < runLength && pixel < pixelCount; ++k, ++pixel)
+            addresses.push_back(pixel * 2 + polarity);
+    }
+    // The GPU appends events in nearly sorted order.
+    for (size_t i = 0; i + 1 < addresses.size(); i += 7)
+        std::swap(addresses[i], addresses[i + 1]);
+    return addresses;
+}
+} // namespace
+
+CPU_TEST(EventCodec_Address32)
+{
+    std::mt19937 rng;
+    EventCodec codec;
+    for (float density : {0.f, 0.001f, 0.05f, 0.5f, 1.f})
+    {
+        std::vector<uint32_t> addresses = createFrame(rng, 64 * 64, density);
+        std::vector<uint8_t> encoded;
+        codec.encodeAddress32(addresses.data(), addresses.size(), 17, encoded);
+
+        std::vector<uint2> decoded;
+        ASSERT(EventCodec::decode(encoded.data(), encoded.size(), decoded));
+        ASSERT_EQ(decoded.size(), addresses.size());
+
+        std::sort(addresses.begin(), addresses.end());
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            EXPECT_EQ(decoded[i].x, 17) << "density " << density << ", event " << i;
+            EXPECT_EQ(decoded[i].y, addresses[i]) << "density " << density << ", event " << i;
+        }
+        if (addresses.size() > 100)
+            EXPECT_LT(encoded.size(), addresses.size() * 2) << "density " << density;
+    }
+}
+
+CPU_TEST(EventCodec_FrameAddress64)
+{
+    std::mt19937 rng;
+    EventCodec codec;
+
+    // Events from several frames, including duplicated addresses and both polarities at the same pixel.
+    std::vector<uint2> events;
+    for (uint32_t frame : {3u, 1u, 1000u, 4u})
+    {
+        for (uint32_t address : createFrame(rng, 10000, 0.1f))
+            events.push_back({frame, address});
+        events.push_back({frame, 42});
+        events.push_back({frame, 42});
+        events.push_back({frame, 43});
+    }
+    events.push_back({0xffffffffu, 0xffffffffu});
+    std::shuffle(events.begin(), events.end(), rng);
+
+    std::vector<uint8_t> encoded;
+    codec.encodeFrameAddress64(events.data(), events.size(), encoded);
+
+    std::vector<uint2> decoded;
+    ASSERT(EventCodec::decode(encoded.data(), encoded.size(), decoded));
+    ASSERT_EQ(decoded.size(), events.size());
+
+    std::sort(events.begin(), events.end(), [](const uint2& a, const uint2& b) { return a.x != b.x ? a.x < b.x : a.y < b.y; });
+    for (size_t i = 0; i < decoded.size(); ++i)
+    {
+        EXPECT_EQ(decoded[i].x, events[i].x) << "event " << i;
+        EXPECT_EQ(decoded[i].y, events[i].y) << "event " << i;
+    }
+}
+
+CPU_TEST(EventCodec_Malformed)
+{
+    std::vector<uint2> decoded;
+    EXPECT(EventCodec::decode(nullptr, 0, decoded));
+    EXPECT_EQ(decoded.size(), 0);
+
+    // Reserved token kind.
+    const uint8_t reserved[] = {0x02, 0x03};
+    EXPECT(!EventCodec::decode(reserved, sizeof(reserved), decoded));
+
+    // Truncated varint.
+    const uint8_t truncated[] = {0x02, 0x80, 0x80};
+    EXPECT(!EventCodec::decode(truncated, sizeof(truncated), decoded));
+
+    // Varint longer than 64 bits.
+    std::vector<uint8_t> overlong(20, 0xff);
+    overlong.back() = 0x00;
+    EXPECT(!EventCodec::decode(overlong.data(), overlong.size(), decoded));
+
+    // Event token with a pixel delta of 2^31 (v = 2^34), which overflows the 31 bit pixel index.
+    const uint8_t overflow[] = {0x02, 0x80, 0x80, 0x80, 0x80, 0x40};
+    EXPECT(!EventCodec::decode(overflow, sizeof(overflow), decoded));
+}
+} // namespace Falcor
@@ -0,0 +1,129 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/EventCompaction.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kMaxEventsPerPixel = 3;
+
+/// Random event slots where slot i of pixel p holds (p, i), roughly half the pixels have no events.
+void createSlots(uint32_t pixelCount, std::vector<uint2>& slots, std::vector<uint32_t>& counts)
+{
+    std::mt19937 rng(13);
+    slots.assign(size_t(pixelCount) * kMaxEventsPerPixel, uint2(~0u));
+    counts.resize(pixelCount);
+    for (uint32_t pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        counts[pixel] = rng() % 2 ? rng() % (kMaxEventsPerPixel + 1) : 0;
+        for (uint32_t i = 0; i < counts[pixel]; ++i)
+            slots[size_t(pixel) * kMaxEventsPerPixel + i] = uint2(pixel, i);
+    }
+}
+
+std::vector<uint2> compactReference(const std::vector<uint2>& slots, const std::vector<uint32_t>& counts)
+{
+    std::vector<uint2> events;
+    for (uint32_t pixel = 0; pixel < counts.size(); ++pixel)
+        for (uint32_t i = 0; i < counts[pixel]; ++i)
+            events.push_back(slots[size_t(pixel) * kMaxEventsPerPixel + i]);
+    return events;
+}
+} // namespace
+
+CPU_TEST(EventCompaction_CPU)
+{
+    for (uint32_t pixelCount : {1u, 1000u, 1024u, 5000u})
+    {
+        std::vector<uint2> slots;
+        std::vector<uint32_t> counts;
+        createSlots(pixelCount, slots, counts);
+        const std::vector<uint2> expected = compactReference(slots, counts);
+
+        std::vector<uint2> events = {uint2(7, 7)};
+        const size_t count = EventCompaction::compact(slots.data(), counts.data(), pixelCount, kMaxEventsPerPixel, events);
+        ASSERT_EQ(count, expected.size());
+        ASSERT_EQ(events.size(), expected.size() + 1);
+        EXPECT(all(events[0] == uint2(7, 7)));
+        size_t mismatches = 0;
+        for (size_t i = 0; i < expected.size(); ++i)
+            mismatches += any(events[i + 1] != expected[i]);
+        EXPECT_EQ(mismatches, 0) << "pixelCount = " << pixelCount;
+    }
+
+    // Counts are clamped to the number of slots.
+    std::vector<uint2> slots = {uint2(1), uint2(2), uint2(3), uint2(4), uint2(5), uint2(6)};
+    std::vector<uint32_t> counts = {5, 2};
+    std::vector<uint2> events;
+    EXPECT_EQ(EventCompaction::compact(slots.data(), counts.data(), 2, kMaxEventsPerPixel, events), 5);
+}
+
+GPU_TEST(EventCompaction)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    EventCompaction compaction(pDevice, sizeof(uint2));
+    for (uint32_t pixelCount : {1u, 1000u, 1024u, 300000u})
+    {
+        std::vector<uint2> slots;
+        std::vector<uint32_t> counts;
+        createSlots(pixelCount, slots, counts);
+        std::vector<uint2> expected;
+        EventCompaction::compact(slots.data(), counts.data(), pixelCount, kMaxEventsPerPixel, expected);
+
+        compaction.resize(pixelCount, kMaxEventsPerPixel);
+        compaction.getSlotBuffer()->setBlob(slots.data(), 0, slots.size() * sizeof(uint2));
+        compaction.getCountBuffer()->setBlob(counts.data(), 0, counts.size() * sizeof(uint32_t));
+
+        ref<Buffer> pEvents = pDevice->createStructuredBuffer(
+            sizeof(uint2),
+            pixelCount * kMaxEventsPerPixel,
+            ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
+            MemoryType::DeviceLocal,
+            nullptr,
+            true
+        );
+        pRenderContext->clearUAVCounter(pEvents, 0);
+        compaction.execute(pRenderContext, pEvents);
+
+        const uint32_t count = pEvents->getUAVCounter()->getElement<uint32_t>(0);
+        ASSERT_EQ(count, expected.size()) << "pixelCount = " << pixelCount;
+        if (count == 0)
+            continue;
+        const std::vector<uint2> events = pEvents->getElements<uint2>(0, count);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; ++i)
+            mismatches += any(events[i] != expected[i]);
+        EXPECT_EQ(mismatches, 0) << "pixelCount = " << pixelCount;
+    }
+}
+} // namespace Falcor
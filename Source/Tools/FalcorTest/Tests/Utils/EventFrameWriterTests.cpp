@@ -0,0 +1,112 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/EventFrameWriter.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const std::vector<uint2> kEvents = {{3, 1}, {3, 4}, {3, 5}, {3, 9}};
+}
+
+CPU_TEST(EventFrameWriter_Stream)
+{
+    const std::filesystem::path directory = std::filesystem::absolute("test_event_frame_writer");
+    std::filesystem::create_directories(directory);
+
+    for (bool compact : {false, true})
+    {
+        EventFrameWriter writer;
+        EventFrameWriter::Desc desc;
+        desc.directory = directory;
+        desc.compact = compact;
+        writer.open(desc, uint2(16, 8), 0);
+        writer.write(3, 30, kEvents.data(), kEvents.size() * sizeof(uint2));
+        // A resolution change continues in a new stream.
+        writer.open(desc, uint2(32, 8), 5);
+        writer.write(5, 50, kEvents.data(), kEvents.size() * sizeof(uint2));
+        writer.close();
+
+        EventStreamReader reader(directory / "events.evs");
+        ASSERT(reader.isOpen());
+        EXPECT_EQ(reader.getDesc().width, 16);
+        EXPECT(reader.getDesc().encoding == (compact ? EventEncoding::Compact : EventEncoding::FrameAddress64));
+        ASSERT_EQ(reader.getChunkCount(), 1);
+        EXPECT_EQ(reader.getChunks()[0].frame, 3);
+        EXPECT_EQ(reader.getChunks()[0].timestamp, 30);
+        EXPECT_EQ(reader.getChunks()[0].eventCount, kEvents.size());
+
+        std::vector<uint2> events;
+        const auto* pData = reinterpret_cast<const uint8_t*>(reader.getChunkData(0));
+        if (compact)
+            EXPECT(EventCodec::decode(pData, reader.getChunks()[0].size, events));
+        else
+            events.assign(reinterpret_cast<const uint2*>(pData), reinterpret_cast<const uint2*>(pData) + kEvents.size());
+        ASSERT_EQ(events.size(), kEvents.size());
+        for (size_t i = 0; i < kEvents.size(); ++i)
+        {
+            EXPECT_EQ(events[i].x, kEvents[i].x) << "event " << i;
+            EXPECT_EQ(events[i].y, kEvents[i].y) << "event " << i;
+        }
+
+        EventStreamReader continued(directory / "events-5.evs");
+        ASSERT(continued.isOpen());
+        EXPECT_EQ(continued.getDesc().width, 32);
+        EXPECT_EQ(continued.getChunkCount(), 1);
+        EXPECT_EQ(writer.getStoredBytes(), reader.getChunks()[0].size + continued.getChunks()[0].size);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(EventFrameWriter_Files)
+{
+    const std::filesystem::path directory = std::filesystem::absolute("test_event_frame_writer_files");
+    std::filesystem::create_directories(directory);
+
+    EventFrameWriter writer;
+    EventFrameWriter::Desc desc;
+    desc.directory = directory;
+    desc.outputFormat = EventOutputFormat::Files;
+    desc.encoding = EventEncoding::Address32;
+    writer.open(desc, uint2(16, 8), 0);
+    const std::vector<uint32_t> addresses = {2, 7, 11};
+    writer.write(7, 7, addresses.data(), addresses.size() * sizeof(uint32_t));
+
+    // Files hold the raw events, the compact flag only applies to streams.
+    EXPECT(!std::filesystem::exists(directory / "events.evs"));
+    EXPECT_EQ(std::filesystem::file_size(directory / "data-7.bin"), addresses.size() * sizeof(uint32_t));
+    EXPECT_EQ(writer.getStoredBytes(), addresses.size() * sizeof(uint32_t));
+
+    std::filesystem::remove_all(directory);
+}
+} // namespace Falcor
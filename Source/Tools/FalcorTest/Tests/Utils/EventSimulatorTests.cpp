@@ -0,0 +1,694 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/BlockStorage/BlockArchive.h"
+#include "Utils/BlockStorage/BlockStorageReader.h"
+#include "Utils/Events/EventSimulator.h"
+#include "Utils/Math/Float16.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint2 kFrameDim = {37, 23};
+const uint32_t kFrameCount = 40;
+
+/// Frames of a per-pixel random walk in RGB, with a few pixels jumping between dark and bright.
+std::vector<std::vector<float>> createFrames(uint32_t channelCount)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> step(-0.08f, 0.1f);
+    std::vector<float> values(size_t(kFrameDim.x) * kFrameDim.y * 4, 0.5f);
+    std::vector<std::vector<float>> frames;
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = std::max(0.f, values[i] * (1.f + step(rng)));
+        for (size_t pixel = 0; pixel < values.size() / 4; pixel += 11)
+            values[pixel * 4 + 1] = (frame / 5) % 2 ? 2.f : 0.01f;
+
+        std::vector<float> data(size_t(kFrameDim.x) * kFrameDim.y * channelCount);
+        for (size_t pixel = 0; pixel < values.size() / 4; ++pixel)
+            for (uint32_t c = 0; c < channelCount; ++c)
+                data[pixel * channelCount + c] = channelCount == 1 ? values[pixel * 4] * 0.1f - 0.03f : values[pixel * 4 + c];
+        frames.push_back(std::move(data));
+    }
+    return frames;
+}
+
+/// Per-pixel transcriptions of the shaders.
+struct ReferencePixel
+{
+    // ErrorMeasurer.cs.slang
+    float lastEvent = 0.f;
+    float recentSum[5] = {};
+    uint32_t recentCount[5] = {};
+    // Denoise.slang
+    float lastFrames[10][3] = {};
+    float internalState = 0.f;
+    float lastLog = 0.f;
+    // DvsSensor.slangh
+    uint32_t lastEventTime = kDvsNoEvent;
+    // NetworkOutput.cs.slang
+    float v = 0.f;
+
+    void missEvent()
+    {
+        for (int i = 3; i >= 0; --i)
+        {
+            recentSum[i + 1] = recentSum[i];
+            recentCount[i + 1] = recentCount[i];
+        }
+        recentSum[0] = 0.f;
+        recentCount[0] = 0;
+    }
+
+    int ratioThreshold(const EventSimulatorDesc& desc, const float* pSource)
+    {
+        float nowI = 0.299f * pSource[0] + 0.587f * pSource[1] + 0.114f * pSource[2];
+        float preI = lastEvent;
+        for (int i = 0; i < 5; ++i)
+        {
+            recentSum[i] += nowI;
+            recentCount[i]++;
+        }
+        float diff = nowI / preI;
+        bool type;
+        if (diff > desc.ratioThreshold)
+            type = false;
+        else if (diff < 1.0f / desc.ratioThreshold)
+            type = true;
+        else
+        {
+            missEvent();
+            return 0;
+        }
+        bool lastType = recentSum[0] > preI * recentCount[0] ? false : true;
+        if (lastType != type)
+        {
+            missEvent();
+            return 0;
+        }
+        if (recentCount[desc.toleranceEvents] == desc.needAccumulatedEvents)
+        {
+            lastEvent = recentSum[desc.toleranceEvents] / desc.needAccumulatedEvents;
+            for (int i = 0; i < 5; ++i)
+            {
+                recentSum[i] = 0.f;
+                recentCount[i] = 0;
+            }
+            return type ? -1 : 1;
+        }
+        return 0;
+    }
+
+    float filterLogLuminance(const EventSimulatorDesc& desc, const float* pInput, float* pX = nullptr)
+    {
+        for (uint32_t i = 0; i + 1 < desc.window; ++i)
+            for (int c = 0; c < 3; ++c)
+                lastFrames[i][c] = lastFrames[i + 1][c];
+        for (int c = 0; c < 3; ++c)
+            lastFrames[desc.window - 1][c] = pInput[c];
+        float color[3] = {};
+        for (uint32_t i = 0; i < desc.window; ++i)
+            for (int c = 0; c < 3; ++c)
+                color[c] += lastFrames[i][c];
+        for (int c = 0; c < 3; ++c)
+            color[c] /= float(desc.window);
+
+        float x = (0.2126f * color[0] + 0.7152f * color[1] + 0.0722f * color[2]) * 255.f;
+        if (pX)
+            *pX = x;
+        float threshold = 3.f;
+        float f = (1.f / threshold) * std::log(threshold);
+        float y = x <= threshold ? x * f : std::log(x);
+        float rounding = 1e8f;
+        y = std::nearbyint(y * rounding) / rounding;
+        return y;
+    }
+
+    int logThreshold(const EventSimulatorDesc& desc, const float* pInput)
+    {
+        float y = filterLogLuminance(desc, pInput);
+        if (internalState < y - 0.2f)
+        {
+            internalState += 0.2f;
+            return 1;
+        }
+        else if (internalState > y + 0.2f)
+        {
+            internalState -= 0.2f;
+            return -1;
+        }
+        return 0;
+    }
+
+    void logThresholdInterpolated(
+        const EventSimulatorDesc& desc,
+        const float* pInput,
+        uint32_t time,
+        uint32_t prevTime,
+        uint32_t address,
+        std::vector<uint2>& events
+    )
+    {
+        float y = filterLogLuminance(desc, pInput);
+        float yPrev = lastLog;
+        lastLog = y;
+        float dy = y - yPrev;
+        float state = internalState;
+        auto emit = [&](uint32_t polarityBit)
+        {
+            float t = dy != 0.f ? std::clamp((state - yPrev) / dy, 0.f, 1.f) : 0.f;
+            events.push_back({prevTime + uint32_t(std::nearbyint(t * float(time - prevTime))), address * 2 + polarityBit});
+        };
+        uint32_t count = 0;
+        for (; count < desc.maxEventsPerFrame && state < y - 0.2f; ++count)
+        {
+            state += 0.2f;
+            emit(1);
+        }
+        for (; count < desc.maxEventsPerFrame && state > y + 0.2f; ++count)
+        {
+            state -= 0.2f;
+            emit(0);
+        }
+        internalState = state;
+    }
+
+    void sensor(
+        const EventSimulatorDesc& desc,
+        const float4& params,
+        const float* pInput,
+        uint32_t time,
+        uint32_t prevTime,
+        uint32_t frame,
+        uint32_t address,
+        std::vector<uint2>& events
+    )
+    {
+        float x;
+        float y = filterLogLuminance(desc, pInput, &x);
+        if (frame == 0)
+        {
+            lastLog = y;
+            internalState = y;
+            return;
+        }
+        const DvsFrameConstants constants = getDvsFrameConstants(desc.sensor, time - prevTime, desc.ticksPerSecond);
+
+        float yPrev = lastLog;
+        if (constants.lowpassGain > 0.f)
+        {
+            float eps = std::min(1.f, (x + 20.f) / 275.f * constants.lowpassGain);
+            lastLog = (1.f - eps) * lastLog + eps * y;
+        }
+        else
+            lastLog = y;
+        float dy = lastLog - yPrev;
+        internalState -= params.z * constants.dt * params.x;
+
+        auto crossingTime = [&](float level)
+        {
+            float t = dy != 0.f ? std::clamp((level - yPrev) / dy, 0.f, 1.f) : 0.f;
+            return prevTime + uint32_t(std::nearbyint(t * float(time - prevTime)));
+        };
+        uint32_t count = 0;
+        for (; count < desc.maxEventsPerFrame && internalState < lastLog - params.x; ++count)
+        {
+            uint32_t t = crossingTime(internalState + params.x);
+            if (lastEventTime != kDvsNoEvent && t - lastEventTime < constants.refractoryTicks)
+                break;
+            internalState += params.x;
+            lastEventTime = t;
+            events.push_back({t, address * 2 + 1});
+        }
+        for (; count < desc.maxEventsPerFrame && internalState > lastLog + params.y; ++count)
+        {
+            uint32_t t = crossingTime(internalState - params.y);
+            if (lastEventTime != kDvsNoEvent && t - lastEventTime < constants.refractoryTicks)
+                break;
+            internalState -= params.y;
+            lastEventTime = t;
+            events.push_back({t, address * 2});
+        }
+        float u = dvsUniform(desc.sensor.seed, address, frame);
+        bool on = u < constants.shotProbability;
+        bool off = u >= 1.f - constants.shotProbability;
+        if ((on || off) && count < desc.maxEventsPerFrame &&
+            (lastEventTime == kDvsNoEvent || time - lastEventTime >= constants.refractoryTicks))
+        {
+            internalState += on ? params.x : -params.y;
+            lastEventTime = time;
+            events.push_back({time, address * 2 + (on ? 1 : 0)});
+        }
+    }
+
+    int leakyIntegrateFire(const EventSimulatorDesc& desc, float input)
+    {
+        float x = math::float16ToFloat32(math::float32ToFloat16(input));
+        v = v * (1.f - 1.f / desc.tau) + x;
+        float pos_spike = (v >= desc.threshold) ? 1.f : 0.f;
+        float neg_spike = (v <= -desc.threshold) ? 1.f : 0.f;
+        v = v - (pos_spike - neg_spike) * desc.threshold;
+        float output_spike = pos_spike - neg_spike;
+        return output_spike > 0.f ? 1 : (output_spike < 0.f ? -1 : 0);
+    }
+};
+
+std::vector<uint2> simulateReference(const EventSimulatorDesc& desc, const std::vector<std::vector<float>>& frames)
+{
+    std::vector<ReferencePixel> pixels(size_t(kFrameDim.x) * kFrameDim.y);
+    std::vector<uint2> events;
+    for (uint32_t frame = 0; frame < frames.size(); ++frame)
+    {
+        for (uint32_t i = 0; i < pixels.size(); ++i)
+        {
+            const float* pPixel = frames[frame].data() + size_t(i) * desc.channelCount;
+            int polarity = 0;
+            if (desc.model == EventModel::RatioThreshold)
+                polarity = pixels[i].ratioThreshold(desc, pPixel);
+            else if (desc.model == EventModel::LogThreshold)
+                polarity = pixels[i].logThreshold(desc, pPixel);
+            else
+            {
+                // The network output is column-major like the buffer of the Network pass.
+                const uint32_t input = (i % kFrameDim.x) * kFrameDim.y + i / kFrameDim.x;
+                polarity = pixels[i].leakyIntegrateFire(desc, frames[frame][size_t(input) * desc.channelCount]);
+            }
+            if (polarity != 0)
+                events.push_back({frame, i * 2 + (polarity > 0 ? 1 : 0)});
+        }
+    }
+    return events;
+}
+
+void testModel(CPUUnitTestContext& ctx, const EventSimulatorDesc& desc)
+{
+    const auto frames = createFrames(desc.channelCount);
+    const std::vector<uint2> expected = simulateReference(desc, frames);
+    EXPECT_GT(expected.size(), 100);
+
+    for (uint32_t threadCount : {1u, 8u})
+    {
+        EventSimulator simulator(desc, threadCount);
+        std::vector<uint2> events;
+        for (uint32_t frame = 0; frame < frames.size(); ++frame)
+            simulator.simulate(frames[frame].data(), frame, events);
+
+        ASSERT_EQ(events.size(), expected.size()) << "threads = " << threadCount;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < events.size(); ++i)
+            mismatches += any(events[i] != expected[i]);
+        EXPECT_EQ(mismatches, 0) << "threads = " << threadCount;
+
+        const EventSimulator::Stats& stats = simulator.getStats();
+        EXPECT_EQ(stats.frames, kFrameCount);
+        EXPECT_EQ(stats.pixelFrames, uint64_t(kFrameCount) * kFrameDim.x * kFrameDim.y);
+        EXPECT_EQ(stats.events, expected.size());
+
+        // Reset restarts from the initial state.
+        simulator.reset();
+        std::vector<uint2> restarted;
+        simulator.simulate(frames[0].data(), 0, restarted);
+        EXPECT_EQ(restarted.size(), size_t(std::count_if(expected.begin(), expected.end(), [](uint2 e) { return e.x == 0; })));
+    }
+}
+} // namespace
+
+CPU_TEST(EventSimulator_RatioThreshold)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::RatioThreshold;
+    desc.frameDim = kFrameDim;
+    desc.ratioThreshold = 1.15f;
+    desc.needAccumulatedEvents = 2;
+    desc.toleranceEvents = 1;
+    testModel(ctx, desc);
+}
+
+CPU_TEST(EventSimulator_LogThreshold)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LogThreshold;
+    desc.frameDim = kFrameDim;
+    desc.window = 4;
+    testModel(ctx, desc);
+}
+
+CPU_TEST(EventSimulator_LeakyIntegrateFire)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LeakyIntegrateFire;
+    desc.frameDim = kFrameDim;
+    desc.channelCount = 1;
+    desc.tau = 3.f;
+    desc.threshold = 0.1f;
+    testModel(ctx, desc);
+}
+
+CPU_TEST(EventSimulator_LeakyIntegrateFireLayout)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LeakyIntegrateFire;
+    desc.frameDim = {8, 3};
+    desc.channelCount = 1;
+
+    // A spike of pixel (5, 1), stored at x * height + y as in NetworkOutput.cs.slang.
+    std::vector<float> frame(size_t(desc.frameDim.x) * desc.frameDim.y, 0.f);
+    frame[5 * desc.frameDim.y + 1] = 2.f * desc.threshold;
+
+    EventSimulator simulator(desc, 1);
+    std::vector<uint2> events;
+    simulator.simulate(frame.data(), 3, events);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].x, 3);
+    EXPECT_EQ(events[0].y, (1 * desc.frameDim.x + 5) * 2 + 1);
+}
+
+CPU_TEST(EventSimulator_Interpolate)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LogThreshold;
+    desc.frameDim = kFrameDim;
+    desc.window = 2;
+    desc.interpolate = true;
+    desc.maxEventsPerFrame = 3;
+
+    // Frames are 16.667 ms apart, timestamps are in microseconds.
+    const auto frames = createFrames(4);
+    auto getTime = [](uint32_t frame) { return uint32_t(std::llround(frame * 1e6 / 60.0)); };
+
+    std::vector<ReferencePixel> pixels(size_t(kFrameDim.x) * kFrameDim.y);
+    std::vector<uint2> expected;
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        const size_t firstEvent = expected.size();
+        const uint32_t prevTime = getTime(frame == 0 ? 0 : frame - 1);
+        for (uint32_t i = 0; i < pixels.size(); ++i)
+            pixels[i].logThresholdInterpolated(desc, frames[frame].data() + size_t(i) * 4, getTime(frame), prevTime, i, expected);
+        std::sort(
+            expected.begin() + firstEvent,
+            expected.end(),
+            [](uint2 a, uint2 b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+        );
+    }
+
+    // The jumping pixels cross several thresholds per frame, at distinct times between the frames.
+    EventSimulator simulator(desc, 4);
+    std::vector<uint2> events;
+    std::set<uint32_t> times;
+    uint32_t maxEventsPerPixel = 0;
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        const size_t firstEvent = events.size();
+        simulator.simulate(frames[frame].data(), getTime(frame), events);
+        std::map<uint32_t, uint32_t> pixelEvents;
+        for (size_t i = firstEvent; i < events.size(); ++i)
+        {
+            maxEventsPerPixel = std::max(maxEventsPerPixel, ++pixelEvents[events[i].y / 2]);
+            times.insert(events[i].x);
+        }
+    }
+
+    ASSERT_EQ(events.size(), expected.size());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+        mismatches += any(events[i] != expected[i]);
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(maxEventsPerPixel, desc.maxEventsPerFrame);
+    EXPECT_GT(times.size(), 10 * kFrameCount);
+}
+
+CPU_TEST(EventSimulator_Sensor)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LogThreshold;
+    desc.frameDim = kFrameDim;
+    desc.window = 2;
+    desc.interpolate = true;
+    desc.maxEventsPerFrame = 3;
+    desc.sensor.enabled = true;
+    desc.sensor.thresholdSigma = 0.03f;
+    desc.sensor.cutoffHz = 50.f;
+    desc.sensor.leakRateHz = 0.5f;
+    desc.sensor.leakJitter = 0.1f;
+    desc.sensor.shotNoiseRateHz = 2.f;
+    desc.sensor.refractoryPeriod = 2e-3f;
+    desc.sensor.seed = 3;
+
+    const auto frames = createFrames(4);
+    auto getTime = [](uint32_t frame) { return uint32_t(std::llround(frame * 1e6 / 60.0)); };
+    const std::vector<float4> params = createDvsPixelParams(desc.sensor, desc.contrastThreshold, kFrameDim.x * kFrameDim.y);
+
+    std::vector<ReferencePixel> pixels(size_t(kFrameDim.x) * kFrameDim.y);
+    std::vector<uint2> expected;
+    for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        const size_t firstEvent = expected.size();
+        const uint32_t prevTime = getTime(frame == 0 ? 0 : frame - 1);
+        for (uint32_t i = 0; i < pixels.size(); ++i)
+            pixels[i].sensor(desc, params[i], frames[frame].data() + size_t(i) * 4, getTime(frame), prevTime, frame, i, expected);
+        std::sort(
+            expected.begin() + firstEvent,
+            expected.end(),
+            [](uint2 a, uint2 b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+        );
+    }
+    EXPECT_GT(expected.size(), 100);
+
+    for (uint32_t threadCount : {1u, 8u})
+    {
+        EventSimulator simulator(desc, threadCount);
+        std::vector<uint2> events;
+        for (uint32_t frame = 0; frame < kFrameCount; ++frame)
+            simulator.simulate(frames[frame].data(), getTime(frame), events);
+
+        ASSERT_EQ(events.size(), expected.size()) << "threads = " << threadCount;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < events.size(); ++i)
+            mismatches += any(events[i] != expected[i]);
+        EXPECT_EQ(mismatches, 0) << "threads = " << threadCount;
+    }
+
+    // The thresholds vary per pixel around the contrast threshold.
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    for (const float4& p : params)
+    {
+        sum += p.x;
+        sumSquares += double(p.x) * p.x;
+    }
+    const double mean = sum / params.size();
+    const double sigma = std::sqrt(sumSquares / params.size() - mean * mean);
+    EXPECT_LT(std::abs(mean - desc.contrastThreshold), 0.01);
+    EXPECT_LT(std::abs(sigma - desc.sensor.thresholdSigma), 0.01);
+}
+
+CPU_TEST(EventSimulator_SensorNoise)
+{
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LogThreshold;
+    desc.frameDim = kFrameDim;
+    desc.interpolate = true;
+    desc.sensor.enabled = true;
+    desc.sensor.seed = 11;
+
+    // A static scene only produces noise events, 1000 frames at 10 ms.
+    const std::vector<float> frame(size_t(kFrameDim.x) * kFrameDim.y * 4, 0.5f);
+    const uint32_t frameCount = 1000;
+    const uint32_t frameTicks = 10000;
+    const double seconds = frameCount * frameTicks * 1e-6;
+    const double pixelCount = double(kFrameDim.x) * kFrameDim.y;
+    // Returns the events and the number of events stamped with the frame time, which are the shot noise events.
+    auto simulate = [&](const EventSimulatorDesc& desc)
+    {
+        EventSimulator simulator(desc, 4);
+        std::vector<uint2> events;
+        size_t frameTimeEvents = 0;
+        for (uint32_t i = 0; i <= frameCount; ++i)
+        {
+            const size_t firstEvent = events.size();
+            simulator.simulate(frame.data(), i * frameTicks, events);
+            frameTimeEvents += std::count_if(events.begin() + firstEvent, events.end(), [&](uint2 e) { return e.x == i * frameTicks; });
+        }
+        return std::make_pair(events, frameTimeEvents);
+    };
+    auto countOn = [](const std::vector<uint2>& events)
+    { return size_t(std::count_if(events.begin(), events.end(), [](uint2 e) { return (e.y & 1) != 0; })); };
+    auto equal = [](const std::vector<uint2>& a, const std::vector<uint2>& b)
+    { return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](uint2 x, uint2 y) { return all(x == y); }); };
+
+    // Without non-idealities there are no events.
+    EXPECT_EQ(simulate(desc).first.size(), 0);
+
+    // Leak events are ON events at the leak rate.
+    EventSimulatorDesc leakDesc = desc;
+    leakDesc.sensor.leakRateHz = 10.f;
+    const std::vector<uint2> leakEvents = simulate(leakDesc).first;
+    EXPECT_EQ(countOn(leakEvents), leakEvents.size());
+    EXPECT_LT(std::abs(leakEvents.size() / (pixelCount * seconds) - 10.0), 0.2);
+
+    // Shot noise events have both polarities at the shot noise rate, are reproducible and depend on the seed.
+    // They move the reference level, so additional events return it to the scene intensity.
+    EventSimulatorDesc shotDesc = desc;
+    shotDesc.sensor.shotNoiseRateHz = 20.f;
+    const auto [shotEvents, shotCount] = simulate(shotDesc);
+    EXPECT_LT(std::abs(shotCount / (pixelCount * seconds) - 20.0), 0.5);
+    EXPECT_LT(std::abs(double(countOn(shotEvents)) / shotEvents.size() - 0.5), 0.02);
+    EXPECT(equal(simulate(shotDesc).first, shotEvents));
+    shotDesc.sensor.seed = 12;
+    EXPECT(!equal(simulate(shotDesc).first, shotEvents));
+
+    // The refractory period separates the events of a pixel.
+    shotDesc.sensor.shotNoiseRateHz = 200.f;
+    shotDesc.sensor.refractoryPeriod = 0.02f;
+    const std::vector<uint2> refractoryEvents = simulate(shotDesc).first;
+    std::map<uint32_t, uint32_t> lastTime;
+    uint32_t minInterval = ~0u;
+    for (const uint2& e : refractoryEvents)
+    {
+        auto it = lastTime.find(e.y / 2);
+        if (it != lastTime.end())
+            minInterval = std::min(minInterval, e.x - it->second);
+        lastTime[e.y / 2] = e.x;
+    }
+    EXPECT_GT(refractoryEvents.size(), 1000);
+    EXPECT_GE(minInterval, 20000);
+    EXPECT_LT(minInterval, 40000);
+}
+
+CPU_TEST(EventSimulator_Storage)
+{
+    const auto frames = createFrames(4);
+    const std::filesystem::path path = std::filesystem::absolute("test_event_simulator.fba");
+
+    // Store the frames as uncompressed blocks.
+    BlockArchiveDesc archiveDesc;
+    archiveDesc.frameDim = kFrameDim;
+    archiveDesc.blockSize = {16, 16, 8};
+    archiveDesc.format = BlockFormat::RGBA32Float;
+    archiveDesc.bytesPerPixel = getBlockFormatBytesPerPixel(archiveDesc.format);
+    {
+        const uint3 blockSize = archiveDesc.blockSize;
+        const uint2 blockCount = archiveDesc.getBlockCount();
+        BlockArchiveWriter writer(path, archiveDesc);
+        std::vector<float> block(size_t(blockSize.x) * blockSize.y * blockSize.z * 4);
+        for (uint32_t bz = 0; bz < kFrameCount / blockSize.z; ++bz)
+        {
+            writer.beginBatch(bz, blockSize.z);
+            for (uint32_t by = 0; by < blockCount.y; ++by)
+            {
+                for (uint32_t bx = 0; bx < blockCount.x; ++bx)
+                {
+                    std::fill(block.begin(), block.end(), 0.f);
+                    for (uint32_t z = 0; z < blockSize.z; ++z)
+                    {
+                        for (uint32_t y = 0; y < blockSize.y; ++y)
+                        {
+                            for (uint32_t x = 0; x < blockSize.x; ++x)
+                            {
+                                const uint2 p = uint2(bx, by) * blockSize.xy() + uint2(x, y);
+                                if (any(p >= kFrameDim))
+                                    continue;
+                                const float* pSrc = frames[bz * blockSize.z + z].data() + (size_t(p.y) * kFrameDim.x + p.x) * 4;
+                                std::copy(pSrc, pSrc + 4, block.data() + ((size_t(z) * blockSize.y + y) * blockSize.x + x) * 4);
+                            }
+                        }
+                    }
+                    writer.writeBlock(bx, by, BlockCodec::Raw, block.data(), block.size() * sizeof(float));
+                }
+            }
+            writer.endBatch();
+        }
+    }
+
+    EventSimulatorDesc desc;
+    desc.model = EventModel::LogThreshold;
+    desc.frameDim = kFrameDim;
+    desc.window = 3;
+
+    EventSimulator simulator(desc);
+    std::vector<uint2> expected;
+    for (uint32_t frame = 10; frame < kFrameCount; ++frame)
+        simulator.simulate(frames[frame].data(), frame, expected);
+    EXPECT_GT(expected.size(), 0);
+
+    {
+        ref<BlockStorageReader> pReader = BlockStorageReader::create(path);
+        simulator.reset();
+        std::vector<uint2> events;
+        const size_t eventCount = simulator.simulate(*pReader, 10, kFrameCount - 10, events);
+        EXPECT_EQ(eventCount, expected.size());
+        ASSERT_EQ(events.size(), expected.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < events.size(); ++i)
+            mismatches += any(events[i] != expected[i]);
+        EXPECT_EQ(mismatches, 0);
+
+        EXPECT_THROW(simulator.simulate(*pReader, 10, kFrameCount, events));
+
+        desc.channelCount = 1;
+        EventSimulator lumaSimulator(desc);
+        EXPECT_THROW(lumaSimulator.simulate(*pReader, 0, 1, events));
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(EventSimulator_Invalid)
+{
+    EventSimulatorDesc desc;
+    EXPECT_THROW(EventSimulator simulator(desc));
+    desc.frameDim = kFrameDim;
+    desc.channelCount = 3;
+    EXPECT_THROW(EventSimulator simulator(desc));
+    desc.channelCount = 4;
+    desc.toleranceEvents = 5;
+    EXPECT_THROW(EventSimulator simulator(desc));
+    desc.toleranceEvents = 0;
+    desc.model = EventModel::RatioThreshold;
+    desc.interpolate = true;
+    EXPECT_THROW(EventSimulator simulator(desc));
+    desc.model = EventModel::LogThreshold;
+    desc.interpolate = false;
+    desc.sensor.enabled = true;
+    EXPECT_THROW(EventSimulator simulator(desc));
+    desc.interpolate = true;
+    desc.sensor.leakRateHz = -1.f;
+    EXPECT_THROW(EventSimulator simulator(desc));
+}
+} // namespace Falcor
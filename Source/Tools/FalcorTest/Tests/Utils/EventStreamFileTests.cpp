@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/EventStreamFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<std::vector<uint32_t>> createChunks(size_t chunkCount)
+{
+    std::mt19937 rng;
+    std::vector<std::vector<uint32_t>> chunks(chunkCount);
+    for (auto& chunk : chunks)
+    {
+        // Include empty and odd-sized chunks to exercise padding.
+        chunk.resize(rng() % 100);
+        for (auto& e : chunk)
+            e = rng();
+    }
+    return chunks;
+}
+
+void writeStream(const std::filesystem::path& path, const std::vector<std::vector<uint32_t>>& chunks, bool close)
+{
+    EventStreamDesc desc;
+    desc.width = 64;
+    desc.height = 32;
+    desc.timeScale = 1000.0;
+    desc.encoding = EventEncoding::Address32;
+    desc.polarity = EventPolarity::EvenIsOn;
+
+    EventStreamWriter writer(path, desc);
+    for (size_t i = 0; i < chunks.size(); ++i)
+        writer.appendChunk(uint32_t(i), i * 10, uint32_t(chunks[i].size()), chunks[i].data(), chunks[i].size() * sizeof(uint32_t));
+    if (!close)
+    {
+        // Simulate an interrupted run by stripping the index.
+        writer.close();
+        std::filesystem::resize_file(path, writer.getBytesWritten());
+    }
+}
+
+void checkStream(CPUUnitTestContext& ctx, const EventStreamReader& reader, const std::vector<std::vector<uint32_t>>& chunks)
+{
+    EXPECT_EQ(reader.getDesc().width, 64);
+    EXPECT_EQ(reader.getDesc().height, 32);
+    EXPECT_EQ(reader.getDesc().timeScale, 1000.0);
+    EXPECT(reader.getDesc().encoding == EventEncoding::Address32);
+    EXPECT(reader.getDesc().polarity == EventPolarity::EvenIsOn);
+    ASSERT_EQ(reader.getChunkCount(), chunks.size());
+
+    uint64_t eventCount = 0;
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        const EventChunkInfo& info = reader.getChunks()[i];
+        EXPECT_EQ(info.frame, i);
+        EXPECT_EQ(info.timestamp, i * 10);
+        EXPECT_EQ(info.eventCount, chunks[i].size());
+        ASSERT_EQ(info.size, chunks[i].size() * sizeof(uint32_t));
+        EXPECT_EQ(info.offset % 8, 0);
+        EXPECT(std::memcmp(reader.getChunkData(i), chunks[i].data(), info.size) == 0) << "chunk " << i;
+        eventCount += chunks[i].size();
+    }
+    EXPECT_EQ(reader.getEventCount(), eventCount);
+}
+} // namespace
+
+CPU_TEST(EventStreamFile_ReadWrite)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_event_stream.evs");
+    auto chunks = createChunks(50);
+    writeStream(path, chunks, true);
+
+    {
+        EventStreamReader reader(path);
+        ASSERT(reader.isOpen());
+        EXPECT(!reader.wasRecovered());
+        checkStream(ctx, reader, chunks);
+
+        // Seek by timestamp.
+        EXPECT_EQ(reader.findChunk(0), 0);
+        EXPECT_EQ(reader.findChunk(15), 2);
+        EXPECT_EQ(reader.findChunk(20), 2);
+        EXPECT_EQ(reader.findChunk(1000), 50);
+        auto range = reader.findChunks(100, 200);
+        EXPECT_EQ(range.first, 10);
+        EXPECT_EQ(range.second, 20);
+        range = reader.findChunks(200, 100);
+        EXPECT_EQ(range.first, range.second);
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(EventStreamFile_Recover)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_event_stream_recover.evs");
+    auto chunks = createChunks(20);
+    writeStream(path, chunks, false);
+
+    {
+        EventStreamReader reader(path);
+        ASSERT(reader.isOpen());
+        EXPECT(reader.wasRecovered());
+        checkStream(ctx, reader, chunks);
+    }
+
+    // Truncate the last chunk, which is then dropped.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    chunks.pop_back();
+
+    {
+        EventStreamReader reader(path);
+        ASSERT(reader.isOpen());
+        EXPECT(reader.wasRecovered());
+        checkStream(ctx, reader, chunks);
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(EventStreamFile_Invalid)
+{
+    const std::filesystem::path path = std::filesystem::absolute("test_event_stream_invalid.evs");
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        std::vector<char> data(256, 'x');
+        ofs.write(data.data(), data.size());
+    }
+
+    EventStreamReader reader;
+    EXPECT(!reader.open(path));
+    EXPECT(!reader.isOpen());
+    EXPECT(!reader.open("__file_that_does_not_exist__"));
+
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "BlockStorageTestUtils.h"
+#include "Utils/BlockStorage/PixelSeries.h"
+
+#include <filesystem>
+
+namespace Falcor
+{
+namespace
+{
+/// RGBA volume of 32x32x4 blocks with a partial last batch.
+BlockStorageTestVolume createVolume()
+{
+    BlockStorageTestVolume volume;
+    volume.format = BlockFormat::RGBA32Float;
+    return volume;
+}
+
+void checkSeries(CPUUnitTestContext& ctx, const std::filesystem::path& path, uint2 chunkSize)
+{
+    const BlockStorageTestVolume volume = createVolume();
+    const uint3 dim = volume.dim;
+    ref<PixelSeriesReader> pSeries = PixelSeriesReader::create(path);
+    const PixelSeriesDesc& desc = pSeries->getDesc();
+    EXPECT(all(desc.frameDim == dim.xy()));
+    EXPECT(all(desc.chunkSize == chunkSize));
+    ASSERT_EQ(desc.frameCount, dim.z);
+    ASSERT_EQ(desc.channelCount, 4);
+
+    size_t mismatches = 0;
+    for (uint32_t y = 0; y < dim.y; ++y)
+    {
+        for (uint32_t x = 0; x < dim.x; ++x)
+        {
+            const float* pValues = pSeries->getSeries(x, y);
+            for (uint32_t z = 0; z < dim.z; ++z)
+                for (uint32_t c = 0; c < 4; ++c)
+                    mismatches += pValues[z * 4 + c] != volume.getValue(x, y, z, c);
+        }
+    }
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_THROW(pSeries->getSeries(dim.x, 0));
+}
+} // namespace
+
+CPU_TEST(PixelSeries_Transpose)
+{
+    const std::filesystem::path archivePath = std::filesystem::absolute("test_pixel_series.fba");
+    const std::filesystem::path seriesPath = std::filesystem::absolute("test_pixel_series.fps");
+    const BlockStorageTestVolume volume = createVolume();
+    volume.writeArchive(archivePath);
+
+    {
+        ref<BlockStorageReader> pReader = BlockStorageReader::create(archivePath);
+
+        // Chunks default to the block size.
+        writePixelSeries(*pReader, seriesPath);
+        checkSeries(ctx, seriesPath, {32, 32});
+
+        // Chunks not aligned to the blocks.
+        writePixelSeries(*pReader, seriesPath, {24, 20});
+        checkSeries(ctx, seriesPath, {24, 20});
+        EXPECT_EQ(std::filesystem::file_size(seriesPath), 64 + size_t(volume.dim.x) * volume.dim.y * volume.dim.z * 16);
+
+        // A working set of one frame batch writes the series of a chunk in three passes.
+        writePixelSeries(*pReader, seriesPath, {0, 0}, 32 * 32 * 4 * 16);
+        checkSeries(ctx, seriesPath, {32, 32});
+        EXPECT_EQ(std::filesystem::file_size(seriesPath), 64 + size_t(volume.dim.x) * volume.dim.y * volume.dim.z * 16);
+    }
+
+    // Incomplete files are rejected.
+    std::filesystem::resize_file(seriesPath, std::filesystem::file_size(seriesPath) - 16);
+    EXPECT_THROW(PixelSeriesReader::create(seriesPath));
+
+    std::filesystem::remove(archivePath);
+    std::filesystem::remove(seriesPath);
+}
+} // namespace Falcor
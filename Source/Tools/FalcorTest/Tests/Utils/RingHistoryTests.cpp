@@ -0,0 +1,76 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/RingHistory.h"
+#include <deque>
+
+namespace Falcor
+{
+CPU_TEST(RingHistory_MatchesShiftRegister)
+{
+    for (uint32_t length : {1u, 2u, 5u, 43u})
+    {
+        RingHistory history(length);
+        std::vector<uint32_t> ring(length, 0);
+        std::deque<uint32_t> shift(length, 0);
+        size_t mismatches = 0;
+        for (uint32_t frame = 1; frame <= 3 * length + 1; ++frame)
+        {
+            history.advance();
+            ring[history.getHead()] = frame;
+            shift.pop_front();
+            shift.push_back(frame);
+            for (uint32_t age = 0; age < length; ++age)
+                mismatches += ring[history.getSlot(age)] != shift[length - 1 - age];
+        }
+        EXPECT_EQ(mismatches, 0) << "length = " << length;
+    }
+}
+
+CPU_TEST(RingHistory_Reset)
+{
+    RingHistory history(4);
+    history.advance();
+    EXPECT_EQ(history.getHead(), 0);
+    EXPECT_EQ(history.getSlot(1), 3);
+    history.advance();
+    history.reset(3);
+    EXPECT_EQ(history.getLength(), 3);
+    history.advance();
+    EXPECT_EQ(history.getHead(), 0);
+    // Ages wrap around the length.
+    EXPECT_EQ(history.getSlot(3), 0);
+
+    // Restoring a head keeps the slots of a saved history.
+    history.setHead(2);
+    EXPECT_EQ(history.getSlot(1), 1);
+    EXPECT_THROW(history.setHead(3));
+
+    EXPECT_THROW(history.reset(0));
+}
+} // namespace Falcor
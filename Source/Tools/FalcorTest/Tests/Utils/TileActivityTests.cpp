@@ -0,0 +1,157 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Events/TileActivity.h"
+
+namespace Falcor
+{
+namespace
+{
+const uint2 kFrameDim = {64, 40}; // 4x3 tiles, the last row is partially covered.
+
+/// Get the active tiles as indices and the number of listed tiles.
+std::vector<uint32_t> getActiveTiles(TileActivity& activity, uint32_t& listed)
+{
+    listed = activity.getDispatchArgs()->getElement<uint32_t>(0);
+    const uint2 tileCount = activity.getTileCount();
+    std::vector<uint32_t> active;
+    if (listed == 0)
+        return active;
+    for (uint32_t tile : activity.getTileBuffer()->getElements<uint32_t>(0, listed))
+    {
+        if (tile & 0x80000000)
+            active.push_back(((tile >> 16) & 0x7fff) * tileCount.x + (tile & 0xffff));
+    }
+    return active;
+}
+} // namespace
+
+GPU_TEST(TileActivity)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    TileActivity::Desc desc;
+    desc.dilation = 0;
+    TileActivity activity(pDevice, desc);
+    activity.resize(kFrameDim);
+    EXPECT(all(activity.getTileCount() == uint2(4, 3)));
+
+    // The first update lists all tiles as active.
+    uint32_t listed = 0;
+    activity.update(pRenderContext);
+    EXPECT_EQ(getActiveTiles(activity, listed).size(), 12);
+    EXPECT_EQ(listed, 12);
+
+    // A moving pixel in tile (1, 1) keeps it active, the other tiles are listed once more as inactive.
+    std::vector<float2> motion(kFrameDim.x * kFrameDim.y, float2(0.f));
+    motion[20 * kFrameDim.x + 20] = float2(1.f / kFrameDim.x, 0.f);
+    ref<Texture> pMotion =
+        pDevice->createTexture2D(kFrameDim.x, kFrameDim.y, ResourceFormat::RG32Float, 1, 1, motion.data(), ResourceBindFlags::ShaderResource);
+    activity.addMotion(pRenderContext, pMotion);
+    activity.update(pRenderContext);
+    EXPECT(getActiveTiles(activity, listed) == std::vector<uint32_t>({5}));
+    EXPECT_EQ(listed, 12);
+
+    // Events reported in tile (3, 2) keep it active, tile (1, 1) is listed to be cleared.
+    std::vector<uint32_t> events(12, 0);
+    events[11] = 3;
+    activity.getEventBuffer()->setBlob(events.data(), 0, events.size() * sizeof(uint32_t));
+    activity.update(pRenderContext);
+    EXPECT(getActiveTiles(activity, listed) == std::vector<uint32_t>({11}));
+    EXPECT_EQ(listed, 2);
+
+    // Without motion or events nothing but the previously active tile is listed.
+    activity.update(pRenderContext);
+    EXPECT(getActiveTiles(activity, listed).empty());
+    EXPECT_EQ(listed, 1);
+    activity.update(pRenderContext);
+    EXPECT_EQ(activity.getDispatchArgs()->getElement<uint32_t>(0), 0);
+
+    // Dilation activates the neighbors, events below the threshold are ignored.
+    desc.dilation = 1;
+    desc.eventThreshold = 2;
+    activity.setDesc(desc);
+    events.assign(12, 0);
+    events[0] = 2;
+    events[7] = 1;
+    activity.getEventBuffer()->setBlob(events.data(), 0, events.size() * sizeof(uint32_t));
+    activity.update(pRenderContext);
+    EXPECT(getActiveTiles(activity, listed) == std::vector<uint32_t>({0, 1, 4, 5}));
+    EXPECT_EQ(listed, 4);
+
+    // A refresh lists all tiles as active again.
+    desc.refreshPeriod = 6;
+    activity.setDesc(desc);
+    activity.update(pRenderContext);
+    EXPECT_EQ(getActiveTiles(activity, listed).size(), 12);
+    EXPECT_EQ(activity.getUpdateCount(), 7);
+}
+
+GPU_TEST(TileActivity_Color)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = ctx.getRenderContext();
+
+    TileActivity::Desc desc;
+    desc.dilation = 0;
+    desc.refreshPeriod = 0;
+    TileActivity activity(pDevice, desc);
+    activity.resize(kFrameDim);
+    activity.update(pRenderContext);
+
+    std::vector<float4> color(kFrameDim.x * kFrameDim.y, float4(0.5f, 0.5f, 0.5f, 1.f));
+    ref<Texture> pColor = pDevice->createTexture2D(
+        kFrameDim.x, kFrameDim.y, ResourceFormat::RGBA32Float, 1, 1, color.data(), ResourceBindFlags::ShaderResource
+    );
+    auto addColor = [&](float value)
+    {
+        color[5 * kFrameDim.x + 40] = float4(value, value, value, 1.f);
+        pColor->setSubresourceBlob(0, color.data(), color.size() * sizeof(float4));
+        activity.addColor(pRenderContext, pColor);
+        activity.update(pRenderContext);
+    };
+
+    // The first color marks all tiles.
+    uint32_t listed = 0;
+    addColor(0.5f);
+    EXPECT_EQ(getActiveTiles(activity, listed).size(), 12);
+
+    // A static color marks nothing.
+    addColor(0.5f);
+    EXPECT(getActiveTiles(activity, listed).empty());
+
+    // A change below the threshold does not mark the tile (2, 0), but changes add up until they exceed it.
+    addColor(0.51f);
+    EXPECT(getActiveTiles(activity, listed).empty());
+    addColor(0.53f);
+    EXPECT(getActiveTiles(activity, listed) == std::vector<uint32_t>({2}));
+    addColor(0.53f);
+    EXPECT(getActiveTiles(activity, listed).empty());
+}
+} // namespace Falcor
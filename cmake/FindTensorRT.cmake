@@ -43,54 +43,36 @@ if(NOT TensorRT_LIBRARY)
         find_library(TensorRT_LIBRARY NAMES nvinfer_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_LIBRARY)
-    message(FATAL_ERROR "tensorrt not found")
-endif()
 
 if(NOT TensorRT_NVONNXPARSER_LIBRARY)
     foreach(search ${_TensorRT_SEARCHES})
         find_library(TensorRT_NVONNXPARSER_LIBRARY NAMES nvonnxparser_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_NVONNXPARSER_LIBRARY)
-    message(FATAL_ERROR "onnxparser not found")
-endif()
 
 if(NOT TensorRT_PLUGIN_LIBRARY)
     foreach(search ${_TensorRT_SEARCHES})
         find_library(TensorRT_PLUGIN_LIBRARY NAMES nvinfer_plugin_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_PLUGIN_LIBRARY)
-    message(FATAL_ERROR "tensorrt plugin not found")
-endif()
 
 if(NOT TensorRT_VCPLUGIN_LIBRARY)
     foreach(search ${_TensorRT_SEARCHES})
         find_library(TensorRT_VCPLUGIN_LIBRARY NAMES nvinfer_vc_plugin_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_VCPLUGIN_LIBRARY)
-    message(FATAL_ERROR "tensorrt vcplugin not found")
-endif()
 
 if(NOT TensorRT_LEAN_LIBRARY)
     foreach(search ${_TensorRT_SEARCHES})
         find_library(TensorRT_LEAN_LIBRARY NAMES nvinfer_lean_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_LEAN_LIBRARY)
-    message(FATAL_ERROR "tensorrt lean not found")
-endif()
 
 if(NOT TensorRT_DISPATCH_LIBRARY)
     foreach(search ${_TensorRT_SEARCHES})
         find_library(TensorRT_DISPATCH_LIBRARY NAMES nvinfer_dispatch_10 ${${search}} PATH_SUFFIXES lib)
     endforeach()
 endif()
-if(NOT TensorRT_DISPATCH_LIBRARY)
-    message(FATAL_ERROR "tensorrt dispatch not found")
-endif()
 
 set(TensorRT_INFER_BUILDER_RESOURCE_DLL ${TensorRT_DIR}/lib/nvinfer_builder_resource_10.dll)
 
@@ -108,7 +90,12 @@ if(TensorRT_INCLUDE_DIR AND EXISTS "${TensorRT_INCLUDE_DIR}/NvInfer.h")
 endif()
 
 include(FindPackageHandleStandardArgs)
-FIND_PACKAGE_HANDLE_STANDARD_ARGS(TensorRT REQUIRED_VARS TensorRT_LIBRARY TensorRT_INCLUDE_DIR VERSION_VAR TensorRT_VERSION_STRING)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(TensorRT
+    REQUIRED_VARS
+        TensorRT_LIBRARY TensorRT_NVONNXPARSER_LIBRARY TensorRT_PLUGIN_LIBRARY TensorRT_VCPLUGIN_LIBRARY
+        TensorRT_LEAN_LIBRARY TensorRT_DISPATCH_LIBRARY TensorRT_INCLUDE_DIR
+    VERSION_VAR TensorRT_VERSION_STRING
+)
 
 if(TensorRT_FOUND)
     set(TensorRT_INCLUDE_DIRS ${TensorRT_INCLUDE_DIR})
@@ -122,9 +109,7 @@ if(TensorRT_FOUND)
         set_target_properties(TensorRT::TensorRT PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${TensorRT_INCLUDE_DIRS}")
         set_property(TARGET TensorRT::TensorRT APPEND PROPERTY IMPORTED_LOCATION "${TensorRT_LIBRARY}")
     endif()
-endif()
-
 
-LIST(TRANSFORM TensorRT_LIBRARIES REPLACE "\\.lib" ".dll" OUTPUT_VARIABLE TensorRT_DLLS)
-LIST(APPEND TensorRT_DLLS ${TensorRT_INFER_BUILDER_RESOURCE_DLL})
-message("${TensorRT_DLLS}")
+    LIST(TRANSFORM TensorRT_LIBRARIES REPLACE "\\.lib" ".dll" OUTPUT_VARIABLE TensorRT_DLLS)
+    LIST(APPEND TensorRT_DLLS ${TensorRT_INFER_BUILDER_RESOURCE_DLL})
+endif()
@@ -0,0 +1,77 @@
+import os
+import json
+import yaml
+import subprocess
+import argparse
+import TemplateInstantiate
+import time
+from pathlib import Path
+from Dataset import root_dir, scenes, get_parameters
+
+# Renders the dataset stages of several scenes in a single Mogwai process with --batch.
+# The jobs are ordered by scene, so that the stages of a scene reuse the loaded scene, and all jobs reuse the device and
+# the compiled programs. Every job starts with fresh render graphs, so its output is the same as that of a separate run.
+
+stages = {
+    'dataset': ('DatasetScriptTemplate.py', 'image'),
+    'network': ('NetworkScriptTemplate.py', 'bin'),
+    'denoise': ('DenoiseScriptTemplate.py', 'denoise'),
+    'optix': ('OptixDenoiseScriptTemplate.py', 'optix'),
+}
+
+
+def get_jobs(config, scene_indices, stage_names):
+    script_config = config.get('script', {})
+    jobs = []
+    for scene_index in scene_indices:
+        directory, parameters = get_parameters(script_config, scene_index)
+        script_dir = os.path.join(directory, 'scripts')
+        os.makedirs(script_dir, exist_ok=True)
+        for stage in stage_names:
+            template_name, output_dir = stages[stage]
+            script = os.path.join(script_dir, f"{stage}.py")
+            TemplateInstantiate.instantiate_template(os.path.join(root_dir, 'scripts', template_name), script, parameters)
+            jobs.append({
+                'scene': Path(scenes[scene_index]).as_posix(),
+                'script': Path(script).as_posix(),
+                'outputDir': Path(directory, output_dir).as_posix(),
+            })
+    return jobs
+
+
+def run(args, config):
+    build_type = config.get('build', 'Release')
+    assert(build_type in ['Release', 'Debug'])
+    mogwai_path = os.path.join(root_dir, 'build', 'windows-ninja-msvc', 'bin', build_type, 'Mogwai')
+    width = config.get('width', 0)
+    height = config.get('height', 0)
+
+    jobs = get_jobs(config, args.scenes, args.stages)
+    batch_path = os.path.abspath(args.output)
+    with open(batch_path, 'w') as file:
+        json.dump({'jobs': jobs}, file, indent=4)
+
+    verbosity = config.get('verbosity', 2)
+    assert(verbosity in [0, 1, 2, 3, 4, 5])
+    cmd = [mogwai_path, f"--batch={batch_path}", f"--verbosity={verbosity}", f"--width={width}", f"--height={height}"]
+    if config.get('headless', False):
+        cmd.append("--headless")
+
+    print(f"Running {len(jobs)} jobs: {' '.join(cmd)}")
+    start_time = time.time()
+    subprocess.run(cmd, check=True)
+    execution_time = time.time() - start_time
+    print(f"Batch completed in {execution_time:.2f} seconds ({execution_time/60:.2f} minutes).")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Render the dataset stages of several scenes in one Mogwai process.")
+    parser.add_argument('--config', type=str, default="config/default.yaml", help='Path to the YAML configuration file.')
+    parser.add_argument('--scenes', type=int, nargs='+', default=[0], help='Scene indices to run.')
+    parser.add_argument('--stages', type=str, nargs='+', default=['network', 'denoise'], choices=stages.keys(), help='Stages to run for every scene.')
+    parser.add_argument('--output', type=str, default="batch.json", help='Path of the batch file written for Mogwai.')
+    args = parser.parse_args()
+
+    with open(args.config, 'r') as file:
+        config = yaml.safe_load(file)
+    run(args, config)
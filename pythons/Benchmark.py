@@ -0,0 +1,95 @@
+import os
+import json
+import yaml
+import subprocess
+import argparse
+import TemplateInstantiate
+import time
+from pathlib import Path
+from Dataset import root_dir
+
+# Benchmarks the event pipeline on the fixed synthetic scene scripts/BenchmarkScene.pyscene.
+# The GPU mode runs the event graph variants in Mogwai (scripts/BenchmarkScriptTemplate.py), the CPU mode runs the
+# CPU event models and writers with EventBench --pipeline, which needs no GPU. Both write a JSON report.
+
+variants = ['Compress', 'Denoise', 'Network', 'BlockStorage']
+
+
+def get_bin_dir(config):
+    build_type = config.get('build', 'Release')
+    assert(build_type in ['Release', 'Debug'])
+    return os.path.join(root_dir, 'build', 'windows-ninja-msvc', 'bin', build_type)
+
+
+def run_gpu(args, config):
+    script_config = config.get('script', {})
+    directory = os.path.abspath(args.directory)
+    os.makedirs(directory, exist_ok=True)
+    parameters = {
+        "FRAMES": args.frames,
+        "WARMUP": args.warmup,
+        "VARIANTS": args.variants,
+        "DIRECTORY": Path(directory).as_posix(),
+        "REPORT": Path(os.path.abspath(args.report)).as_posix(),
+        "SCENE": Path(root_dir, 'scripts', 'BenchmarkScene.pyscene').as_posix(),
+        "WIDTH": args.width,
+        "HEIGHT": args.height,
+        "NETWORK_MODEL": script_config.get('networkModel', ''),
+        "NETWORK_BACKEND": args.network_backend,
+    }
+    script = os.path.join(directory, 'benchmark.py')
+    TemplateInstantiate.instantiate_template(os.path.join(root_dir, 'scripts', 'BenchmarkScriptTemplate.py'), script, parameters)
+
+    verbosity = config.get('verbosity', 2)
+    assert(verbosity in [0, 1, 2, 3, 4, 5])
+    cmd = [os.path.join(get_bin_dir(config), 'Mogwai'), f"--script={script}", f"--verbosity={verbosity}", "--headless"]
+    print(f"Running: {' '.join(cmd)}")
+    subprocess.run(cmd, check=True)
+
+
+def run_cpu(args, config):
+    script_config = config.get('script', {})
+    cmd = [
+        os.path.join(get_bin_dir(config), 'EventBench'), "--pipeline",
+        f"--width={args.width}", f"--height={args.height}", f"--frames={args.frames}", f"--warmup={args.warmup}",
+        f"--report={os.path.abspath(args.report)}", f"--directory={os.path.abspath(args.directory)}",
+    ]
+    cmd += [f"--variant={variant}" for variant in args.variants]
+    if script_config.get('networkModel'):
+        cmd.append(f"--model={script_config['networkModel']}")
+    print(f"Running: {' '.join(cmd)}")
+    subprocess.run(cmd, check=True)
+
+
+def print_report(path):
+    with open(path, 'r') as file:
+        report = json.load(file)
+    print(f"{report['mode']} benchmark, {report['width']}x{report['height']}, {report['frames']} frames")
+    for name, variant in report['variants'].items():
+        print(f"  {name:<13} {variant['framesPerSecond']:8.1f} frames/s {variant['eventsPerSecond'] * 1e-6:8.2f} Mevents/s "
+              f"{variant['bytesWrittenPerSecond'] * 1e-6:8.2f} MB/s, {variant['readbackStalls']} stalls")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Benchmark the event pipeline variants on a synthetic scene.")
+    parser.add_argument('--config', type=str, default="config/default.yaml", help='Path to the YAML configuration file.')
+    parser.add_argument('--cpu', action='store_true', help='Run the CPU event models and writers instead of the GPU passes.')
+    parser.add_argument('--variants', type=str, nargs='+', default=variants, choices=variants, help='Variants to run.')
+    parser.add_argument('--frames', type=int, default=256, help='Number of measured frames.')
+    parser.add_argument('--warmup', type=int, default=16, help='Number of frames rendered before measuring.')
+    parser.add_argument('--width', type=int, default=1920, help='Frame width.')
+    parser.add_argument('--height', type=int, default=1080, help='Frame height.')
+    parser.add_argument('--network-backend', type=str, default='TensorRT', choices=['TensorRT', 'CPU'], help='Inference backend of the Network pass.')
+    parser.add_argument('--directory', type=str, default="benchmark", help='Directory the event passes write to.')
+    parser.add_argument('--report', type=str, default="benchmark.json", help='Path of the JSON report.')
+    args = parser.parse_args()
+
+    with open(args.config, 'r') as file:
+        config = yaml.safe_load(file)
+    start_time = time.time()
+    if args.cpu:
+        run_cpu(args, config)
+    else:
+        run_gpu(args, config)
+    print(f"Benchmark completed in {time.time() - start_time:.2f} seconds.")
+    print_report(args.report)
@@ -0,0 +1,168 @@
+import numpy as np
+import os
+import struct
+import zlib
+
+# Block archives written by BlockStoragePass (see Source/Falcor/Utils/BlockStorage/BlockArchive.h).
+ARCHIVE_FILENAME = 'blocks.fba'
+FILE_MAGIC = 0x4B4C4246    # 'FBLK'
+BATCH_MAGIC = 0x54424246   # 'FBBT'
+FOOTER_MAGIC = 0x58494246  # 'FBIX'
+FILE_VERSION = 1
+ALIGNMENT = 64
+
+HEADER_FORMAT = '<11If16x'
+BATCH_HEADER_FORMAT = '<IIIIQQ'
+INDEX_ENTRY_DTYPE = np.dtype([('bx', '<u4'), ('by', '<u4'), ('bz', '<u4'), ('codec', '<u4'), ('offset', '<u8'), ('size', '<u8'),
+                              ('range_min', '<f4'), ('range_max', '<f4'), ('reserved', '<u4', 2)])
+FOOTER_FORMAT = '<QII'
+
+CODEC_RAW = 0
+CODEC_LZ4 = 1
+CODEC_DEFLATE = 2
+CODEC_ZERO = 3
+CODEC_CONSTANT = 4  # The pixel value is stored in place of the offset and size of the index entry.
+
+# Pixel formats as (name, dtype, channels). Quantized formats map codes q to range_min + q / max_code * (range_max - range_min).
+FORMATS = [
+    ('RGBA32Float', np.float32, 4),
+    ('RGBA16Float', np.float16, 4),
+    ('Luma32Float', np.float32, 1),
+    ('Luma16Float', np.float16, 1),
+    ('LogLuma16', np.uint16, 1),
+    ('LogLuma8', np.uint8, 1),
+]
+
+
+def find_archive(path):
+    """Return the archive path if path is an archive or a directory containing one, otherwise None."""
+    if os.path.isdir(path):
+        path = os.path.join(path, ARCHIVE_FILENAME)
+    return path if os.path.isfile(path) else None
+
+
+def _align(offset):
+    return (offset + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+
+class BlockArchive:
+    def __init__(self, path):
+        self.path = path
+        self.data = np.memmap(path, dtype=np.uint8, mode='r')
+        header_size = struct.calcsize(HEADER_FORMAT)
+        if len(self.data) < header_size:
+            raise ValueError(f"{path} is too small to be a block archive")
+        (magic, version, width, height, sx, sy, sz, self.bytes_per_pixel, cx, cy, self.format, self.log_threshold) = struct.unpack_from(HEADER_FORMAT, self.data, 0)
+        if magic != FILE_MAGIC or version != FILE_VERSION:
+            raise ValueError(f"{path} is not a block archive (version {FILE_VERSION})")
+        if self.format >= len(FORMATS):
+            raise ValueError(f"{path} has unknown block format {self.format}")
+        self.format_name, self.dtype, self.channels = FORMATS[self.format]
+        self.frame_dim = (width, height)
+        self.block_size = (sx, sy, sz)
+        self.block_count = (cx, cy)
+
+        self.recovered = False
+        batch_offsets = self._read_footer(header_size)
+        if batch_offsets is None:
+            batch_offsets = self._scan_batches(header_size)
+            self.recovered = True
+
+        # One index table per block z coordinate, entry (bx, by) is at by * block_count[0] + bx.
+        # The last batch of a run may hold fewer than block_size[2] valid frames.
+        self.batches = {}
+        self.batch_frame_counts = {}
+        for offset in batch_offsets:
+            _, bz, count, frame_count, index_offset, _ = struct.unpack_from(BATCH_HEADER_FORMAT, self.data, int(offset))
+            self.batches[bz] = np.frombuffer(self.data, dtype=INDEX_ENTRY_DTYPE, count=count, offset=index_offset)
+            self.batch_frame_counts[bz] = frame_count
+
+    def _read_footer(self, header_size):
+        footer_size = struct.calcsize(FOOTER_FORMAT)
+        if len(self.data) < header_size + footer_size:
+            return None
+        list_offset, batch_count, magic = struct.unpack_from(FOOTER_FORMAT, self.data, len(self.data) - footer_size)
+        if magic != FOOTER_MAGIC or list_offset + batch_count * 8 + footer_size != len(self.data):
+            return None
+        return np.frombuffer(self.data, dtype='<u8', count=batch_count, offset=list_offset)
+
+    def _scan_batches(self, header_size):
+        # The run was interrupted before the footer was written, scan the batch headers instead.
+        batch_header_size = struct.calcsize(BATCH_HEADER_FORMAT)
+        index_size = self.block_count[0] * self.block_count[1] * INDEX_ENTRY_DTYPE.itemsize
+        offsets = []
+        offset = _align(header_size)
+        while offset + batch_header_size <= len(self.data):
+            magic, _, _, _, index_offset, _ = struct.unpack_from(BATCH_HEADER_FORMAT, self.data, offset)
+            if magic != BATCH_MAGIC or index_offset <= offset or index_offset + index_size > len(self.data):
+                break
+            offsets.append(offset)
+            offset = _align(index_offset + index_size)
+        return offsets
+
+    def batch_count(self):
+        return max(self.batches.keys(), default=-1) + 1
+
+    def frame_count(self):
+        """Total number of frames, counting missing batches as full."""
+        if not self.batches:
+            return 0
+        last = self.batch_count() - 1
+        return last * self.block_size[2] + self.batch_frame_counts[last]
+
+    def find_block(self, bx, by, bz):
+        """Return the index entry of a block, or None if it is not in the archive."""
+        index = self.batches.get(bz)
+        if index is None or not (0 <= bx < self.block_count[0] and 0 <= by < self.block_count[1]):
+            return None
+        entry = index[by * self.block_count[0] + bx]
+        return entry if entry['offset'] != 0 or entry['codec'] in (CODEC_ZERO, CODEC_CONSTANT) else None
+
+    def raw_block(self, bx, by, bz):
+        """Return the payload of a block as a uint8 array without copying, or None if it is missing.
+        For constant blocks this is the pixel value."""
+        entry = self.find_block(bx, by, bz)
+        if entry is None:
+            return None
+        if entry['codec'] == CODEC_CONSTANT:
+            return np.frombuffer(entry.tobytes(), dtype=np.uint8, count=self.bytes_per_pixel, offset=16)
+        return self.data[int(entry['offset']):int(entry['offset']) + int(entry['size'])]
+
+    def block(self, bx, by, bz, dtype=None, channels=None):
+        """Return the stored pixels of a block as a (z, y, x, channels) array, or None if it is missing.
+        dtype and channels default to the archive format. Raw blocks are returned without copying."""
+        entry = self.find_block(bx, by, bz)
+        if entry is None:
+            return None
+        dtype = self.dtype if dtype is None else dtype
+        channels = self.channels if channels is None else channels
+        shape = (self.block_size[2], self.block_size[1], self.block_size[0], channels)
+        block_bytes = int(np.prod(shape)) * np.dtype(dtype).itemsize
+        codec = entry['codec']
+        payload = self.raw_block(bx, by, bz)
+        if codec == CODEC_RAW:
+            data = payload
+        elif codec == CODEC_ZERO:
+            return np.zeros(shape, dtype=dtype)
+        elif codec == CODEC_CONSTANT:
+            return np.broadcast_to(payload.view(dtype), (int(np.prod(shape[:3])), channels)).reshape(shape).copy()
+        elif codec == CODEC_LZ4:
+            import lz4.block
+            data = lz4.block.decompress(payload.tobytes(), uncompressed_size=block_bytes)
+        elif codec == CODEC_DEFLATE:
+            data = zlib.decompress(payload.tobytes())
+        else:
+            raise ValueError(f"unsupported block codec {codec}")
+        return np.frombuffer(data, dtype=dtype, count=block_bytes // np.dtype(dtype).itemsize).reshape(shape)
+
+    def values(self, bx, by, bz):
+        """Return a block as a float32 (z, y, x, channels) array with quantized formats mapped back to their values,
+        or None if it is missing. LogLuma formats hold lin-log luma (see log_threshold)."""
+        data = self.block(bx, by, bz)
+        if data is None:
+            return None
+        if self.dtype in (np.uint8, np.uint16):
+            entry = self.find_block(bx, by, bz)
+            scale = (entry['range_max'] - entry['range_min']) / np.iinfo(self.dtype).max
+            return (entry['range_min'] + data.astype(np.float32) * scale).astype(np.float32)
+        return data.astype(np.float32)
@@ -18,32 +18,8 @@ scenes = [
     os.path.join(root_dir, "../Scenes", "classroom", "classroom.pyscene"),
 ]
 
-def run(args, scene_index):
-    print(f"config file: {args.config}")
-    with open(args.config, 'r') as file:
-        config = yaml.safe_load(file)
-    name = config.get('name', 'default')
-
-    build_type = config.get('build', 'Release')
-    assert(build_type in ['Release', 'Debug'])
-    mogwai_path = os.path.join(root_dir, 'build', 'windows-ninja-msvc', 'bin', build_type, 'Mogwai')
-    width = config.get('width', 0)
-    height = config.get('height', 0)
-
-    assert(scene_index in [0, 1, 2, 4, 5, 6])
-    scene = scenes[scene_index]
-
-    # Use TemplateInstantiate.py to create script based on config parameters
-    script_config = config.get('script', {})
-    dataset_script = os.path.join(root_dir, 'scripts', f"EventCamera.py")
-    network_script = os.path.join(root_dir, 'scripts', f"Network.py")
-    denoise_script = os.path.join(root_dir, 'scripts', f"Denoise.py")
-    optix_denoise_script = os.path.join(root_dir, 'scripts', f"OptixDenoise.py")
-    dataset_template_path = os.path.join(root_dir, 'scripts', 'DatasetScriptTemplate.py')
-    network_template_path = os.path.join(root_dir, 'scripts', 'NetworkScriptTemplate.py')
-    denoise_template_path = os.path.join(root_dir, 'scripts', 'DenoiseScriptTemplate.py')
-    optix_denoise_template_path = os.path.join(root_dir, 'scripts', 'OptixDenoiseScriptTemplate.py')
-
+def get_parameters(script_config, scene_index):
+    """Create the output directories of a scene and return them with the script template parameters."""
     # Extract parameters from config
     samples_per_pixel = script_config.get('samplesPerPixel', 8)
     russian_roulette = script_config.get('russianRoulette', True)
@@ -94,7 +70,43 @@ def run(args, scene_index):
         "NETWORK_TIME_SCALE": network_time_scale,
         "NETWORK_EXIT_FRAME": exit_time * network_time_scale * accumulatePass,
         "OPTIX_NETWORK_EXIT_FRAME": exit_time * network_time_scale,
+        # The whole sequence in one process, see Shard.py.
+        "START_FRAME": 0,
+        "FRAME_OFFSET": 0,
+        "BEGIN_FRAME": 0,
+        "END_FRAME": 0,
+        "LOAD_CHECKPOINT": "",
+        "SAVE_CHECKPOINT": "",
     }
+    return directory, parameters
+
+def run(args, scene_index):
+    print(f"config file: {args.config}")
+    with open(args.config, 'r') as file:
+        config = yaml.safe_load(file)
+    name = config.get('name', 'default')
+
+    build_type = config.get('build', 'Release')
+    assert(build_type in ['Release', 'Debug'])
+    mogwai_path = os.path.join(root_dir, 'build', 'windows-ninja-msvc', 'bin', build_type, 'Mogwai')
+    width = config.get('width', 0)
+    height = config.get('height', 0)
+
+    assert(scene_index in [0, 1, 2, 4, 5, 6])
+    scene = scenes[scene_index]
+
+    # Use TemplateInstantiate.py to create script based on config parameters
+    script_config = config.get('script', {})
+    dataset_script = os.path.join(root_dir, 'scripts', f"EventCamera.py")
+    network_script = os.path.join(root_dir, 'scripts', f"Network.py")
+    denoise_script = os.path.join(root_dir, 'scripts', f"Denoise.py")
+    optix_denoise_script = os.path.join(root_dir, 'scripts', f"OptixDenoise.py")
+    dataset_template_path = os.path.join(root_dir, 'scripts', 'DatasetScriptTemplate.py')
+    network_template_path = os.path.join(root_dir, 'scripts', 'NetworkScriptTemplate.py')
+    denoise_template_path = os.path.join(root_dir, 'scripts', 'DenoiseScriptTemplate.py')
+    optix_denoise_template_path = os.path.join(root_dir, 'scripts', 'OptixDenoiseScriptTemplate.py')
+
+    directory, parameters = get_parameters(script_config, scene_index)
     TemplateInstantiate.instantiate_template(dataset_template_path, dataset_script, parameters)
     TemplateInstantiate.instantiate_template(network_template_path, network_script, parameters)
     TemplateInstantiate.instantiate_template(denoise_template_path, denoise_script, parameters)
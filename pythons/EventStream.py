@@ -0,0 +1,189 @@
+import numpy as np
+import struct
+import bisect
+
+# Event stream files written by CompressPass, DenoisePass and Network (see Source/Falcor/Utils/Events/EventStreamFile.h).
+FILE_MAGIC = 0x53564546   # 'FEVS'
+CHUNK_MAGIC = 0x43564546  # 'FEVC'
+INDEX_MAGIC = 0x49564546  # 'FEVI'
+FILE_VERSION = 1
+
+HEADER_FORMAT = '<IIIIdII32x'
+CHUNK_HEADER_FORMAT = '<IIQIIQ'
+INDEX_ENTRY_DTYPE = np.dtype([('frame', '<u4'), ('event_count', '<u4'), ('timestamp', '<u8'), ('offset', '<u8'), ('size', '<u8')])
+FOOTER_FORMAT = '<QII'
+
+ENCODING_ADDRESS32 = 0
+ENCODING_FRAME_ADDRESS64 = 1
+ENCODING_COMPACT = 2
+POLARITY_ODD_IS_ON = 0
+POLARITY_EVEN_IS_ON = 1
+
+
+def decode_compact(payload):
+    """Decode a compact chunk (see Source/Falcor/Utils/Events/EventCodec.h) into (time, address) arrays."""
+    b = np.asarray(payload, dtype=np.uint8)
+    if len(b) == 0:
+        empty = np.zeros(0, dtype=np.uint32)
+        return empty, empty
+    # Tokens are LEB128 varints, each one ends with a byte below 0x80.
+    ends = np.flatnonzero(b < 0x80)
+    if len(ends) == 0 or ends[-1] != len(b) - 1:
+        raise ValueError("truncated compact chunk")
+    starts = np.concatenate(([0], ends[:-1] + 1))
+    token = np.repeat(np.arange(len(ends)), ends - starts + 1)
+    shift = (np.arange(len(b)) - starts[token]) * 7
+    if shift.max() > 63:
+        raise ValueError("invalid varint in compact chunk")
+    values = np.zeros(len(ends), dtype=np.uint64)
+    np.add.at(values, token, (b & 0x7f).astype(np.uint64) << shift.astype(np.uint64))
+
+    kind = values & 3
+    if np.any(kind == 3):
+        raise ValueError("invalid token in compact chunk")
+    is_time = kind == 2
+    is_run = kind == 1
+    count = np.where(is_time, 0, np.where(is_run, ((values >> 3) & 31) + 2, 1)).astype(np.int64)
+    delta = np.where(is_time, 0, np.where(is_run, values >> 8, values >> 3)).astype(np.int64)
+    time = np.cumsum(np.where(is_time, values >> 2, 0))
+
+    # The current pixel advances by delta + count - 1 per token and is reset by time tokens.
+    advance = np.cumsum(delta + np.maximum(count - 1, 0))
+    last_time = np.maximum.accumulate(np.where(is_time, np.arange(len(values)), -1))
+    end_pixel = advance - np.where(last_time >= 0, advance[np.maximum(last_time, 0)], 0)
+    first_pixel = end_pixel - (count - 1)
+
+    event_token = np.repeat(np.arange(len(values)), count)
+    offset = np.arange(len(event_token)) - np.repeat(np.cumsum(count) - count, count)
+    pixel = first_pixel[event_token] + offset
+    addresses = (pixel * 2 + ((values[event_token] >> 2) & 1).astype(np.int64)).astype(np.uint32)
+    return time[event_token].astype(np.uint32), addresses
+
+
+class EventStream:
+    def __init__(self, path):
+        self.path = path
+        self.data = np.memmap(path, dtype=np.uint8, mode='r')
+        header_size = struct.calcsize(HEADER_FORMAT)
+        if len(self.data) < header_size:
+            raise ValueError(f"{path} is too small to be an event stream file")
+        magic, version, self.width, self.height, self.time_scale, self.encoding, self.polarity = struct.unpack_from(HEADER_FORMAT, self.data, 0)
+        if magic != FILE_MAGIC or version != FILE_VERSION:
+            raise ValueError(f"{path} is not an event stream file (version {FILE_VERSION})")
+
+        self.recovered = False
+        self.index = self._read_index(header_size)
+        if self.index is None:
+            self.index = self._rebuild_index(header_size)
+            self.recovered = True
+        self._timestamps = self.index['timestamp'].tolist()
+
+    def _read_index(self, header_size):
+        footer_size = struct.calcsize(FOOTER_FORMAT)
+        if len(self.data) < header_size + footer_size:
+            return None
+        index_offset, chunk_count, magic = struct.unpack_from(FOOTER_FORMAT, self.data, len(self.data) - footer_size)
+        if magic != INDEX_MAGIC or index_offset + chunk_count * INDEX_ENTRY_DTYPE.itemsize + footer_size != len(self.data):
+            return None
+        return np.frombuffer(self.data, dtype=INDEX_ENTRY_DTYPE, count=chunk_count, offset=index_offset)
+
+    def _rebuild_index(self, header_size):
+        # The run was interrupted before the index was written, scan the chunk headers instead.
+        chunk_header_size = struct.calcsize(CHUNK_HEADER_FORMAT)
+        entries = []
+        offset = header_size
+        while offset + chunk_header_size <= len(self.data):
+            magic, frame, timestamp, event_count, padding, size = struct.unpack_from(CHUNK_HEADER_FORMAT, self.data, offset)
+            if magic != CHUNK_MAGIC or offset + chunk_header_size + size + padding > len(self.data):
+                break
+            entries.append((frame, event_count, timestamp, offset + chunk_header_size, size))
+            offset += chunk_header_size + size + padding
+        return np.array(entries, dtype=INDEX_ENTRY_DTYPE)
+
+    def __len__(self):
+        return len(self.index)
+
+    def find_chunks(self, begin_timestamp, end_timestamp):
+        """Return the range of chunk indices with timestamps in [begin_timestamp, end_timestamp)."""
+        begin = bisect.bisect_left(self._timestamps, begin_timestamp)
+        end = max(begin, bisect.bisect_left(self._timestamps, end_timestamp))
+        return begin, end
+
+    def raw_chunk(self, i):
+        """Return the undecoded payload of chunk i without copying."""
+        entry = self.index[i]
+        dtype = {ENCODING_ADDRESS32: np.uint32, ENCODING_FRAME_ADDRESS64: np.dtype((np.uint32, 2))}.get(self.encoding, np.uint8)
+        count = int(entry['size']) // np.dtype(dtype).itemsize
+        return np.frombuffer(self.data, dtype=dtype, count=count, offset=int(entry['offset']))
+
+    def addresses(self, i):
+        """Return the (t, address) arrays of chunk i. Addresses are (y * width + x) * 2 + polarity bit."""
+        raw = self.raw_chunk(i)
+        if self.encoding == ENCODING_ADDRESS32:
+            return np.full(len(raw), self.index[i]['timestamp'], dtype=np.uint32), raw.astype(np.uint32)
+        if self.encoding == ENCODING_FRAME_ADDRESS64:
+            return raw[:, 0].astype(np.uint32), raw[:, 1].astype(np.uint32)
+        return decode_compact(raw)
+
+    def chunk(self, i):
+        """Decode chunk i into (x, y, t, p) arrays. p is 1 for ON events and 0 for OFF events."""
+        t, addr = self.addresses(i)
+        p = addr & 1
+        if self.polarity == POLARITY_EVEN_IS_ON:
+            p ^= 1
+        addr = addr >> 1
+        return addr % self.width, addr // self.width, t, p
+
+    def events(self, begin_timestamp=0, end_timestamp=None):
+        """Decode all events of the chunks with timestamps in [begin_timestamp, end_timestamp)."""
+        if end_timestamp is None:
+            end_timestamp = np.iinfo(np.uint64).max
+        begin, end = self.find_chunks(begin_timestamp, end_timestamp)
+        chunks = [self.chunk(i) for i in range(begin, end)]
+        if not chunks:
+            empty = np.zeros(0, dtype=np.uint32)
+            return empty, empty, empty, empty
+        return tuple(np.concatenate(c) for c in zip(*chunks))
+
+
+def stitch(shards, output_path):
+    """Concatenate the event streams of the shards of a sequence into one stream.
+
+    shards is a list of (path, begin_frame, end_frame) tuples with consecutive frame ranges, end_frame None for no
+    limit. Only the chunks of the frames in the range of their shard are copied, which drops the warm-up frames. The
+    payloads are copied without decoding. Returns the number of chunks written.
+    """
+    streams = [(EventStream(path), begin, end) for path, begin, end in shards]
+    first = streams[0][0]
+    for (stream, begin, _), (_, _, prev_end) in zip(streams[1:], streams[:-1]):
+        if prev_end is None or prev_end != begin:
+            raise ValueError(f"shard {stream.path} starts at frame {begin}, the previous shard ends at frame {prev_end}")
+        if (stream.width, stream.height, stream.time_scale, stream.encoding, stream.polarity) != \
+                (first.width, first.height, first.time_scale, first.encoding, first.polarity):
+            raise ValueError(f"shard {stream.path} has a different header than {first.path}")
+
+    entries = []
+    last_timestamp = 0
+    with open(output_path, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, FILE_MAGIC, FILE_VERSION, first.width, first.height, first.time_scale, first.encoding, first.polarity))
+        offset = struct.calcsize(HEADER_FORMAT)
+        for stream, begin, end in streams:
+            for i, entry in enumerate(stream.index):
+                frame = int(entry['frame'])
+                if frame < begin or (end is not None and frame >= end):
+                    continue
+                timestamp = int(entry['timestamp'])
+                if timestamp < last_timestamp:
+                    raise ValueError(f"chunk of frame {frame} in {stream.path} has a decreasing timestamp")
+                last_timestamp = timestamp
+                size = int(entry['size'])
+                padding = (8 - size % 8) % 8
+                f.write(struct.pack(CHUNK_HEADER_FORMAT, CHUNK_MAGIC, frame, timestamp, int(entry['event_count']), padding, size))
+                f.write(stream.raw_chunk(i).tobytes())
+                f.write(bytes(padding))
+                offset += struct.calcsize(CHUNK_HEADER_FORMAT)
+                entries.append((frame, int(entry['event_count']), timestamp, offset, size))
+                offset += size + padding
+        f.write(np.array(entries, dtype=INDEX_ENTRY_DTYPE).tobytes())
+        f.write(struct.pack(FOOTER_FORMAT, offset, len(entries), INDEX_MAGIC))
+    return len(entries)
@@ -0,0 +1,51 @@
+import numpy as np
+import os
+import struct
+
+# Pixel series files written by BlockStoragePass (see Source/Falcor/Utils/BlockStorage/PixelSeries.h).
+SERIES_FILENAME = 'series.fps'
+FILE_MAGIC = 0x53585046  # 'FPXS'
+FILE_VERSION = 1
+HEADER_FORMAT = '<8I32x'
+
+
+def find_series(path):
+    """Return the series path if path is a series file or a directory containing one, otherwise None."""
+    if os.path.isdir(path):
+        path = os.path.join(path, SERIES_FILENAME)
+    return path if os.path.isfile(path) else None
+
+
+class PixelSeries:
+    """Pixel-major frames: the time series of every pixel is stored contiguously, grouped into chunks of pixels."""
+
+    def __init__(self, path):
+        self.path = path
+        self.data = np.memmap(path, dtype=np.uint8, mode='r')
+        header_size = struct.calcsize(HEADER_FORMAT)
+        magic, version, width, height, chunk_width, chunk_height, frame_count, channels = struct.unpack_from(HEADER_FORMAT, self.data)
+        if magic != FILE_MAGIC or version != FILE_VERSION:
+            raise ValueError(f"{path} is not a pixel series file or has an unsupported version")
+        self.frame_dim = (width, height)
+        self.chunk_size = (chunk_width, chunk_height)
+        self.frame_count = frame_count
+        self.channels = channels
+        if len(self.data) != header_size + width * height * frame_count * channels * 4:
+            raise ValueError(f"{path} is incomplete")
+        self.values = self.data[header_size:].view(np.float32)
+
+    def _pixel_index(self, x, y):
+        # Chunks are clipped to the frame and stored in row-major order, as are the pixels within a chunk.
+        ox = x // self.chunk_size[0] * self.chunk_size[0]
+        oy = y // self.chunk_size[1] * self.chunk_size[1]
+        w = min(self.chunk_size[0], self.frame_dim[0] - ox)
+        h = min(self.chunk_size[1], self.frame_dim[1] - oy)
+        return oy * self.frame_dim[0] + ox * h + (y - oy) * w + (x - ox)
+
+    def series(self, x, y):
+        """Return a read-only view of the time series of a pixel with shape (frame_count, channels)."""
+        if not (0 <= x < self.frame_dim[0] and 0 <= y < self.frame_dim[1]):
+            raise IndexError(f"Pixel ({x}, {y}) out of bounds")
+        size = self.frame_count * self.channels
+        start = self._pixel_index(x, y) * size
+        return self.values[start:start + size].reshape(self.frame_count, self.channels)
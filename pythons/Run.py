@@ -51,6 +51,9 @@ def run(args):
     time_scale = script_config.get('timeScale', 10000.0)
     exit_frame = script_config.get('exitFrame', 0)
     accumulatePass = script_config.get('accumulatePass', 1)
+    adaptive_sampling = script_config.get('adaptiveSampling', False)
+    target_samples = script_config.get('targetSamples', samples_per_pixel)
+    tile_activity = script_config.get('tileActivity', False)
 
     if not os.path.exists(os.path.join('/mnt/ssd2/jinfan/EventDataset', directory)):
         os.makedirs(os.path.join('/mnt/ssd2/jinfan/EventDataset', directory))
@@ -78,6 +81,9 @@ def run(args):
         "BLOCK_STORAGE_ENABLED": enable_block_storage,
         "TIME_SCALE": time_scale,
         "ACCUMULATE_PASS": accumulatePass,
+        "ADAPTIVE_SAMPLING": adaptive_sampling,
+        "TARGET_SAMPLES": target_samples,
+        "TILE_ACTIVITY": tile_activity,
         "DIRECTORY": f"/mnt/ssd2/jinfan/EventDataset/{directory}"
     }
     TemplateInstantiate.instantiate_template(template_path, script_output, parameters)
@@ -0,0 +1,130 @@
+import os
+import yaml
+import subprocess
+import argparse
+import TemplateInstantiate
+import EventStream
+import time
+from pathlib import Path
+from Dataset import root_dir, scenes
+
+# Renders the Network or Denoise event stream of a scene in shards of consecutive frames and stitches their streams.
+# Every shard starts a number of warm-up frames before its first frame to rebuild the pass state, or, with --resume,
+# restores the checkpoint saved by the previous shard, which continues the pass state of a single run exactly.
+# Shards can run on several machines with --shard, the stitching is run once all shards are done with --stitch.
+
+stages = {
+    'network': ('NetworkScriptTemplate.py', 'bin'),
+    'denoise': ('DenoiseScriptTemplate.py', 'denoise'),
+}
+
+
+def get_shard_ranges(frame_count, shard_count):
+    """Split the frames [1, frame_count] into consecutive [begin, end) ranges."""
+    bounds = [1 + frame_count * k // shard_count for k in range(shard_count + 1)]
+    return list(zip(bounds[:-1], bounds[1:]))
+
+
+def get_shard_dir(directory, stage, k):
+    return os.path.join(directory, 'shards', f"{stage}-{k}")
+
+
+def run_shard(args, config, scene_index, k):
+    build_type = config.get('build', 'Release')
+    assert(build_type in ['Release', 'Debug'])
+    mogwai_path = os.path.join(root_dir, 'build', 'windows-ninja-msvc', 'bin', build_type, 'Mogwai')
+    width = config.get('width', 0)
+    height = config.get('height', 0)
+    scene = scenes[scene_index]
+
+    script_config = config.get('script', {})
+    directory = os.path.join(root_dir, "..\\Dataset", Path(scene).stem)
+    template_name, output_dir = stages[args.stage]
+    template_path = os.path.join(root_dir, 'scripts', template_name)
+
+    network_time_scale = script_config.get('networkTimeScale', 10000.0)
+    exit_time = 20 if scene_index <= 2 else 10
+    accumulatePass = script_config.get('accumulatePass', 1)
+    frame_count = int(exit_time * network_time_scale)
+    begin, end = get_shard_ranges(frame_count, args.shards)[k]
+
+    # Frames are counted after the accumulation, the first frame of the sequence is 1.
+    shard_dir = get_shard_dir(directory, args.stage, k)
+    os.makedirs(os.path.join(shard_dir, output_dir), exist_ok=True)
+    load_checkpoint = ""
+    if args.resume and k > 0:
+        load_checkpoint = Path(get_shard_dir(directory, args.stage, k - 1), 'checkpoint.bin').as_posix()
+        if not os.path.exists(load_checkpoint):
+            raise FileNotFoundError(f"shard {k - 1} has no checkpoint, run the shards in order with --resume")
+        start = begin
+    else:
+        start = max(1, begin - args.warmup)
+
+    parameters = {
+        "ACCUMULATE_PASS": accumulatePass,
+        "DIRECTORY": Path(shard_dir).as_posix(),
+        "NETWORK_MODEL": script_config.get('networkModel'),
+        "BATCH_SIZE": script_config.get('batchSize', 64),
+        "TAU": script_config.get('tau'),
+        "VTHRESHOLD": script_config.get('vThreshold'),
+        "NETWORK_TIME_SCALE": network_time_scale,
+        "START_FRAME": (start - 1) * accumulatePass,
+        "NETWORK_EXIT_FRAME": (end - 1) * accumulatePass,
+        "FRAME_OFFSET": start - 1,
+        "BEGIN_FRAME": begin,
+        "END_FRAME": end,
+        "LOAD_CHECKPOINT": load_checkpoint,
+        "SAVE_CHECKPOINT": Path(shard_dir, 'checkpoint.bin').as_posix(),
+    }
+    script = os.path.join(shard_dir, f"{args.stage}.py")
+    TemplateInstantiate.instantiate_template(template_path, script, parameters)
+
+    verbosity = config.get('verbosity', 2)
+    assert(verbosity in [0, 1, 2, 3, 4, 5])
+    cmd = [mogwai_path, f"--script={script}", f"--scene={scene}", f"--verbosity={verbosity}", "--deferred", f"--width={width}", f"--height={height}"]
+    if config.get('headless', False):
+        cmd.append("--headless")
+
+    print(f"Running shard {k} (frames {begin} to {end - 1}, starting at {start}): {' '.join(cmd)}")
+    start_time = time.time()
+    subprocess.run(cmd, check=True)
+    execution_time = time.time() - start_time
+    print(f"Shard {k} completed in {execution_time:.2f} seconds ({execution_time/60:.2f} minutes).")
+
+
+def stitch(args, config, scene_index):
+    script_config = config.get('script', {})
+    directory = os.path.join(root_dir, "..\\Dataset", Path(scenes[scene_index]).stem)
+    _, output_dir = stages[args.stage]
+    network_time_scale = script_config.get('networkTimeScale', 10000.0)
+    exit_time = 20 if scene_index <= 2 else 10
+    frame_count = int(exit_time * network_time_scale)
+
+    shards = []
+    for k, (begin, end) in enumerate(get_shard_ranges(frame_count, args.shards)):
+        shards.append((os.path.join(get_shard_dir(directory, args.stage, k), output_dir, 'events.evs'), begin, end))
+    os.makedirs(os.path.join(directory, output_dir), exist_ok=True)
+    output_path = os.path.join(directory, output_dir, 'events.evs')
+    chunk_count = EventStream.stitch(shards, output_path)
+    print(f"Stitched {chunk_count} chunks of {len(shards)} shards into {output_path}.")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Render an event stream in shards of frames.")
+    parser.add_argument('--config', type=str, default="config/default.yaml", help='Path to the YAML configuration file.')
+    parser.add_argument('--scene', type=int, default=0, help='Scene index to run.')
+    parser.add_argument('--stage', type=str, default='network', choices=stages.keys(), help='Event pass to run.')
+    parser.add_argument('--shards', type=int, default=4, help='Number of shards the sequence is split into.')
+    parser.add_argument('--warmup', type=int, default=64, help='Frames rendered before the first frame of a shard.')
+    parser.add_argument('--resume', action='store_true', help="Restore the previous shard's checkpoint instead of warming up.")
+    parser.add_argument('--shard', type=int, default=None, help='Only run this shard.')
+    parser.add_argument('--stitch', action='store_true', help='Only stitch the event streams of the shards.')
+    args = parser.parse_args()
+
+    with open(args.config, 'r') as file:
+        config = yaml.safe_load(file)
+    if not args.stitch:
+        for k in ([args.shard] if args.shard is not None else range(args.shards)):
+            run_shard(args, config, args.scene, k)
+    if args.stitch or args.shard is None:
+        stitch(args, config, args.scene)
@@ -4,9 +4,16 @@ import torch
 import os
 import math
 from collections import OrderedDict
+from BlockArchive import BlockArchive, find_archive
+from PixelSeries import PixelSeries, find_series
+
+try:
+    import falcor
+except ImportError:
+    falcor = None
 
 class TileBasedStorage:
-    def __init__(self, tile_size, tile_count, directory_path, max_cache_size=500, data_format="rgba"):
+    def __init__(self, tile_size, tile_count, directory_path, max_cache_size=500, data_format="rgba", use_native=True):
         self.tile_size = tile_size  # [x, y, z]
         self.tile_count = tile_count  # [x, y, z]
         self.directory_path = directory_path
@@ -20,6 +27,27 @@ class TileBasedStorage:
         self.data_format = data_format.lower()
         if self.data_format not in ["rgba", "int8"]:
             raise ValueError("data_format must be either 'rgba' or 'int8'")
+        # Blocks are read from a single archive if the directory contains one, otherwise from per-block files.
+        archive_path = find_archive(directory_path)
+        self.archive = BlockArchive(archive_path) if archive_path else None
+        # Archives record their format, blocks are returned as float values with the format's channel count.
+        self.channels = 4 if self.data_format == "rgba" else 1
+        if self.archive is not None:
+            self.channels = self.archive.channels
+        # Pixel time series are read from the pixel-major copy of the frames if the directory contains one.
+        series_path = find_series(directory_path)
+        self.series = PixelSeries(series_path) if series_path else None
+        # Queries are served by Falcor's native reader if the falcor module is available.
+        # It gathers the blocks on worker threads and returns numpy arrays, the cache is bounded by the same number of blocks.
+        self.native = None
+        if use_native and falcor is not None and (self.archive is not None or self.data_format == "rgba"):
+            self.native = falcor.BlockStorageReader(
+                directory_path,
+                frame_dim=falcor.uint3(*self.frame_dim),
+                block_size=falcor.uint3(*tile_size),
+                format=falcor.BlockFormat.RGBA32Float,
+                cache_budget=max_cache_size * tile_size[0] * tile_size[1] * tile_size[2] * self.channels * 4,
+            )
 
     def _update_cache(self, key):
         """Update position of a key in cache, moving recently used item to the end"""
@@ -39,7 +67,12 @@ class TileBasedStorage:
             self._update_cache(key)
             return self.cached_tiles[key]
 
-        if os.path.exists(filename):
+        data = None
+        if self.archive is not None:
+            # Copy out of the read-only mapping, the cache keeps the block alive.
+            data = self.archive.values(bx, by, bz)
+            data = None if data is None else np.array(data)
+        elif os.path.exists(filename):
             with open(filename, "rb") as f:
                 if self.data_format == "rgba":
                     data = np.fromfile(f, dtype=np.float32)
@@ -54,19 +87,20 @@ class TileBasedStorage:
                         self.tile_size[2], self.tile_size[1], self.tile_size[0], 1
                     )
 
-                tensor = torch.from_numpy(data)
+        if data is not None:
+            tensor = torch.from_numpy(data)
 
-                # Check cache size, remove least recently used if full
-                if len(self.cached_tiles) >= self.max_cache_size:
-                    self.cached_tiles.popitem(last=False)  # Remove the first (oldest) item
+            # Check cache size, remove least recently used if full
+            if len(self.cached_tiles) >= self.max_cache_size:
+                self.cached_tiles.popitem(last=False)  # Remove the first (oldest) item
 
-                self.cached_tiles[key] = tensor
-                return tensor
+            self.cached_tiles[key] = tensor
+            return tensor
         else:
             # Return zeros if block doesn't exist
-            if self.data_format == "rgba":
+            if self.archive is not None or self.data_format == "rgba":
                 return torch.zeros(
-                    (self.tile_size[2], self.tile_size[1], self.tile_size[0], 4)
+                    (self.tile_size[2], self.tile_size[1], self.tile_size[0], self.channels)
                 )
             else:  # int8
                 return torch.zeros(
@@ -93,8 +127,33 @@ class TileBasedStorage:
         block = self._load_block(bx, by, bz)
         return block[lz, ly, lx]
 
+    def _get_native(self, x, y, z):
+        """Dynamic accessor using the native reader"""
+        dim = self.native.dim
+        if x is not None and y is not None and z is not None:
+            return torch.from_numpy(self.native.voxel(x, y, z))
+        elif x is not None and y is not None:
+            return torch.from_numpy(self.native.column(x, y))
+        elif z is not None and x is None and y is None:
+            return torch.from_numpy(self.native.slice(z))[:720, :1280, :]
+        elif x is None and y is None:
+            raise ValueError("At least one dimension must be specified")
+
+        # Lines and planes are read as boxes spanning the unspecified dimensions.
+        origin = falcor.uint3(x or 0, y or 0, z or 0)
+        size = falcor.uint3(1 if x is not None else dim.x, 1 if y is not None else dim.y, 1 if z is not None else dim.z)
+        box = torch.from_numpy(self.native.box(origin, size))
+        if z is not None:
+            return box.reshape(-1, self.channels)
+        return box[:, :, 0] if x is not None else box[:, 0, :]
+
     def get(self, x=None, y=None, z=None):
         """Dynamic accessor based on specified dimensions"""
+        if self.series is not None and x is not None and y is not None and z is None:
+            return torch.from_numpy(np.array(self.series.series(x, y)))
+        if self.native is not None:
+            return self._get_native(x, y, z)
+
         if x is not None and y is not None and z is not None:
             # Single voxel
             return self.get_voxel(x, y, z)
@@ -134,7 +193,7 @@ class TileBasedStorage:
 
         elif x is not None:
             # Get YZ plane
-            result = torch.zeros((self.frame_dim[2], self.frame_dim[1], self.data_format == "rgba" and 4 or 1))
+            result = torch.zeros((self.frame_dim[2], self.frame_dim[1], self.channels))
             bx = x // self.tile_size[0]
             lx = x % self.tile_size[0]
 
@@ -156,7 +215,7 @@ class TileBasedStorage:
 
         elif y is not None:
             # Get XZ plane
-            result = torch.zeros((self.frame_dim[2], self.frame_dim[0], self.data_format == "rgba" and 4 or 1))
+            result = torch.zeros((self.frame_dim[2], self.frame_dim[0], self.channels))
             by = y // self.tile_size[1]
             ly = y % self.tile_size[1]
 
@@ -178,7 +237,7 @@ class TileBasedStorage:
 
         elif z is not None:
             # Get XY plane (frame)
-            result = torch.zeros((self.frame_dim[1], self.frame_dim[0], self.data_format == "rgba" and 4 or 1))
+            result = torch.zeros((self.frame_dim[1], self.frame_dim[0], self.channels))
             bz = z // self.tile_size[2]
             lz = z % self.tile_size[2]
 
@@ -205,9 +264,13 @@ class TileBasedStorage:
     def clear_cache(self):
         """Clear the entire cache"""
         self.cached_tiles.clear()
+        if self.native is not None:
+            self.native.clear_cache()
 
     def get_cache_info(self):
         """Return cache information"""
+        if self.native is not None:
+            return self.native.get_stats()
         return {
             "current_size": len(self.cached_tiles),
             "max_size": self.max_cache_size
@@ -9,6 +9,7 @@ import argparse
 import yaml
 import struct
 from Run import run
+from EventStream import EventStream
 
 work_dir = r"C:\\Users\\pengfei\\workspace"
 video_width = 1280
@@ -23,8 +24,14 @@ def create_video_from_bin():
     time_window_ms = script_config.get('timeScale', 10000) / 60 # it should be the video fps
     # need_accumulated_events = script_config.get('needAccumulatedEvents', 100)
 
-    bin_files = sorted(glob(os.path.join(output_dir, "data-*.bin")),
-                       key=lambda x: int(x.split('-')[-1].split('.')[0]))
+    stream_path = os.path.join(output_dir, "events.evs")
+    if os.path.isfile(stream_path):
+        stream = EventStream(stream_path)
+        frames = [stream.addresses(i)[1] for i in range(len(stream))]
+    else:
+        bin_files = sorted(glob(os.path.join(output_dir, "data-*.bin")),
+                           key=lambda x: int(x.split('-')[-1].split('.')[0]))
+        frames = [np.fromfile(bin_file, dtype=np.uint32) for bin_file in bin_files]
 
     fourcc = cv2.VideoWriter_fourcc(*'mp4v')
     video_output = os.path.join(work_dir, "output", config.get('outputFile') + ".mp4")
@@ -34,8 +41,7 @@ def create_video_from_bin():
 
     events = []
     event_frame = np.zeros((video_height, video_width), dtype=np.uint8)
-    for frame_idx, bin_file in enumerate(tqdm(bin_files, desc="Processing bin files")):
-        data = np.fromfile(bin_file, dtype=np.uint32)
+    for frame_idx, data in enumerate(tqdm(frames, desc="Processing bin files")):
         for value in data:
             pol = value % 2
             value //= 2
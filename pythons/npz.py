@@ -4,6 +4,7 @@ from pathlib import Path
 import argparse
 from tqdm import tqdm
 import re
+from EventStream import EventStream
 
 def load_events(file_path, width):
     data = np.fromfile(file_path, dtype=np.uint32)
@@ -16,17 +17,43 @@ def load_events(file_path, width):
     x = addr % width
     return x, y, timestamps, polarity
 
-def process_files(input_dir, pattern, width, height, save_npz, show):
+def find_stream(input_path):
+    path = Path(input_path)
+    if path.is_file() and path.suffix == '.evs':
+        return path
+    if (path / 'events.evs').is_file():
+        return path / 'events.evs'
+    return None
+
+def iterate_stream(stream):
+    for i in range(len(stream)):
+        yield f"frame {stream.index[i]['frame']}", stream.chunk(i)
+
+def iterate_files(input_dir, pattern, width):
     files = sorted(Path(input_dir).glob(pattern), key=lambda f: int(re.findall(r'\d+', f.stem)[0]))
+    for f in files:
+        yield f.name, load_events(f, width)
+
+def process_files(input_dir, pattern, width, height, save_npz, show):
+    stream_path = find_stream(input_dir)
+    if stream_path is not None:
+        stream = EventStream(stream_path)
+        if stream.recovered:
+            print(f"Warning: {stream_path} has no index, it was rebuilt from the chunk headers")
+        width, height = stream.width, stream.height
+        input_dir = stream_path.parent
+        chunks = iterate_stream(stream)
+        chunk_count = len(stream)
+    else:
+        chunks = iterate_files(input_dir, pattern, width)
+        chunk_count = len(list(Path(input_dir).glob(pattern)))
 
     all_x = []
     all_y = []
     all_t = []
     all_p = []
 
-    for f in tqdm(files, desc="Processing files"):
-        x, y, t, p = load_events(f, width)
-
+    for name, (x, y, t, p) in tqdm(chunks, total=chunk_count, desc="Processing files"):
         all_x.append(x)
         all_y.append(y)
         all_t.append(t)
@@ -42,7 +69,7 @@ def process_files(input_dir, pattern, width, height, save_npz, show):
 
             plt.figure(figsize=(10, 6))
             plt.imshow(canvas)
-            plt.title(f.name)
+            plt.title(name)
             plt.axis('off')
             plt.show()
 
@@ -60,7 +87,7 @@ def process_files(input_dir, pattern, width, height, save_npz, show):
 
 def main():
     parser = argparse.ArgumentParser()
-    parser.add_argument('--input_dir', type=str, default=r'F:\output', help='Directory containing .bin files')
+    parser.add_argument('--input_dir', type=str, default=r'F:\output', help='Directory containing .bin files or an events.evs stream, or the path of a .evs stream')
     parser.add_argument('--pattern', type=str, default='data-*.bin', help='Filename pattern to match')
     parser.add_argument('--width', type=int, default=1280, help='Sensor width in pixels')
     parser.add_argument('--height', type=int, default=720, help='Sensor height in pixels')
@@ -1,5 +1,6 @@
 #!/usr/bin/env python
 # Script to process event camera data using TileToEXR and v2e
+# DenoisePass can apply the DVS non-idealities in-engine instead (sensorModel property), without the EXR round trip.
 
 import os
 import subprocess
@@ -0,0 +1,158 @@
+from falcor import *
+import json
+import time
+
+# Event pipeline benchmark, instantiated by pythons/Benchmark.py.
+# Every variant renders the benchmark scene for a number of warm-up frames, then the measured frames while the
+# profiler is capturing. The per-pass CPU/GPU times, the event throughput and the memory of the render graph
+# resources are written to a JSON report.
+
+frame_count = $FRAMES$
+warmup_count = $WARMUP$
+variants = $VARIANTS$
+directory = "$DIRECTORY$"
+report_path = "$REPORT$"
+network_model = "$NETWORK_MODEL$"
+network_backend = "$NETWORK_BACKEND$"
+
+def add_path_tracer(g):
+    PathTracer = createPass("PathTracer", {
+        'samplesPerPixel': 1,
+        'useNRDDemodulation': False,
+        'maxTransmissionBounces': 0,
+    })
+    g.addPass(PathTracer, "PathTracer")
+    VBufferRT = createPass("VBufferRT", {'samplePattern': 'Stratified', 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, "VBufferRT")
+    AccumulatePass = createPass("AccumulatePass", {'enabled': True, 'precisionMode': 'Single'})
+    g.addPass(AccumulatePass, "AccumulatePass")
+
+    g.addEdge("VBufferRT.vbuffer", "PathTracer.vbuffer")
+    g.addEdge("VBufferRT.viewW", "PathTracer.viewW")
+    g.addEdge("VBufferRT.mvec", "PathTracer.mvec")
+    g.addEdge("PathTracer.color", "AccumulatePass.input")
+
+def create_graph(variant):
+    """Create the render graph of a variant. Returns the graph and the name of its event pass."""
+    g = RenderGraph(f"Benchmark{variant}")
+    add_path_tracer(g)
+    output_dir = f"{directory}/{variant}"
+    if variant == 'Compress':
+        ErrorMeasurePass = createPass("ErrorMeasurePass", {'threshold': 0.5})
+        g.addPass(ErrorMeasurePass, "ErrorMeasurePass")
+        g.addEdge("PathTracer.color", "ErrorMeasurePass.Reference")
+        g.addEdge("PathTracer.color", "ErrorMeasurePass.Source")
+        CompressPass = createPass("CompressPass", {'directory': output_dir})
+        g.addPass(CompressPass, "CompressPass")
+        g.addEdge("ErrorMeasurePass.Output", "CompressPass.input")
+        g.markOutput("CompressPass.output")
+        return g, "CompressPass"
+    if variant == 'Denoise':
+        DenoisePass = createPass("DenoisePass", {'directory': output_dir, 'window': 10})
+        g.addPass(DenoisePass, "DenoisePass")
+        g.addEdge("AccumulatePass.output", "DenoisePass.input")
+        g.markOutput("DenoisePass.output")
+        return g, "DenoisePass"
+    if variant == 'Network':
+        Network = createPass("Network", {
+            'model_path': network_model,
+            'backend': network_backend,
+            'networkInputLength': 43,
+            'directory': output_dir,
+        })
+        g.addPass(Network, "Network")
+        g.addEdge("AccumulatePass.output", "Network.input")
+        g.markOutput("Network.output")
+        return g, "Network"
+    if variant == 'BlockStorage':
+        BlockStoragePass = createPass("BlockStoragePass", {'directory': output_dir})
+        g.addPass(BlockStoragePass, "BlockStoragePass")
+        g.addEdge("AccumulatePass.output", "BlockStoragePass.input")
+        g.markOutput("BlockStoragePass.output")
+        return g, "BlockStoragePass"
+    raise ValueError(f"Unknown variant '{variant}'")
+
+def get_stages(capture):
+    """Mean CPU and GPU time in ms of each render pass and the counters it sets, from the profiler capture."""
+    stages = {}
+    for name, event in capture["events"].items():
+        parts = name.strip('/').split('/')
+        if "RenderGraphExe::execute()" not in parts:
+            continue
+        i = parts.index("RenderGraphExe::execute()")
+        if len(parts) != i + 3:
+            continue
+        stage = stages.setdefault(parts[i + 1], {})
+        if parts[i + 2] in ("cpuTime", "gpuTime"):
+            stage[parts[i + 2]] = event["stats"]["mean"]
+        elif event["records"]:
+            # Counters such as the blocks written are cumulative, so the last frame is reported next to the mean.
+            stage.setdefault('counters', {})[parts[i + 2]] = {'mean': event["stats"]["mean"], 'last': event["records"][-1]}
+    return stages
+
+def run_variant(variant):
+    g, event_pass = create_graph(variant)
+    m.addGraph(g)
+    m.clock.frame = 0
+    for _ in range(warmup_count):
+        renderFrame()
+    begin_stats = g.getPass(event_pass).stats
+
+    m.profiler.enabled = True
+    m.profiler.startCapture()
+    start_time = time.perf_counter()
+    for _ in range(frame_count):
+        renderFrame()
+    if variant == 'BlockStorage':
+        g.getPass(event_pass).flush()
+    seconds = time.perf_counter() - start_time
+    capture = m.profiler.endCapture()
+    m.profiler.enabled = False
+
+    # Events are written asynchronously, the frames still in flight are not counted.
+    end_stats = g.getPass(event_pass).stats
+    stats = {key: end_stats[key] - begin_stats[key] for key in end_stats}
+    memory = g.get_resource_memory_stats()
+    m.removeGraph(g)
+
+    events = stats.get('events', 0)
+    return {
+        'frames': frame_count,
+        'seconds': seconds,
+        'framesPerSecond': frame_count / seconds,
+        'events': events,
+        'eventsPerSecond': events / seconds,
+        'bytesWritten': stats['bytes_stored'],
+        'bytesWrittenPerSecond': stats['bytes_stored'] / seconds,
+        'readbackStalls': stats['stalls'],
+        'stages': get_stages(capture),
+        'frameTime': {
+            'cpuTime': capture["events"].get("/onFrameRender/cpuTime", {}).get("stats", {}).get("mean"),
+            'gpuTime': capture["events"].get("/onFrameRender/gpuTime", {}).get("stats", {}).get("mean"),
+        },
+        # Render graph resources are allocated once per compilation, so this is also their peak memory.
+        'peakMemory': {
+            'graphAllocatedBytes': memory['allocated_bytes'],
+            'graphRequiredBytes': memory['required_bytes'],
+        },
+        'passStats': stats,
+    }
+
+m.loadScene("$SCENE$")
+m.resizeFrameBuffer($WIDTH$, $HEIGHT$)
+report = {
+    'mode': 'gpu',
+    'scene': "$SCENE$",
+    'width': $WIDTH$,
+    'height': $HEIGHT$,
+    'frames': frame_count,
+    'warmup': warmup_count,
+    'variants': {},
+}
+for variant in variants:
+    report['variants'][variant] = run_variant(variant)
+    print(f"{variant}: {report['variants'][variant]['framesPerSecond']:.1f} frames/s")
+
+with open(report_path, 'w') as file:
+    json.dump(report, file, indent=4)
+exit()
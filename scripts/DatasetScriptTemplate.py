@@ -34,6 +34,7 @@ def render_graph_PathTracer():
     CompressPass = createPass("CompressPass", {
         'enabled': $ENABLED$,
         'directory': "$DIRECTORY$",
+        'timeScale': $TIME_SCALE$ * $ACCUMULATE_PASS$,
     })
     g.addPass(CompressPass, "CompressPass")
     g.addEdge("ErrorMeasurePass.Output", "CompressPass.input")
@@ -22,6 +22,12 @@ def render_graph_PathTracer():
         'accumulatePass': $ACCUMULATE_PASS$,
         'directory': "$DIRECTORY$\\denoise",
         "window": 10,
+        'timeScale': $NETWORK_TIME_SCALE$,
+        'frameOffset': $FRAME_OFFSET$,
+        'beginFrame': $BEGIN_FRAME$,
+        'endFrame': $END_FRAME$,
+        'loadCheckpoint': "$LOAD_CHECKPOINT$",
+        'saveCheckpoint': "$SAVE_CHECKPOINT$",
     })
     g.addPass(DenoisePass, "DenoisePass")
 
@@ -35,4 +41,5 @@ try: m.addGraph(PathTracer)
 except NameError: None
 
 m.clock.timeScale = $NETWORK_TIME_SCALE$
+m.clock.frame = $START_FRAME$
 m.clock.exitFrame = $NETWORK_EXIT_FRAME$
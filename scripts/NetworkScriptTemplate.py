@@ -28,6 +28,12 @@ def render_graph_PathTracer():
         'directory': "$DIRECTORY$\\bin",
         'tau': $TAU$,
         'threshold': $VTHRESHOLD$,
+        'timeScale': $NETWORK_TIME_SCALE$,
+        'frameOffset': $FRAME_OFFSET$,
+        'beginFrame': $BEGIN_FRAME$,
+        'endFrame': $END_FRAME$,
+        'loadCheckpoint': "$LOAD_CHECKPOINT$",
+        'saveCheckpoint': "$SAVE_CHECKPOINT$",
     })
     g.addPass(Network, "Network")
 
@@ -45,4 +51,5 @@ try: m.addGraph(PathTracer)
 except NameError: None
 
 m.clock.timeScale = $NETWORK_TIME_SCALE$
+m.clock.frame = $START_FRAME$
 m.clock.exitFrame = $NETWORK_EXIT_FRAME$
@@ -25,6 +25,7 @@ def render_graph_PathTracer():
     DenoisePass = createPass("DenoisePass", {
         'accumulatePass': 1,
         'directory': "$DIRECTORY$\\optix",
+        'timeScale': $NETWORK_TIME_SCALE$,
     })
     g.addPass(DenoisePass, "DenoisePass")
 
@@ -51,6 +51,25 @@ def render_graph_PathTracer():
 
     g.markOutput("AccumulatePass.output")
 
+    # Publishes per-pixel sample counts that the PathTracer uses from the next frame on.
+    if $ADAPTIVE_SAMPLING$:
+        AdaptiveSamplingPass = createPass("AdaptiveSamplingPass", {
+            'accumulatePass': $ACCUMULATE_PASS$,
+            'targetSamples': $TARGET_SAMPLES$,
+        })
+        g.addPass(AdaptiveSamplingPass, "AdaptiveSamplingPass")
+        g.addEdge("AccumulatePass.output", "AdaptiveSamplingPass.input")
+        g.markOutput("AdaptiveSamplingPass.sampleCount")
+
+    # Publishes the 16x16 tiles with motion, luminance changes or events, static tiles are held by the BlockStoragePass.
+    TileActivityPass = createPass("TileActivityPass", {
+        'enabled': $TILE_ACTIVITY$,
+        'accumulatePass': $ACCUMULATE_PASS$,
+    })
+    g.addPass(TileActivityPass, "TileActivityPass")
+    g.addEdge("VBufferRT.mvec", "TileActivityPass.mvec")
+    g.addEdge("AccumulatePass.output", "TileActivityPass.color")
+
     SceneDebuggerID = createPass('SceneDebugger', {'mode': 'InstanceID'})
     g.addPass(SceneDebuggerID, 'SceneDebuggerID')
     SceneDebuggerNormal = createPass('SceneDebugger', {'mode': 'FaceNormal'})
@@ -60,9 +79,11 @@ def render_graph_PathTracer():
         'enabled': $BLOCK_STORAGE_ENABLED$,
         'accumulatePass': $ACCUMULATE_PASS$,
         'directory': "$DIRECTORY$/Output",
+        'tileActivity': $TILE_ACTIVITY$,
     })
     g.addPass(BlockStoragePass, "BlockStoragePass")
     g.addEdge("AccumulatePass.output", "BlockStoragePass.input")
+    g.addEdge("TileActivityPass.activity", "BlockStoragePass.tileActivity")
 
     BlockStoragePassDI = createPass("BlockStoragePass", {
         'enabled': $BLOCK_STORAGE_ENABLED$,
@@ -0,0 +1,67 @@
+import os
+import tempfile
+import unittest
+import falcor
+import numpy as np
+
+
+def write_block_files(directory, frame_dim, block_size, batch_count):
+    """Write RGBA32Float block files and return the stored frames, ordered by frame, row, column and channel."""
+    frames = np.random.default_rng(1).random((batch_count * block_size[2], frame_dim[1], frame_dim[0], 4), dtype=np.float32)
+    for bz in range(batch_count):
+        for by in range(frame_dim[1] // block_size[1]):
+            for bx in range(frame_dim[0] // block_size[0]):
+                block = frames[
+                    bz * block_size[2] : (bz + 1) * block_size[2],
+                    by * block_size[1] : (by + 1) * block_size[1],
+                    bx * block_size[0] : (bx + 1) * block_size[0],
+                ]
+                block.tofile(os.path.join(directory, f"block_{bx}_{by}_{bz}.bin"))
+    return frames
+
+
+class TestBlockStorage(unittest.TestCase):
+    def setUp(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        self.frame_dim = (8, 4)
+        self.block_size = (4, 4, 2)
+        self.frames = write_block_files(self.tmp.name, self.frame_dim, self.block_size, 2)
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def create_reader(self):
+        return falcor.BlockStorageReader(
+            self.tmp.name,
+            frame_dim=falcor.uint3(self.frame_dim[0], self.frame_dim[1], 0),
+            block_size=falcor.uint3(*self.block_size),
+            format=falcor.BlockFormat.RGBA32Float,
+        )
+
+    def test_block_is_read_only(self):
+        reader = self.create_reader()
+        block = reader.block(1, 0, 1)
+        self.assertEqual(block.shape, (2, 4, 4, 4))
+        self.assertTrue(np.all(block == self.frames[2:4, 0:4, 4:8]))
+        self.assertFalse(block.flags.writeable)
+        with self.assertRaises(ValueError):
+            block[0, 0, 0, 0] = 1.0
+        with self.assertRaises(ValueError):
+            block.setflags(write=True)
+        # The cached block is unchanged.
+        self.assertTrue(np.all(reader.block(1, 0, 1) == self.frames[2:4, 0:4, 4:8]))
+
+    def test_pixel_series_is_read_only(self):
+        path = os.path.join(self.tmp.name, "series.fps")
+        falcor.write_pixel_series(self.create_reader(), path)
+        reader = falcor.PixelSeriesReader(path)
+        series = reader.series(5, 2)
+        self.assertEqual(series.shape, (4, 4))
+        self.assertTrue(np.all(series == self.frames[:, 2, 5]))
+        self.assertFalse(series.flags.writeable)
+        with self.assertRaises(ValueError):
+            series[0, 0] = 1.0
+
+
+if __name__ == '__main__':
+    unittest.main()